@@ -1,7 +1,12 @@
 #include <jni.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
-#include <sstream>
+#include <vector>
 #include "core/PasswordManager.h"
+#include "core/JsonWriter.h"
+#include "core/StrengthAnalyzer.h"
 #include "models/PasswordEntry.h"
 
 extern "C" JNIEXPORT jlong JNICALL
@@ -112,17 +117,16 @@ jint category) {
 if (manager_ptr == 0) return env->NewStringUTF("{\"error\": \"Manager not initialized\"}");
 
 PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
-auto passwords = manager->getPasswordsByCategory(static_cast<Category>(category));
 
-std::stringstream ss;
-ss << "[";
-for(size_t i = 0; i < passwords.size(); ++i) {
-ss << passwords[i].toJson();
-if(i != passwords.size() - 1) ss << ",";
-}
-ss << "]";
+// Serialise straight from the vault instead of copying the entries first
+JsonWriter json;
+json.beginArray();
+manager->forEachInCategory(static_cast<Category>(category), [&](const PasswordEntry& entry) {
+entry.writeJson(json);
+});
+json.endArray();
 
-return env->NewStringUTF(ss.str().c_str());
+return env->NewStringUTF(json.str().c_str());
 }
 
 // Search passwords as JSON
@@ -138,18 +142,63 @@ if (manager_ptr == 0) return env->NewStringUTF("{\"error\": \"Manager not initia
 PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 const char* nativeQuery = env->GetStringUTFChars(query, nullptr);
 
-auto passwords = manager->searchPasswords(nativeQuery);
+JsonWriter json;
+json.beginArray();
+manager->forEachSearchResult(nativeQuery, [&](const PasswordEntry& entry) {
+entry.writeJson(json);
+});
+json.endArray();
 
-std::stringstream ss;
-ss << "[";
-for(size_t i = 0; i < passwords.size(); ++i) {
-ss << passwords[i].toJson();
-if(i != passwords.size() - 1) ss << ",";
+env->ReleaseStringUTFChars(query, nativeQuery);
+return env->NewStringUTF(json.str().c_str());
 }
-ss << "]";
 
-env->ReleaseStringUTFChars(query, nativeQuery);
-return env->NewStringUTF(ss.str().c_str());
+// Autofill candidates for a page URL as JSON
+extern "C" JNIEXPORT jstring JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_matchForUrlJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong manager_ptr,
+jstring url) {
+
+if (manager_ptr == 0) return env->NewStringUTF("{\"error\": \"Manager not initialized\"}");
+
+PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+const char* nativeUrl = env->GetStringUTFChars(url, nullptr);
+
+JsonWriter json;
+json.beginArray();
+manager->forEachMatchForUrl(nativeUrl, [&](const PasswordEntry& entry) {
+entry.writeJson(json);
+});
+json.endArray();
+
+env->ReleaseStringUTFChars(url, nativeUrl);
+return env->NewStringUTF(json.str().c_str());
+}
+
+// Autofill candidates for an Android app package as JSON
+extern "C" JNIEXPORT jstring JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_matchForPackageJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong manager_ptr,
+jstring package) {
+
+if (manager_ptr == 0) return env->NewStringUTF("{\"error\": \"Manager not initialized\"}");
+
+PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+const char* nativePackage = env->GetStringUTFChars(package, nullptr);
+
+JsonWriter json;
+json.beginArray();
+manager->forEachMatchForPackage(nativePackage, [&](const PasswordEntry& entry) {
+entry.writeJson(json);
+});
+json.endArray();
+
+env->ReleaseStringUTFChars(package, nativePackage);
+return env->NewStringUTF(json.str().c_str());
 }
 
 // Get category statistics as JSON
@@ -164,17 +213,64 @@ if (manager_ptr == 0) return env->NewStringUTF("{\"error\": \"Manager not initia
 PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 auto stats = manager->getCategoryStats();
 
-std::stringstream ss;
-ss << "{";
-bool first = true;
+JsonWriter json;
+json.beginObject();
 for(const auto& [category, count] : stats) {
-if(!first) ss << ",";
-ss << "\"" << category << "\":" << count;
-first = false;
+json.member(category, count);
 }
-ss << "}";
+json.endObject();
+
+return env->NewStringUTF(json.str().c_str());
+}
+
+// Vault health: counts plus the ids behind each finding, never passwords
+extern "C" JNIEXPORT jstring JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_getVaultAuditJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong manager_ptr) {
+
+if (manager_ptr == 0) return env->NewStringUTF("{\"error\": \"Manager not initialized\"}");
 
-return env->NewStringUTF(ss.str().c_str());
+PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+VaultAuditReport report = manager->auditVault();
+
+auto writeGroups = [](JsonWriter& json, const std::vector<std::vector<std::string>>& groups) {
+json.beginArray();
+for(const auto& group : groups) {
+json.beginArray();
+for(const std::string& id : group) json.value(id);
+json.endArray();
+}
+json.endArray();
+};
+
+JsonWriter json;
+json.beginObject()
+.member("totalEntries", report.totalEntries)
+.member("analyzedEntries", report.analyzedEntries)
+.member("weakEntries", report.weakEntries)
+.member("reusedEntries", report.reusedEntries)
+.member("similarEntries", report.similarEntries)
+.member("breachedEntries", report.breachedEntries)
+.member("breachUnknownEntries", report.breachUnknownEntries)
+.member("averageScore", report.averageScore)
+.key("strengthHistogram").beginArray();
+for(size_t count : report.strengthHistogram) json.value(count);
+json.endArray()
+.key("weakIds").beginArray();
+for(const std::string& id : report.weakIds) json.value(id);
+json.endArray()
+.key("breachedIds").beginArray();
+for(const std::string& id : report.breachedIds) json.value(id);
+json.endArray();
+json.key("reuseGroups");
+writeGroups(json, report.reuseGroups);
+json.key("similarGroups");
+writeGroups(json, report.similarGroups);
+json.endObject();
+
+return env->NewStringUTF(json.str().c_str());
 }
 
 // Get total password count
@@ -190,6 +286,31 @@ PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 return manager->getTotalCount();
 }
 
+// Re-encrypt the vault after a master password change, if one is pending
+extern "C" JNIEXPORT jboolean JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_startRekey(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong manager_ptr) {
+
+if (manager_ptr == 0) return false;
+
+PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+return manager->startRekey();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_isRekeying(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong manager_ptr) {
+
+if (manager_ptr == 0) return false;
+
+PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+return manager->isRekeying();
+}
+
 // NEW: Enhanced password analysis with detailed suggestions
 extern "C" JNIEXPORT jstring JNICALL
         Java_com_example_advanced_1password_1manager_NativePasswordService_analyzePasswordDetailed(
@@ -204,41 +325,30 @@ PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 const char* nativePassword = env->GetStringUTFChars(password, nullptr);
 
 // Use the enhanced password analysis
-PasswordAnalysisResult result = PasswordEntry::analyzePasswordDetailed(nativePassword);
-
-std::stringstream ss;
-ss << "{";
-ss << "\"score\":" << result.score << ",";
-ss << "\"strength\":\"" << result.strength << "\",";
-ss << "\"suggestions\":[";
-
-for(size_t i = 0; i < result.suggestions.size(); ++i) {
-ss << "\"" << result.suggestions[i] << "\"";
-if(i != result.suggestions.size() - 1) ss << ",";
+StrengthAnalyzer analyzer(nativePassword);
+PasswordAnalysisResult result = analyzer.result();
+
+JsonWriter json;
+json.beginObject()
+.member("score", result.score)
+.member("strength", result.strength)
+.key("suggestions").beginArray();
+for(const std::string& suggestion : result.suggestions) {
+json.value(suggestion);
 }
+json.endArray()
+.member("length", strlen(nativePassword));
 
-ss << "],";
-ss << "\"length\":" << strlen(nativePassword) << ",";
-
-// Analyze character types for UI
-bool hasUpper = false, hasLower = false, hasDigit = false, hasSpecial = false;
-std::string passStr = nativePassword;
-
-for(char c : passStr) {
-if(std::isupper(c)) hasUpper = true;
-else if(std::islower(c)) hasLower = true;
-else if(std::isdigit(c)) hasDigit = true;
-else if(!std::isalnum(c)) hasSpecial = true;
-}
-
-ss << "\"hasUpper\":" << (hasUpper ? "true" : "false") << ",";
-ss << "\"hasLower\":" << (hasLower ? "true" : "false") << ",";
-ss << "\"hasDigit\":" << (hasDigit ? "true" : "false") << ",";
-ss << "\"hasSpecial\":" << (hasSpecial ? "true" : "false");
-ss << "}";
+// Character types for the UI, from the same pass
+json.member("hasUpper", analyzer.classCount(StrengthAnalyzer::UPPER) > 0)
+.member("hasLower", analyzer.classCount(StrengthAnalyzer::LOWER) > 0)
+.member("hasDigit", analyzer.classCount(StrengthAnalyzer::DIGIT) > 0)
+.member("hasSpecial", analyzer.classCount(StrengthAnalyzer::SPECIAL) > 0)
+.member("breached", result.breached)
+.endObject();
 
 env->ReleaseStringUTFChars(password, nativePassword);
-return env->NewStringUTF(ss.str().c_str());
+return env->NewStringUTF(json.str().c_str());
 }
 
 // NEW: Quick password strength check (for real-time feedback)
@@ -256,6 +366,44 @@ env->ReleaseStringUTFChars(password, nativePassword);
 return env->NewStringUTF(result.c_str());
 }
 
+// Live strength meter: keeps per-character state between keystrokes, so
+// each update only re-analyses the text after the common prefix
+extern "C" JNIEXPORT jlong JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_createStrengthMeter(
+        JNIEnv* env,
+        jobject /* this */) {
+return reinterpret_cast<jlong>(new StrengthAnalyzer());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_updateStrengthMeter(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong meter_ptr,
+jstring password) {
+
+if (meter_ptr == 0) return env->NewStringUTF("");
+
+StrengthAnalyzer* meter = reinterpret_cast<StrengthAnalyzer*>(meter_ptr);
+const char* nativePassword = env->GetStringUTFChars(password, nullptr);
+
+meter->assign(nativePassword);
+std::string result = std::string(meter->label()) + " (" + std::to_string(meter->score()) + "/100)";
+
+env->ReleaseStringUTFChars(password, nativePassword);
+return env->NewStringUTF(result.c_str());
+}
+
+extern "C" JNIEXPORT void JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_destroyStrengthMeter(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong meter_ptr) {
+if (meter_ptr != 0) {
+delete reinterpret_cast<StrengthAnalyzer*>(meter_ptr);
+}
+}
+
 // NEW: Generate password with specific requirements
 extern "C" JNIEXPORT jstring JNICALL
         Java_com_example_advanced_1password_1manager_NativePasswordService_generateStrongPassword(
@@ -272,42 +420,52 @@ if (manager_ptr == 0) return env->NewStringUTF("");
 
 PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 
-// Generate password with specified requirements
-const std::string uppercase = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-const std::string lowercase = "abcdefghijklmnopqrstuvwxyz";
-const std::string digits = "0123456789";
-const std::string symbols = "!@#$%^&*()_+-=[]{}|;:,.<>?";
-
-std::string charPool = "";
-if (includeUpper) charPool += uppercase;
-if (includeLower) charPool += lowercase;
-if (includeDigits) charPool += digits;
-if (includeSymbols) charPool += symbols;
+GenerationPolicy policy;
+policy.length = length;
+policy.uppercase = includeUpper;
+policy.lowercase = includeLower;
+policy.digits = includeDigits;
+policy.symbols = includeSymbols;
 
-if (charPool.empty()) {
-charPool = uppercase + lowercase + digits + symbols; // Default to all
+std::string result = manager->generatePassword(policy);
+return env->NewStringUTF(result.c_str());
 }
 
-std::string result;
-std::random_device rd;
-std::mt19937 gen(rd());
-std::uniform_int_distribution<> dis(0, charPool.size() - 1);
+// NEW: Generate many passwords at once, returned as a JSON array of strings
+extern "C" JNIEXPORT jstring JNICALL
+        Java_com_example_advanced_1password_1manager_NativePasswordService_generatePasswordBatch(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong manager_ptr,
+jint count,
+        jint length,
+jboolean includeUpper,
+        jboolean includeLower,
+jboolean includeDigits,
+        jboolean includeSymbols) {
 
-// Ensure at least one of each required type
-if (includeUpper) result += uppercase[dis(gen) % uppercase.size()];
-if (includeLower) result += lowercase[dis(gen) % lowercase.size()];
-if (includeDigits) result += digits[dis(gen) % digits.size()];
-if (includeSymbols) result += symbols[dis(gen) % symbols.size()];
+if (manager_ptr == 0 || count <= 0) return env->NewStringUTF("[]");
 
-// Fill remaining length
-while (result.length() < length) {
-result += charPool[dis(gen)];
-}
+PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 
-// Shuffle the result
-std::shuffle(result.begin(), result.end(), gen);
+GenerationPolicy policy;
+policy.length = length;
+policy.uppercase = includeUpper;
+policy.lowercase = includeLower;
+policy.digits = includeDigits;
+policy.symbols = includeSymbols;
 
-return env->NewStringUTF(result.c_str());
+PasswordBatch batch = manager->generatePasswords(static_cast<size_t>(count), policy);
+
+JsonWriter json;
+json.reserve(batch.size() * (batch.length() + 4) + 2);
+json.beginArray();
+for (size_t i = 0; i < batch.size(); ++i) {
+json.value(batch[i]);
+}
+json.endArray();
+
+return env->NewStringUTF(json.str().c_str());
 }
 
 // Your existing methods remain the same...
@@ -394,4 +552,265 @@ PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
 std::string result = manager->generatePin(length);
 
 return env->NewStringUTF(result.c_str());
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Binary record exchange and method registration
+//
+// Batches travel through direct ByteBuffers as a u32 entry count followed by
+// PasswordEntry::appendBinary entries (u8 category, u64 created, u64
+// modified, then u32-length-prefixed id, title, username, password, website
+// and notes), all little-endian. This is the encoding the vault file and
+// encrypted backups use. Nothing is converted to modified UTF-8, and
+// Kotlin reads the records in place with ByteBuffer.order(LITTLE_ENDIAN).
+// ============================================================================
+
+namespace {
+
+const char* const SERVICE_CLASS = "com/example/last_final/NativePasswordService";
+
+// Resolved once in JNI_OnLoad. java.nio.Buffer is a boot class and is never
+// unloaded, so its method IDs stay valid without a global reference
+struct JniCache {
+    jclass service = nullptr;               // Global ref: the class natives are registered on
+    jmethodID bufferPosition = nullptr;     // int Buffer.position()
+    jmethodID bufferLimit = nullptr;        // int Buffer.limit()
+    jmethodID bufferSetPosition = nullptr;  // Buffer Buffer.position(int)
+    jmethodID bufferSetLimit = nullptr;     // Buffer Buffer.limit(int)
+};
+JniCache g_jni;
+
+constexpr size_t COUNT_SIZE = 4;
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+void storeCount(uint8_t* p, uint32_t value) {
+    for (size_t i = 0; i < COUNT_SIZE; ++i) p[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+uint32_t loadCount(const uint8_t* p) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < COUNT_SIZE; ++i) value |= uint32_t(p[i]) << (8 * i);
+    return value;
+}
+
+/**
+ * @brief Packs whole entries into a direct buffer, then flips it for reading
+ *
+ * The count goes first and entries follow while they fit. An entry that
+ * does not fit ends the batch, and its size is kept so the caller can ask
+ * for a bigger buffer if not even the first entry fitted.
+ */
+class RecordSink {
+public:
+    RecordSink(uint8_t* base, size_t capacity) : base(base), capacity(capacity), used(COUNT_SIZE) {}
+    ~RecordSink() { secureWipe(&scratch[0], scratch.size()); }
+
+    bool full() const { return needed != 0; }
+
+    bool add(const PasswordEntry& entry) {
+        if (full()) return false;
+        secureWipe(&scratch[0], scratch.size());
+        scratch.clear();
+        entry.appendBinary(scratch);
+        if (scratch.size() > capacity - used) {
+            needed = COUNT_SIZE + scratch.size();
+            return false;
+        }
+        std::memcpy(base + used, scratch.data(), scratch.size());
+        used += scratch.size();
+        ++count;
+        return true;
+    }
+
+    /** @brief Entries written; -(bytes needed) when the first entry did not fit */
+    jint finish(JNIEnv* env, jobject buffer) {
+        storeCount(base, count);
+        env->CallObjectMethod(buffer, g_jni.bufferSetLimit, static_cast<jint>(used));
+        env->CallObjectMethod(buffer, g_jni.bufferSetPosition, 0);
+        if (count == 0 && needed != 0) {
+            return needed > static_cast<size_t>(INT32_MAX) ? INT32_MIN : -static_cast<jint>(needed);
+        }
+        return static_cast<jint>(count);
+    }
+
+private:
+    uint8_t* base;
+    size_t capacity;
+    size_t used;
+    uint32_t count = 0;
+    size_t needed = 0;
+    std::string scratch;
+};
+
+/** @brief Writable direct buffer with room for at least the count, or nullptr */
+uint8_t* outputBuffer(JNIEnv* env, jobject buffer, size_t& capacity) {
+    if (!buffer) return nullptr;
+    uint8_t* base = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    const jlong size = env->GetDirectBufferCapacity(buffer);
+    if (!base || size < static_cast<jlong>(COUNT_SIZE)) return nullptr;
+    capacity = static_cast<size_t>(size);
+    return base;
+}
+
+} // namespace
+
+/**
+ * Adds every entry in `records` [position, limit) in batched transactions.
+ * Record ids are ignored, and the new row ids go to `ids` when it is given.
+ * Returns the entries added, or -1 if the batch is malformed or the buffer
+ * is not direct. Nothing is added in that case.
+ */
+static jint addPasswordsBinary(JNIEnv* env, jobject /* this */, jlong manager_ptr, jobject records, jlongArray ids) {
+    if (manager_ptr == 0 || !records) return -1;
+    PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+
+    const char* base = static_cast<const char*>(env->GetDirectBufferAddress(records));
+    if (!base) return -1;
+    const jint position = env->CallIntMethod(records, g_jni.bufferPosition);
+    const jint limit = env->CallIntMethod(records, g_jni.bufferLimit);
+    if (limit - position < static_cast<jint>(COUNT_SIZE)) return -1;
+
+    const std::string_view data(base + position, static_cast<size_t>(limit - position));
+    const uint32_t count = loadCount(reinterpret_cast<const uint8_t*>(data.data()));
+    std::vector<PasswordEntry> entries;
+    entries.reserve(std::min<size_t>(count, data.size() / 32));
+    size_t offset = COUNT_SIZE;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::optional<PasswordEntry> entry = PasswordEntry::readBinary(data, offset);
+        if (!entry) return -1;
+        entries.push_back(std::move(*entry));
+    }
+    if (offset != data.size()) return -1;
+    env->CallObjectMethod(records, g_jni.bufferSetPosition, limit);
+
+    std::vector<int64_t> rowIds;
+    const size_t added = manager->addPasswords(std::move(entries), &rowIds);
+    if (ids) {
+        const jsize room = env->GetArrayLength(ids);
+        const jsize n = static_cast<jsize>(std::min<size_t>(added, static_cast<size_t>(room)));
+        static_assert(sizeof(jlong) == sizeof(int64_t), "jlong must be 64-bit");
+        env->SetLongArrayRegion(ids, 0, n, reinterpret_cast<const jlong*>(rowIds.data()));
+    }
+    return static_cast<jint>(added);
+}
+
+/**
+ * Fills `buffer` with the entries for `ids`, in request order. Unknown ids
+ * are skipped. Returns how many ids were consumed, so a caller whose buffer
+ * filled up can continue from there. Returns -(bytes needed) if not even
+ * the next entry fits, and -1 for a non-direct buffer.
+ */
+static jint getPasswordsBinary(JNIEnv* env, jobject /* this */, jlong manager_ptr, jlongArray ids, jobject buffer) {
+    size_t capacity = 0;
+    uint8_t* base = outputBuffer(env, buffer, capacity);
+    if (manager_ptr == 0 || !ids || !base) return -1;
+    PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+
+    std::vector<int64_t> wanted(static_cast<size_t>(env->GetArrayLength(ids)));
+    env->GetLongArrayRegion(ids, 0, static_cast<jsize>(wanted.size()), reinterpret_cast<jlong*>(wanted.data()));
+
+    RecordSink sink(base, capacity);
+    size_t consumed = 0;
+    for (; consumed < wanted.size() && !sink.full(); ++consumed) {
+        manager->forEachById(&wanted[consumed], 1, [&](const PasswordEntry& entry) { sink.add(entry); });
+        if (sink.full()) break;
+    }
+
+    const jint written = sink.finish(env, buffer);
+    return written < 0 ? written : static_cast<jint>(consumed);
+}
+
+/**
+ * Pages through every entry. The first `start` are skipped and `buffer` is
+ * filled with as many of the rest as fit. Returns the entries written: 0
+ * once past the end, -(bytes needed) if not even the next entry fits, and
+ * -1 for a non-direct buffer.
+ */
+static jint getAllPasswordsBinary(JNIEnv* env, jobject /* this */, jlong manager_ptr, jint start, jobject buffer) {
+    size_t capacity = 0;
+    uint8_t* base = outputBuffer(env, buffer, capacity);
+    if (manager_ptr == 0 || start < 0 || !base) return -1;
+    PasswordManager* manager = reinterpret_cast<PasswordManager*>(manager_ptr);
+
+    RecordSink sink(base, capacity);
+    manager->forEachPasswordFrom(static_cast<size_t>(start),
+                                 [&](const PasswordEntry& entry) { return sink.add(entry); });
+    return sink.finish(env, buffer);
+}
+
+#define SF_NATIVE(name, signature) \
+    { #name, signature, reinterpret_cast<void*>(Java_com_example_advanced_1password_1manager_NativePasswordService_##name) }
+#define STR "Ljava/lang/String;"
+
+static const JNINativeMethod SERVICE_METHODS[] = {
+    SF_NATIVE(createManager, "()J"),
+    SF_NATIVE(destroyManager, "(J)V"),
+    SF_NATIVE(setDatabasePath, "(J" STR ")V"),
+    SF_NATIVE(addPassword, "(J" STR STR STR "I" STR STR ")Z"),
+    SF_NATIVE(deletePassword, "(JI)Z"),
+    SF_NATIVE(getAllPasswordsJson, "(J)" STR),
+    SF_NATIVE(getPasswordsByCategoryJson, "(JI)" STR),
+    SF_NATIVE(searchPasswordsJson, "(J" STR ")" STR),
+    SF_NATIVE(matchForUrlJson, "(J" STR ")" STR),
+    SF_NATIVE(matchForPackageJson, "(J" STR ")" STR),
+    SF_NATIVE(getCategoryStatsJson, "(J)" STR),
+    SF_NATIVE(getVaultAuditJson, "(J)" STR),
+    SF_NATIVE(getTotalPasswordCount, "(J)I"),
+    SF_NATIVE(startRekey, "(J)Z"),
+    SF_NATIVE(isRekeying, "(J)Z"),
+    SF_NATIVE(analyzePassword, "(J" STR ")" STR),
+    SF_NATIVE(generateRandomPassword, "(JI)" STR),
+    SF_NATIVE(generateFromFavorite, "(J" STR "I)" STR),
+    SF_NATIVE(generateMemorablePassword, "(J)" STR),
+    SF_NATIVE(generatePin, "(JI)" STR),
+    SF_NATIVE(analyzePasswordDetailed, "(J" STR ")" STR),
+    SF_NATIVE(getPasswordStrength, "(" STR ")" STR),
+    SF_NATIVE(createStrengthMeter, "()J"),
+    SF_NATIVE(updateStrengthMeter, "(J" STR ")" STR),
+    SF_NATIVE(destroyStrengthMeter, "(J)V"),
+    SF_NATIVE(generateStrongPassword, "(JIZZZZ)" STR),
+    SF_NATIVE(generatePasswordBatch, "(JIIZZZZ)" STR),
+    { "addPasswordsBinary", "(JLjava/nio/ByteBuffer;[J)I", reinterpret_cast<void*>(addPasswordsBinary) },
+    { "getPasswordsBinary", "(J[JLjava/nio/ByteBuffer;)I", reinterpret_cast<void*>(getPasswordsBinary) },
+    { "getAllPasswordsBinary", "(JILjava/nio/ByteBuffer;)I", reinterpret_cast<void*>(getAllPasswordsBinary) },
+};
+
+#undef STR
+#undef SF_NATIVE
+
+/**
+ * Registers every native of NativePasswordService explicitly. The exported
+ * Java_* symbols are named for an older package, so symbol lookup would not
+ * find them. Registration also saves the runtime a dlsym per method, and it
+ * fails loudly at load time if the Kotlin declarations drift.
+ */
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /* reserved */) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) return JNI_ERR;
+
+    jclass buffer = env->FindClass("java/nio/Buffer");
+    if (!buffer) return JNI_ERR;
+    g_jni.bufferPosition = env->GetMethodID(buffer, "position", "()I");
+    g_jni.bufferLimit = env->GetMethodID(buffer, "limit", "()I");
+    g_jni.bufferSetPosition = env->GetMethodID(buffer, "position", "(I)Ljava/nio/Buffer;");
+    g_jni.bufferSetLimit = env->GetMethodID(buffer, "limit", "(I)Ljava/nio/Buffer;");
+    env->DeleteLocalRef(buffer);
+    if (!g_jni.bufferPosition || !g_jni.bufferLimit || !g_jni.bufferSetPosition || !g_jni.bufferSetLimit) {
+        return JNI_ERR;
+    }
+
+    jclass service = env->FindClass(SERVICE_CLASS);
+    if (!service) return JNI_ERR;
+    g_jni.service = static_cast<jclass>(env->NewGlobalRef(service));
+    env->DeleteLocalRef(service);
+
+    const jint count = static_cast<jint>(sizeof(SERVICE_METHODS) / sizeof(SERVICE_METHODS[0]));
+    if (env->RegisterNatives(g_jni.service, SERVICE_METHODS, count) != JNI_OK) return JNI_ERR;
+    return JNI_VERSION_1_6;
+}
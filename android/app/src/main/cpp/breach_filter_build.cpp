@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "core/BreachFilter.h"
+
+/**
+ * @brief Build BreachFilter shards from a breach corpus
+ *
+ * Reads SHA-1 hex lines from stdin, optionally followed by ":COUNT" as in
+ * the Pwned Passwords downloads, and writes one shard file per shard to
+ * --out. Lines with a count below --min-count are skipped, which is how a
+ * smaller on-device corpus is cut from the full list.
+ *
+ *   breach_filter_build --out DIR --generation N [--min-count N] < corpus.txt
+ *
+ * Publish the shards with their generation; clients compare it against
+ * cpp_breach_shard_generation and install newer files.
+ */
+
+namespace {
+
+struct Options {
+    std::string out;
+    uint64_t generation = 0;
+    uint64_t minCount = 0;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (arg == "--generation" && hasValue) {
+            options.generation = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--min-count" && hasValue) {
+            options.minCount = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            options.out.clear();
+            break;
+        }
+    }
+    if (options.out.empty() || options.generation == 0) {
+        std::cerr << "usage: " << argv[0] << " --out DIR --generation N [--min-count N] < corpus.txt" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) return 2;
+
+    std::vector<std::vector<uint64_t>> byShard(BreachFilter::SHARD_COUNT);
+    std::string line;
+    size_t lineNumber = 0, skipped = 0, kept = 0;
+    while (std::getline(std::cin, line)) {
+        ++lineNumber;
+        uint64_t key;
+        if (!BreachFilter::parseHexKey(line, key)) {
+            std::cerr << "line " << lineNumber << ": not a SHA-1 hex digest" << std::endl;
+            return 1;
+        }
+        const size_t colon = line.find(':');
+        if (options.minCount && colon != std::string::npos &&
+            std::strtoull(line.c_str() + colon + 1, nullptr, 10) < options.minCount) {
+            ++skipped;
+            continue;
+        }
+        byShard[BreachFilter::shardOf(key)].push_back(key);
+        ++kept;
+    }
+
+    for (uint32_t shard = 0; shard < BreachFilter::SHARD_COUNT; ++shard) {
+        const std::string path = options.out + "/" + BreachFilter::shardFileName(shard);
+        std::ofstream file(path, std::ios::binary);
+        file << BreachFilter::buildShard(shard, std::move(byShard[shard]), options.generation);
+        if (!file) {
+            std::cerr << "Could not write " << path << std::endl;
+            return 1;
+        }
+    }
+    std::cerr << kept << " keys in " << BreachFilter::SHARD_COUNT << " shards, " << skipped
+              << " below --min-count" << std::endl;
+    return 0;
+}
@@ -137,6 +137,105 @@ std::string AESEncryptionStrategy::decrypt(const std::string& cipherText) {
     }
 }
 
+size_t AESEncryptionStrategy::maxEncryptedSize(size_t plainLength) const {
+    const size_t padded = (plainLength / AES::BLOCKSIZE + 1) * AES::BLOCKSIZE;
+    return (padded + 2) / 3 * 4;
+}
+
+size_t AESEncryptionStrategy::maxDecryptedSize(size_t cipherLength) const {
+    return cipherLength / 4 * 3 + 3;
+}
+
+size_t AESEncryptionStrategy::encryptInto(ConstByteSpan plain, ByteSpan out) {
+    if (!initialized) {
+        throw std::runtime_error("AES encryption strategy not initialized. Call initialize() first.");
+    }
+    if (plain.empty()) {
+        return 0; // Empty input returns empty output
+    }
+    if (out.size() < maxEncryptedSize(plain.size())) {
+        throw std::length_error("Output buffer too small for ciphertext");
+    }
+
+    try {
+        CBC_Mode<AES>::Encryption encryptor(key, key.size(), iv);
+        ArraySink* sink = new ArraySink(out.data(), out.size());
+        ArraySource source(plain.data(), plain.size(), true,
+            new StreamTransformationFilter(encryptor, new Base64Encoder(sink, false)));
+        return static_cast<size_t>(sink->TotalPutLength());
+    } catch (const Exception& e) {
+        throw std::runtime_error(std::string("AES encryption failed: ") + e.what());
+    }
+}
+
+size_t AESEncryptionStrategy::decryptInto(ConstByteSpan cipher, ByteSpan out) {
+    if (!initialized) {
+        throw std::runtime_error("AES encryption strategy not initialized. Call initialize() first.");
+    }
+    if (cipher.empty()) {
+        return 0; // Empty input returns empty output
+    }
+    if (out.size() < maxDecryptedSize(cipher.size())) {
+        throw std::length_error("Output buffer too small for plaintext");
+    }
+
+    try {
+        CBC_Mode<AES>::Decryption decryptor(key, key.size(), iv);
+        ArraySink* sink = new ArraySink(out.data(), out.size());
+        ArraySource source(cipher.data(), cipher.size(), true,
+            new Base64Decoder(new StreamTransformationFilter(decryptor, sink)));
+        return static_cast<size_t>(sink->TotalPutLength());
+    } catch (const Exception& e) {
+        throw std::runtime_error(std::string("AES decryption failed: ") + e.what());
+    }
+}
+
+std::vector<std::string> AESEncryptionStrategy::encryptBatch(const std::vector<std::string>& plainTexts) {
+    if (!initialized) {
+        throw std::runtime_error("AES encryption strategy not initialized. Call initialize() first.");
+    }
+
+    std::vector<std::string> out(plainTexts.size());
+    try {
+        CBC_Mode<AES>::Encryption encryptor(key, key.size(), iv);
+        for (size_t i = 0; i < plainTexts.size(); ++i) {
+            if (plainTexts[i].empty()) continue;
+            encryptor.Resynchronize(iv, static_cast<int>(iv.size()));
+            out[i].resize(maxEncryptedSize(plainTexts[i].size()));
+            ArraySink* sink = new ArraySink(reinterpret_cast<CryptoPP::byte*>(&out[i][0]), out[i].size());
+            ArraySource source(plainTexts[i], true,
+                new StreamTransformationFilter(encryptor, new Base64Encoder(sink, false)));
+            out[i].resize(static_cast<size_t>(sink->TotalPutLength()));
+        }
+    } catch (const Exception& e) {
+        throw std::runtime_error(std::string("AES encryption failed: ") + e.what());
+    }
+    return out;
+}
+
+std::vector<std::string> AESEncryptionStrategy::decryptBatch(const std::vector<std::string>& cipherTexts) {
+    if (!initialized) {
+        throw std::runtime_error("AES encryption strategy not initialized. Call initialize() first.");
+    }
+
+    std::vector<std::string> out(cipherTexts.size());
+    try {
+        CBC_Mode<AES>::Decryption decryptor(key, key.size(), iv);
+        for (size_t i = 0; i < cipherTexts.size(); ++i) {
+            if (cipherTexts[i].empty()) continue;
+            decryptor.Resynchronize(iv, static_cast<int>(iv.size()));
+            out[i].resize(maxDecryptedSize(cipherTexts[i].size()));
+            ArraySink* sink = new ArraySink(reinterpret_cast<CryptoPP::byte*>(&out[i][0]), out[i].size());
+            ArraySource source(cipherTexts[i], true,
+                new Base64Decoder(new StreamTransformationFilter(decryptor, sink)));
+            out[i].resize(static_cast<size_t>(sink->TotalPutLength()));
+        }
+    } catch (const Exception& e) {
+        throw std::runtime_error(std::string("AES decryption failed: ") + e.what());
+    }
+    return out;
+}
+
 std::string AESEncryptionStrategy::getAlgorithmName() const {
     return "AES-256-CBC";
 }
@@ -41,6 +41,15 @@ public:
     void initialize() override;
     int getKeyStrength() const override;
 
+    // Buffer and batch forms: base64 of AES-256-CBC/PKCS#7, no newlines.
+    // Batches reuse one key schedule and resynchronize the IV per record.
+    size_t maxEncryptedSize(size_t plainLength) const override;
+    size_t maxDecryptedSize(size_t cipherLength) const override;
+    size_t encryptInto(ConstByteSpan plain, ByteSpan out) override;
+    size_t decryptInto(ConstByteSpan cipher, ByteSpan out) override;
+    std::vector<std::string> encryptBatch(const std::vector<std::string>& plainTexts) override;
+    std::vector<std::string> decryptBatch(const std::vector<std::string>& cipherTexts) override;
+
     // Additional AES-specific methods
     void clearKeys();
     bool isInitialized() const { return initialized; }
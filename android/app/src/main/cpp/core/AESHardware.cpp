@@ -0,0 +1,68 @@
+#include "AESHardware.h"
+#include <atomic>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+static std::atomic<bool> g_hardwareEnabled{true};
+
+static bool cpuHasArmCrypto() {
+#if defined(__aarch64__) && defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+    return false;
+#endif
+}
+
+static bool cpuHasAesNi() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    const bool aes = (ecx & (1u << 25)) != 0;
+    const bool ssse3 = (ecx & (1u << 9)) != 0;
+    return aes && ssse3;
+#else
+    return false;
+#endif
+}
+
+static const AESHardwareKernels* detectKernels() {
+    if (const AESHardwareKernels* arm = aesArmCryptoKernels()) {
+        if (cpuHasArmCrypto()) return arm;
+    }
+    if (const AESHardwareKernels* x86 = aesNiKernels()) {
+        if (cpuHasAesNi()) return x86;
+    }
+    return nullptr;
+}
+
+const AESHardwareKernels* AESHardware::kernels() {
+    static const AESHardwareKernels* detected = detectKernels();
+    return g_hardwareEnabled.load(std::memory_order_relaxed) ? detected : nullptr;
+}
+
+bool AESHardware::isAvailable() {
+    return kernels() != nullptr;
+}
+
+const char* AESHardware::backendName() {
+    const AESHardwareKernels* k = kernels();
+    return k ? k->name : "none";
+}
+
+void AESHardware::setEnabled(bool enabled) {
+    g_hardwareEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void AESHardware::encryptBlocks(const uint32_t* roundKeys, const uint8_t* in, uint8_t* out, size_t blocks) {
+    kernels()->encryptBlocks(roundKeys, in, out, blocks);
+}
+
@@ -0,0 +1,47 @@
+#ifndef AESHARDWARE_H
+#define AESHARDWARE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Kernel table exported by an ISA-specific AES backend
+ *
+ * All kernels take the standard AES-256 encryption key schedule as produced
+ * by SimpleAES::keyExpansion (60 big-endian words). Only GCM runs here: the
+ * legacy CBC path uses the pre-FIPS rounds of older builds, which no AES
+ * instruction computes.
+ */
+struct AESHardwareKernels {
+    const char* name;
+    void (*encryptBlocks)(const uint32_t* roundKeys, const uint8_t* in, uint8_t* out, size_t blocks);
+};
+
+// Defined in AESHardwareArm.cpp / AESHardwareX86.cpp; return nullptr when the
+// translation unit was built without the matching instruction set flags
+const AESHardwareKernels* aesArmCryptoKernels();
+const AESHardwareKernels* aesNiKernels();
+
+/**
+ * @brief Runtime dispatch to hardware AES (ARMv8 Crypto Extensions / AES-NI)
+ *
+ * The CPU is probed once (getauxval HWCAP_AES on arm64, cpuid on x86).
+ * Callers check isAvailable() and fall back to the portable round engine.
+ */
+class AESHardware {
+public:
+    static bool isAvailable();
+    static const char* backendName();
+
+    /**
+     * @brief Enable/disable hardware dispatch (for benchmarking the portable path)
+     */
+    static void setEnabled(bool enabled);
+
+    static void encryptBlocks(const uint32_t* roundKeys, const uint8_t* in, uint8_t* out, size_t blocks);
+
+private:
+    static const AESHardwareKernels* kernels();
+};
+
+#endif // AESHARDWARE_H
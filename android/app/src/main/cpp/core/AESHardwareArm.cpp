@@ -0,0 +1,72 @@
+#include "AESHardware.h"
+
+// Built with -march=armv8-a+crypto (see CMakeLists.txt). Only reached after
+// getauxval reports HWCAP_AES, so nothing here runs on CPUs without it.
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+
+#include <arm_neon.h>
+
+// Round keys are stored as big-endian words; reverse each 32-bit lane to get
+// the byte order AESE/AESD expect
+static inline uint8x16_t loadRoundKey(const uint32_t* rk) {
+    return vrev32q_u8(vreinterpretq_u8_u32(vld1q_u32(rk)));
+}
+
+static inline void loadEncryptKeys(const uint32_t* roundKeys, uint8x16_t k[15]) {
+    for (int i = 0; i < 15; i++) {
+        k[i] = loadRoundKey(roundKeys + 4 * i);
+    }
+}
+
+// AESE = AddRoundKey + SubBytes + ShiftRows, AESMC = MixColumns
+static inline uint8x16_t encryptOne(uint8x16_t b, const uint8x16_t k[15]) {
+    for (int i = 0; i < 13; i++) {
+        b = vaesmcq_u8(vaeseq_u8(b, k[i]));
+    }
+    b = vaeseq_u8(b, k[13]);
+    return veorq_u8(b, k[14]);
+}
+
+static void ceEncryptBlocks(const uint32_t* roundKeys, const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint8x16_t k[15];
+    loadEncryptKeys(roundKeys, k);
+
+    size_t i = 0;
+    // Four independent blocks in flight; AESE/AESMC pairs fuse on most cores
+    for (; i + 4 <= blocks; i += 4) {
+        uint8x16_t b0 = vld1q_u8(in + 16 * i);
+        uint8x16_t b1 = vld1q_u8(in + 16 * i + 16);
+        uint8x16_t b2 = vld1q_u8(in + 16 * i + 32);
+        uint8x16_t b3 = vld1q_u8(in + 16 * i + 48);
+        for (int r = 0; r < 13; r++) {
+            b0 = vaesmcq_u8(vaeseq_u8(b0, k[r]));
+            b1 = vaesmcq_u8(vaeseq_u8(b1, k[r]));
+            b2 = vaesmcq_u8(vaeseq_u8(b2, k[r]));
+            b3 = vaesmcq_u8(vaeseq_u8(b3, k[r]));
+        }
+        vst1q_u8(out + 16 * i, veorq_u8(vaeseq_u8(b0, k[13]), k[14]));
+        vst1q_u8(out + 16 * i + 16, veorq_u8(vaeseq_u8(b1, k[13]), k[14]));
+        vst1q_u8(out + 16 * i + 32, veorq_u8(vaeseq_u8(b2, k[13]), k[14]));
+        vst1q_u8(out + 16 * i + 48, veorq_u8(vaeseq_u8(b3, k[13]), k[14]));
+    }
+    for (; i < blocks; i++) {
+        vst1q_u8(out + 16 * i, encryptOne(vld1q_u8(in + 16 * i), k));
+    }
+}
+
+static const AESHardwareKernels kArmCryptoKernels = {
+    "ARMv8-CE",
+    ceEncryptBlocks,
+};
+
+const AESHardwareKernels* aesArmCryptoKernels() {
+    return &kArmCryptoKernels;
+}
+
+#else
+
+const AESHardwareKernels* aesArmCryptoKernels() {
+    return nullptr;
+}
+
+#endif
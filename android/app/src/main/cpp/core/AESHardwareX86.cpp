@@ -0,0 +1,75 @@
+#include "AESHardware.h"
+
+// Built with -maes -mssse3 (see CMakeLists.txt). Only reached after cpuid
+// reports AES-NI, so nothing here runs on CPUs without it.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__AES__) && defined(__SSSE3__)
+
+#include <immintrin.h>
+
+// Round keys are stored as big-endian words; reverse each 32-bit lane to get
+// the byte order the AES instructions expect
+static inline __m128i loadRoundKey(const uint32_t* rk) {
+    const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rk)), swap);
+}
+
+static inline void loadEncryptKeys(const uint32_t* roundKeys, __m128i k[15]) {
+    for (int i = 0; i < 15; i++) {
+        k[i] = loadRoundKey(roundKeys + 4 * i);
+    }
+}
+
+static inline __m128i encryptOne(__m128i b, const __m128i k[15]) {
+    b = _mm_xor_si128(b, k[0]);
+    for (int i = 1; i < 14; i++) {
+        b = _mm_aesenc_si128(b, k[i]);
+    }
+    return _mm_aesenclast_si128(b, k[14]);
+}
+
+static void niEncryptBlocks(const uint32_t* roundKeys, const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i k[15];
+    loadEncryptKeys(roundKeys, k);
+
+    size_t i = 0;
+    // Four independent blocks in flight to cover AESENC latency
+    for (; i + 4 <= blocks; i += 4) {
+        const __m128i* src = reinterpret_cast<const __m128i*>(in + 16 * i);
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + 1), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + 2), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + 3), k[0]);
+        for (int r = 1; r < 14; r++) {
+            b0 = _mm_aesenc_si128(b0, k[r]);
+            b1 = _mm_aesenc_si128(b1, k[r]);
+            b2 = _mm_aesenc_si128(b2, k[r]);
+            b3 = _mm_aesenc_si128(b3, k[r]);
+        }
+        __m128i* dst = reinterpret_cast<__m128i*>(out + 16 * i);
+        _mm_storeu_si128(dst, _mm_aesenclast_si128(b0, k[14]));
+        _mm_storeu_si128(dst + 1, _mm_aesenclast_si128(b1, k[14]));
+        _mm_storeu_si128(dst + 2, _mm_aesenclast_si128(b2, k[14]));
+        _mm_storeu_si128(dst + 3, _mm_aesenclast_si128(b3, k[14]));
+    }
+    for (; i < blocks; i++) {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * i), encryptOne(b, k));
+    }
+}
+
+static const AESHardwareKernels kAesNiKernels = {
+    "AES-NI",
+    niEncryptBlocks,
+};
+
+const AESHardwareKernels* aesNiKernels() {
+    return &kAesNiKernels;
+}
+
+#else
+
+const AESHardwareKernels* aesNiKernels() {
+    return nullptr;
+}
+
+#endif
@@ -1,9 +1,49 @@
 #include "AuthManager.h"
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <regex>
 #include <chrono>
 #include <random>
 
+namespace {
+
+// Constant character tables: no locale, no signed-char pitfalls, and no
+// std::regex to compile on every keystroke of the login form
+enum CharBits : uint8_t {
+    UPPER = 1 << 0,
+    LOWER = 1 << 1,
+    DIGIT = 1 << 2,
+    SPECIAL = 1 << 3,
+    EMAIL_LOCAL = 1 << 4,     // [A-Za-z0-9._%+-]
+    EMAIL_DOMAIN = 1 << 5,    // [A-Za-z0-9.-]
+};
+
+constexpr std::array<uint8_t, 256> makeCharTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        uint8_t bits = 0;
+        if (c >= 'A' && c <= 'Z') bits = UPPER | EMAIL_LOCAL | EMAIL_DOMAIN;
+        else if (c >= 'a' && c <= 'z') bits = LOWER | EMAIL_LOCAL | EMAIL_DOMAIN;
+        else if (c >= '0' && c <= '9') bits = DIGIT | EMAIL_LOCAL | EMAIL_DOMAIN;
+        else bits = SPECIAL;
+        if (c == '.' || c == '-') bits |= EMAIL_LOCAL | EMAIL_DOMAIN;
+        if (c == '_' || c == '%' || c == '+') bits |= EMAIL_LOCAL;
+        table[c] = bits;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> CHAR_BITS = makeCharTable();
+
+// Number of character types in a mask of UPPER | LOWER | DIGIT | SPECIAL
+constexpr uint8_t TYPE_COUNT[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+inline uint8_t bitsOf(char c) {
+    return CHAR_BITS[static_cast<uint8_t>(c)];
+}
+
+} // namespace
+
 AuthManager::AuthManager()
         : currentUserEmail(""), currentUserId(""), isAuthenticated(false) {
 }
@@ -93,24 +133,36 @@ bool AuthManager::validatePasswordStrength(const std::string& password) {
         return false;
     }
 
-    bool hasUpper = false, hasLower = false, hasDigit = false, hasSpecial = false;
-
+    // Require at least 3 out of 4 character types
+    uint8_t seen = 0;
     for (char c : password) {
-        if (std::isupper(c)) hasUpper = true;
-        else if (std::islower(c)) hasLower = true;
-        else if (std::isdigit(c)) hasDigit = true;
-        else if (!std::isalnum(c)) hasSpecial = true;
+        seen |= bitsOf(c) & (UPPER | LOWER | DIGIT | SPECIAL);
+        if (TYPE_COUNT[seen] >= 3) return true;
     }
-
-    // Require at least 3 out of 4 character types
-    int typeCount = (hasUpper ? 1 : 0) + (hasLower ? 1 : 0) + (hasDigit ? 1 : 0) + (hasSpecial ? 1 : 0);
-    return typeCount >= 3;
+    return false;
 }
 
 bool AuthManager::isEmailValid(const std::string& email) {
-    // Simple email validation regex
-    std::regex emailPattern(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
-    return std::regex_match(email, emailPattern);
+    // Same language as the former regex [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}:
+    // a local part, one '@', and a domain ending in a dot and two or more
+    // letters with something before that dot
+    const size_t n = email.size();
+    size_t i = 0;
+    while (i < n && (bitsOf(email[i]) & EMAIL_LOCAL)) ++i;
+    if (i == 0 || i == n || email[i] != '@') return false;
+
+    const size_t domain = ++i;
+    size_t lastDot = n;
+    for (; i < n; ++i) {
+        if (!(bitsOf(email[i]) & EMAIL_DOMAIN)) return false;
+        if (email[i] == '.') lastDot = i;
+    }
+    if (lastDot == n || lastDot == domain || n - lastDot - 1 < 2) return false;
+
+    for (i = lastDot + 1; i < n; ++i) {
+        if (!(bitsOf(email[i]) & (UPPER | LOWER))) return false;
+    }
+    return true;
 }
 
 std::string AuthManager::hashPassword(const std::string& password) {
@@ -0,0 +1,413 @@
+#include "BackupStream.h"
+#include "CipherContext.h"
+#include "RecordCompression.h"
+#include "SecureRandom.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+inline void storeLE(uint8_t* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline uint64_t loadLE(const uint8_t* p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= uint64_t(p[i]) << (8 * i);
+    return v;
+}
+
+constexpr uint8_t CHUNK_FINAL = 0x01;
+
+bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        const ssize_t n = ::write(fd, data, length);
+        if (n > 0) {
+            data += n;
+            length -= static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Bytes read before EOF (short only at EOF); -1 on error */
+ssize_t readFully(int fd, uint8_t* data, size_t length) {
+    size_t got = 0;
+    while (got < length) {
+        const ssize_t n = ::read(fd, data + got, length - got);
+        if (n > 0) {
+            got += static_cast<size_t>(n);
+        } else if (n == 0) {
+            break;
+        } else if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return static_cast<ssize_t>(got);
+}
+
+} // namespace
+
+constexpr char BackupStream::MAGIC[8];
+
+/**
+ * @brief Fixed-capacity FIFO between two pipeline stages
+ *
+ * push() blocks while full and pop() while empty. close() ends the stream
+ * after the queued items; abort() also drops them and fails every waiter.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    void abort() {
+        std::deque<T> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            dropped.swap(items);
+            notEmpty.notify_all();
+            notFull.notify_all();
+        }
+    }   // Dropped items are destroyed outside the lock
+
+private:
+    const size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+// ============================================================================
+// BackupWriter
+// ============================================================================
+
+/** @brief Plaintext of one chunk, header first; wiped on destruction */
+struct BackupWriter::Chunk {
+    std::string plain;
+    uint32_t rows = 0;
+
+    Chunk() : plain(BackupStream::CHUNK_HEADER_SIZE, '\0') {}
+    Chunk(Chunk&&) = default;
+    Chunk& operator=(Chunk&& other) {
+        secureWipe(&plain[0], plain.size());
+        plain = std::move(other.plain);
+        rows = other.rows;
+        return *this;
+    }
+    ~Chunk() { secureWipe(&plain[0], plain.size()); }
+
+    void seal(const uint8_t* id, uint64_t sequence, bool final, uint64_t total) {
+        uint8_t* header = reinterpret_cast<uint8_t*>(&plain[0]);
+        std::memcpy(header, id, BackupStream::ID_SIZE);
+        storeLE(header + 16, sequence, 8);
+        header[24] = final ? CHUNK_FINAL : 0;
+        storeLE(header + 25, rows, 4);
+        storeLE(header + 29, final ? total : 0, 8);
+    }
+};
+
+BackupWriter::BackupWriter(int fd, std::shared_ptr<const CipherContext> keys, uint64_t expectedRows,
+                           const BackupStreamOptions& options)
+    : fd(fd), keys(std::move(keys)), expectedRows(expectedRows), options(options),
+      rows(new BoundedQueue<std::vector<PasswordEntry>>(options.queueDepth)),
+      chunks(new BoundedQueue<Chunk>(options.queueDepth)) {
+    if (!this->keys) {
+        throw std::invalid_argument("BackupWriter requires encryption keys");
+    }
+    SecureRandom::systemEntropy(backupId.data(), backupId.size());
+    batch.reserve(options.rowsPerBatch);
+    serializer = std::thread(&BackupWriter::serializeLoop, this);
+    writer = std::thread(&BackupWriter::writeLoop, this);
+}
+
+BackupWriter::~BackupWriter() {
+    if (!finished) {
+        failed.store(true);
+        stop();
+    }
+    if (serializer.joinable()) serializer.join();
+    if (writer.joinable()) writer.join();
+}
+
+void BackupWriter::stop() {
+    rows->abort();
+    chunks->abort();
+}
+
+void BackupWriter::fail(const char* stage, const char* reason) {
+    if (!failed.exchange(true)) {
+        std::cerr << "Backup " << stage << " failed: " << reason << std::endl;
+    }
+    stop();
+}
+
+bool BackupWriter::add(PasswordEntry entry) {
+    if (finished || failed.load(std::memory_order_relaxed)) return false;
+
+    batch.push_back(std::move(entry));
+    ++rowsAdded;
+    if (batch.size() >= options.rowsPerBatch) {
+        std::vector<PasswordEntry> full;
+        full.reserve(options.rowsPerBatch);
+        full.swap(batch);
+        if (!rows->push(std::move(full))) return false;
+    }
+    return !failed.load(std::memory_order_relaxed);
+}
+
+bool BackupWriter::finish() {
+    if (finished) return !failed.load();
+    finished = true;
+
+    if (!batch.empty() && !failed.load()) rows->push(std::move(batch));
+    batch.clear();
+    rows->close();
+    serializer.join();
+    writer.join();
+
+    if (!failed.load() && rowsAdded != expectedRows) {
+        fail("finish", "row count changed while the backup was written");
+    }
+    return !failed.load();
+}
+
+void BackupWriter::serializeLoop() {
+    try {
+        uint64_t sequence = 0;
+        uint64_t total = 0;
+        Chunk chunk;
+        std::vector<PasswordEntry> in;
+
+        while (rows->pop(in)) {
+            for (const PasswordEntry& entry : in) {
+                entry.appendBinary(chunk.plain);
+                ++chunk.rows;
+                ++total;
+                if (chunk.plain.size() >= options.chunkSize) {
+                    chunk.seal(backupId.data(), sequence++, false, 0);
+                    if (!chunks->push(std::move(chunk))) return;
+                    chunk = Chunk();
+                }
+            }
+            in.clear();   // Entries hold plaintext; drop them before blocking again
+        }
+        if (failed.load()) return;
+
+        chunk.seal(backupId.data(), sequence, true, total);
+        if (chunks->push(std::move(chunk))) chunks->close();
+    } catch (const std::exception& e) {
+        fail("serializer", e.what());
+    }
+}
+
+void BackupWriter::writeLoop() {
+    try {
+        uint8_t header[BackupStream::HEADER_SIZE] = {0};
+        std::memcpy(header, BackupStream::MAGIC, sizeof(BackupStream::MAGIC));
+        storeLE(header + 8, BackupStream::VERSION, 2);
+        storeLE(header + 16, expectedRows, 8);
+        std::memcpy(header + 24, backupId.data(), BackupStream::ID_SIZE);
+        if (!writeAll(fd, header, sizeof(header))) {
+            fail("writer", std::strerror(errno));
+            return;
+        }
+
+        uint8_t lengthBytes[4];
+        Chunk chunk;
+        while (chunks->pop(chunk)) {
+            const std::string record = RecordCompression::seal(*keys, reinterpret_cast<const uint8_t*>(chunk.plain.data()),
+                                                               chunk.plain.size(), RecordCompression::Dictionary::NONE);
+            chunk = Chunk();   // Wipe the plaintext before the write blocks
+            storeLE(lengthBytes, record.size(), 4);
+            if (!writeAll(fd, lengthBytes, sizeof(lengthBytes)) ||
+                !writeAll(fd, reinterpret_cast<const uint8_t*>(record.data()), record.size())) {
+                fail("writer", std::strerror(errno));
+                return;
+            }
+        }
+    } catch (const std::exception& e) {
+        fail("writer", e.what());
+    }
+}
+
+// ============================================================================
+// BackupReader
+// ============================================================================
+
+struct BackupReader::Item {
+    enum class Kind { ROWS, END, ERROR } kind = Kind::ERROR;
+    std::vector<PasswordEntry> rows;
+};
+
+BackupReader::BackupReader(int fd, std::shared_ptr<const CipherContext> keys, const BackupStreamOptions& options)
+    : fd(fd), keys(std::move(keys)), items(new BoundedQueue<Item>(options.queueDepth)) {
+    if (!this->keys) {
+        std::cerr << "Restore failed: encryption keys are not loaded" << std::endl;
+        return;
+    }
+
+    uint8_t header[BackupStream::HEADER_SIZE];
+    if (readFully(fd, header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header, BackupStream::MAGIC, sizeof(BackupStream::MAGIC)) != 0) {
+        std::cerr << "Restore failed: not an encrypted backup" << std::endl;
+        return;
+    }
+    if (loadLE(header + 8, 2) != BackupStream::VERSION || loadLE(header + 10, 2) != 0) {
+        std::cerr << "Restore failed: unsupported backup version" << std::endl;
+        return;
+    }
+    headerRows = loadLE(header + 16, 8);
+    std::memcpy(backupId.data(), header + 24, BackupStream::ID_SIZE);
+
+    valid = true;
+    reader = std::thread(&BackupReader::readLoop, this);
+}
+
+BackupReader::~BackupReader() {
+    items->abort();
+    if (reader.joinable()) reader.join();
+}
+
+bool BackupReader::next(std::vector<PasswordEntry>& rows) {
+    rows.clear();
+    if (!valid) return false;
+    if (done) return true;
+
+    Item item;
+    if (!items->pop(item) || item.kind == Item::Kind::ERROR) {
+        valid = false;
+        return false;
+    }
+    if (item.kind == Item::Kind::END) {
+        done = true;
+        return true;
+    }
+    rows = std::move(item.rows);
+    return true;
+}
+
+void BackupReader::readLoop() {
+    auto failWith = [this](const char* reason) {
+        std::cerr << "Restore failed: " << reason << std::endl;
+        items->push(Item());   // ERROR
+        items->close();
+    };
+
+    uint64_t sequence = 0;
+    uint64_t total = 0;
+    std::string record;
+    std::string plain;
+    for (;;) {
+        uint8_t lengthBytes[4];
+        const ssize_t got = readFully(fd, lengthBytes, sizeof(lengthBytes));
+        if (got != static_cast<ssize_t>(sizeof(lengthBytes))) {
+            return failWith(got < 0 ? std::strerror(errno) : "backup is truncated");
+        }
+        const size_t length = static_cast<size_t>(loadLE(lengthBytes, 4));
+        if (length <= SimpleAES::RECORD_OVERHEAD || length > BackupStream::MAX_FRAME) {
+            return failWith("invalid chunk length");
+        }
+
+        record.resize(length);
+        if (readFully(fd, reinterpret_cast<uint8_t*>(&record[0]), length) != static_cast<ssize_t>(length)) {
+            return failWith("backup is truncated");
+        }
+
+        try {
+            plain = RecordCompression::open(*keys, reinterpret_cast<const uint8_t*>(record.data()), length);
+        } catch (const std::exception&) {
+            return failWith("chunk failed authentication (wrong key or damaged backup)");
+        }
+        if (plain.size() < BackupStream::CHUNK_HEADER_SIZE) {
+            secureWipe(&plain[0], plain.size());
+            return failWith("malformed chunk");
+        }
+
+        const uint8_t* header = reinterpret_cast<const uint8_t*>(plain.data());
+        const uint8_t flags = header[24];
+        const uint32_t count = static_cast<uint32_t>(loadLE(header + 25, 4));
+        const bool final = (flags & CHUNK_FINAL) != 0;
+        if (std::memcmp(header, backupId.data(), BackupStream::ID_SIZE) != 0 ||
+            loadLE(header + 16, 8) != sequence || (flags & ~CHUNK_FINAL) != 0) {
+            secureWipe(&plain[0], plain.size());
+            return failWith("chunk out of sequence or from another backup");
+        }
+
+        Item item;
+        item.kind = Item::Kind::ROWS;
+        item.rows.reserve(count);
+        size_t offset = BackupStream::CHUNK_HEADER_SIZE;
+        for (uint32_t i = 0; i < count; ++i) {
+            std::optional<PasswordEntry> entry = PasswordEntry::readBinary(plain, offset);
+            if (!entry) break;
+            item.rows.push_back(std::move(*entry));
+        }
+        const bool parsed = item.rows.size() == count && offset == plain.size();
+        const uint64_t declaredTotal = loadLE(header + 29, 8);
+        secureWipe(&plain[0], plain.size());
+        if (!parsed) return failWith("malformed chunk");
+
+        total += count;
+        ++sequence;
+        if (final) {
+            uint8_t extra;
+            if (total != declaredTotal || total != headerRows) return failWith("row count mismatch");
+            if (readFully(fd, &extra, 1) != 0) return failWith("unexpected data after the final chunk");
+        }
+
+        if (!item.rows.empty() && !items->push(std::move(item))) return;   // Reader abandoned
+        if (final) {
+            Item end;
+            end.kind = Item::Kind::END;
+            if (items->push(std::move(end))) items->close();
+            return;
+        }
+    }
+}
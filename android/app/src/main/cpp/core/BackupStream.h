@@ -0,0 +1,158 @@
+#ifndef BACKUPSTREAM_H
+#define BACKUPSTREAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../models/PasswordEntry.h"
+
+class CipherContext;
+
+/** @brief Tuning shared by BackupWriter and BackupReader */
+struct BackupStreamOptions {
+    /** Plaintext bytes per chunk before it is sealed (a single larger entry gets its own chunk) */
+    size_t chunkSize = 256 * 1024;
+    /** Items each bounded queue between pipeline stages may hold */
+    size_t queueDepth = 2;
+    /** Entries handed from add() to the serializer at a time */
+    size_t rowsPerBatch = 128;
+};
+
+/**
+ * @brief Encrypted backup stream format
+ *
+ *   header  "SFBACKUP" | u16 version | u16 flags | u32 reserved |
+ *           u64 row count | 16-byte random backup id            (40 bytes)
+ *   frames  u32 length | raw SimpleAES GCM record, repeated
+ *
+ * Records are LZ4-compressed when that pays (see RecordCompression; the
+ * record header says which). Each record opens to a chunk: the backup id, u64 sequence number,
+ * u8 flags (bit 0: final chunk), u32 rows, u64 total rows (final chunk
+ * only), then that many PasswordEntry::appendBinary entries. Every chunk is
+ * authenticated on its own. The id and sequence number catch chunks that
+ * are reordered or spliced in from another backup. A stream without a
+ * final chunk, with a row count that disagrees with the header, or with
+ * bytes after the final chunk is rejected. All integers are little-endian.
+ */
+class BackupStream {
+public:
+    static constexpr char MAGIC[8] = {'S', 'F', 'B', 'A', 'C', 'K', 'U', 'P'};
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 40;
+    static constexpr size_t ID_SIZE = 16;
+    static constexpr size_t CHUNK_HEADER_SIZE = ID_SIZE + 8 + 1 + 4 + 8;
+    /** Frames above this are refused before anything is allocated */
+    static constexpr size_t MAX_FRAME = 64u * 1024 * 1024;
+};
+
+template <typename T> class BoundedQueue;
+
+/**
+ * @brief Three-stage pipelined backup to a file descriptor
+ *
+ * The caller's thread reads rows and feeds add(). A serializer thread packs
+ * rows into chunks, and a writer thread encrypts each chunk and writes it
+ * to `fd`. The stages are joined by bounded queues, so a full queue blocks
+ * the stage before it. Memory stays at a few chunks whatever the vault
+ * size, and nothing is buffered whole. The descriptor can be a pipe or a
+ * socket: it is only ever written sequentially, and it is not closed. A
+ * closed pipe fails the backup with EPIPE as long as SIGPIPE is ignored,
+ * as it is in app processes.
+ */
+class BackupWriter {
+public:
+    /**
+     * @param keys         Chunks are sealed with the context's primary key
+     * @param expectedRows Stored in the header; finish() fails if add() saw a different count
+     */
+    BackupWriter(int fd, std::shared_ptr<const CipherContext> keys, uint64_t expectedRows,
+                 const BackupStreamOptions& options = BackupStreamOptions());
+    /** @brief Abandons an unfinished stream: the stages stop and the output is incomplete */
+    ~BackupWriter();
+
+    BackupWriter(const BackupWriter&) = delete;
+    BackupWriter& operator=(const BackupWriter&) = delete;
+
+    /** @brief Queue one entry; false once the pipeline has failed. Blocks while the queues are full */
+    bool add(PasswordEntry entry);
+    /** @brief Seal the final chunk, wait for the stages and report overall success */
+    bool finish();
+
+private:
+    struct Chunk;
+
+    const int fd;
+    const std::shared_ptr<const CipherContext> keys;
+    const uint64_t expectedRows;
+    const BackupStreamOptions options;
+    std::array<uint8_t, BackupStream::ID_SIZE> backupId{};
+
+    std::vector<PasswordEntry> batch;
+    uint64_t rowsAdded = 0;
+    bool finished = false;
+    std::atomic<bool> failed{false};
+
+    std::unique_ptr<BoundedQueue<std::vector<PasswordEntry>>> rows;
+    std::unique_ptr<BoundedQueue<Chunk>> chunks;
+    std::thread serializer;
+    std::thread writer;
+
+    void serializeLoop();
+    void writeLoop();
+    void fail(const char* stage, const char* reason);
+    void stop();
+};
+
+/**
+ * @brief Verified, chunk-at-a-time restore from a file descriptor
+ *
+ * A reader thread reads, decrypts and parses the next chunks while the
+ * caller applies the current one. next() hands out one verified chunk per
+ * call. Rows are only known to be complete once next() has reported the
+ * end, so appliers should stage everything (e.g. in one transaction) and
+ * keep it only then.
+ */
+class BackupReader {
+public:
+    BackupReader(int fd, std::shared_ptr<const CipherContext> keys,
+                 const BackupStreamOptions& options = BackupStreamOptions());
+    ~BackupReader();
+
+    BackupReader(const BackupReader&) = delete;
+    BackupReader& operator=(const BackupReader&) = delete;
+
+    /** @brief Header was readable and of a supported version */
+    bool isValid() const { return valid; }
+    /** @brief Row count from the header, confirmed by the final chunk before next() reports the end */
+    uint64_t expectedRows() const { return headerRows; }
+
+    /**
+     * @brief Rows of the next verified chunk
+     * @return true with rows, true with `rows` empty at the verified end
+     *         of the stream, false if the stream is damaged, truncated or
+     *         under another key (a message has been logged)
+     */
+    bool next(std::vector<PasswordEntry>& rows);
+
+private:
+    struct Item;
+
+    const int fd;
+    const std::shared_ptr<const CipherContext> keys;
+    std::array<uint8_t, BackupStream::ID_SIZE> backupId{};
+    uint64_t headerRows = 0;
+    bool valid = false;
+    bool done = false;
+
+    std::unique_ptr<BoundedQueue<Item>> items;
+    std::thread reader;
+
+    void readLoop();
+};
+
+#endif // BACKUPSTREAM_H
@@ -0,0 +1,163 @@
+#include "Base64.h"
+#include <array>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+static constexpr char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+static constexpr std::array<int8_t, 256> makeDecodeTable() {
+    std::array<int8_t, 256> table{};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = -1;
+    }
+    for (int i = 0; i < 64; i++) {
+        table[static_cast<uint8_t>(kAlphabet[i])] = static_cast<int8_t>(i);
+    }
+    return table;
+}
+
+static constexpr std::array<int8_t, 256> kDecode = makeDecodeTable();
+
+static bool cpuHasSsse3() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & (1u << 9)) != 0;
+#else
+    return false;
+#endif
+}
+
+static const Base64Kernels* detectKernels() {
+    // NEON is mandatory on arm64, so no runtime probe is needed there
+    if (const Base64Kernels* neon = base64NeonKernels()) return neon;
+    if (const Base64Kernels* x86 = base64Ssse3Kernels()) {
+        if (cpuHasSsse3()) return x86;
+    }
+    return nullptr;
+}
+
+static const Base64Kernels* kernels() {
+    static const Base64Kernels* detected = detectKernels();
+    return detected;
+}
+
+const char* Base64::backendName() {
+    const Base64Kernels* k = kernels();
+    return k ? k->name : "scalar";
+}
+
+size_t Base64::encode(const uint8_t* data, size_t length, char* out) {
+    size_t i = 0;
+    size_t o = 0;
+
+    if (const Base64Kernels* k = kernels()) {
+        i = k->encodeBlocks(data, length, out);
+        o = (i / 3) * 4;
+    }
+
+    // Each group of 3 input bytes is read before its 4 output chars are
+    // written, which keeps encoding over the tail of `out` safe
+    while (i + 3 <= length) {
+        uint32_t v = (static_cast<uint32_t>(data[i]) << 16) |
+                     (static_cast<uint32_t>(data[i + 1]) << 8) |
+                     static_cast<uint32_t>(data[i + 2]);
+        i += 3;
+        out[o++] = kAlphabet[(v >> 18) & 0x3F];
+        out[o++] = kAlphabet[(v >> 12) & 0x3F];
+        out[o++] = kAlphabet[(v >> 6) & 0x3F];
+        out[o++] = kAlphabet[v & 0x3F];
+    }
+
+    size_t rest = length - i;
+    if (rest > 0) {
+        uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+        if (rest == 2) v |= static_cast<uint32_t>(data[i + 1]) << 8;
+        out[o++] = kAlphabet[(v >> 18) & 0x3F];
+        out[o++] = kAlphabet[(v >> 12) & 0x3F];
+        out[o++] = rest == 2 ? kAlphabet[(v >> 6) & 0x3F] : '=';
+        out[o++] = '=';
+    }
+
+    return o;
+}
+
+static inline int32_t decodeQuad(const char* in) {
+    int32_t a = kDecode[static_cast<uint8_t>(in[0])];
+    int32_t b = kDecode[static_cast<uint8_t>(in[1])];
+    int32_t c = kDecode[static_cast<uint8_t>(in[2])];
+    int32_t d = kDecode[static_cast<uint8_t>(in[3])];
+    if ((a | b | c | d) < 0) {
+        return -1;
+    }
+    return (a << 18) | (b << 12) | (c << 6) | d;
+}
+
+size_t Base64::decode(const char* text, size_t length, uint8_t* out) {
+    if (length == 0) {
+        return 0;
+    }
+    if (length % 4 != 0) {
+        throw std::invalid_argument("base64: length is not a multiple of 4");
+    }
+
+    // Everything before the final quad is padding-free
+    const size_t body = length - 4;
+    size_t i = 0;
+    size_t o = 0;
+
+    if (const Base64Kernels* k = kernels()) {
+        i = k->decodeBlocks(text, body, out);
+        o = (i / 4) * 3;
+    }
+
+    for (; i < body; i += 4) {
+        int32_t v = decodeQuad(text + i);
+        if (v < 0) {
+            throw std::invalid_argument("base64: invalid character");
+        }
+        out[o++] = static_cast<uint8_t>(v >> 16);
+        out[o++] = static_cast<uint8_t>(v >> 8);
+        out[o++] = static_cast<uint8_t>(v);
+    }
+
+    // Final quad: "xxxx", "xxx=" or "xx=="
+    const char* q = text + body;
+    int pad = q[3] == '=' ? (q[2] == '=' ? 2 : 1) : 0;
+    char last[4] = {q[0], q[1], pad == 2 ? 'A' : q[2], pad ? 'A' : q[3]};
+    int32_t v = decodeQuad(last);
+    if (v < 0) {
+        throw std::invalid_argument("base64: invalid character");
+    }
+    // Bits below the last encoded byte must be zero (canonical encoding)
+    if ((pad == 1 && (v & 0xFF) != 0) || (pad == 2 && (v & 0xFFFF) != 0)) {
+        throw std::invalid_argument("base64: non-canonical padding bits");
+    }
+
+    out[o++] = static_cast<uint8_t>(v >> 16);
+    if (pad < 2) out[o++] = static_cast<uint8_t>(v >> 8);
+    if (pad < 1) out[o++] = static_cast<uint8_t>(v);
+    return o;
+}
+
+std::string Base64::encode(const std::vector<uint8_t>& data) {
+    std::string out(encodedSize(data.size()), '\0');
+    if (!data.empty()) {
+        encode(data.data(), data.size(), &out[0]);
+    }
+    return out;
+}
+
+std::vector<uint8_t> Base64::decode(const std::string& text) {
+    std::vector<uint8_t> out(maxDecodedSize(text.size()));
+    out.resize(decode(text.data(), text.size(), out.data()));
+    return out;
+}
@@ -0,0 +1,66 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Kernel table exported by an ISA-specific base64 backend
+ *
+ * Kernels handle whole SIMD blocks only and return how much input they
+ * consumed; the scalar code finishes the tail. Decode kernels stop at the
+ * first block containing a character outside the alphabet and leave it to
+ * the scalar path to report.
+ */
+struct Base64Kernels {
+    const char* name;
+    // Returns input bytes consumed (multiple of 3); writes 4/3 as many chars
+    size_t (*encodeBlocks)(const uint8_t* in, size_t length, char* out);
+    // Returns input chars consumed (multiple of 4); writes 3/4 as many bytes
+    size_t (*decodeBlocks)(const char* in, size_t length, uint8_t* out);
+};
+
+// Defined in Base64Arm.cpp / Base64X86.cpp; return nullptr when the
+// translation unit was built without the matching instruction set flags
+const Base64Kernels* base64NeonKernels();
+const Base64Kernels* base64Ssse3Kernels();
+
+/**
+ * @brief Standard base64 (RFC 4648, padded) with NEON / SSSE3 kernels
+ *
+ * Decoding is strict: the length must be a multiple of 4, only the
+ * alphabet is accepted, '=' may appear only as 1-2 trailing characters,
+ * and the unused bits before padding must be zero. Anything else throws
+ * std::invalid_argument.
+ */
+class Base64 {
+public:
+    static constexpr size_t encodedSize(size_t length) { return ((length + 2) / 3) * 4; }
+    static constexpr size_t maxDecodedSize(size_t length) { return (length / 4) * 3; }
+
+    /**
+     * @brief Encode into out (exactly encodedSize(length) chars, no terminator)
+     *
+     * `data` may live in the tail of `out` (encode in place over the last
+     * `length` bytes of an encodedSize(length) buffer).
+     */
+    static size_t encode(const uint8_t* data, size_t length, char* out);
+
+    /**
+     * @brief Decode into out (at most maxDecodedSize(length) bytes)
+     * @return Number of bytes written
+     */
+    static size_t decode(const char* text, size_t length, uint8_t* out);
+
+    static std::string encode(const std::vector<uint8_t>& data);
+    static std::vector<uint8_t> decode(const std::string& text);
+
+    /**
+     * @brief Name of the backend in use ("NEON", "SSSE3" or "scalar")
+     */
+    static const char* backendName();
+};
+
+#endif // BASE64_H
@@ -0,0 +1,119 @@
+#include "Base64.h"
+
+// AdvSIMD is part of the arm64 baseline, so this needs no extra flags and
+// no runtime probe. 32-bit ARM builds use the scalar codec.
+#if defined(__aarch64__) && defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+static const uint8_t kEncodeTable[64] = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+// ASCII 0..127 -> 6-bit value, 0xFF for characters outside the alphabet
+static const uint8_t kDecodeTable[128] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255, 255,  63,
+     52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+    255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255, 255,
+    255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255
+};
+
+static size_t encodeBlocks(const uint8_t* in, size_t length, char* out) {
+    const uint8x16x4_t table = vld1q_u8_x4(kEncodeTable);
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    const uintptr_t inEnd = reinterpret_cast<uintptr_t>(in + length);
+    size_t i = 0;
+    size_t o = 0;
+
+    // 48 bytes -> 64 chars; vld3 de-interleaves the three bytes of each group
+    while (i + 48 <= length) {
+        // In-place encoding (input in the tail of out): the 64-char store
+        // must not reach input that is still unread
+        const uintptr_t storeBegin = reinterpret_cast<uintptr_t>(out + o);
+        if (storeBegin + 64 > reinterpret_cast<uintptr_t>(in + i + 48) && storeBegin < inEnd) {
+            break;
+        }
+
+        const uint8x16x3_t src = vld3q_u8(in + i);
+        uint8x16x4_t idx;
+        idx.val[0] = vshrq_n_u8(src.val[0], 2);
+        idx.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(src.val[0], 4), vshrq_n_u8(src.val[1], 4)), mask);
+        idx.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(src.val[1], 2), vshrq_n_u8(src.val[2], 6)), mask);
+        idx.val[3] = vandq_u8(src.val[2], mask);
+
+        uint8x16x4_t chars;
+        chars.val[0] = vqtbl4q_u8(table, idx.val[0]);
+        chars.val[1] = vqtbl4q_u8(table, idx.val[1]);
+        chars.val[2] = vqtbl4q_u8(table, idx.val[2]);
+        chars.val[3] = vqtbl4q_u8(table, idx.val[3]);
+        vst4q_u8(reinterpret_cast<uint8_t*>(out + o), chars);
+
+        i += 48;
+        o += 64;
+    }
+    return i;
+}
+
+// Table lookup over 0..127; out-of-range lanes come back with the high bit set
+static inline uint8x16_t lookup(uint8x16x4_t lo, uint8x16x4_t hi, uint8x16_t c) {
+    uint8x16_t v = vqtbl4q_u8(lo, c);                            // 0..63, else 0
+    v = vqtbx4q_u8(v, hi, vsubq_u8(c, vdupq_n_u8(64)));          // 64..127
+    return vorrq_u8(v, vandq_u8(c, vdupq_n_u8(0x80)));           // >= 128: invalid
+}
+
+static size_t decodeBlocks(const char* in, size_t length, uint8_t* out) {
+    const uint8x16x4_t lo = vld1q_u8_x4(kDecodeTable);
+    const uint8x16x4_t hi = vld1q_u8_x4(kDecodeTable + 64);
+    size_t i = 0;
+    size_t o = 0;
+
+    // 64 chars -> 48 bytes; vld4 de-interleaves the four chars of each quad
+    while (i + 64 <= length) {
+        const uint8x16x4_t src = vld4q_u8(reinterpret_cast<const uint8_t*>(in + i));
+        const uint8x16_t a = lookup(lo, hi, src.val[0]);
+        const uint8x16_t b = lookup(lo, hi, src.val[1]);
+        const uint8x16_t c = lookup(lo, hi, src.val[2]);
+        const uint8x16_t d = lookup(lo, hi, src.val[3]);
+
+        // Valid values are < 64, so any high bit marks a bad character
+        const uint8x16_t any = vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d));
+        if (vmaxvq_u8(any) >= 64) {
+            break;   // Let the scalar path report it
+        }
+
+        uint8x16x3_t dst;
+        dst.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        dst.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        dst.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(out + o, dst);
+
+        i += 64;
+        o += 48;
+    }
+    return i;
+}
+
+static const Base64Kernels kNeonKernels = {
+    "NEON",
+    encodeBlocks,
+    decodeBlocks
+};
+
+const Base64Kernels* base64NeonKernels() {
+    return &kNeonKernels;
+}
+
+#else
+
+const Base64Kernels* base64NeonKernels() {
+    return nullptr;
+}
+
+#endif
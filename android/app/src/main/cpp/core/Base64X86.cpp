@@ -0,0 +1,113 @@
+#include "Base64.h"
+
+// Built with -mssse3 (see CMakeLists.txt). Only reached after cpuid reports
+// SSSE3. Kernels follow Muła & Lemire, "Faster Base64 Encoding and Decoding
+// using AVX2 Instructions" (SSE variants).
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSSE3__)
+
+#include <tmmintrin.h>
+#include <cstring>
+
+// 16 six-bit indices -> ASCII, using one shuffle on a range-offset table
+static inline __m128i indicesToAscii(__m128i indices) {
+    const __m128i shiftLut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftLut, range), indices);
+}
+
+static size_t encodeBlocks(const uint8_t* in, size_t length, char* out) {
+    const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const uintptr_t inEnd = reinterpret_cast<uintptr_t>(in + length);
+    size_t i = 0;
+    size_t o = 0;
+
+    // Loads 16 bytes, consumes 12
+    while (i + 16 <= length) {
+        // In-place encoding (input in the tail of out): the 16-char store
+        // must not reach input that is still unread
+        const uintptr_t storeBegin = reinterpret_cast<uintptr_t>(out + o);
+        if (storeBegin + 16 > reinterpret_cast<uintptr_t>(in + i + 12) && storeBegin < inEnd) {
+            break;
+        }
+
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        v = _mm_shuffle_epi8(v, shuffle);
+
+        // Split each 24-bit group into four 6-bit fields, one per byte
+        const __m128i t0 = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), indicesToAscii(_mm_or_si128(t1, t3)));
+        i += 12;
+        o += 16;
+    }
+    return i;
+}
+
+static size_t decodeBlocks(const char* in, size_t length, uint8_t* out) {
+    // Nibble-class tables: a char is valid iff lutLo[lo] & lutHi[hi] == 0
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+
+    size_t i = 0;
+    size_t o = 0;
+
+    while (i + 16 <= length) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi32(v, 4), nibble);
+        const __m128i lo = _mm_and_si128(v, nibble);
+
+        const __m128i bad = _mm_and_si128(_mm_shuffle_epi8(lutLo, lo), _mm_shuffle_epi8(lutHi, hi));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128())) != 0xFFFF) {
+            break;   // Let the scalar path report it
+        }
+
+        // ASCII -> 6-bit values ('/' shares a high nibble with '+')
+        const __m128i eq2F = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x2F));
+        const __m128i values = _mm_add_epi8(v, _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hi)));
+
+        // Merge 4 x 6 bits -> 24 bits per lane, then gather the 12 bytes
+        const __m128i ab = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i abcd = _mm_madd_epi16(ab, _mm_set1_epi32(0x00011000));
+        const __m128i bytes = _mm_shuffle_epi8(abcd, pack);
+
+        // Exactly 12 bytes: the output buffer has no slack
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + o), bytes);
+        const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+        std::memcpy(out + o + 8, &tail, 4);
+
+        i += 16;
+        o += 12;
+    }
+    return i;
+}
+
+static const Base64Kernels kSsse3Kernels = {
+    "SSSE3",
+    encodeBlocks,
+    decodeBlocks
+};
+
+const Base64Kernels* base64Ssse3Kernels() {
+    return &kSsse3Kernels;
+}
+
+#else
+
+const Base64Kernels* base64Ssse3Kernels() {
+    return nullptr;
+}
+
+#endif
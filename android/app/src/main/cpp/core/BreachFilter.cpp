@@ -0,0 +1,554 @@
+#include "BreachFilter.h"
+#include "SHA256.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "BreachFilter reads fingerprints in place and needs a little-endian target"
+#endif
+
+namespace {
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+constexpr char MAGIC[8] = {'S', 'F', 'B', 'R', 'E', 'A', 'C', 'H'};
+constexpr size_t DIGEST_OFFSET = 48;
+constexpr size_t DIGEST_SIZE = 16;
+constexpr uint32_t MAX_SEGMENT_LENGTH = 1u << 18;
+constexpr int MAX_BUILD_ATTEMPTS = 100;
+// Keys per prefetch block in checkKeys: enough misses in flight to cover
+// DRAM latency, few enough that the addresses stay in registers/L1
+constexpr size_t LOOKUP_BLOCK = 16;
+
+inline void storeLE(uint8_t* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline uint64_t loadLE(const uint8_t* p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= uint64_t(p[i]) << (8 * i);
+    return v;
+}
+
+// ============================================================================
+// SHA-1, only for key derivation (breach corpora are published as SHA-1)
+// ============================================================================
+
+inline uint32_t rotl32(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+// 16-word rolling message schedule, as in the portable SHA-256 kernel
+void sha1Block(uint32_t state[5], const uint8_t* block) {
+    uint32_t w[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t wi;
+        if (i < 16) {
+            wi = w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                        (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+        } else {
+            wi = w[i & 15] = rotl32(w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w[i & 15], 1);
+        }
+        uint32_t f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);           k = 0x5a827999; }
+        else if (i < 40) { f = b ^ c ^ d;                    k = 0x6ed9eba1; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8f1bbcdc; }
+        else             { f = b ^ c ^ d;                    k = 0xca62c1d6; }
+        const uint32_t t = rotl32(a, 5) + f + e + k + wi;
+        e = d;
+        d = c;
+        c = rotl32(b, 30);
+        b = a;
+        a = t;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+    secureWipe(w, sizeof(w));
+}
+
+/** @brief First 64 bits of SHA-1(data), big-endian like the hex digest */
+uint64_t sha1Prefix64(const uint8_t* data, size_t length) {
+    uint32_t state[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+    size_t offset = 0;
+    for (; offset + 64 <= length; offset += 64) sha1Block(state, data + offset);
+
+    uint8_t tail[128] = {0};
+    const size_t rest = length - offset;
+    std::memcpy(tail, data + offset, rest);
+    tail[rest] = 0x80;
+    const size_t tailLength = rest + 9 <= 64 ? 64 : 128;
+    const uint64_t bits = uint64_t(length) * 8;
+    for (int i = 0; i < 8; ++i) tail[tailLength - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    sha1Block(state, tail);
+    if (tailLength == 128) sha1Block(state, tail + 64);
+    secureWipe(tail, tailLength);
+
+    const uint64_t prefix = (uint64_t(state[0]) << 32) | state[1];
+    secureWipe(state, sizeof(state));
+    return prefix;
+}
+
+// ============================================================================
+// Binary fuse filter (Graf & Lemire, 2022), arity 3, 16-bit fingerprints
+// ============================================================================
+
+inline uint64_t murmur64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t mulhi64(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+    // 32-bit ABIs (armeabi-v7a, x86)
+    const uint64_t aLo = a & 0xffffffffu, aHi = a >> 32;
+    const uint64_t bLo = b & 0xffffffffu, bHi = b >> 32;
+    const uint64_t mid1 = aHi * bLo;
+    const uint64_t mid2 = aLo * bHi;
+    const uint64_t carry = ((aLo * bLo) >> 32) + (mid1 & 0xffffffffu) + (mid2 & 0xffffffffu);
+    return aHi * bHi + (mid1 >> 32) + (mid2 >> 32) + (carry >> 32);
+#endif
+}
+
+inline uint16_t fingerprintOf(uint64_t hash) {
+    return static_cast<uint16_t>(hash ^ (hash >> 32));
+}
+
+/** @brief Segment layout of one filter; three slots per key, one per segment */
+struct Geometry {
+    uint64_t seed = 0;
+    uint32_t segmentLength = 0;
+    uint32_t segmentLengthMask = 0;
+    uint32_t segmentCount = 0;
+    uint32_t segmentCountLength = 0;
+    uint32_t arrayLength = 0;
+
+    inline void slots(uint64_t hash, uint32_t out[3]) const {
+        const uint32_t h0 = static_cast<uint32_t>(mulhi64(hash, segmentCountLength));
+        out[0] = h0;
+        out[1] = (h0 + segmentLength) ^ (static_cast<uint32_t>(hash >> 18) & segmentLengthMask);
+        out[2] = (h0 + 2 * segmentLength) ^ (static_cast<uint32_t>(hash) & segmentLengthMask);
+    }
+
+    /** @brief Sizing from the reference implementation for arity 3 */
+    static Geometry forSize(uint32_t size) {
+        Geometry g;
+        g.segmentLength = size == 0 ? 4
+            : 1u << static_cast<int>(std::floor(std::log(double(size)) / std::log(3.33) + 2.25));
+        g.segmentLength = std::min(g.segmentLength, MAX_SEGMENT_LENGTH);
+        g.segmentLengthMask = g.segmentLength - 1;
+
+        const double sizeFactor = size <= 1 ? 0.0
+            : std::max(1.125, 0.875 + 0.25 * std::log(1000000.0) / std::log(double(size)));
+        const uint32_t capacity = size <= 1 ? 0 : static_cast<uint32_t>(std::round(double(size) * sizeFactor));
+        const uint32_t segments = (capacity + g.segmentLength - 1) / g.segmentLength;
+        g.segmentCount = segments > 3 ? segments - 2 : 1;
+        g.arrayLength = (g.segmentCount + 2) * g.segmentLength;
+        g.segmentCountLength = g.segmentCount * g.segmentLength;
+        return g;
+    }
+};
+
+/**
+ * @brief Fingerprint array for unique keys (sorted by the caller)
+ *
+ * Peels the 3-hypergraph: slots touched by a single key are removed
+ * repeatedly, then fingerprints are assigned in reverse peeling order. A
+ * failed peel (probability well below 1% per seed) retries with the next
+ * seed.
+ */
+bool populate(const std::vector<uint64_t>& keys, Geometry& g, std::vector<uint16_t>& fingerprints) {
+    const size_t size = keys.size();
+    const uint32_t capacity = g.arrayLength;
+    std::vector<uint64_t> hashes(size);
+    std::vector<uint64_t> xorHash(capacity);
+    std::vector<uint8_t> counts(capacity);   // Keys in slot << 2 | xor of their slot positions
+    std::vector<uint32_t> alone(capacity);
+    std::vector<uint64_t> stack(size);
+    std::vector<uint8_t> stackSlot(size);
+
+    uint64_t rng = 0x726b2b9d438b9d4dULL;
+    for (int attempt = 0; attempt < MAX_BUILD_ATTEMPTS; ++attempt) {
+        g.seed = splitmix64(rng);
+        std::fill(xorHash.begin(), xorHash.end(), 0);
+        std::fill(counts.begin(), counts.end(), 0);
+
+        // Sorting by hash walks the slots in address order, which keeps
+        // construction of large shards cache-friendly
+        for (size_t i = 0; i < size; ++i) hashes[i] = murmur64(keys[i] + g.seed);
+        std::sort(hashes.begin(), hashes.end());
+
+        bool overflow = false;
+        for (uint64_t hash : hashes) {
+            uint32_t s[3];
+            g.slots(hash, s);
+            for (uint8_t j = 0; j < 3; ++j) {
+                counts[s[j]] = static_cast<uint8_t>((counts[s[j]] + 4) ^ j);
+                xorHash[s[j]] ^= hash;
+                overflow |= counts[s[j]] < 4;   // More than 63 keys in one slot
+            }
+        }
+        if (overflow) continue;
+
+        uint32_t queued = 0;
+        for (uint32_t i = 0; i < capacity; ++i) {
+            alone[queued] = i;
+            queued += (counts[i] >> 2) == 1 ? 1 : 0;
+        }
+        size_t peeled = 0;
+        while (queued > 0) {
+            const uint32_t index = alone[--queued];
+            if ((counts[index] >> 2) != 1) continue;
+            const uint64_t hash = xorHash[index];
+            const uint8_t found = counts[index] & 3;
+            stack[peeled] = hash;
+            stackSlot[peeled] = found;
+            ++peeled;
+
+            uint32_t s[3];
+            g.slots(hash, s);
+            for (uint8_t j = 0; j < 3; ++j) {
+                if (j == found) continue;
+                const uint32_t other = s[j];
+                alone[queued] = other;
+                queued += (counts[other] >> 2) == 2 ? 1 : 0;
+                counts[other] = static_cast<uint8_t>((counts[other] - 4) ^ j);
+                xorHash[other] ^= hash;
+            }
+            counts[index] = 0;
+        }
+        if (peeled != size) continue;
+
+        fingerprints.assign(capacity, 0);
+        for (size_t i = size; i-- > 0;) {
+            const uint64_t hash = stack[i];
+            uint32_t s[3];
+            g.slots(hash, s);
+            const uint8_t found = stackSlot[i];
+            fingerprints[s[found]] = static_cast<uint16_t>(
+                fingerprintOf(hash) ^ fingerprints[s[(found + 1) % 3]] ^ fingerprints[s[(found + 2) % 3]]);
+        }
+        return true;
+    }
+    return false;
+}
+
+void shardDigest(const uint8_t* header, const uint8_t* fingerprints, size_t length, uint8_t out[DIGEST_SIZE]) {
+    uint8_t zeroDigest[DIGEST_SIZE] = {0};
+    uint8_t digest[SHA256::DIGEST_SIZE];
+    SHA256 sha;
+    sha.update(header, DIGEST_OFFSET);
+    sha.update(zeroDigest, DIGEST_SIZE);
+    sha.update(fingerprints, length);
+    sha.finish(digest);
+    std::memcpy(out, digest, DIGEST_SIZE);
+}
+
+std::shared_ptr<BreachFilter> g_shared;
+
+} // namespace
+
+struct BreachFilter::Shard {
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    const uint16_t* fingerprints = nullptr;
+    Geometry geometry;
+    uint64_t generation = 0;
+
+    Shard() = default;
+    ~Shard() {
+        if (base) ::munmap(const_cast<uint8_t*>(base), size);
+    }
+    Shard(const Shard&) = delete;
+    Shard& operator=(const Shard&) = delete;
+
+    /** @brief Map and check a shard file; nullptr (with a message) if unusable */
+    static std::shared_ptr<const Shard> open(const std::string& path, uint32_t index, bool verifyDigest);
+};
+
+std::shared_ptr<const BreachFilter::Shard> BreachFilter::Shard::open(const std::string& path, uint32_t index,
+                                                                     bool verifyDigest) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // A shard that was never downloaded is expected, not an error
+        if (errno != ENOENT) std::cerr << "Cannot open breach shard " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < HEADER_SIZE) {
+        std::cerr << "Not a breach shard: " << path << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+
+    auto shard = std::make_shared<Shard>();
+    shard->size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, shard->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // The mapping keeps the file referenced
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Cannot map breach shard " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    shard->base = static_cast<const uint8_t*>(mapped);
+
+    const uint8_t* header = shard->base;
+    Geometry& g = shard->geometry;
+    g.seed = loadLE(header + 16, 8);
+    g.segmentLength = static_cast<uint32_t>(loadLE(header + 24, 4));
+    g.segmentLengthMask = g.segmentLength - 1;
+    g.segmentCount = static_cast<uint32_t>(loadLE(header + 28, 4));
+    g.segmentCountLength = g.segmentCount * g.segmentLength;
+    g.arrayLength = static_cast<uint32_t>(loadLE(header + 32, 4));
+    shard->generation = loadLE(header + 40, 8);
+
+    const bool shapeOk = std::memcmp(header, MAGIC, sizeof(MAGIC)) == 0 &&
+                         loadLE(header + 8, 2) == FORMAT_VERSION &&
+                         header[10] == SHARD_BITS &&
+                         loadLE(header + 12, 4) == index &&
+                         g.segmentLength >= 4 && g.segmentLength <= MAX_SEGMENT_LENGTH &&
+                         (g.segmentLength & g.segmentLengthMask) == 0 &&
+                         g.segmentCount >= 1 && g.segmentCount <= UINT32_MAX / g.segmentLength - 2 &&
+                         uint64_t(g.arrayLength) == uint64_t(g.segmentCount + 2) * g.segmentLength &&
+                         shard->size == HEADER_SIZE + uint64_t(g.arrayLength) * sizeof(uint16_t);
+    if (!shapeOk) {
+        std::cerr << "Unsupported or damaged breach shard: " << path << std::endl;
+        return nullptr;
+    }
+    shard->fingerprints = reinterpret_cast<const uint16_t*>(shard->base + HEADER_SIZE);
+
+    if (verifyDigest) {
+        uint8_t digest[DIGEST_SIZE];
+        shardDigest(header, shard->base + HEADER_SIZE, g.arrayLength * sizeof(uint16_t), digest);
+        if (std::memcmp(digest, header + DIGEST_OFFSET, DIGEST_SIZE) != 0) {
+            std::cerr << "Breach shard checksum mismatch: " << path << std::endl;
+            return nullptr;
+        }
+    }
+    // Lookups hit random pages; read-ahead would only inflate resident memory.
+    // After a digest pass, drop the pages it pulled in
+    ::madvise(mapped, shard->size, MADV_RANDOM);
+    if (verifyDigest) ::madvise(mapped, shard->size, MADV_DONTNEED);
+    return shard;
+}
+
+BreachFilter::BreachFilter(const std::string& directory) : directory(directory) {
+    for (std::atomic<uint8_t>& state : states) state.store(UNTRIED, std::memory_order_relaxed);
+}
+
+BreachFilter::~BreachFilter() = default;
+
+uint64_t BreachFilter::keyFor(std::string_view password) {
+    return sha1Prefix64(reinterpret_cast<const uint8_t*>(password.data()), password.size());
+}
+
+bool BreachFilter::parseHexKey(std::string_view hex, uint64_t& key) {
+    if (hex.size() < 16) return false;
+    uint64_t value = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        const char c = hex[i];
+        uint64_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else return false;
+        value = (value << 4) | nibble;
+    }
+    key = value;
+    return true;
+}
+
+std::string BreachFilter::shardFileName(uint32_t shard) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "breach-%02x.sfbf", shard);
+    return name;
+}
+
+std::string BreachFilter::shardPath(uint32_t index) const {
+    return directory + "/" + shardFileName(index);
+}
+
+std::shared_ptr<const BreachFilter::Shard> BreachFilter::shard(uint32_t index) const {
+    const uint8_t state = states[index].load(std::memory_order_acquire);
+    if (state == MAPPED) return std::atomic_load_explicit(&shards[index], std::memory_order_acquire);
+    if (state == MISSING) return nullptr;
+
+    std::lock_guard<std::mutex> lock(loadMutex);
+    if (states[index].load(std::memory_order_relaxed) == UNTRIED) {
+        // The digest is checked once, when a shard is installed
+        std::shared_ptr<const Shard> opened = Shard::open(shardPath(index), index, false);
+        std::atomic_store_explicit(&shards[index], opened, std::memory_order_release);
+        states[index].store(opened ? MAPPED : MISSING, std::memory_order_release);
+    }
+    return std::atomic_load_explicit(&shards[index], std::memory_order_acquire);
+}
+
+BreachFilter::Status BreachFilter::check(std::string_view password) const {
+    const uint64_t key = keyFor(password);
+    Status status;
+    checkKeys(&key, 1, &status);
+    return status;
+}
+
+void BreachFilter::check(const std::string_view* passwords, size_t count, Status* out) const {
+    std::vector<uint64_t> keys(count);
+    for (size_t i = 0; i < count; ++i) keys[i] = keyFor(passwords[i]);
+    checkKeys(keys.data(), count, out);
+    secureWipe(keys.data(), keys.size() * sizeof(uint64_t));
+}
+
+void BreachFilter::checkKeys(const uint64_t* keys, size_t count, Status* out) const {
+    // Shards resolved so far in this call; `held` keeps them mapped until it returns
+    std::array<const Shard*, SHARD_COUNT> resolved;
+    std::array<bool, SHARD_COUNT> isResolved{};
+    std::vector<std::shared_ptr<const Shard>> held;
+
+    const Shard* blockShards[LOOKUP_BLOCK];
+    uint64_t blockHashes[LOOKUP_BLOCK];
+    uint32_t blockSlots[LOOKUP_BLOCK][3];
+
+    for (size_t begin = 0; begin < count; begin += LOOKUP_BLOCK) {
+        const size_t n = std::min(LOOKUP_BLOCK, count - begin);
+
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t key = keys[begin + i];
+            const uint32_t index = shardOf(key);
+            if (!isResolved[index]) {
+                std::shared_ptr<const Shard> mapped = shard(index);
+                resolved[index] = mapped.get();
+                isResolved[index] = true;
+                if (mapped) held.push_back(std::move(mapped));
+            }
+            const Shard* s = resolved[index];
+            blockShards[i] = s;
+            if (!s) continue;
+            blockHashes[i] = murmur64(key + s->geometry.seed);
+            s->geometry.slots(blockHashes[i], blockSlots[i]);
+            for (uint32_t slot : blockSlots[i]) __builtin_prefetch(s->fingerprints + slot);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const Shard* s = blockShards[i];
+            if (!s) {
+                out[begin + i] = Status::UNKNOWN;
+                continue;
+            }
+            const uint16_t* f = s->fingerprints;
+            const uint32_t* slot = blockSlots[i];
+            const uint16_t x = static_cast<uint16_t>(fingerprintOf(blockHashes[i]) ^ f[slot[0]] ^ f[slot[1]] ^ f[slot[2]]);
+            out[begin + i] = x == 0 ? Status::BREACHED : Status::CLEAR;
+        }
+    }
+    secureWipe(blockHashes, sizeof(blockHashes));
+}
+
+std::vector<uint32_t> BreachFilter::requestedShards() const {
+    std::vector<uint32_t> requested;
+    for (uint32_t i = 0; i < SHARD_COUNT; ++i) {
+        if (states[i].load(std::memory_order_acquire) == MISSING) requested.push_back(i);
+    }
+    return requested;
+}
+
+uint64_t BreachFilter::shardGeneration(uint32_t index) const {
+    if (index >= SHARD_COUNT) return 0;
+    std::shared_ptr<const Shard> s = shard(index);
+    return s ? s->generation : 0;
+}
+
+bool BreachFilter::installShard(uint32_t index, const std::string& path) {
+    if (index >= SHARD_COUNT) return false;
+    std::shared_ptr<const Shard> candidate = Shard::open(path, index, true);
+    if (!candidate) return false;
+
+    // Make the download durable before it replaces anything
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || ::fsync(fd) != 0) {
+        std::cerr << "Cannot sync breach shard " << path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    std::lock_guard<std::mutex> lock(loadMutex);
+    const std::string target = shardPath(index);
+    std::shared_ptr<const Shard> current = std::atomic_load_explicit(&shards[index], std::memory_order_acquire);
+    if (!current && states[index].load(std::memory_order_relaxed) == UNTRIED) current = Shard::open(target, index, false);
+    if (current && candidate->generation < current->generation) {
+        std::cerr << "Refusing older breach shard " << path << " (generation " << candidate->generation
+                  << " < " << current->generation << ")" << std::endl;
+        return false;
+    }
+    if (path != target && std::rename(path.c_str(), target.c_str()) != 0) {
+        std::cerr << "Cannot install breach shard " << target << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // The candidate mapping refers to the renamed inode, so it can be published as is
+    std::atomic_store_explicit(&shards[index], candidate, std::memory_order_release);
+    states[index].store(MAPPED, std::memory_order_release);
+    return true;
+}
+
+std::string BreachFilter::buildShard(uint32_t shard, std::vector<uint64_t> keys, uint64_t generation) {
+    if (shard >= SHARD_COUNT) throw std::invalid_argument("Breach shard index out of range");
+    for (uint64_t key : keys) {
+        if (shardOf(key) != shard) throw std::invalid_argument("Key belongs to another breach shard");
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (keys.size() > UINT32_MAX / 2) throw std::invalid_argument("Too many keys for one breach shard");
+
+    Geometry g = Geometry::forSize(static_cast<uint32_t>(keys.size()));
+    std::vector<uint16_t> fingerprints;
+    if (!populate(keys, g, fingerprints)) throw std::runtime_error("Breach filter construction failed");
+
+    std::string file(HEADER_SIZE + fingerprints.size() * sizeof(uint16_t), '\0');
+    uint8_t* header = reinterpret_cast<uint8_t*>(&file[0]);
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    storeLE(header + 8, FORMAT_VERSION, 2);
+    header[10] = static_cast<uint8_t>(SHARD_BITS);
+    storeLE(header + 12, shard, 4);
+    storeLE(header + 16, g.seed, 8);
+    storeLE(header + 24, g.segmentLength, 4);
+    storeLE(header + 28, g.segmentCount, 4);
+    storeLE(header + 32, g.arrayLength, 4);
+    storeLE(header + 36, keys.size(), 4);
+    storeLE(header + 40, generation, 8);
+    for (size_t i = 0; i < fingerprints.size(); ++i) storeLE(header + HEADER_SIZE + 2 * i, fingerprints[i], 2);
+    shardDigest(header, header + HEADER_SIZE, fingerprints.size() * sizeof(uint16_t), header + DIGEST_OFFSET);
+    return file;
+}
+
+std::shared_ptr<BreachFilter> BreachFilter::shared() {
+    return std::atomic_load_explicit(&g_shared, std::memory_order_acquire);
+}
+
+void BreachFilter::setShared(std::shared_ptr<BreachFilter> filter) {
+    std::atomic_store_explicit(&g_shared, std::move(filter), std::memory_order_release);
+}
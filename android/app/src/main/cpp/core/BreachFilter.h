@@ -0,0 +1,123 @@
+#ifndef BREACHFILTER_H
+#define BREACHFILTER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Offline check against known breach corpora
+ *
+ * A password's key is the first 64 bits of its SHA-1 digest, the hash that
+ * Have I Been Pwned publishes. The top SHARD_BITS bits of the key pick one
+ * of SHARD_COUNT shard files in the filter directory. Each shard is a
+ * 16-bit binary fuse filter over its keys, so a lookup reads exactly three
+ * fingerprints. That gives a false-positive rate of about 1/65536 at
+ * roughly 2.3 bytes per key.
+ *
+ * Shard file (little-endian), named by shardFileName():
+ *   [0..63]   header: magic "SFBREACH", version, shard bits and index,
+ *             seed, segment length and count, array length, key count,
+ *             corpus generation, and a truncated SHA-256 of the header and
+ *             fingerprints
+ *   [64..]    array length u16 fingerprints
+ *
+ * Shards are memory-mapped read-only with MADV_RANDOM on first use, so
+ * only the pages a lookup touches become resident, and those stay clean
+ * and reclaimable. A shard that is not on disk yet answers UNKNOWN and is
+ * remembered in requestedShards(). The app downloads what is requested (or
+ * a newer generation) and hands it to installShard(), which verifies it
+ * and swaps it in without blocking readers.
+ *
+ * Lookups are thread-safe and never allocate per key.
+ */
+class BreachFilter {
+public:
+    enum class Status : uint8_t {
+        CLEAR = 0,       // Not in the corpus (up to the false-positive rate)
+        BREACHED = 1,
+        UNKNOWN = 2,     // Shard not installed
+    };
+
+    static constexpr unsigned SHARD_BITS = 8;
+    static constexpr uint32_t SHARD_COUNT = 1u << SHARD_BITS;
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr uint16_t FORMAT_VERSION = 1;
+
+    explicit BreachFilter(const std::string& directory);
+    ~BreachFilter();
+
+    BreachFilter(const BreachFilter&) = delete;
+    BreachFilter& operator=(const BreachFilter&) = delete;
+
+    /** @brief First 64 bits (big-endian) of SHA-1(password) */
+    static uint64_t keyFor(std::string_view password);
+    /** @brief Key from a hex SHA-1 line as published ("5BAA61E4..."); false if malformed */
+    static bool parseHexKey(std::string_view hex, uint64_t& key);
+    static uint32_t shardOf(uint64_t key) { return static_cast<uint32_t>(key >> (64 - SHARD_BITS)); }
+    /** @brief "breach-XX.sfbf", XX the shard index in hex */
+    static std::string shardFileName(uint32_t shard);
+
+    Status check(std::string_view password) const;
+    void check(const std::string_view* passwords, size_t count, Status* out) const;
+    /**
+     * @brief Look up precomputed keys
+     *
+     * Works through the keys in blocks: all fingerprint addresses of a
+     * block are computed and prefetched before any is read, so the cache
+     * misses of a block overlap instead of queueing.
+     */
+    void checkKeys(const uint64_t* keys, size_t count, Status* out) const;
+
+    /** @brief Shards that a lookup needed but were not installed, ascending */
+    std::vector<uint32_t> requestedShards() const;
+    /** @brief Corpus generation of an installed shard, 0 when missing */
+    uint64_t shardGeneration(uint32_t shard) const;
+
+    /**
+     * @brief Verify a downloaded shard file and move it into the directory
+     *
+     * The file must be a valid shard for `shard`, match its digest, and be
+     * at least as new as the installed generation. It is renamed into
+     * place, so `path` should be on the same file system (a file in the
+     * filter directory). Lookups already running keep the old mapping.
+     */
+    bool installShard(uint32_t shard, const std::string& path);
+
+    /**
+     * @brief Shard file contents for `keys` (every key must belong to `shard`)
+     *
+     * Duplicates are dropped. Construction is deterministic, so the same
+     * keys and generation always give the same file.
+     * @throws std::invalid_argument for a key from another shard
+     */
+    static std::string buildShard(uint32_t shard, std::vector<uint64_t> keys, uint64_t generation);
+
+    /** @brief Filter consulted by StrengthAnalyzer and VaultAuditor, or nullptr */
+    static std::shared_ptr<BreachFilter> shared();
+    /** @brief Atomically replace the shared filter (nullptr to turn checks off) */
+    static void setShared(std::shared_ptr<BreachFilter> filter);
+
+private:
+    struct Shard;
+
+    enum ShardState : uint8_t { UNTRIED, MAPPED, MISSING };
+
+    std::string directory;
+    // Published with the shared_ptr atomic free functions; state says
+    // whether a lookup should try the file (UNTRIED) or skip it (MISSING)
+    mutable std::array<std::shared_ptr<const Shard>, SHARD_COUNT> shards;
+    mutable std::array<std::atomic<uint8_t>, SHARD_COUNT> states;
+    mutable std::mutex loadMutex;    // Serializes opening and installing shards
+
+    std::shared_ptr<const Shard> shard(uint32_t index) const;
+    std::string shardPath(uint32_t index) const;
+};
+
+#endif // BREACHFILTER_H
@@ -0,0 +1,131 @@
+#include "CipherContext.h"
+#include <atomic>
+#include <stdexcept>
+#include "SecureArena.h"
+
+// Published with the C++11 shared_ptr atomic free functions. These are not
+// lock-free in libc++ or libstdc++: each call takes a mutex from a small
+// address-hashed pool, held for one pointer copy and reference count
+// update. Readers can therefore wait briefly on a concurrent publish() or
+// on an unrelated shared_ptr hashed to the same lock, but never on key
+// derivation, which happens before publish() is called.
+static std::shared_ptr<const CipherContext> g_current;
+
+CipherContext::CipherContext(std::unique_ptr<const SimpleAES> aes, std::unique_ptr<const SimpleAES> legacy,
+                             LegacyLoader loadLegacy)
+    : primary(std::move(aes)), legacyKey(std::move(legacy)), legacyLoader(std::move(loadLegacy)) {
+    if (!primary) {
+        throw std::invalid_argument("CipherContext requires a key");
+    }
+}
+
+CipherContext::CipherContext(const CipherContext& keys, std::shared_ptr<const CipherContext> retiring)
+    : primary(keys.primary), legacyKey(keys.legacyKey), retiringKeys(std::move(retiring)),
+      legacyLoader(keys.legacyLoader) {
+    // A key `keys` already loaded is not derived again
+    std::lock_guard<std::mutex> lock(keys.loadMutex);
+    loadedLegacy = keys.loadedLegacy;
+}
+
+size_t CipherContext::encryptInto(const uint8_t* plain, size_t length, char* out, size_t capacity) const {
+    return primary->encryptInto(plain, length, out, capacity);
+}
+
+size_t CipherContext::decryptInto(const char* cipherText, size_t length, uint8_t* out, size_t capacity) const {
+    if (!SimpleAES::hasRecordPrefix(cipherText, length)) {
+        return cbcKey().decryptInto(cipherText, length, out, capacity);
+    }
+    return decryptRecordText(cipherText, length, out, capacity);
+}
+
+const SimpleAES& CipherContext::cbcKey() const {
+    if (legacyKey) return *legacyKey;
+    if (retiringKeys) return retiringKeys->cbcKey();
+
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        if (loadedLegacy) return *loadedLegacy;
+    }
+    // Not under loadMutex: the loader may take locks held by whoever copies this context
+    std::shared_ptr<const SimpleAES> loaded;
+    if (legacyLoader) loaded = legacyLoader();
+    std::lock_guard<std::mutex> lock(loadMutex);
+    if (!loadedLegacy) loadedLegacy = std::move(loaded);
+    if (!loadedLegacy) throw std::runtime_error("Decryption failed: no key for legacy ciphertexts");
+    return *loadedLegacy;
+}
+
+size_t CipherContext::decryptRecordText(const char* cipherText, size_t length, uint8_t* out, size_t capacity) const {
+    try {
+        return primary->decryptInto(cipherText, length, out, capacity);
+    } catch (const std::exception&) {
+        if (retiringKeys) {
+            try {
+                return retiringKeys->decryptRecordText(cipherText, length, out, capacity);
+            } catch (const std::exception&) {
+                if (!legacyKey) throw;
+            }
+        }
+        if (!legacyKey) throw;
+        return legacyKey->decryptInto(cipherText, length, out, capacity);
+    }
+}
+
+size_t CipherContext::encryptRecord(const uint8_t* plain, size_t length, uint8_t* out, size_t capacity,
+                                    uint8_t flags, const uint8_t* context, size_t contextLength) const {
+    return primary->encryptRecord(plain, length, out, capacity, flags, context, contextLength);
+}
+
+size_t CipherContext::decryptRecord(const uint8_t* record, size_t length, uint8_t* out, size_t capacity,
+                                    uint8_t* flags, const uint8_t* context, size_t contextLength) const {
+    try {
+        return primary->decryptRecord(record, length, out, capacity, flags, context, contextLength);
+    } catch (const std::exception& e) {
+        if (!legacyKey && !retiringKeys) throw;
+        return decryptRecordRetired(record, length, out, capacity, flags, context, contextLength);
+    }
+}
+
+size_t CipherContext::decryptRecordRetired(const uint8_t* record, size_t length, uint8_t* out, size_t capacity,
+                                           uint8_t* flags, const uint8_t* context, size_t contextLength) const {
+    if (retiringKeys) {
+        try {
+            return retiringKeys->decryptRecord(record, length, out, capacity, flags, context, contextLength);
+        } catch (const std::exception&) {
+            if (!legacyKey) throw;
+        }
+    }
+    if (!legacyKey) throw std::runtime_error("Decryption failed: no key opens the record");
+    return legacyKey->decryptRecord(record, length, out, capacity, flags, context, contextLength);
+}
+
+bool CipherContext::resealRecord(const uint8_t* record, size_t length, std::vector<uint8_t>& out) const {
+    SecureBuffer plain(length > SimpleAES::RECORD_OVERHEAD ? length - SimpleAES::RECORD_OVERHEAD : 0);
+    uint8_t flags = 0;
+    try {
+        primary->decryptRecord(record, length, plain.data(), plain.size(), &flags);
+        return false;
+    } catch (const std::exception&) {
+        // Not (yet) under the primary key
+    }
+    plain.resize(decryptRecordRetired(record, length, plain.data(), plain.size(), &flags));
+
+    out.resize(SimpleAES::recordSize(plain.size()));
+    out.resize(primary->encryptRecord(plain.data(), plain.size(), out.data(), out.size(), flags));
+    return true;
+}
+
+std::shared_ptr<const CipherContext> CipherContext::current() {
+    return std::atomic_load_explicit(&g_current, std::memory_order_acquire);
+}
+
+void CipherContext::publish(std::shared_ptr<const CipherContext> context) {
+    std::atomic_store_explicit(&g_current, std::move(context), std::memory_order_release);
+}
+
+bool CipherContext::replace(const std::shared_ptr<const CipherContext>& expected,
+                            std::shared_ptr<const CipherContext> context) {
+    std::shared_ptr<const CipherContext> current = expected;
+    return std::atomic_compare_exchange_strong_explicit(&g_current, &current, std::move(context),
+                                                        std::memory_order_acq_rel, std::memory_order_acquire);
+}
@@ -0,0 +1,139 @@
+#ifndef CIPHERCONTEXT_H
+#define CIPHERCONTEXT_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "SimpleAES.h"
+
+/**
+ * @brief Immutable set of keys used by the FFI layer
+ *
+ * A context owns the current AES key and, when it differs, the key for data
+ * written by older builds. Contexts are never modified after construction:
+ * key changes build a new one and publish() swaps it in atomically. Readers
+ * take a reference with current() and keep using it even if a swap happens
+ * mid-operation; the old keys are wiped when the last reader lets go.
+ *
+ * While the master password changes, the published context also carries
+ * the retiring context (see KeyRotation). Writes use the new key; reads
+ * try the keys newest first: primary, then the retiring chain, then legacy.
+ *
+ * The legacy key is costly to derive and rarely needed, so a context may
+ * instead hold a loader that derives it the first time a legacy CBC
+ * ciphertext turns up. That is the one thing that changes after
+ * construction.
+ */
+class CipherContext {
+public:
+    /** @brief Derives the legacy key on demand; may throw */
+    using LegacyLoader = std::function<std::unique_ptr<const SimpleAES>()>;
+
+private:
+    std::shared_ptr<const SimpleAES> primary;
+    std::shared_ptr<const SimpleAES> legacyKey;
+    std::shared_ptr<const CipherContext> retiringKeys;
+    LegacyLoader legacyLoader;
+    mutable std::mutex loadMutex;
+    mutable std::shared_ptr<const SimpleAES> loadedLegacy;   // From legacyLoader, guarded by loadMutex
+
+    // Key for legacy CBC ciphertexts: the newest generation's legacy key,
+    // loaded on first use; throws when there is none
+    const SimpleAES& cbcKey() const;
+    // Base64 GCM record: primary, retiring chain, then legacy; GCM only
+    size_t decryptRecordText(const char* cipherText, size_t length, uint8_t* out, size_t capacity) const;
+    // Decrypt with everything but the primary key
+    size_t decryptRecordRetired(const uint8_t* record, size_t length, uint8_t* out, size_t capacity,
+                                uint8_t* flags, const uint8_t* context = nullptr, size_t contextLength = 0) const;
+
+public:
+    /**
+     * @param aes        Key for new writes (and GCM records)
+     * @param legacy     Key legacy CBC ciphertexts were written with, or nullptr
+     * @param loadLegacy Without `legacy`: derives it when first needed
+     */
+    explicit CipherContext(std::unique_ptr<const SimpleAES> aes,
+                           std::unique_ptr<const SimpleAES> legacy = nullptr,
+                           LegacyLoader loadLegacy = nullptr);
+
+    /**
+     * @brief Same keys as `keys`, with `retiring` (may be nullptr) as the older generation
+     */
+    CipherContext(const CipherContext& keys, std::shared_ptr<const CipherContext> retiring);
+
+    const SimpleAES& aes() const { return *primary; }
+
+    bool hasSeparateLegacy() const { return legacyKey != nullptr; }
+
+    /** @brief Previous key generation while a re-key is running, else nullptr */
+    const std::shared_ptr<const CipherContext>& retiring() const { return retiringKeys; }
+    bool isRotating() const { return retiringKeys != nullptr; }
+
+    /**
+     * @brief Encrypt into a caller buffer with the primary key
+     */
+    size_t encryptInto(const uint8_t* plain, size_t length, char* out, size_t capacity) const;
+
+    /**
+     * @brief Decrypt with whichever key wrote the ciphertext
+     *
+     * Legacy CBC ciphertexts only ever go to the legacy key (the retiring
+     * generation's while this one has none), loaded if need be. GCM
+     * records are tried with the primary key, then the retiring chain,
+     * then the legacy key, and are never read as CBC, so a key that does
+     * not fit fails instead of returning garbage.
+     */
+    size_t decryptInto(const char* cipherText, size_t length, uint8_t* out, size_t capacity) const;
+
+    /**
+     * @brief Raw GCM record under the primary key (see SimpleAES::encryptRecord)
+     *
+     * Use RecordCompression::seal() to compress on the way.
+     */
+    size_t encryptRecord(const uint8_t* plain, size_t length, uint8_t* out, size_t capacity,
+                         uint8_t flags = 0, const uint8_t* context = nullptr, size_t contextLength = 0) const;
+
+    /**
+     * @brief Decrypt a raw GCM record, primary key first, then the legacy key
+     *
+     * `flags` as for SimpleAES::decryptRecord; RecordCompression::open()
+     * reads compressed records too.
+     */
+    size_t decryptRecord(const uint8_t* record, size_t length, uint8_t* out, size_t capacity,
+                         uint8_t* flags = nullptr, const uint8_t* context = nullptr,
+                         size_t contextLength = 0) const;
+
+    /**
+     * @brief Re-seal a raw GCM record under the primary key
+     *
+     * The payload and its flags are carried over as they are, compressed or
+     * not. Returns false, leaving `out` alone, when the primary key already
+     * opens it. Throws when no key does.
+     */
+    bool resealRecord(const uint8_t* record, size_t length, std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Currently published context, or nullptr when keys are not loaded
+     *
+     * Never blocks on key derivation. Not lock-free: it shares a short
+     * critical section (a pointer copy) with publish(), see CipherContext.cpp.
+     */
+    static std::shared_ptr<const CipherContext> current();
+
+    /**
+     * @brief Atomically replace the published context (nullptr to clear)
+     */
+    static void publish(std::shared_ptr<const CipherContext> context);
+
+    /**
+     * @brief Publish `context` only if `expected` is still the current one
+     *
+     * For publishers outside the FFI key lifecycle (the re-key engine), so
+     * they never overwrite keys that changed while they worked.
+     */
+    static bool replace(const std::shared_ptr<const CipherContext>& expected,
+                        std::shared_ptr<const CipherContext> context);
+};
+
+#endif // CIPHERCONTEXT_H
@@ -0,0 +1,224 @@
+#include "CryptoWorkerPool.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ============================================================================
+// Job
+// ============================================================================
+
+CryptoWorkerPool::Job::Job(size_t count, size_t grain, RangeFn fn, const std::atomic<int32_t>* externalCancel)
+    : count(count), grain(grain == 0 ? 1 : grain), fn(std::move(fn)), externalCancel(externalCancel) {}
+
+bool CryptoWorkerPool::Job::shouldStop() const {
+    return isCancelled() ||
+           (externalCancel && externalCancel->load(std::memory_order_relaxed) != 0);
+}
+
+bool CryptoWorkerPool::Job::runChunk() {
+    const size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+    if (begin >= count) {
+        return false;
+    }
+    const size_t end = std::min(count, begin + grain);
+
+    bool ran = false;
+    if (!shouldStop()) {
+        try {
+            fn(begin, end);
+            ran = true;
+        } catch (...) {
+            // Items report their own failures; never let one take down a worker
+        }
+    }
+
+    if (ran) {
+        done.fetch_add(end - begin, std::memory_order_relaxed);
+    }
+    // Settled counts skipped chunks too, so wait() returns after a cancel
+    if (settled.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.notify_all();
+    }
+    return true;
+}
+
+bool CryptoWorkerPool::Job::wait() {
+    // The waiting thread is one more worker
+    while (runChunk()) {
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return settled.load(std::memory_order_acquire) >= count; });
+    return done.load(std::memory_order_relaxed) == count;
+}
+
+// ============================================================================
+// Pool
+// ============================================================================
+
+CryptoWorkerPool::CryptoWorkerPool(size_t threads) {
+    for (size_t i = 0; i < threads; i++) {
+        try {
+            workers.emplace_back(&CryptoWorkerPool::workerLoop, this);
+        } catch (const std::system_error&) {
+            break;   // Run with what we have; run() still works inline
+        }
+    }
+}
+
+CryptoWorkerPool::~CryptoWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    backgroundReady.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    if (backgroundWorker.joinable()) {
+        backgroundWorker.join();
+    }
+}
+
+CryptoWorkerPool& CryptoWorkerPool::shared() {
+    // The caller of run() also works, so one fewer background thread
+    static CryptoWorkerPool pool(bigCoreCount() > 1 ? bigCoreCount() - 1 : 0);
+    return pool;
+}
+
+size_t CryptoWorkerPool::bigCoreCount() {
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    // cpuinfo_max_freq per core; on big.LITTLE the little cluster has the
+    // lowest ceiling. Count everything above it (prime + big clusters).
+    std::vector<unsigned long> maxFreq;
+    for (unsigned int cpu = 0; cpu < cores; cpu++) {
+        std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq");
+        unsigned long freq = 0;
+        if (!(in >> freq)) {
+            return cores;
+        }
+        maxFreq.push_back(freq);
+    }
+
+    const unsigned long lowest = *std::min_element(maxFreq.begin(), maxFreq.end());
+    size_t big = static_cast<size_t>(std::count_if(maxFreq.begin(), maxFreq.end(),
+                                                   [lowest](unsigned long f) { return f > lowest; }));
+    return big == 0 ? cores : big;   // Homogeneous: every core is a big core
+}
+
+std::shared_ptr<CryptoWorkerPool::Job> CryptoWorkerPool::submit(size_t count, size_t grain, RangeFn fn,
+                                                               const std::atomic<int32_t>* externalCancel) {
+    std::shared_ptr<Job> job(new Job(count, grain, std::move(fn), externalCancel));
+
+    const size_t chunks = (count + job->grain - 1) / job->grain;
+    const size_t helpers = std::min(workers.size(), chunks);
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            for (size_t i = 0; i < helpers; i++) {
+                queue.push_back(job);
+            }
+        }
+        queueReady.notify_all();
+    }
+    return job;
+}
+
+bool CryptoWorkerPool::run(size_t count, size_t grain, RangeFn fn, const std::atomic<int32_t>* externalCancel) {
+    if (count == 0) {
+        return true;
+    }
+    // One chunk or no workers: skip the queue round-trip
+    if (count <= grain || workers.empty()) {
+        grain = grain == 0 ? 1 : grain;
+        for (size_t begin = 0; begin < count; begin += grain) {
+            if (externalCancel && externalCancel->load(std::memory_order_relaxed) != 0) {
+                return false;
+            }
+            try {
+                fn(begin, std::min(count, begin + grain));
+            } catch (...) {
+                // Same contract as the pooled path
+            }
+        }
+        return true;
+    }
+    return submit(count, grain, std::move(fn), externalCancel)->wait();
+}
+
+void CryptoWorkerPool::workerLoop() {
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping && queue.empty()) {
+                return;
+            }
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        while (job->runChunk()) {
+        }
+    }
+}
+
+void CryptoWorkerPool::post(Task task, std::chrono::milliseconds delay) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) {
+            return;
+        }
+        if (!backgroundWorker.joinable()) {
+            try {
+                backgroundWorker = std::thread(&CryptoWorkerPool::backgroundLoop, this);
+            } catch (const std::system_error&) {
+                return;   // The owner sees its task never run
+            }
+        }
+        backgroundQueue.push_back(Background{Clock::now() + delay, backgroundOrder++, std::move(task)});
+        std::push_heap(backgroundQueue.begin(), backgroundQueue.end(), std::greater<Background>());
+    }
+    backgroundReady.notify_one();
+}
+
+void CryptoWorkerPool::backgroundLoop() {
+    // Nice values are per thread on Linux; lowering our own needs no privilege
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), BACKGROUND_NICE);
+
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            for (;;) {
+                if (stopping) {
+                    return;
+                }
+                if (backgroundQueue.empty()) {
+                    backgroundReady.wait(lock);
+                } else if (backgroundQueue.front().due > Clock::now()) {
+                    backgroundReady.wait_until(lock, backgroundQueue.front().due);
+                } else {
+                    break;
+                }
+            }
+            std::pop_heap(backgroundQueue.begin(), backgroundQueue.end(), std::greater<Background>());
+            task = std::move(backgroundQueue.back().task);
+            backgroundQueue.pop_back();
+        }
+
+        try {
+            task();
+        } catch (...) {
+            // Same contract as job chunks
+        }
+    }
+}
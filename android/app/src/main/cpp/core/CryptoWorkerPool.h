@@ -0,0 +1,151 @@
+#ifndef CRYPTOWORKERPOOL_H
+#define CRYPTOWORKERPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size thread pool for bulk crypto jobs (vault unlock, re-key, backup)
+ *
+ * A job is a range of `count` independent items processed in chunks of
+ * `grain` items. Workers (and the thread waiting on the job) claim chunks
+ * from a shared counter, so uneven items balance themselves. Jobs can be
+ * cancelled; chunks not yet started are skipped.
+ *
+ * The shared() pool is sized to the big cores of the device (highest
+ * cpufreq cluster(s) on big.LITTLE), since little cores only add latency to
+ * the last chunk.
+ *
+ * post() queues background tasks (e.g. the vault re-key) for one more
+ * thread, started on first use and kept at BACKGROUND_NICE for its whole
+ * life, so the scheduler prefers the app's threads and the job workers.
+ */
+class CryptoWorkerPool {
+public:
+    using RangeFn = std::function<void(size_t begin, size_t end)>;
+    using Task = std::function<void()>;
+
+    /** @brief Nice value of the background thread (Android's THREAD_PRIORITY_BACKGROUND) */
+    static constexpr int BACKGROUND_NICE = 10;
+
+    /**
+     * @brief Handle for one submitted job
+     */
+    class Job {
+    public:
+        /**
+         * @brief Stop handing out chunks; running chunks finish normally
+         */
+        void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+        bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Help process remaining chunks, then wait for the rest
+         * @return false if the job was cancelled before all chunks ran
+         */
+        bool wait();
+
+        /**
+         * @brief Items processed so far
+         */
+        size_t completed() const { return done.load(std::memory_order_relaxed); }
+
+    private:
+        friend class CryptoWorkerPool;
+
+        Job(size_t count, size_t grain, RangeFn fn, const std::atomic<int32_t>* externalCancel);
+
+        // Claim and run one chunk; false when none are left
+        bool runChunk();
+        bool shouldStop() const;
+
+        const size_t count;
+        const size_t grain;
+        const RangeFn fn;
+        const std::atomic<int32_t>* externalCancel;
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<size_t> settled{0};   // Run or skipped
+        std::atomic<bool> cancelled{false};
+
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    explicit CryptoWorkerPool(size_t threads);
+    ~CryptoWorkerPool();
+
+    CryptoWorkerPool(const CryptoWorkerPool&) = delete;
+    CryptoWorkerPool& operator=(const CryptoWorkerPool&) = delete;
+
+    /**
+     * @brief Process-wide pool sized to bigCoreCount()
+     */
+    static CryptoWorkerPool& shared();
+
+    /**
+     * @brief Number of performance cores, from cpufreq (falls back to all cores)
+     */
+    static size_t bigCoreCount();
+
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Queue fn over [0, count) in chunks of grain items
+     * @param externalCancel Optional flag polled between chunks (non-zero = cancel),
+     *                       e.g. memory shared with the FFI caller
+     */
+    std::shared_ptr<Job> submit(size_t count, size_t grain, RangeFn fn,
+                                const std::atomic<int32_t>* externalCancel = nullptr);
+
+    /**
+     * @brief submit() + wait(); small jobs run inline on the caller
+     * @return false if cancelled
+     */
+    bool run(size_t count, size_t grain, RangeFn fn, const std::atomic<int32_t>* externalCancel = nullptr);
+
+    /**
+     * @brief Run `task` on the background thread once `delay` has passed
+     *
+     * Tasks run one at a time in deadline order. Tasks still queued when
+     * the pool is destroyed are dropped.
+     */
+    void post(Task task, std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Background {
+        Clock::time_point due;
+        uint64_t order;   // FIFO among equal deadlines
+        Task task;
+        bool operator>(const Background& other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    void workerLoop();
+    void backgroundLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping = false;
+
+    std::thread backgroundWorker;
+    std::vector<Background> backgroundQueue;   // Min-heap on (due, order)
+    uint64_t backgroundOrder = 0;
+    std::condition_variable backgroundReady;
+};
+
+#endif // CRYPTOWORKERPOOL_H
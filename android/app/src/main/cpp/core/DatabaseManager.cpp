@@ -1,43 +1,337 @@
 #include "DatabaseManager.h"
-#include "../models/PasswordEntry.h"
+#include "Base64.h"
+#include "CipherContext.h"
+#include "PerfTrace.h"
+#include "RecordCompression.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 
-DatabaseManager::DatabaseManager(const std::string& databasePath) : db(nullptr), dbPath(databasePath) {
+namespace {
+
+const char* const STATEMENT_SQL[] = {
+        // INSERT
+        "INSERT INTO passwords "
+        "(title, username, password, category, website, notes, created_date, modified_date) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?);",
+        // INSERT_WITH_ID
+        "INSERT OR REPLACE INTO passwords "
+        "(title, username, password, category, website, notes, created_date, modified_date, id) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);",
+        // UPDATE
+        "UPDATE passwords SET title = ?, username = ?, password = ?, category = ?, "
+        "website = ?, notes = ?, created_date = ?, modified_date = ? WHERE id = ?;",
+        // DELETE_BY_ID
+        "DELETE FROM passwords WHERE id = ?;",
+        // SELECT_BY_ID
+        "SELECT id, title, username, password, category, website, notes, created_date, modified_date "
+        "FROM passwords WHERE id = ?;",
+        // SELECT_ALL
+        "SELECT id, title, username, password, category, website, notes, created_date, modified_date "
+        "FROM passwords ORDER BY id;",
+        // DELETE_ALL
+        "DELETE FROM passwords;",
+        // COUNT_ALL
+        "SELECT COUNT(*) FROM passwords;",
+        // SELECT_SECRETS_BY_ID
+        "SELECT password, notes FROM passwords WHERE id = ?;",
+        // PAGE_BY_TITLE
+        "SELECT id, title, username, category, website, modified_date FROM passwords "
+        "ORDER BY title COLLATE NOCASE, id LIMIT ? OFFSET ?;",
+        // PAGE_BY_USERNAME
+        "SELECT id, title, username, category, website, modified_date FROM passwords "
+        "ORDER BY username COLLATE NOCASE, id LIMIT ? OFFSET ?;",
+        // PAGE_BY_WEBSITE
+        "SELECT id, title, username, category, website, modified_date FROM passwords "
+        "ORDER BY website COLLATE NOCASE, id LIMIT ? OFFSET ?;",
+        // PAGE_BY_CATEGORY
+        "SELECT id, title, username, category, website, modified_date FROM passwords "
+        "ORDER BY category, title COLLATE NOCASE, id LIMIT ? OFFSET ?;",
+        // PAGE_BY_RECENTLY_MODIFIED
+        "SELECT id, title, username, category, website, modified_date FROM passwords "
+        "ORDER BY modified_date DESC, id DESC LIMIT ? OFFSET ?;",
+        // PAGE_BY_ID
+        "SELECT id, title, username, category, website, modified_date FROM passwords "
+        "ORDER BY id LIMIT ? OFFSET ?;",
+        // BEGIN
+        "BEGIN IMMEDIATE;",
+        // COMMIT
+        "COMMIT;",
+        // ROLLBACK
+        "ROLLBACK;",
+        // SELECT_TEXT_RECORDS: 'U0YB' is the base64 record prefix (SimpleAES::hasRecordPrefix)
+        "SELECT id, password, notes FROM passwords WHERE id > ? AND ("
+        "(typeof(password) = 'text' AND substr(password, 1, 4) = 'U0YB') OR "
+        "(typeof(notes) = 'text' AND substr(notes, 1, 4) = 'U0YB')) "
+        "ORDER BY id LIMIT ?;",
+        // UPDATE_SECRETS: a NULL binding keeps the stored value
+        "UPDATE passwords SET password = coalesce(?, password), notes = coalesce(?, notes) WHERE id = ?;",
+        // SELECT_CHANGES: row columns first so readRow() applies; p.id is NULL for deleted entries
+        "SELECT p.id, p.title, p.username, p.password, p.category, p.website, p.notes, "
+        "p.created_date, p.modified_date, c.seq, c.entry_id "
+        "FROM changes c LEFT JOIN passwords p ON p.id = c.entry_id "
+        "WHERE c.seq > ? AND c.seq = (SELECT MAX(seq) FROM changes l WHERE l.entry_id = c.entry_id) "
+        "ORDER BY c.seq LIMIT ?;",
+        // JOURNAL_HEAD: sqlite_sequence keeps the high-water mark even after compaction
+        "SELECT coalesce((SELECT seq FROM sqlite_sequence WHERE name = 'changes'), 0);",
+        // JOURNAL_FLOOR
+        "SELECT floor FROM journal_state WHERE id = 1;",
+        // COMPACT_SUPERSEDED
+        "DELETE FROM changes WHERE seq < (SELECT MAX(seq) FROM changes l WHERE l.entry_id = changes.entry_id);",
+        // COMPACT_TOMBSTONES
+        "DELETE FROM changes WHERE seq <= ? AND NOT EXISTS (SELECT 1 FROM passwords WHERE id = changes.entry_id);",
+        // RAISE_JOURNAL_FLOOR
+        "UPDATE journal_state SET floor = max(floor, ?) WHERE id = 1;",
+        // SELECT_SECRETS_AFTER
+        "SELECT id, password, notes FROM passwords WHERE id > ? ORDER BY id LIMIT ?;",
+        // SELECT_REKEY_STATE
+        "SELECT rotation, cursor FROM rekey_state WHERE id = 1;",
+        // SAVE_REKEY_STATE
+        "INSERT OR REPLACE INTO rekey_state (id, rotation, cursor) VALUES (1, ?, ?);",
+        // CLEAR_REKEY_STATE
+        "DELETE FROM rekey_state;",
+        // JOURNAL_ENTRY: changes the triggers do not see (a re-key rewrites secrets only)
+        "INSERT INTO changes (entry_id) VALUES (?);",
+};
+
+// Busy handler wait before a locked database surfaces SQLITE_BUSY
+constexpr int BUSY_TIMEOUT_MS = 2000;
+
+/**
+ * @brief Returns a cached statement to its initial state on scope exit
+ *
+ * Reset releases the read transaction a SELECT holds open; clearing bindings
+ * drops the transient copies of the last entry's strings.
+ */
+class StatementScope {
+public:
+    explicit StatementScope(sqlite3_stmt* stmt) : stmt(stmt) {}
+    ~StatementScope() {
+        if (stmt) {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+        }
+    }
+
+    StatementScope(const StatementScope&) = delete;
+    StatementScope& operator=(const StatementScope&) = delete;
+
+private:
+    sqlite3_stmt* stmt;
+};
+
+// Zeroize through a volatile pointer so the stores are not optimized away
+void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    while (length--) *p++ = 0;
+}
+
+void bindText(sqlite3_stmt* stmt, int index, const std::string& value) {
+    sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+}
+
+// For strings that outlive the statement's StatementScope: bound without a copy
+void bindStaticText(sqlite3_stmt* stmt, int index, const std::string& value) {
+    sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+}
+
+// Raw bytes of a base64 GCM record, or empty when `text` is anything else
+std::string decodeRecord(const std::string& text) {
+    if (!SimpleAES::hasRecordPrefix(text.data(), text.size())) return std::string();
+
+    std::string raw(Base64::maxDecodedSize(text.size()), '\0');
+    size_t length = 0;
+    try {
+        length = Base64::decode(text.data(), text.size(), reinterpret_cast<uint8_t*>(&raw[0]));
+    } catch (const std::invalid_argument&) {
+        return std::string();
+    }
+    if (!SimpleAES::isRecord(reinterpret_cast<const uint8_t*>(raw.data()), length)) return std::string();
+    raw.resize(length);
+    return raw;
+}
+
+/**
+ * @brief Bind a password or notes column
+ *
+ * GCM records go in as BLOBs without being decrypted: a record sealed in
+ * the entry is bound straight from it, and base64 records (sealed or handed
+ * in as the plain value) are decoded first. A sealed legacy CBC ciphertext
+ * is re-sealed as a record under the current keys, or kept as it is when
+ * they cannot open it; its plaintext never reaches the column. Plain
+ * values are TEXT as given.
+ */
+template <typename Read>
+void bindSecret(sqlite3_stmt* stmt, int index, const LazySecret& sealed, Read read) {
+    if (!sealed.empty() && sealed.encoding() == LazySecret::Encoding::RECORD) {
+        const std::string& record = sealed.ciphertext();
+        sqlite3_bind_blob(stmt, index, record.data(), static_cast<int>(record.size()), SQLITE_STATIC);
+        return;
+    }
+
+    const std::string value = sealed.empty() ? read() : std::string();
+    std::string record = decodeRecord(sealed.empty() ? value : sealed.ciphertext());
+    if (record.empty() && !sealed.empty()) {
+        std::shared_ptr<const CipherContext> keys = CipherContext::current();
+        if (keys) {
+            std::string plain;
+            try {
+                plain = read();
+                record = RecordCompression::seal(*keys, reinterpret_cast<const uint8_t*>(plain.data()), plain.size(),
+                                                 RecordCompression::Dictionary::TEXT);
+            } catch (const std::exception&) {
+                record.clear();
+            }
+            secureWipe(&plain[0], plain.size());
+        }
+        if (record.empty()) {
+            bindText(stmt, index, sealed.ciphertext());
+            return;
+        }
+    }
+    if (!record.empty()) {
+        sqlite3_bind_blob(stmt, index, record.data(), static_cast<int>(record.size()), SQLITE_TRANSIENT);
+    } else {
+        bindText(stmt, index, value);
+    }
+}
+
+// Binds the eight entry columns shared by INSERT and UPDATE
+void bindEntry(sqlite3_stmt* stmt, const PasswordEntry& entry) {
+    // Title, username, website and sealed records reference the entry
+    // itself; other secrets come back as temporaries and are copied
+    bindStaticText(stmt, 1, entry.getTitle());
+    bindStaticText(stmt, 2, entry.getUsername());
+    bindSecret(stmt, 3, entry.getSealedPassword(), [&entry] { return entry.getPassword(); });
+    sqlite3_bind_int(stmt, 4, static_cast<int>(entry.getCategory()));
+    bindStaticText(stmt, 5, entry.getWebsite());
+    bindSecret(stmt, 6, entry.getSealedNotes(), [&entry] { return entry.getNotes(); });
+    sqlite3_bind_int64(stmt, 7, static_cast<sqlite3_int64>(entry.getCreatedDate()));
+    sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(entry.getModifiedDate()));
+}
+
+std::string columnText(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    if (!text) return "";
+    return std::string(reinterpret_cast<const char*>(text),
+                       static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+}
+
+bool isBlob(sqlite3_stmt* stmt, int column) {
+    return sqlite3_column_type(stmt, column) == SQLITE_BLOB;
+}
+
+std::string columnBlob(sqlite3_stmt* stmt, int column) {
+    const void* data = sqlite3_column_blob(stmt, column);
+    if (!data) return "";
+    return std::string(static_cast<const char*>(data), static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+}
+
+// TEXT as stored; a BLOB record is decrypted straight from the column
+std::string columnSecret(sqlite3_stmt* stmt, int column, const CipherContext* keys) {
+    if (!isBlob(stmt, column)) return columnText(stmt, column);
+
+    const uint8_t* record = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, column));
+    const size_t length = static_cast<size_t>(sqlite3_column_bytes(stmt, column));
+    if (!keys) throw std::runtime_error("Encryption keys are not loaded");
+
+    return RecordCompression::open(*keys, record, length);
+}
+
+// Row ids are carried in PasswordEntry as decimal strings
+int64_t parseRowId(const std::string& id) {
+    if (id.empty()) return -1;
+    char* end = nullptr;
+    long long value = std::strtoll(id.c_str(), &end, 10);
+    if (*end != '\0' || value <= 0) return -1;
+    return static_cast<int64_t>(value);
+}
+
+} // namespace
+
+DatabaseManager::DatabaseManager(const std::string& databasePath)
+        : db(nullptr), dbPath(databasePath), statements{} {
     initializeDatabase();
 }
 
 DatabaseManager::~DatabaseManager() {
+    close();
+}
+
+void DatabaseManager::close() {
+    for (sqlite3_stmt*& stmt : statements) {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+        }
+    }
     if (db) {
         sqlite3_close(db);
+        db = nullptr;
     }
 }
 
 bool DatabaseManager::initializeDatabase() {
     std::cout << "Initializing database at: " << dbPath << std::endl;
 
-    int result = sqlite3_open(dbPath.c_str(), &db);
+    const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    int result = sqlite3_open_v2(dbPath.c_str(), &db, flags, nullptr);
     if (result != SQLITE_OK) {
-        std::cerr << "Cannot open database: " << sqlite3_errmsg(db) << std::endl;
+        std::cerr << "Cannot open database: " << (db ? sqlite3_errmsg(db) : sqlite3_errstr(result)) << std::endl;
+        close();
+        return false;
+    }
+
+    if (!configureConnection() || !createTables() || !createIndexes() || !createJournal()) {
+        close();
         return false;
     }
 
     std::cout << "Database opened successfully" << std::endl;
-    return createTables();
+    return true;
+}
+
+bool DatabaseManager::configureConnection() {
+    // WAL lets a save commit with one append to the log instead of rewriting
+    // the rollback journal; NORMAL sync is durable across app crashes in WAL
+    // mode and only risks the last commit on power loss.
+    const char* pragmas =
+            "PRAGMA journal_mode = WAL;"
+            "PRAGMA synchronous = NORMAL;"
+            "PRAGMA temp_store = MEMORY;"
+            "PRAGMA cache_size = -2000;"
+            "PRAGMA foreign_keys = ON;";
+
+    sqlite3_busy_timeout(db, BUSY_TIMEOUT_MS);
+
+    char* errorMessage = nullptr;
+    if (sqlite3_exec(db, pragmas, nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+        std::cerr << "Error configuring database: " << errorMessage << std::endl;
+        sqlite3_free(errorMessage);
+        return false;
+    }
+    return true;
 }
 
 bool DatabaseManager::createTables() {
     const char* createPasswordsTable =
             "CREATE TABLE IF NOT EXISTS passwords ("
-            "id TEXT PRIMARY KEY,"
+            "id INTEGER PRIMARY KEY AUTOINCREMENT,"
             "title TEXT NOT NULL,"
             "username TEXT NOT NULL,"
             "password TEXT NOT NULL,"
+            "category INTEGER NOT NULL,"
             "website TEXT,"
-            "category TEXT,"
             "notes TEXT,"
             "created_date INTEGER,"
             "modified_date INTEGER"
+            ");"
+            // Checkpoint of the re-key after a master password change (RekeyMigration)
+            "CREATE TABLE IF NOT EXISTS rekey_state ("
+            "id INTEGER PRIMARY KEY CHECK (id = 1),"
+            "rotation INTEGER NOT NULL,"
+            "cursor INTEGER NOT NULL"
             ");";
 
     char* errorMessage = nullptr;
@@ -52,78 +346,701 @@ bool DatabaseManager::createTables() {
     return true;
 }
 
-bool DatabaseManager::savePassword(const PasswordEntry& entry) {
-    const char* insertSQL =
-            "INSERT OR REPLACE INTO passwords "
-            "(id, title, username, password, website, category, notes, created_date, modified_date) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);";
+bool DatabaseManager::createIndexes() {
+    // Back the default list order and the "recent" view so the first page
+    // is read straight from the index instead of sorting the whole table
+    const char* createIndexesSQL =
+            "CREATE INDEX IF NOT EXISTS idx_passwords_title ON passwords(title COLLATE NOCASE, id);"
+            "CREATE INDEX IF NOT EXISTS idx_passwords_modified ON passwords(modified_date, id);";
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, insertSQL, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare insert statement" << std::endl;
+    char* errorMessage = nullptr;
+
+    if (sqlite3_exec(db, createIndexesSQL, nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+        std::cerr << "Error creating indexes: " << errorMessage << std::endl;
+        sqlite3_free(errorMessage);
         return false;
     }
+    return true;
+}
 
-    sqlite3_bind_text(stmt, 1, entry.getId().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, entry.getTitle().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, entry.getUsername().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, entry.getPassword().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 5, entry.getWebsite().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 6, entry.getCategory().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 7, entry.getNotes().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int64(stmt, 8, entry.getCreatedDate());
-    sqlite3_bind_int64(stmt, 9, entry.getModifiedDate());
+bool DatabaseManager::createJournal() {
+    // The update trigger lists the columns every edit sets; the record
+    // migration sets only password and notes, so re-encoding is not a
+    // change. A re-key does change what a sync peer holds (the old keys go
+    // away), so rekeyRecords journals its rows explicitly. INSERT OR
+    // REPLACE journals through the insert trigger.
+    // Rows that predate the journal are seeded once, when journal_state is
+    // first created, so a first sync from 0 still sees them.
+    const char* createJournalSQL =
+            "BEGIN IMMEDIATE;"
+            "CREATE TABLE IF NOT EXISTS changes ("
+            "seq INTEGER PRIMARY KEY AUTOINCREMENT,"
+            "entry_id INTEGER NOT NULL"
+            ");"
+            "CREATE INDEX IF NOT EXISTS idx_changes_entry ON changes(entry_id, seq);"
+            "CREATE TABLE IF NOT EXISTS journal_state ("
+            "id INTEGER PRIMARY KEY CHECK (id = 1),"
+            "floor INTEGER NOT NULL"
+            ");"
+            "INSERT INTO changes (entry_id) SELECT id FROM passwords "
+            "WHERE NOT EXISTS (SELECT 1 FROM journal_state) ORDER BY id;"
+            "INSERT OR IGNORE INTO journal_state (id, floor) VALUES (1, 0);"
+            "CREATE TRIGGER IF NOT EXISTS journal_insert AFTER INSERT ON passwords "
+            "BEGIN INSERT INTO changes (entry_id) VALUES (new.id); END;"
+            "CREATE TRIGGER IF NOT EXISTS journal_update "
+            "AFTER UPDATE OF title, username, category, website, created_date, modified_date ON passwords "
+            "BEGIN INSERT INTO changes (entry_id) VALUES (new.id); END;"
+            "CREATE TRIGGER IF NOT EXISTS journal_delete AFTER DELETE ON passwords "
+            "BEGIN INSERT INTO changes (entry_id) VALUES (old.id); END;"
+            "COMMIT;";
 
-    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
+    char* errorMessage = nullptr;
 
-    if (success) {
-        std::cout << "Password saved successfully: " << entry.getTitle() << std::endl;
-    } else {
-        std::cerr << "Failed to save password: " << entry.getTitle() << std::endl;
+    if (sqlite3_exec(db, createJournalSQL, nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+        std::cerr << "Error creating change journal: " << errorMessage << std::endl;
+        sqlite3_free(errorMessage);
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
     }
+    return true;
+}
 
-    return success;
+sqlite3_stmt* DatabaseManager::statement(Statement which) {
+    if (!db) return nullptr;
+
+    sqlite3_stmt*& slot = statements[static_cast<size_t>(which)];
+    if (!slot) {
+        const char* sql = STATEMENT_SQL[static_cast<size_t>(which)];
+        if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &slot, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            slot = nullptr;
+        }
+    }
+    return slot;
+}
+
+PasswordEntry DatabaseManager::readRow(sqlite3_stmt* stmt) {
+    // BLOB secrets stay sealed: nothing is decrypted until they are read
+    const bool passwordSealed = isBlob(stmt, 3);
+    const bool notesSealed = isBlob(stmt, 6);
+    PasswordEntry entry(
+            columnText(stmt, 1),
+            columnText(stmt, 2),
+            passwordSealed ? std::string() : columnText(stmt, 3),
+            static_cast<Category>(sqlite3_column_int(stmt, 4)),
+            columnText(stmt, 5),
+            notesSealed ? std::string() : columnText(stmt, 6)
+    );
+    if (passwordSealed) entry.setEncryptedPassword(columnBlob(stmt, 3), LazySecret::Encoding::RECORD);
+    if (notesSealed) entry.setEncryptedNotes(columnBlob(stmt, 6), LazySecret::Encoding::RECORD);
+    entry.setId(std::to_string(sqlite3_column_int64(stmt, 0)));
+    entry.setCreatedDate(static_cast<time_t>(sqlite3_column_int64(stmt, 7)));
+    entry.setModifiedDate(static_cast<time_t>(sqlite3_column_int64(stmt, 8)));
+    return entry;
+}
+
+bool DatabaseManager::execute(Statement which) {
+    sqlite3_stmt* stmt = statement(which);
+    if (!stmt) return false;
+    StatementScope scope(stmt);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "Database statement failed: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int64_t DatabaseManager::savePassword(const PasswordEntry& entry) {
+    sqlite3_stmt* stmt = statement(Statement::INSERT);
+    if (!stmt) return -1;
+    StatementScope scope(stmt);
+
+    bindEntry(stmt, entry);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "Failed to save password: " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
+    return static_cast<int64_t>(sqlite3_last_insert_rowid(db));
+}
+
+size_t DatabaseManager::savePasswords(const PasswordEntry* entries, size_t count,
+                                      const BatchOptions& options, std::vector<int64_t>* ids) {
+    if (ids) {
+        ids->clear();
+        ids->reserve(count);
+    }
+    if (count == 0 && !options.replaceExisting) return 0;
+
+    const Statement insertKind = options.keepIds ? Statement::INSERT_WITH_ID : Statement::INSERT;
+    sqlite3_stmt* stmt = statement(insertKind);
+    if (!stmt) return 0;
+
+    const size_t chunk = (options.chunkSize == 0 || options.replaceExisting) ? count : options.chunkSize;
+    size_t committed = 0;
+
+    do {
+        const size_t end = std::min(count, committed + chunk);
+
+        if (!execute(Statement::BEGIN)) break;
+
+        bool ok = !options.replaceExisting || execute(Statement::DELETE_ALL);
+        size_t written = committed;
+        for (; ok && written < end; ++written) {
+            StatementScope scope(stmt);
+            const PasswordEntry& entry = entries[written];
+
+            bindEntry(stmt, entry);
+            if (options.keepIds) {
+                int64_t id = parseRowId(entry.getId());
+                if (id < 0) {
+                    std::cerr << "Batch entry has no row id: " << entry.getTitle() << std::endl;
+                    ok = false;
+                    break;
+                }
+                sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(id));
+            }
+
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Failed to save password: " << sqlite3_errmsg(db) << std::endl;
+                ok = false;
+                break;
+            }
+            if (ids) ids->push_back(static_cast<int64_t>(sqlite3_last_insert_rowid(db)));
+        }
+
+        if (!ok || !execute(Statement::COMMIT)) {
+            execute(Statement::ROLLBACK);
+            if (ids) ids->resize(committed);
+            break;
+        }
+
+        committed = end;
+        if (options.progress) options.progress(committed, count);
+    } while (committed < count);
+
+    std::cout << "Saved " << committed << " of " << count << " passwords in batch" << std::endl;
+    return committed;
+}
+
+size_t DatabaseManager::savePasswords(const std::vector<PasswordEntry>& entries,
+                                      const BatchOptions& options, std::vector<int64_t>* ids) {
+    return savePasswords(entries.data(), entries.size(), options, ids);
+}
+
+bool DatabaseManager::updatePassword(const PasswordEntry& entry) {
+    int64_t id = parseRowId(entry.getId());
+    if (id < 0) return false;
+
+    sqlite3_stmt* stmt = statement(Statement::UPDATE);
+    if (!stmt) return false;
+    StatementScope scope(stmt);
+
+    bindEntry(stmt, entry);
+    sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(id));
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "Failed to update password: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return sqlite3_changes(db) > 0;
+}
+
+bool DatabaseManager::deletePassword(int64_t id) {
+    sqlite3_stmt* stmt = statement(Statement::DELETE_BY_ID);
+    if (!stmt) return false;
+    StatementScope scope(stmt);
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(id));
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "Failed to delete password: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return sqlite3_changes(db) > 0;
 }
 
 std::vector<PasswordEntry> DatabaseManager::getAllPasswords() {
+    PERF_SCOPE(PerfOp::VAULT_LOAD);
     std::vector<PasswordEntry> passwords;
-    const char* selectSQL = "SELECT * FROM passwords;";
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, selectSQL, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare select statement" << std::endl;
-        return passwords;
+    sqlite3_stmt* stmt = statement(Statement::SELECT_ALL);
+    if (!stmt) return passwords;
+    StatementScope scope(stmt);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        passwords.push_back(readRow(stmt));
     }
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to load passwords: " << sqlite3_errmsg(db) << std::endl;
+    }
+
+    std::cout << "Loaded " << passwords.size() << " passwords from database" << std::endl;
+    return passwords;
+}
+
+std::optional<PasswordEntry> DatabaseManager::getPasswordById(int64_t id) {
+    sqlite3_stmt* stmt = statement(Statement::SELECT_BY_ID);
+    if (!stmt) return std::nullopt;
+    StatementScope scope(stmt);
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(id));
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return std::nullopt;
+    return readRow(stmt);
+}
+
+std::vector<PasswordSummary> DatabaseManager::loadPage(size_t offset, size_t limit, PasswordSortKey sortKey) {
+    std::vector<PasswordSummary> page;
+    if (limit == 0) return page;
+
+    const size_t which = static_cast<size_t>(Statement::PAGE_BY_TITLE) + static_cast<size_t>(sortKey);
+    if (which > static_cast<size_t>(Statement::PAGE_BY_ID)) return page;
+
+    sqlite3_stmt* stmt = statement(static_cast<Statement>(which));
+    if (!stmt) return page;
+    StatementScope scope(stmt);
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        std::string id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        std::string title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string username = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string password = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(limit));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(offset));
+
+    page.reserve(limit);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        PasswordSummary summary;
+        summary.id = std::to_string(sqlite3_column_int64(stmt, 0));
+        summary.title = columnText(stmt, 1);
+        summary.username = columnText(stmt, 2);
+        summary.category = static_cast<Category>(sqlite3_column_int(stmt, 3));
+        summary.website = columnText(stmt, 4);
+        summary.modifiedDate = static_cast<time_t>(sqlite3_column_int64(stmt, 5));
+        page.push_back(std::move(summary));
+    }
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to load page: " << sqlite3_errmsg(db) << std::endl;
+    }
+    return page;
+}
+
+std::optional<PasswordSecrets> DatabaseManager::getSecretsById(int64_t id) {
+    sqlite3_stmt* stmt = statement(Statement::SELECT_SECRETS_BY_ID);
+    if (!stmt) return std::nullopt;
+    StatementScope scope(stmt);
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(id));
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return std::nullopt;
+
+    std::shared_ptr<const CipherContext> keys;
+    if (isBlob(stmt, 0) || isBlob(stmt, 1)) keys = CipherContext::current();
+    try {
+        return PasswordSecrets{columnSecret(stmt, 0, keys.get()), columnSecret(stmt, 1, keys.get())};
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to decrypt secrets: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+int64_t DatabaseManager::countPasswords() {
+    sqlite3_stmt* stmt = statement(Statement::COUNT_ALL);
+    if (!stmt) return -1;
+    StatementScope scope(stmt);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) return -1;
+    return static_cast<int64_t>(sqlite3_column_int64(stmt, 0));
+}
+
+int DatabaseManager::schemaVersion() {
+    sqlite3_stmt* stmt = nullptr;
+    int version = -1;
+    if (db && sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+bool DatabaseManager::needsRecordMigration() {
+    const int version = schemaVersion();
+    return version >= 0 && version < RECORD_SCHEMA_VERSION;
+}
 
-        PasswordEntry entry(title, username, password);
+size_t DatabaseManager::migrateRecords(int64_t& cursor, size_t batchSize) {
+    sqlite3_stmt* select = statement(Statement::SELECT_TEXT_RECORDS);
+    sqlite3_stmt* update = statement(Statement::UPDATE_SECRETS);
+    if (!select || !update || batchSize == 0) return 0;
 
-        // Set ID from database
-        // Note: You'll need to add setId method to PasswordEntry
+    struct Row {
+        int64_t id;
+        std::string records[2];   // Empty: column left as it is
+    };
+    std::vector<Row> rows;
+    rows.reserve(batchSize);
 
-        // Set optional fields if they exist
-        if (sqlite3_column_text(stmt, 4)) {
-            entry.setWebsite(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)));
+    // Read and rewrite under one write lock, so a concurrent save through
+    // another connection cannot slip in between and be overwritten
+    if (!execute(Statement::BEGIN)) return 0;
+    {
+        StatementScope scope(select);
+        sqlite3_bind_int64(select, 1, static_cast<sqlite3_int64>(cursor));
+        sqlite3_bind_int64(select, 2, static_cast<sqlite3_int64>(batchSize));
+        while (sqlite3_step(select) == SQLITE_ROW) {
+            Row row;
+            row.id = static_cast<int64_t>(sqlite3_column_int64(select, 0));
+            for (int i = 0; i < 2; ++i) {
+                if (!isBlob(select, i + 1)) row.records[i] = decodeRecord(columnText(select, i + 1));
+            }
+            rows.push_back(std::move(row));
         }
-        if (sqlite3_column_text(stmt, 5)) {
-            entry.setCategory(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5)));
+    }
+
+    bool ok = true;
+    for (const Row& row : rows) {
+        if (row.records[0].empty() && row.records[1].empty()) continue;   // Prefix only, not a record
+        StatementScope scope(update);
+        for (int i = 0; i < 2; ++i) {
+            const std::string& record = row.records[i];
+            if (!record.empty()) {
+                sqlite3_bind_blob(update, i + 1, record.data(), static_cast<int>(record.size()), SQLITE_STATIC);
+            }
+        }
+        sqlite3_bind_int64(update, 3, static_cast<sqlite3_int64>(row.id));
+        if (sqlite3_step(update) != SQLITE_DONE) {
+            std::cerr << "Failed to migrate record: " << sqlite3_errmsg(db) << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    if (ok && rows.empty()) {
+        // Stamped in the same transaction that found nothing left to convert
+        const std::string stamp = "PRAGMA user_version = " + std::to_string(RECORD_SCHEMA_VERSION) + ";";
+        ok = sqlite3_exec(db, stamp.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+    if (!ok || !execute(Statement::COMMIT)) {
+        std::cerr << "Record migration batch rolled back" << std::endl;
+        execute(Statement::ROLLBACK);
+        return 0;
+    }
+
+    if (!rows.empty()) cursor = rows.back().id;
+    return rows.size();
+}
+
+int64_t DatabaseManager::rekeyCheckpoint(uint64_t rotation) {
+    sqlite3_stmt* stmt = statement(Statement::SELECT_REKEY_STATE);
+    if (!stmt) return -1;
+    StatementScope scope(stmt);
+
+    const int step = sqlite3_step(stmt);
+    if (step == SQLITE_DONE) return 0;
+    if (step != SQLITE_ROW) return -1;
+    // A checkpoint from an earlier rotation says nothing about this one
+    if (static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)) != rotation) return 0;
+    return static_cast<int64_t>(sqlite3_column_int64(stmt, 1));
+}
+
+int64_t DatabaseManager::rekeyRecords(const CipherContext& keys, uint64_t rotation, int64_t& cursor,
+                                      size_t batchSize, RekeyTally* tally) {
+    sqlite3_stmt* select = statement(Statement::SELECT_SECRETS_AFTER);
+    sqlite3_stmt* update = statement(Statement::UPDATE_SECRETS);
+    sqlite3_stmt* save = statement(Statement::SAVE_REKEY_STATE);
+    sqlite3_stmt* journal = statement(Statement::JOURNAL_ENTRY);
+    if (!select || !update || !save || !journal || batchSize == 0) return -1;
+
+    struct Row {
+        int64_t id;
+        std::vector<uint8_t> records[2];   // Empty: column left as it is
+    };
+    std::vector<Row> rows;
+    rows.reserve(batchSize);
+    int64_t last = cursor;
+    int64_t examined = 0;
+    size_t unreadable = 0;
+
+    // Same single write transaction as migrateRecords: a save through the
+    // foreground connection cannot land between the read and the rewrite
+    if (!execute(Statement::BEGIN)) return -1;
+    {
+        StatementScope scope(select);
+        sqlite3_bind_int64(select, 1, static_cast<sqlite3_int64>(cursor));
+        sqlite3_bind_int64(select, 2, static_cast<sqlite3_int64>(batchSize));
+        while (sqlite3_step(select) == SQLITE_ROW) {
+            Row row;
+            row.id = last = static_cast<int64_t>(sqlite3_column_int64(select, 0));
+            ++examined;
+            bool changed = false;
+            for (int i = 0; i < 2; ++i) {
+                // Base64 records not yet converted by migrateRecords are re-keyed too
+                std::string converted;
+                const uint8_t* record;
+                size_t length;
+                if (isBlob(select, i + 1)) {
+                    record = static_cast<const uint8_t*>(sqlite3_column_blob(select, i + 1));
+                    length = static_cast<size_t>(sqlite3_column_bytes(select, i + 1));
+                } else {
+                    converted = decodeRecord(columnText(select, i + 1));
+                    record = reinterpret_cast<const uint8_t*>(converted.data());
+                    length = converted.size();
+                }
+                if (length == 0) continue;
+                try {
+                    changed |= keys.resealRecord(record, length, row.records[i]);
+                } catch (const std::exception&) {
+                    // No key opens it; leave it rather than stall the pass
+                    row.records[i].clear();
+                    ++unreadable;
+                }
+            }
+            if (changed) rows.push_back(std::move(row));
+        }
+    }
+
+    bool ok = true;
+    for (const Row& row : rows) {
+        StatementScope scope(update);
+        for (int i = 0; i < 2; ++i) {
+            const std::vector<uint8_t>& record = row.records[i];
+            if (!record.empty()) {
+                sqlite3_bind_blob(update, i + 1, record.data(), static_cast<int>(record.size()), SQLITE_STATIC);
+            }
         }
-        if (sqlite3_column_text(stmt, 6)) {
-            entry.setNotes(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)));
+        sqlite3_bind_int64(update, 3, static_cast<sqlite3_int64>(row.id));
+        if (sqlite3_step(update) != SQLITE_DONE) {
+            std::cerr << "Failed to re-key record: " << sqlite3_errmsg(db) << std::endl;
+            ok = false;
+            break;
         }
+        // Synced copies are still sealed under the keys being retired
+        StatementScope journalScope(journal);
+        sqlite3_bind_int64(journal, 1, static_cast<sqlite3_int64>(row.id));
+        if (sqlite3_step(journal) != SQLITE_DONE) {
+            std::cerr << "Failed to journal re-keyed record: " << sqlite3_errmsg(db) << std::endl;
+            ok = false;
+            break;
+        }
+    }
 
-        passwords.push_back(entry);
+    // The checkpoint commits with the rows it covers; the pass that finds
+    // nothing left drops it
+    if (ok && examined > 0) {
+        StatementScope scope(save);
+        sqlite3_bind_int64(save, 1, static_cast<sqlite3_int64>(rotation));
+        sqlite3_bind_int64(save, 2, static_cast<sqlite3_int64>(last));
+        ok = sqlite3_step(save) == SQLITE_DONE;
+    } else if (ok) {
+        ok = execute(Statement::CLEAR_REKEY_STATE);
+    }
+    if (!ok || !execute(Statement::COMMIT)) {
+        std::cerr << "Re-key batch rolled back" << std::endl;
+        execute(Statement::ROLLBACK);
+        return -1;
     }
 
+    cursor = last;
+    if (tally) {
+        tally->rewritten += rows.size();
+        tally->unreadable += unreadable;
+    }
+    return examined;
+}
+
+bool DatabaseManager::backupTo(const std::string& backupPath) {
+    if (!db) return false;
+
+    sqlite3* target = nullptr;
+    if (sqlite3_open(backupPath.c_str(), &target) != SQLITE_OK) {
+        std::cerr << "Cannot open backup file: " << (target ? sqlite3_errmsg(target) : backupPath) << std::endl;
+        sqlite3_close(target);
+        return false;
+    }
+
+    bool success = false;
+    sqlite3_backup* backup = sqlite3_backup_init(target, "main", db, "main");
+    if (backup) {
+        success = (sqlite3_backup_step(backup, -1) == SQLITE_DONE);
+        sqlite3_backup_finish(backup);
+    }
+    if (!success) {
+        std::cerr << "Backup failed: " << sqlite3_errmsg(target) << std::endl;
+    }
+
+    sqlite3_close(target);
+    return success;
+}
+
+bool DatabaseManager::restoreFrom(const std::string& backupPath, const BatchProgressFn& progress) {
+    if (!db) return false;
+
+    // Read the backup through its own read-only connection so the file is
+    // never modified, then write everything back through the batch path.
+    std::vector<PasswordEntry> entries;
+    sqlite3* source = nullptr;
+    if (sqlite3_open_v2(backupPath.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot open backup file: " << (source ? sqlite3_errmsg(source) : backupPath) << std::endl;
+        sqlite3_close(source);
+        return false;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    bool readOk = false;
+    if (sqlite3_prepare_v2(source, STATEMENT_SQL[static_cast<size_t>(Statement::SELECT_ALL)], -1, &stmt, nullptr) == SQLITE_OK) {
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            entries.push_back(readRow(stmt));
+        }
+        readOk = (rc == SQLITE_DONE);
+    }
+    if (!readOk) {
+        std::cerr << "Failed to read backup: " << sqlite3_errmsg(source) << std::endl;
+    }
     sqlite3_finalize(stmt);
-    std::cout << "Loaded " << passwords.size() << " passwords from database" << std::endl;
-    return passwords;
+    sqlite3_close(source);
+    if (!readOk) return false;
+
+    BatchOptions options;
+    options.keepIds = true;
+    options.replaceExisting = true;
+    options.progress = progress;
+    return savePasswords(entries, options) == entries.size();
+}
+
+bool DatabaseManager::forEachPassword(const std::function<bool(PasswordEntry&& entry)>& visit) {
+    sqlite3_stmt* stmt = statement(Statement::SELECT_ALL);
+    if (!stmt) return false;
+    StatementScope scope(stmt);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (!visit(readRow(stmt))) return false;
+    }
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to read passwords: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::replaceAllFrom(const BatchSource& next) {
+    sqlite3_stmt* stmt = statement(Statement::INSERT_WITH_ID);
+    if (!stmt || !execute(Statement::BEGIN)) return false;
+
+    bool ok = execute(Statement::DELETE_ALL);
+    size_t written = 0;
+    std::vector<PasswordEntry> batch;
+    while (ok) {
+        batch.clear();
+        if (!next(batch)) {
+            ok = false;
+            break;
+        }
+        if (batch.empty()) break;
+
+        for (const PasswordEntry& entry : batch) {
+            StatementScope scope(stmt);
+            int64_t id = parseRowId(entry.getId());
+            if (id < 0) {
+                std::cerr << "Restored entry has no row id: " << entry.getTitle() << std::endl;
+                ok = false;
+                break;
+            }
+            bindEntry(stmt, entry);
+            sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(id));
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Failed to restore password: " << sqlite3_errmsg(db) << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        written += batch.size();
+    }
+
+    if (!ok || !execute(Statement::COMMIT)) {
+        execute(Statement::ROLLBACK);
+        return false;
+    }
+    std::cout << "Restored " << written << " passwords" << std::endl;
+    return true;
+}
+
+int64_t DatabaseManager::queryInt(Statement which) {
+    sqlite3_stmt* stmt = statement(which);
+    if (!stmt) return -1;
+    StatementScope scope(stmt);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "Database query failed: " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
+    return static_cast<int64_t>(sqlite3_column_int64(stmt, 0));
+}
+
+bool DatabaseManager::changesSince(int64_t since, size_t limit, std::vector<JournalChange>& out) {
+    out.clear();
+    sqlite3_stmt* stmt = statement(Statement::SELECT_CHANGES);
+    if (!stmt) return false;
+    StatementScope scope(stmt);
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(since));
+    sqlite3_bind_int64(stmt, 2, limit ? static_cast<sqlite3_int64>(limit) : -1);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        JournalChange change;
+        change.seq = static_cast<int64_t>(sqlite3_column_int64(stmt, 9));
+        change.id = static_cast<int64_t>(sqlite3_column_int64(stmt, 10));
+        if (sqlite3_column_type(stmt, 0) != SQLITE_NULL) change.entry = readRow(stmt);
+        out.push_back(std::move(change));
+    }
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to read change journal: " << sqlite3_errmsg(db) << std::endl;
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+int64_t DatabaseManager::journalHead() {
+    return queryInt(Statement::JOURNAL_HEAD);
+}
+
+int64_t DatabaseManager::journalFloor() {
+    return queryInt(Statement::JOURNAL_FLOOR);
+}
+
+bool DatabaseManager::compactJournal(int64_t acknowledged) {
+    // The floor never passes the head: a sequence not yet handed out
+    // cannot have been acknowledged
+    const int64_t head = journalHead();
+    if (head < 0) return false;
+    acknowledged = std::min(acknowledged, head);
+
+    sqlite3_stmt* tombstones = statement(Statement::COMPACT_TOMBSTONES);
+    sqlite3_stmt* floor = statement(Statement::RAISE_JOURNAL_FLOOR);
+    if (!tombstones || !floor || !execute(Statement::BEGIN)) return false;
+
+    bool ok = execute(Statement::COMPACT_SUPERSEDED);
+    if (ok && acknowledged > 0) {
+        {
+            StatementScope scope(tombstones);
+            sqlite3_bind_int64(tombstones, 1, static_cast<sqlite3_int64>(acknowledged));
+            ok = sqlite3_step(tombstones) == SQLITE_DONE;
+        }
+        if (ok) {
+            StatementScope scope(floor);
+            sqlite3_bind_int64(floor, 1, static_cast<sqlite3_int64>(acknowledged));
+            ok = sqlite3_step(floor) == SQLITE_DONE;
+        }
+    }
+
+    if (!ok || !execute(Statement::COMMIT)) {
+        std::cerr << "Journal compaction rolled back: " << sqlite3_errmsg(db) << std::endl;
+        execute(Statement::ROLLBACK);
+        return false;
+    }
+    return true;
 }
 
 bool DatabaseManager::isDatabaseOpen() const {
@@ -132,4 +1049,4 @@ bool DatabaseManager::isDatabaseOpen() const {
 
 std::string DatabaseManager::getDatabasePath() const {
     return dbPath;
-}
\ No newline at end of file
+}
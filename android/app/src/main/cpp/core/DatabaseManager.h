@@ -1,35 +1,292 @@
 #ifndef DATABASEMANAGER_H
 #define DATABASEMANAGER_H
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <sqlite3.h>
 
-// Forward declaration
-class PasswordEntry;
+#include "../models/PasswordEntry.h"
 
+class CipherContext;
+
+/**
+ * @brief Tuning for DatabaseManager::savePasswords
+ *
+ * chunkSize bounds how much work one transaction holds (and how much is
+ * lost if a row fails); 0 writes everything in a single transaction.
+ * keepIds inserts with the entries' own row ids instead of allocating new
+ * ones. replaceExisting deletes every row first, in the same transaction
+ * as the inserts, so it always runs as a single chunk.
+ */
+struct DatabaseBatchOptions {
+    /** @brief Reports rows committed so far, after every chunk */
+    using ProgressFn = std::function<void(size_t done, size_t total)>;
+
+    /** @brief Rows written per transaction unless overridden */
+    static constexpr size_t DEFAULT_CHUNK = 500;
+
+    size_t chunkSize = DEFAULT_CHUNK;
+    bool keepIds = false;
+    bool replaceExisting = false;
+    ProgressFn progress;
+};
+
+/**
+ * @brief Latest journaled change of one entry, as returned by changesSince()
+ *
+ * `entry` is the row as it is now, with password and notes still sealed as
+ * stored; it is empty when the entry has since been deleted.
+ */
+struct JournalChange {
+    int64_t seq;
+    int64_t id;
+    std::optional<PasswordEntry> entry;
+};
+
+/** @brief Running totals of DatabaseManager::rekeyRecords over a pass */
+struct RekeyTally {
+    size_t rewritten = 0;
+    /** Records no key opens; left as they are */
+    size_t unreadable = 0;
+};
+
+/**
+ * @brief Sole owner of the vault's SQLite connection
+ *
+ * The connection is opened once, switched to WAL with tuned pragmas, and
+ * kept for the lifetime of the manager. Every statement the vault runs is
+ * prepared on first use and then reset and re-bound on later calls, so a
+ * save costs one step instead of open + prepare + step + finalize + close.
+ *
+ * Not thread-safe: the connection is opened without SQLite's internal
+ * mutex and the cached statements are shared, so callers must serialise
+ * access (PasswordManager owns one instance and is itself single-threaded).
+ */
 class DatabaseManager {
 private:
+    enum class Statement {
+        INSERT,
+        INSERT_WITH_ID,
+        UPDATE,
+        DELETE_BY_ID,
+        SELECT_BY_ID,
+        SELECT_ALL,
+        DELETE_ALL,
+        COUNT_ALL,
+        SELECT_SECRETS_BY_ID,
+        // One page query per PasswordSortKey, in enum order
+        PAGE_BY_TITLE,
+        PAGE_BY_USERNAME,
+        PAGE_BY_WEBSITE,
+        PAGE_BY_CATEGORY,
+        PAGE_BY_RECENTLY_MODIFIED,
+        PAGE_BY_ID,
+        BEGIN,
+        COMMIT,
+        ROLLBACK,
+        SELECT_TEXT_RECORDS,
+        UPDATE_SECRETS,
+        SELECT_CHANGES,
+        JOURNAL_HEAD,
+        JOURNAL_FLOOR,
+        COMPACT_SUPERSEDED,
+        COMPACT_TOMBSTONES,
+        RAISE_JOURNAL_FLOOR,
+        SELECT_SECRETS_AFTER,
+        SELECT_REKEY_STATE,
+        SAVE_REKEY_STATE,
+        CLEAR_REKEY_STATE,
+        JOURNAL_ENTRY,
+        COUNT
+    };
+
     sqlite3* db;
     std::string dbPath;
+    std::array<sqlite3_stmt*, static_cast<size_t>(Statement::COUNT)> statements;
 
     bool initializeDatabase();
+    bool configureConnection();
     bool createTables();
+    bool createIndexes();
+    bool createJournal();
+    void close();
+
+    /** @brief First column of a single-row query, or -1 on failure */
+    int64_t queryInt(Statement which);
+
+    /** @brief Cached prepared statement, compiled on first request */
+    sqlite3_stmt* statement(Statement which);
+
+    /** @brief Build an entry from the current row of a SELECT statement */
+    static PasswordEntry readRow(sqlite3_stmt* stmt);
+
+    /** @brief Step a cached statement that takes no bindings */
+    bool execute(Statement which);
+
+    /** @brief PRAGMA user_version, or -1 on failure */
+    int schemaVersion();
 
 public:
-    DatabaseManager(const std::string& databasePath);
+    /**
+     * @brief user_version from which secrets are stored as binary records
+     *
+     * GCM ciphertexts (SimpleAES record layout) go in password and notes
+     * as raw BLOBs: a third smaller than base64 TEXT and read back without
+     * a decode pass. SQLite columns are dynamically typed, so the TEXT
+     * declarations stay and older rows keep working until migrated.
+     */
+    static constexpr int RECORD_SCHEMA_VERSION = 1;
+
+    using BatchProgressFn = DatabaseBatchOptions::ProgressFn;
+    using BatchOptions = DatabaseBatchOptions;
+
+    explicit DatabaseManager(const std::string& databasePath);
     ~DatabaseManager();
 
+    DatabaseManager(const DatabaseManager&) = delete;
+    DatabaseManager& operator=(const DatabaseManager&) = delete;
+
     // Password operations
-    bool savePassword(const PasswordEntry& entry);
+
+    /** @brief Insert a new row; returns its id, or -1 on failure */
+    int64_t savePassword(const PasswordEntry& entry);
+    /**
+     * @brief Insert many rows through one bound statement, committing per chunk
+     *
+     * Stops at the first failing row; that row's chunk is rolled back and the
+     * chunks committed before it stay. Returns the number of rows committed.
+     * When `ids` is given it receives the row id of each committed entry.
+     */
+    size_t savePasswords(const PasswordEntry* entries, size_t count,
+                         const BatchOptions& options = BatchOptions(),
+                         std::vector<int64_t>* ids = nullptr);
+    size_t savePasswords(const std::vector<PasswordEntry>& entries,
+                         const BatchOptions& options = BatchOptions(),
+                         std::vector<int64_t>* ids = nullptr);
+
+    /** @brief Overwrite the row whose id matches entry.getId() */
     bool updatePassword(const PasswordEntry& entry);
-    bool deletePassword(const std::string& id);
+    bool deletePassword(int64_t id);
     std::vector<PasswordEntry> getAllPasswords();
-    PasswordEntry getPasswordById(const std::string& id);
+    std::optional<PasswordEntry> getPasswordById(int64_t id);
+
+    // Paged loading
+
+    /**
+     * @brief One page of list-view columns in the given order
+     *
+     * Only id, title, username, category, website and modified date are read,
+     * so a screenful costs a few hundred bytes per row however long the
+     * notes are. Title and recency orders are served from indexes.
+     */
+    std::vector<PasswordSummary> loadPage(size_t offset, size_t limit, PasswordSortKey sortKey);
+    /** @brief Password and notes of one entry */
+    std::optional<PasswordSecrets> getSecretsById(int64_t id);
+    /** @brief Number of rows, or -1 on failure */
+    int64_t countPasswords();
+
+    // Backup and restore
+
+    /** @brief Copy the live database to backupPath with the online backup API */
+    bool backupTo(const std::string& backupPath);
+    /** @brief Replace every row with the contents of a backup, in one transaction */
+    bool restoreFrom(const std::string& backupPath, const BatchProgressFn& progress = BatchProgressFn());
+
+    /** @brief Supplies the next rows to insert; false aborts, an empty batch ends the stream */
+    using BatchSource = std::function<bool(std::vector<PasswordEntry>& batch)>;
+
+    /**
+     * @brief Stream every row, in id order, without building the full list
+     *
+     * Stops early when `visit` returns false. Returns false if the query or
+     * the visitor failed.
+     */
+    bool forEachPassword(const std::function<bool(PasswordEntry&& entry)>& visit);
+    /**
+     * @brief Replace every row with the batches `next` produces, keeping their ids
+     *
+     * The delete and all inserts share one transaction, committed only once
+     * `next` reports the end with an empty batch. Any failure rolls back
+     * and leaves the old rows in place.
+     */
+    bool replaceAllFrom(const BatchSource& next);
+
+    // Binary record migration
+
+    /** @brief Whether base64 record TEXT values written before RECORD_SCHEMA_VERSION may remain */
+    bool needsRecordMigration();
+    /**
+     * @brief Convert the next batchSize rows after `cursor` that hold base64 records to BLOBs
+     *
+     * Each call is one short transaction, so foreground writes interleave
+     * between batches. Advances `cursor` to the last row id examined and
+     * returns the rows examined. Returns 0 once nothing is left (and stamps
+     * RECORD_SCHEMA_VERSION) or when the batch failed and was rolled back;
+     * needsRecordMigration() tells the two apart.
+     */
+    size_t migrateRecords(int64_t& cursor, size_t batchSize);
+
+    // Re-key after a master password change (see RekeyMigration, KeyRotation)
+
+    /** @brief Row id up to which `rotation` has re-keyed (0 to start over), or -1 on failure */
+    int64_t rekeyCheckpoint(uint64_t rotation);
+    /**
+     * @brief Re-seal the records of the next batchSize rows after `cursor` under keys.aes()
+     *
+     * `keys` must be the rotating context, so records under a retiring key
+     * still open. Records already under the new key are left alone, as are
+     * records no key opens. Rewritten rows are journaled, so changesSince()
+     * sends them again before the retiring keys are dropped. One transaction
+     * that also saves (rotation, cursor) as the checkpoint, and adds to
+     * `tally` once committed. Returns
+     * the rows examined; 0 means none are left and the checkpoint was
+     * dropped, -1 that the batch was rolled back.
+     */
+    int64_t rekeyRecords(const CipherContext& keys, uint64_t rotation, int64_t& cursor,
+                         size_t batchSize, RekeyTally* tally = nullptr);
+
+    // Change journal
+    //
+    // Triggers append (seq, entry id) to an append-only table on every
+    // insert, update and delete, whichever path made it, so the journal
+    // cannot drift from the rows. Sequence numbers come from AUTOINCREMENT
+    // and are never reused, compaction included. The background record
+    // migration only re-encodes secrets, so it is not journaled; the re-key
+    // journals each row it rewrites itself (see rekeyRecords).
+
+    /**
+     * @brief The latest change of each entry changed after `since`, in seq order
+     *
+     * At most `limit` changes, each read together with the current row.
+     * Returns false if the query failed.
+     */
+    bool changesSince(int64_t since, size_t limit, std::vector<JournalChange>& out);
+    /** @brief Highest sequence number handed out so far (0 before any change), or -1 on failure */
+    int64_t journalHead();
+    /**
+     * @brief Oldest `since` that still yields every change
+     *
+     * Compaction drops tombstones up to the acknowledged sequence. A reader
+     * whose `since` is below the floor may have missed deletions, so it
+     * must treat what it reads as a full snapshot. -1 on failure.
+     */
+    int64_t journalFloor();
+    /**
+     * @brief Shrink the journal to one row per live entry plus recent deletions
+     *
+     * Superseded changes are always dropped; no answer of changesSince
+     * depends on them. Tombstones of entries deleted up to `acknowledged`
+     * are dropped too, and the floor rises to it. One transaction.
+     */
+    bool compactJournal(int64_t acknowledged);
 
     // Utility methods
     bool isDatabaseOpen() const;
     std::string getDatabasePath() const;
 };
 
-#endif
\ No newline at end of file
+#endif
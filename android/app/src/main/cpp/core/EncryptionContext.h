@@ -14,20 +14,21 @@ public:
 
     explicit EncryptionContext(std::unique_ptr<IEncryptionStrategy> initialStrategy) 
         : strategy(std::move(initialStrategy)) {
-        if (strategy && strategy->requiresInitialization()) {
-            strategy->initialize();
+        if (strategy) {
+            prepare(*strategy);
         }
     }
 
+    /**
+     * @brief Initialize and validate once; encrypt()/decrypt() then skip validation
+     * @throws EncryptionException if the strategy is unusable (the old one is kept)
+     */
     void setStrategy(std::unique_ptr<IEncryptionStrategy> newStrategy) {
         if (!newStrategy) {
             throw std::invalid_argument("Strategy cannot be null");
         }
         
-        if (newStrategy->requiresInitialization()) {
-            newStrategy->initialize();
-        }
-        
+        prepare(*newStrategy);
         strategy = std::move(newStrategy);
     }
 
@@ -45,7 +46,6 @@ public:
         }
 
         try {
-            strategy->validate();
             return strategy->encrypt(plainText);
         } catch (const std::exception& e) {
             throw EncryptionException(std::string("Encryption failed: ") + e.what());
@@ -62,7 +62,6 @@ public:
         }
 
         try {
-            strategy->validate();
             return strategy->decrypt(cipherText);
         } catch (const std::exception& e) {
             throw EncryptionException(std::string("Decryption failed: ") + e.what());
@@ -83,6 +82,14 @@ public:
     }
 
     bool hasStrategy() const { return strategy != nullptr; }
+
+private:
+    static void prepare(IEncryptionStrategy& candidate) {
+        if (candidate.requiresInitialization()) {
+            candidate.initialize();
+        }
+        candidate.validate();
+    }
 };
 
 #endif // ENCRYPTIONCONTEXT_H
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "EntryStore.h"
+#include <utility>
+
+static constexpr size_t MIN_BUCKETS = 16;
+// Below this the pool is small enough that repacking gains nothing
+static constexpr size_t MIN_COMPACT_GARBAGE = 4096;
+
+EntryStore::Key EntryStore::keyFor(std::string_view id) {
+    if (id.empty() || id.size() > 19) return 0;
+    Key key = 0;
+    for (char c : id) {
+        if (c < '0' || c > '9') return 0;
+        key = key * 10 + static_cast<Key>(c - '0');
+    }
+    return key;
+}
+
+size_t EntryStore::hash(Key key) {
+    // splitmix64 finalizer: row ids are sequential, so spread them out
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+size_t EntryStore::findBucket(Key key) const {
+    if (table.empty() || key == 0) return NOT_FOUND;
+
+    const size_t mask = table.size() - 1;
+    for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+        if (table[i].key == key) return i;
+        if (table[i].key == 0) return NOT_FOUND;
+    }
+}
+
+void EntryStore::rehash(size_t bucketCount) {
+    std::vector<Bucket> fresh(bucketCount, Bucket{0, 0});
+    const size_t mask = bucketCount - 1;
+    for (uint32_t index = 0; index < keys.size(); ++index) {
+        size_t i = hash(keys[index]) & mask;
+        while (fresh[i].key != 0) i = (i + 1) & mask;
+        fresh[i] = Bucket{keys[index], index};
+    }
+    table.swap(fresh);
+}
+
+void EntryStore::reserve(size_t count) {
+    keys.reserve(count);
+    categories.reserve(count);
+    createdDates.reserve(count);
+    modifiedDates.reserve(count);
+    for (std::vector<Span>& column : spans) column.reserve(count);
+    cold.reserve(count);
+
+    size_t buckets = table.empty() ? MIN_BUCKETS : table.size();
+    while (count * 4 > buckets * 3) buckets *= 2;
+    if (buckets != table.size()) rehash(buckets);
+}
+
+void EntryStore::clear() {
+    keys.clear();
+    categories.clear();
+    createdDates.clear();
+    modifiedDates.clear();
+    for (std::vector<Span>& column : spans) column.clear();
+    pool.clear();
+    garbage = 0;
+    cold.clear();
+    table.clear();
+}
+
+EntryStore::Span EntryStore::pack(const std::string& value) {
+    const Span span{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(value.size())};
+    pool.append(value);
+    return span;
+}
+
+void EntryStore::store(size_t index, PasswordEntry&& entry) {
+    if (index == keys.size()) {
+        keys.push_back(0);
+        categories.push_back(0);
+        createdDates.push_back(0);
+        modifiedDates.push_back(0);
+        for (std::vector<Span>& column : spans) column.push_back(Span{0, 0});
+        cold.emplace_back(std::move(entry));
+    } else {
+        for (const std::vector<Span>& column : spans) garbage += column[index].length;
+        cold[index] = std::move(entry);
+    }
+
+    // The cold copy keeps everything but the pooled strings, which are
+    // released rather than left as empty allocations
+    PasswordEntry& rest = cold[index];
+    std::string* const hot[FIELD_COUNT] = {&rest.id, &rest.title, &rest.username, &rest.website};
+    for (size_t field = 0; field < FIELD_COUNT; ++field) {
+        spans[field][index] = pack(*hot[field]);
+        std::string().swap(*hot[field]);
+    }
+    categories[index] = static_cast<uint8_t>(rest.category);
+    createdDates[index] = rest.createdDate;
+    modifiedDates[index] = rest.modifiedDate;
+}
+
+void EntryStore::compactPool() {
+    if (garbage < MIN_COMPACT_GARBAGE || garbage * 2 < pool.size()) return;
+
+    std::string packed;
+    packed.reserve(pool.size() - garbage);
+    for (std::vector<Span>& column : spans) {
+        for (Span& span : column) {
+            const uint32_t offset = static_cast<uint32_t>(packed.size());
+            packed.append(pool, span.offset, span.length);
+            span.offset = offset;
+        }
+    }
+    pool.swap(packed);
+    garbage = 0;
+}
+
+void EntryStore::put(Key key, PasswordEntry entry) {
+    size_t bucket = findBucket(key);
+    if (bucket != NOT_FOUND) {
+        store(table[bucket].index, std::move(entry));
+        compactPool();
+        return;
+    }
+
+    if (table.empty() || (keys.size() + 1) * 4 > table.size() * 3) {
+        rehash(table.empty() ? MIN_BUCKETS : table.size() * 2);
+    }
+
+    const uint32_t index = static_cast<uint32_t>(keys.size());
+    store(index, std::move(entry));
+    keys[index] = key;
+
+    const size_t mask = table.size() - 1;
+    size_t i = hash(key) & mask;
+    while (table[i].key != 0) i = (i + 1) & mask;
+    table[i] = Bucket{key, index};
+}
+
+size_t EntryStore::indexOf(Key key) const {
+    size_t bucket = findBucket(key);
+    return bucket == NOT_FOUND ? NOT_FOUND : table[bucket].index;
+}
+
+void EntryStore::restoreHot(size_t index, PasswordEntry& out) const {
+    out.id.assign(text(index, ID));
+    out.title.assign(text(index, TITLE));
+    out.username.assign(text(index, USERNAME));
+    out.website.assign(text(index, WEBSITE));
+}
+
+void EntryStore::load(size_t index, PasswordEntry& out) const {
+    out = cold[index];
+    restoreHot(index, out);
+}
+
+PasswordEntry EntryStore::entry(size_t index) const {
+    PasswordEntry out(cold[index]);
+    restoreHot(index, out);
+    return out;
+}
+
+std::optional<PasswordEntry> EntryStore::find(Key key) const {
+    const size_t index = indexOf(key);
+    if (index == NOT_FOUND) return std::nullopt;
+    return entry(index);
+}
+
+std::vector<PasswordEntry> EntryStore::entries() const {
+    std::vector<PasswordEntry> out;
+    out.reserve(keys.size());
+    for (size_t index = 0; index < keys.size(); ++index) out.push_back(entry(index));
+    return out;
+}
+
+bool EntryStore::update(Key key, const PasswordEntry& entry) {
+    const size_t index = indexOf(key);
+    if (index == NOT_FOUND) return false;
+    store(index, PasswordEntry(entry));
+    compactPool();
+    return true;
+}
+
+bool EntryStore::erase(Key key) {
+    size_t hole = findBucket(key);
+    if (hole == NOT_FOUND) return false;
+
+    const uint32_t index = table[hole].index;
+    const uint32_t last = static_cast<uint32_t>(keys.size() - 1);
+
+    // Backward-shift: pull later members of the probe run into the hole
+    const size_t mask = table.size() - 1;
+    table[hole].key = 0;
+    for (size_t j = (hole + 1) & mask; table[j].key != 0; j = (j + 1) & mask) {
+        const size_t home = hash(table[j].key) & mask;
+        // Move j back unless its home lies cyclically in (hole, j]
+        const bool homeBetween = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!homeBetween) {
+            table[hole] = table[j];
+            table[j].key = 0;
+            hole = j;
+        }
+    }
+
+    // Keep the columns dense: the last row takes over the freed index
+    for (std::vector<Span>& column : spans) {
+        garbage += column[index].length;
+        column[index] = column[last];
+        column.pop_back();
+    }
+    if (index != last) {
+        keys[index] = keys[last];
+        categories[index] = categories[last];
+        createdDates[index] = createdDates[last];
+        modifiedDates[index] = modifiedDates[last];
+        cold[index] = std::move(cold[last]);
+        table[findBucket(keys[index])].index = index;
+    }
+    keys.pop_back();
+    categories.pop_back();
+    createdDates.pop_back();
+    modifiedDates.pop_back();
+    cold.pop_back();
+    compactPool();
+    return true;
+}
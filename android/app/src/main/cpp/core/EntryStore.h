@@ -0,0 +1,141 @@
+#ifndef ENTRYSTORE_H
+#define ENTRYSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../models/PasswordEntry.h"
+
+/**
+ * @brief Hot columns of one stored entry, viewed in place
+ *
+ * The views point into the store's string pool: valid until the next
+ * insert, update or erase.
+ */
+struct EntryRow {
+    std::string_view id;
+    std::string_view title;
+    std::string_view username;
+    std::string_view website;
+    Category category;
+    time_t createdDate;
+    time_t modifiedDate;
+};
+
+/**
+ * @brief In-memory entry store: hot/cold columns plus an open-addressing id map
+ *
+ * List rendering, search and filtering read a handful of fields, so those
+ * are stored column-wise: ids, titles, usernames and websites packed into
+ * one string pool addressed by (offset, length) per field, next to a
+ * category byte and timestamp columns. Password, notes and the rest of the
+ * entry live in a separate cold column, only touched when a full entry is
+ * asked for. Scanning a column of 100k entries reads a few MB, not every
+ * secret and note in the vault.
+ *
+ * A linear-probing table maps each 64-bit entry id (the database row id) to
+ * its row. Removal moves the last row into the hole and fixes its bucket,
+ * and the removed bucket is closed with backward-shift deletion, so lookup,
+ * insert, update and erase are all O(1) with no tombstones accumulating.
+ * Text replaced or erased stays in the pool until it is half garbage, then
+ * the pool is repacked.
+ *
+ * Row order is insertion order until the first erase; after that it is
+ * unspecified. Rows and views are invalidated by any insert, update or
+ * erase. Not thread-safe.
+ */
+class EntryStore {
+public:
+    using Key = uint64_t;   // 0 is reserved for empty buckets
+
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    /** @brief Key for a PasswordEntry id (decimal row id), or 0 if it is not one */
+    static Key keyFor(std::string_view id);
+
+    size_t size() const { return keys.size(); }
+    bool empty() const { return keys.empty(); }
+    void reserve(size_t count);
+    void clear();
+
+    /** @brief Insert, or replace the entry already stored under key (which must be non-zero) */
+    void put(Key key, PasswordEntry entry);
+    /** @brief Replace an existing entry; false when key is not stored */
+    bool update(Key key, const PasswordEntry& entry);
+    /** @brief Remove by moving the last row into its place */
+    bool erase(Key key);
+
+    /** @brief Row holding key, or NOT_FOUND */
+    size_t indexOf(Key key) const;
+    bool contains(Key key) const { return indexOf(key) != NOT_FOUND; }
+
+    /** @brief Hot columns of row `index` (< size()) */
+    EntryRow row(size_t index) const {
+        return EntryRow{text(index, ID), text(index, TITLE), text(index, USERNAME), text(index, WEBSITE),
+                        static_cast<Category>(categories[index]), createdDates[index], modifiedDates[index]};
+    }
+    Category category(size_t index) const { return static_cast<Category>(categories[index]); }
+
+    /**
+     * @brief Assemble the full entry of row `index` into `out`
+     *
+     * Reuses `out`'s string capacity, so a scan that loads every row into
+     * one scratch entry does not allocate per row.
+     */
+    void load(size_t index, PasswordEntry& out) const;
+    PasswordEntry entry(size_t index) const;
+    std::optional<PasswordEntry> find(Key key) const;
+    /** @brief Every entry, in row order */
+    std::vector<PasswordEntry> entries() const;
+
+private:
+    enum Field { ID, TITLE, USERNAME, WEBSITE, FIELD_COUNT };
+
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Bucket {
+        Key key;
+        uint32_t index;
+    };
+
+    // Hot columns, one element per row
+    std::vector<Key> keys;
+    std::vector<uint8_t> categories;
+    std::vector<time_t> createdDates;
+    std::vector<time_t> modifiedDates;
+    std::vector<Span> spans[FIELD_COUNT];
+    std::string pool;
+    size_t garbage = 0;   // Pool bytes no span refers to any more
+
+    // Cold column: the entry with its hot strings moved into the pool
+    std::vector<PasswordEntry> cold;
+
+    std::vector<Bucket> table;   // Power-of-two size, load kept under 3/4
+
+    std::string_view text(size_t index, Field field) const {
+        const Span span = spans[field][index];
+        return std::string_view(pool.data() + span.offset, span.length);
+    }
+
+    /** @brief Append `value` to the pool */
+    Span pack(const std::string& value);
+    /** @brief Move the hot fields of `entry` into row `index` (== size() appends) */
+    void store(size_t index, PasswordEntry&& entry);
+    /** @brief Copy the pooled strings of row `index` back into `out` */
+    void restoreHot(size_t index, PasswordEntry& out) const;
+    /** @brief Repack the pool once most of it is garbage */
+    void compactPool();
+
+    static size_t hash(Key key);
+    size_t findBucket(Key key) const;
+    void rehash(size_t bucketCount);
+};
+
+#endif // ENTRYSTORE_H
@@ -0,0 +1,106 @@
+#include "GHash.h"
+#include <cstring>
+
+// Reduction constants for shifting the accumulator right by 4 bits
+static const uint64_t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static inline uint64_t loadBE64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static inline void storeBE64(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+GHash::~GHash() {
+    volatile uint64_t* p = HL;
+    for (int i = 0; i < 16; i++) p[i] = 0;
+    p = HH;
+    for (int i = 0; i < 16; i++) p[i] = 0;
+}
+
+void GHash::setKey(const uint8_t h[16]) {
+    uint64_t vh = loadBE64(h);
+    uint64_t vl = loadBE64(h + 8);
+
+    // HL/HH[i] = i * H for the 4-bit values i, with bit order reflected
+    HL[8] = vl;
+    HH[8] = vh;
+    HL[0] = 0;
+    HH[0] = 0;
+
+    for (int i = 4; i > 0; i >>= 1) {
+        uint64_t t = (vl & 1) * 0xe1000000ULL;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ (t << 32);
+        HL[i] = vl;
+        HH[i] = vh;
+    }
+
+    for (int i = 2; i <= 8; i *= 2) {
+        vh = HH[i];
+        vl = HL[i];
+        for (int j = 1; j < i; j++) {
+            HH[i + j] = vh ^ HH[j];
+            HL[i + j] = vl ^ HL[j];
+        }
+    }
+}
+
+void GHash::multiply(uint8_t x[16]) const {
+    uint8_t lo = x[15] & 0xf;
+    uint64_t zh = HH[lo];
+    uint64_t zl = HL[lo];
+
+    for (int i = 15; i >= 0; i--) {
+        lo = x[i] & 0xf;
+        uint8_t hi = (x[i] >> 4) & 0xf;
+
+        if (i != 15) {
+            uint8_t rem = static_cast<uint8_t>(zl & 0xf);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (last4[rem] << 48);
+            zh ^= HH[lo];
+            zl ^= HL[lo];
+        }
+
+        uint8_t rem = static_cast<uint8_t>(zl & 0xf);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (last4[rem] << 48);
+        zh ^= HH[hi];
+        zl ^= HL[hi];
+    }
+
+    storeBE64(x, zh);
+    storeBE64(x + 8, zl);
+}
+
+void GHash::update(uint8_t y[16], const uint8_t* data, size_t length) const {
+    while (length >= 16) {
+        for (int i = 0; i < 16; i++) y[i] ^= data[i];
+        multiply(y);
+        data += 16;
+        length -= 16;
+    }
+    if (length > 0) {
+        for (size_t i = 0; i < length; i++) y[i] ^= data[i];
+        multiply(y);
+    }
+}
+
+void GHash::finish(uint8_t y[16], uint64_t aadLength, uint64_t dataLength) const {
+    uint8_t lengths[16];
+    storeBE64(lengths, aadLength * 8);
+    storeBE64(lengths + 8, dataLength * 8);
+    update(y, lengths, 16);
+}
@@ -0,0 +1,41 @@
+#ifndef GHASH_H
+#define GHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief GHASH universal hash for AES-GCM (NIST SP 800-38D)
+ *
+ * Uses Shoup's 4-bit multiplication tables, built once per hash key H.
+ * The tables are key material and are wiped by the destructor.
+ */
+class GHash {
+private:
+    uint64_t HL[16];
+    uint64_t HH[16];
+
+public:
+    GHash() = default;
+    explicit GHash(const uint8_t h[16]) { setKey(h); }
+    ~GHash();
+
+    void setKey(const uint8_t h[16]);
+
+    /**
+     * @brief Multiply a 128-bit block by H in GF(2^128), in place
+     */
+    void multiply(uint8_t x[16]) const;
+
+    /**
+     * @brief Absorb data into the running hash y, zero-padding the final block
+     */
+    void update(uint8_t y[16], const uint8_t* data, size_t length) const;
+
+    /**
+     * @brief Absorb the bit-length block len(A) || len(C)
+     */
+    void finish(uint8_t y[16], uint64_t aadLength, uint64_t dataLength) const;
+};
+
+#endif // GHASH_H
@@ -5,6 +5,9 @@
 #include <memory>
 #include <fstream>
 #include <stdexcept>
+#include <cstring>
+#include <vector>
+#include "Span.h"
 
 /**
  * @brief Custom exception hierarchy for encryption operations
@@ -46,6 +49,57 @@ public:
             throw EncryptionException("Strategy requires initialization before use");
         }
     }
+
+    // Buffer and batch forms. The defaults go through encrypt()/decrypt();
+    // strategies override them with allocation-free native paths.
+
+    /** @brief Upper bound on encryptInto() output for plainLength bytes; 0 if unknown */
+    virtual size_t maxEncryptedSize(size_t /* plainLength */) const { return 0; }
+    /** @brief Upper bound on decryptInto() output for cipherLength bytes; 0 if unknown */
+    virtual size_t maxDecryptedSize(size_t /* cipherLength */) const { return 0; }
+
+    /**
+     * @brief Encrypt into caller memory
+     * @return Bytes written
+     * @throws std::length_error if out is too small
+     */
+    virtual size_t encryptInto(ConstByteSpan plain, ByteSpan out) {
+        return copyOut(encrypt(std::string(reinterpret_cast<const char*>(plain.data()), plain.size())), out);
+    }
+
+    /**
+     * @brief Decrypt into caller memory
+     * @return Bytes written
+     * @throws std::length_error if out is too small
+     */
+    virtual size_t decryptInto(ConstByteSpan cipher, ByteSpan out) {
+        return copyOut(decrypt(std::string(reinterpret_cast<const char*>(cipher.data()), cipher.size())), out);
+    }
+
+    /** @brief encrypt() of every item through one virtual call; throws on the first failure */
+    virtual std::vector<std::string> encryptBatch(const std::vector<std::string>& plainTexts) {
+        std::vector<std::string> out;
+        out.reserve(plainTexts.size());
+        for (const std::string& plainText : plainTexts) out.push_back(encrypt(plainText));
+        return out;
+    }
+
+    /** @brief decrypt() of every item through one virtual call; throws on the first failure */
+    virtual std::vector<std::string> decryptBatch(const std::vector<std::string>& cipherTexts) {
+        std::vector<std::string> out;
+        out.reserve(cipherTexts.size());
+        for (const std::string& cipherText : cipherTexts) out.push_back(decrypt(cipherText));
+        return out;
+    }
+
+protected:
+    static size_t copyOut(const std::string& result, ByteSpan out) {
+        if (result.size() > out.size()) {
+            throw std::length_error("Output buffer too small");
+        }
+        if (!result.empty()) std::memcpy(out.data(), result.data(), result.size());
+        return result.size();
+    }
 };
 
 /**
@@ -0,0 +1,121 @@
+#include "JsonWriter.h"
+#include <utility>
+
+JsonWriter::JsonWriter(Sink sink, size_t flushThreshold)
+    : sink(std::move(sink)), flushThreshold(flushThreshold) {
+    buffer.reserve(flushThreshold + 256);
+}
+
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+void JsonWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (!hasElements.empty()) {
+        if (hasElements.back()) buffer.push_back(',');
+        hasElements.back() = true;
+    }
+}
+
+JsonWriter& JsonWriter::wrote() {
+    if (sink && buffer.size() >= flushThreshold) flush();
+    return *this;
+}
+
+JsonWriter& JsonWriter::open(char bracket) {
+    separate();
+    buffer.push_back(bracket);
+    hasElements.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::close(char bracket) {
+    buffer.push_back(bracket);
+    if (!hasElements.empty()) hasElements.pop_back();
+    return wrote();
+}
+
+JsonWriter& JsonWriter::beginObject() { return open('{'); }
+JsonWriter& JsonWriter::endObject() { return close('}'); }
+JsonWriter& JsonWriter::beginArray() { return open('['); }
+JsonWriter& JsonWriter::endArray() { return close(']'); }
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    buffer.push_back('"');
+    escapeInto(buffer, name);
+    buffer.append("\":", 2);
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separate();
+    buffer.push_back('"');
+    escapeInto(buffer, text);
+    buffer.push_back('"');
+    return wrote();
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    buffer.append(flag ? "true" : "false");
+    return wrote();
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    buffer.append("null", 4);
+    return wrote();
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json) {
+    separate();
+    buffer.append(json.data(), json.size());
+    return wrote();
+}
+
+void JsonWriter::flush() {
+    if (!sink || buffer.empty()) return;
+    sink(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+std::string JsonWriter::take() {
+    std::string out;
+    out.swap(buffer);
+    return out;
+}
+
+void JsonWriter::escapeInto(std::string& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+
+    // Copy clean runs in one append; only quotes, backslashes and control
+    // characters need rewriting. UTF-8 bytes pass through untouched.
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(text.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            default: {
+                const char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(escape, sizeof(escape));
+            }
+        }
+    }
+    out.append(text.data() + run, text.size() - run);
+}
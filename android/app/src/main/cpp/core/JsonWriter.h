@@ -0,0 +1,91 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Minimal streaming JSON writer over a single growing buffer
+ *
+ * Tracks commas and nesting itself, escapes every string, and formats
+ * integers with std::to_chars (no locale, no stream). Without a sink the
+ * whole document accumulates for str()/take(). With a sink the buffer is
+ * handed over each time it passes the flush threshold, so memory stays
+ * bounded by one chunk however large the document is.
+ *
+ * The writer does not validate structure beyond comma placement; callers
+ * pair begin/end calls and put a key() before every object member.
+ */
+class JsonWriter {
+public:
+    using Sink = std::function<void(const char* data, size_t size)>;
+
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 64 * 1024;
+
+    JsonWriter() = default;
+    explicit JsonWriter(Sink sink, size_t flushThreshold = DEFAULT_FLUSH_THRESHOLD);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(bool flag);
+    JsonWriter& null();
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                  !std::is_same<T, bool>::value, int>::type = 0>
+    JsonWriter& value(T number) {
+        separate();
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        buffer.append(digits, static_cast<size_t>(result.ptr - digits));
+        return wrote();
+    }
+
+    /** @brief key(name) followed by value(v) */
+    template <typename T>
+    JsonWriter& member(std::string_view name, const T& v) { return key(name).value(v); }
+
+    /** @brief Append an already-serialised JSON value as the next element */
+    JsonWriter& raw(std::string_view json);
+
+    /** @brief Hand buffered output to the sink (no-op without one) */
+    void flush();
+
+    const std::string& str() const { return buffer; }
+    std::string take();
+    void reserve(size_t bytes) { buffer.reserve(bytes); }
+
+    /** @brief Append `text` to `out` with JSON string escaping (no quotes) */
+    static void escapeInto(std::string& out, std::string_view text);
+
+private:
+    std::string buffer;
+    Sink sink;
+    size_t flushThreshold = 0;
+    // One flag per open container: has it had an element yet?
+    std::vector<bool> hasElements;
+    bool afterKey = false;
+
+    void separate();
+    JsonWriter& wrote();
+    JsonWriter& open(char bracket);
+    JsonWriter& close(char bracket);
+};
+
+#endif // JSONWRITER_H
@@ -0,0 +1,225 @@
+#include "KeyRotation.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr char MAGIC[4] = {'S', 'F', 'R', 'K'};
+constexpr uint8_t VERSION = 2;
+constexpr size_t HEADER_SIZE = 16;
+
+std::mutex g_mutex;   // Serialises every state file operation
+std::string g_path = "/data/data/com.example.last_final/key_rotation.bin";
+
+inline void storeLE(uint8_t* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline uint64_t loadLE(const uint8_t* p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= uint64_t(p[i]) << (8 * i);
+    return v;
+}
+
+struct State {
+    uint64_t rotation = 0;
+    uint8_t required = 0;
+    uint8_t confirmed = 0;
+    std::vector<uint8_t> record;   // Sealed retiring material
+};
+
+// Caller holds g_mutex. False when there is no (well-formed) state file
+bool readState(State& state) {
+    const int fd = ::open(g_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[512];
+    ssize_t n;
+    while ((n = ::read(fd, buffer, sizeof(buffer))) > 0 || (n < 0 && errno == EINTR)) {
+        if (n > 0) data.insert(data.end(), buffer, buffer + n);
+    }
+    ::close(fd);
+
+    if (n < 0 || data.size() <= HEADER_SIZE || std::memcmp(data.data(), MAGIC, 4) != 0 || data[4] != VERSION) {
+        std::cerr << "Ignoring malformed key rotation state " << g_path << std::endl;
+        return false;
+    }
+    state.rotation = loadLE(data.data() + 8, 8);
+    state.required = data[5];
+    state.confirmed = data[6];
+    state.record.assign(data.begin() + HEADER_SIZE, data.end());
+    return state.rotation != 0;
+}
+
+// Caller holds g_mutex. Written to a temporary file, synced, then renamed
+// over the old state so a crash leaves either the old or the new file
+bool writeState(const State& state) {
+    std::vector<uint8_t> data(HEADER_SIZE, 0);
+    std::memcpy(data.data(), MAGIC, 4);
+    data[4] = VERSION;
+    data[5] = state.required;
+    data[6] = state.confirmed;
+    storeLE(data.data() + 8, state.rotation, 8);
+    data.insert(data.end(), state.record.begin(), state.record.end());
+
+    const std::string temp = g_path + ".tmp";
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        std::cerr << "Cannot write key rotation state: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        written += static_cast<size_t>(n);
+    }
+    const bool synced = written == data.size() && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || std::rename(temp.c_str(), g_path.c_str()) != 0) {
+        std::cerr << "Cannot write key rotation state: " << std::strerror(errno) << std::endl;
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    // The rename itself is only durable once the directory is synced
+    const size_t slash = g_path.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : g_path.substr(0, slash == 0 ? 1 : slash);
+    const int dirFd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+// Retiring material sealed in `state`, opened with `keys`; empty when it does not open
+SecureBuffer openState(const State& state, const CipherContext& keys) {
+    const size_t length = state.record.size();
+    SecureBuffer material(length > SimpleAES::RECORD_OVERHEAD ? length - SimpleAES::RECORD_OVERHEAD : 0);
+    try {
+        material.resize(keys.aes().decryptRecord(state.record.data(), length, material.data(), material.size()));
+    } catch (const std::exception&) {
+        return SecureBuffer();
+    }
+    if (material.empty() || material.size() % KeyRotation::MATERIAL_SIZE != 0) return SecureBuffer();
+    return material;
+}
+
+std::unique_ptr<const SimpleAES> keyAt(const uint8_t* material) {
+    return std::unique_ptr<const SimpleAES>(new SimpleAES(material, material + 32));
+}
+
+// A legacy half that repeats the primary one stands for "no separate legacy key"
+std::unique_ptr<const SimpleAES> legacyKeyAt(const uint8_t* generation) {
+    const uint8_t* legacy = generation + KeyRotation::MATERIAL_SIZE / 2;
+    if (std::memcmp(generation, legacy, KeyRotation::MATERIAL_SIZE / 2) == 0) return nullptr;
+    return keyAt(legacy);
+}
+
+// Generations newest first -> one context chained through retiring()
+std::shared_ptr<const CipherContext> chainFrom(const SecureBuffer& material) {
+    std::shared_ptr<const CipherContext> chain;
+    for (size_t offset = material.size(); offset > 0; offset -= KeyRotation::MATERIAL_SIZE) {
+        const uint8_t* generation = material.data() + offset - KeyRotation::MATERIAL_SIZE;
+        CipherContext keys(keyAt(generation), legacyKeyAt(generation));
+        chain = std::make_shared<const CipherContext>(keys, chain);
+    }
+    return chain;
+}
+
+} // namespace
+
+uint8_t KeyRotation::stores() {
+#ifdef SECUREFLOW_JNI_BRIDGE
+    return STORE_VAULT | STORE_CALLER;
+#else
+    return STORE_CALLER;
+#endif
+}
+
+void KeyRotation::setPath(std::string path) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_path = std::move(path);
+}
+
+std::shared_ptr<const CipherContext> KeyRotation::begin(const std::shared_ptr<const CipherContext>& current,
+                                                       const SecureBuffer& currentMaterial,
+                                                       const std::shared_ptr<const CipherContext>& next) {
+    if (!current || !next || currentMaterial.size() != MATERIAL_SIZE) return nullptr;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    SecureBuffer retiring(currentMaterial.begin(), currentMaterial.end());
+    State state;
+    if (readState(state)) {
+        // Still re-keying from an earlier change: those generations stay readable
+        SecureBuffer older = openState(state, *current);
+        retiring.insert(retiring.end(), older.begin(), older.end());
+    }
+    if (retiring.size() / MATERIAL_SIZE > MAX_GENERATIONS) {
+        std::cerr << "Too many password changes pending re-encryption" << std::endl;
+        return nullptr;
+    }
+
+    do {
+        std::vector<uint8_t> id = SimpleAES::generateRandomBytes(8);
+        state.rotation = loadLE(id.data(), 8);
+    } while (state.rotation == 0);
+    // Confirmations of an earlier rotation do not cover the new keys' generation
+    state.required = stores();
+    state.confirmed = 0;
+    state.record.resize(SimpleAES::recordSize(retiring.size()));
+    next->aes().encryptRecord(retiring.data(), retiring.size(), state.record.data(), state.record.size());
+    if (!writeState(state)) return nullptr;
+
+    return std::make_shared<const CipherContext>(*next, chainFrom(retiring));
+}
+
+std::shared_ptr<const CipherContext> KeyRotation::resume(const std::shared_ptr<const CipherContext>& keys) {
+    if (!keys || keys->isRotating()) return keys;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    State state;
+    if (!readState(state)) return keys;
+    SecureBuffer retiring = openState(state, *keys);
+    if (retiring.empty()) {
+        std::cerr << "Key rotation state does not open under the current keys" << std::endl;
+        return keys;
+    }
+    return std::make_shared<const CipherContext>(*keys, chainFrom(retiring));
+}
+
+uint64_t KeyRotation::pending() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    State state;
+    return readState(state) ? state.rotation : 0;
+}
+
+KeyRotation::Confirmation KeyRotation::confirm(uint64_t rotation, Store store,
+                                               const std::shared_ptr<const CipherContext>& keys) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    State state;
+    if (!readState(state) || state.rotation != rotation) return Confirmation::STALE;
+
+    state.confirmed |= store;
+    if ((state.confirmed & state.required) != state.required) {
+        // Persisted, so a store that finished before a restart is not waited on again
+        return writeState(state) ? Confirmation::WAITING : Confirmation::STALE;
+    }
+    if (std::remove(g_path.c_str()) != 0) {
+        std::cerr << "Cannot remove key rotation state: " << std::strerror(errno) << std::endl;
+        return Confirmation::STALE;
+    }
+    if (keys && keys->isRotating()) {
+        CipherContext::replace(keys, std::make_shared<const CipherContext>(*keys, nullptr));
+    }
+    return Confirmation::FINISHED;
+}
@@ -0,0 +1,93 @@
+#ifndef KEYROTATION_H
+#define KEYROTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "CipherContext.h"
+#include "SecureArena.h"
+
+/**
+ * @brief Persistent state of a master password change that is still re-keying
+ *
+ * Changing the password must not strand ciphertexts under the old key, and
+ * a re-encryption pass can be interrupted at any point. begin() therefore
+ * writes the retiring key material, sealed under the new primary key, to a
+ * state file before the new keys are published: only the new password can
+ * reopen it, and after process death resume() rebuilds the rotating
+ * context from it as soon as the new keys are back.
+ *
+ * Every store that holds ciphertexts confirms the rotation once nothing it
+ * holds needs the old keys: the vault through its re-key engine, callers of
+ * the FFI ciphertext API after resealing what they keep. The rotation
+ * ends, and the file is deleted, only once all of them have.
+ *
+ * File layout (little-endian):
+ *   [0..3] magic "SFRK"  [4] version  [5] stores that must confirm
+ *   [6] stores that have confirmed  [7] reserved  [8..15] rotation id
+ *   [16..] GCM record (SimpleAES::encryptRecord) holding MATERIAL_SIZE
+ *          bytes per retiring generation, newest first
+ *
+ * A change while a rotation is pending chains the generations, up to
+ * MAX_GENERATIONS. All members are thread-safe.
+ */
+class KeyRotation {
+public:
+    /** @brief Primary then legacy key material, 32-byte key + 16-byte IV each (as the FFI derives it) */
+    static constexpr size_t MATERIAL_SIZE = 96;
+    static constexpr size_t MAX_GENERATIONS = 4;
+
+    /** @brief Holders of ciphertexts, as a bit mask */
+    enum Store : uint8_t {
+        STORE_VAULT = 0x01,   // The SQLite vault (RekeyMigration); JNI builds only
+        STORE_CALLER = 0x02   // Ciphertexts handed out through the FFI
+    };
+    /** @brief Stores present in this build: begin() requires each of them to confirm */
+    static uint8_t stores();
+
+    enum class Confirmation {
+        STALE,      // `rotation` is not the pending one (any more)
+        WAITING,    // Recorded; other stores have yet to confirm
+        FINISHED    // Recorded, and it was the last: the rotation ended
+    };
+
+    /** @brief Location of the state file; set once at startup */
+    static void setPath(std::string path);
+
+    /**
+     * @brief Record a rotation from `current` to `next` and return the context to publish
+     *
+     * `currentMaterial` is the key material behind `current`. Generations
+     * still pending in the state file are carried over. Returns nullptr
+     * (and publishes nothing) when the state could not be written durably
+     * or the chain would exceed MAX_GENERATIONS.
+     */
+    static std::shared_ptr<const CipherContext> begin(const std::shared_ptr<const CipherContext>& current,
+                                                      const SecureBuffer& currentMaterial,
+                                                      const std::shared_ptr<const CipherContext>& next);
+
+    /**
+     * @brief `keys` plus the pending retiring generations, if a rotation is pending
+     *
+     * Returns `keys` itself when nothing is pending, when it is already
+     * rotating or when the state does not open under its primary key.
+     * Does not publish.
+     */
+    static std::shared_ptr<const CipherContext> resume(const std::shared_ptr<const CipherContext>& keys);
+
+    /** @brief Id of the pending rotation, or 0 when none is */
+    static uint64_t pending();
+
+    /**
+     * @brief `store` holds nothing under the retiring keys of `rotation` any more
+     *
+     * Persisted, and idempotent. Once every required store has confirmed,
+     * the state is deleted and `keys` is published without its retiring
+     * chain. Ignored when a different rotation is pending by now (a newer
+     * password change).
+     */
+    static Confirmation confirm(uint64_t rotation, Store store, const std::shared_ptr<const CipherContext>& keys);
+};
+
+#endif // KEYROTATION_H
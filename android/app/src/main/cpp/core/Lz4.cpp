@@ -0,0 +1,177 @@
+#include "Lz4.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;    // The block always ends in this many literals
+constexpr size_t MATCH_FINDER_LIMIT = 12;   // No match may start later than this before the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hashOf(uint32_t sequence, unsigned hashLog) {
+    return (sequence * 2654435761u) >> (32 - hashLog);
+}
+
+// Length fields: 15 in the token nibble, then 255-valued bytes and a remainder
+inline bool putLength(uint8_t*& op, const uint8_t* end, size_t length) {
+    for (; length >= 255; length -= 255) {
+        if (op >= end) return false;
+        *op++ = 255;
+    }
+    if (op >= end) return false;
+    *op++ = static_cast<uint8_t>(length);
+    return true;
+}
+
+inline bool getLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/**
+ * Emit one sequence: `literals` bytes from `literal`, then a match of
+ * `matchLength` at `offset` (matchLength 0: final literal-only sequence)
+ */
+bool putSequence(uint8_t*& op, const uint8_t* end, const uint8_t* literal, size_t literals,
+                 size_t offset, size_t matchLength) {
+    if (op >= end) return false;
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15 && !putLength(op, end, literals - 15)) return false;
+    if (static_cast<size_t>(end - op) < literals) return false;
+    if (literals > 0) std::memcpy(op, literal, literals);
+    op += literals;
+    if (matchLength == 0) return true;
+
+    if (end - op < 2) return false;
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    const size_t code = matchLength - MIN_MATCH;
+    *token |= static_cast<uint8_t>(code < 15 ? code : 15);
+    return code < 15 || putLength(op, end, code - 15);
+}
+
+} // namespace
+
+size_t Lz4::compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity,
+                     const uint8_t* dictionary, size_t dictionaryLength) {
+    if (dictionaryLength > MAX_OFFSET) {
+        dictionary += dictionaryLength - MAX_OFFSET;
+        dictionaryLength = MAX_OFFSET;
+    }
+    // Positions address the dictionary followed by the input, as one buffer
+    std::vector<uint8_t> joined;
+    const uint8_t* base = in;
+    if (dictionaryLength > 0) {
+        joined.reserve(dictionaryLength + length);
+        joined.assign(dictionary, dictionary + dictionaryLength);
+        joined.insert(joined.end(), in, in + length);
+        base = joined.data();
+    }
+    const size_t start = dictionaryLength;
+    const size_t end = start + length;
+
+    uint8_t* op = out;
+    uint8_t* const outEnd = out + capacity;
+    size_t anchor = start;
+
+    if (length > MATCH_FINDER_LIMIT) {
+        // Small inputs get a small table: clearing it is part of the cost
+        const unsigned hashLog = end < 4096 ? 10 : (end < 65536 ? 12 : 14);
+        std::vector<uint32_t> table(size_t(1) << hashLog, NO_POSITION);
+        for (size_t p = 0; p + MIN_MATCH <= start; ++p) {
+            table[hashOf(read32(base + p), hashLog)] = static_cast<uint32_t>(p);
+        }
+
+        const size_t limit = end - MATCH_FINDER_LIMIT;
+        const size_t matchLimit = end - LAST_LITERALS;
+        size_t ip = start;
+        size_t misses = 0;
+        while (ip < limit) {
+            const uint32_t sequence = read32(base + ip);
+            const uint32_t h = hashOf(sequence, hashLog);
+            const uint32_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+            if (candidate == NO_POSITION || ip - candidate > MAX_OFFSET || read32(base + candidate) != sequence) {
+                ip += 1 + (misses++ >> 6);   // Incompressible stretches are crossed quickly
+                continue;
+            }
+            misses = 0;
+
+            size_t match = candidate;
+            while (ip > anchor && match > 0 && base[ip - 1] == base[match - 1]) {
+                --ip;
+                --match;
+            }
+            size_t matchLength = MIN_MATCH;
+            while (ip + matchLength < matchLimit && base[match + matchLength] == base[ip + matchLength]) {
+                ++matchLength;
+            }
+
+            if (!putSequence(op, outEnd, base + anchor, ip - anchor, ip - match, matchLength)) return 0;
+            ip += matchLength;
+            anchor = ip;
+            if (ip < limit) table[hashOf(read32(base + ip - 2), hashLog)] = static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    if (!putSequence(op, outEnd, base + anchor, end - anchor, 0, 0)) return 0;
+    return static_cast<size_t>(op - out);
+}
+
+bool Lz4::decompress(const uint8_t* in, size_t inLength, uint8_t* out, size_t length,
+                     const uint8_t* dictionary, size_t dictionaryLength) {
+    const uint8_t* ip = in;
+    const uint8_t* const inEnd = in + inLength;
+    size_t op = 0;
+
+    for (;;) {
+        if (ip >= inEnd) return false;
+        const uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !getLength(ip, inEnd, literals)) return false;
+        if (literals > static_cast<size_t>(inEnd - ip) || literals > length - op) return false;
+        if (literals > 0) std::memcpy(out + op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == inEnd) break;   // The last sequence has no match
+
+        if (inEnd - ip < 2) return false;
+        const size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !getLength(ip, inEnd, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > op + dictionaryLength || matchLength > length - op) return false;
+
+        if (offset > op) {
+            // Starts in the dictionary, possibly running on into the output
+            const size_t back = offset - op;
+            const size_t fromDictionary = back < matchLength ? back : matchLength;
+            std::memcpy(out + op, dictionary + dictionaryLength - back, fromDictionary);
+            op += fromDictionary;
+            matchLength -= fromDictionary;
+            for (size_t i = 0; i < matchLength; ++i, ++op) out[op] = out[op - offset];
+        } else if (offset >= matchLength) {
+            std::memcpy(out + op, out + op - offset, matchLength);
+            op += matchLength;
+        } else {
+            for (size_t i = 0; i < matchLength; ++i, ++op) out[op] = out[op - offset];   // Overlapping run
+        }
+    }
+    return op == length;
+}
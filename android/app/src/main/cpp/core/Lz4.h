@@ -0,0 +1,44 @@
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief LZ4 block format codec, with an optional preset dictionary
+ *
+ * Produces and reads standard LZ4 blocks (sequences of token, literals,
+ * 16-bit offset, match length), so any LZ4 block decoder can inspect the
+ * output. The compressor is the greedy single-probe hash of the reference
+ * "fast" mode, skipping ahead faster the longer it goes without a match.
+ *
+ * A dictionary acts as data preceding the block: matches may reach back
+ * into its last 64 KiB. Short inputs gain the most from it, since they
+ * rarely repeat themselves but often repeat common text. Compressor and
+ * decompressor must be given the same dictionary.
+ *
+ * The decompressor is bounds-checked against both buffers and rejects
+ * malformed blocks, so it is safe on untrusted input. Stateless and
+ * thread-safe.
+ */
+class Lz4 {
+public:
+    /** @brief Largest block compress() can produce for `length` input bytes */
+    static size_t compressBound(size_t length) { return length + length / 255 + 16; }
+
+    /**
+     * @brief Compress `length` bytes into `out`
+     * @return Block size, or 0 when it does not fit in `capacity`
+     */
+    static size_t compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity,
+                           const uint8_t* dictionary = nullptr, size_t dictionaryLength = 0);
+
+    /**
+     * @brief Decompress a block that must expand to exactly `length` bytes
+     * @return false when the block is malformed or does not match `length`
+     */
+    static bool decompress(const uint8_t* in, size_t inLength, uint8_t* out, size_t length,
+                           const uint8_t* dictionary = nullptr, size_t dictionaryLength = 0);
+};
+
+#endif // LZ4_H
@@ -1,5 +1,17 @@
 #include "NoEncryptionStrategy.h"
 
+namespace {
+
+size_t copyBytes(ConstByteSpan in, ByteSpan out) {
+    if (in.size() > out.size()) {
+        throw std::length_error("Output buffer too small");
+    }
+    if (!in.empty()) std::memcpy(out.data(), in.data(), in.size());
+    return in.size();
+}
+
+} // namespace
+
 std::string NoEncryptionStrategy::encrypt(const std::string& plainText) {
     // Passthrough - no encryption
     return plainText;
@@ -21,3 +33,19 @@ bool NoEncryptionStrategy::requiresInitialization() const {
 int NoEncryptionStrategy::getKeyStrength() const {
     return 0; // No encryption = no key
 }
+
+size_t NoEncryptionStrategy::encryptInto(ConstByteSpan plain, ByteSpan out) {
+    return copyBytes(plain, out);
+}
+
+size_t NoEncryptionStrategy::decryptInto(ConstByteSpan cipher, ByteSpan out) {
+    return copyBytes(cipher, out);
+}
+
+std::vector<std::string> NoEncryptionStrategy::encryptBatch(const std::vector<std::string>& plainTexts) {
+    return plainTexts;
+}
+
+std::vector<std::string> NoEncryptionStrategy::decryptBatch(const std::vector<std::string>& cipherTexts) {
+    return cipherTexts;
+}
@@ -25,6 +25,14 @@ public:
     std::string getAlgorithmName() const override;
     bool requiresInitialization() const override;
     int getKeyStrength() const override;
+
+    // Buffer and batch forms: plain copies, no temporaries
+    size_t maxEncryptedSize(size_t plainLength) const override { return plainLength; }
+    size_t maxDecryptedSize(size_t cipherLength) const override { return cipherLength; }
+    size_t encryptInto(ConstByteSpan plain, ByteSpan out) override;
+    size_t decryptInto(ConstByteSpan cipher, ByteSpan out) override;
+    std::vector<std::string> encryptBatch(const std::vector<std::string>& plainTexts) override;
+    std::vector<std::string> decryptBatch(const std::vector<std::string>& cipherTexts) override;
 };
 
 #endif // NOENCRYPTIONSTRATEGY_H
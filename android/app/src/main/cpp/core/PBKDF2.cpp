@@ -0,0 +1,192 @@
+#include "PBKDF2.h"
+#include "PerfTrace.h"
+#include "SHA256.h"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+static inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+/**
+ * HMAC-SHA256 keyed state: compression state after absorbing key^ipad and
+ * key^opad. Every HMAC over it then costs one block per 64 bytes of message
+ * plus one for the outer hash.
+ */
+struct HmacKey {
+    uint32_t inner[8];
+    uint32_t outer[8];
+
+    HmacKey(const char* password, size_t length) {
+        uint8_t key[SHA256::BLOCK_SIZE] = {0};
+        if (length > SHA256::BLOCK_SIZE) {
+            SHA256::hash(reinterpret_cast<const uint8_t*>(password), length, key);
+        } else if (length > 0) {
+            std::memcpy(key, password, length);
+        }
+
+        uint8_t pad[SHA256::BLOCK_SIZE];
+        for (size_t i = 0; i < SHA256::BLOCK_SIZE; i++) pad[i] = key[i] ^ 0x36;
+        std::memcpy(inner, SHA256::IV, sizeof(inner));
+        SHA256::compress(inner, pad, 1);
+
+        for (size_t i = 0; i < SHA256::BLOCK_SIZE; i++) pad[i] = key[i] ^ 0x5c;
+        std::memcpy(outer, SHA256::IV, sizeof(outer));
+        SHA256::compress(outer, pad, 1);
+
+        secureWipe(key, sizeof(key));
+        secureWipe(pad, sizeof(pad));
+    }
+
+    ~HmacKey() {
+        secureWipe(inner, sizeof(inner));
+        secureWipe(outer, sizeof(outer));
+    }
+};
+
+// Finalise a hash whose state already covers one 64-byte block and whose
+// remaining message is a 32-byte digest: the padded block is fixed-format
+static inline void finishDigestBlock(const uint32_t start[8], uint8_t block[64], uint8_t out[32]) {
+    uint32_t state[8];
+    std::memcpy(state, start, sizeof(state));
+    SHA256::compress(state, block, 1);
+    for (int i = 0; i < 8; i++) {
+        storeBE32(out + 4 * i, state[i]);
+    }
+}
+
+/**
+ * T_i = U_1 ^ U_2 ^ ... ^ U_c, with U_1 = HMAC(P, S || INT(i)) and
+ * U_j = HMAC(P, U_{j-1}).
+ */
+static void computeBlock(const HmacKey& hmac, const std::vector<uint8_t>& salt, uint32_t blockIndex,
+                         uint32_t iterations, uint8_t out[SHA256::DIGEST_SIZE],
+                         const PBKDF2::ProgressFn* progress = nullptr) {
+    uint8_t u[SHA256::DIGEST_SIZE];
+
+    // Both the inner and outer messages of U_2..U_c (and the outer message
+    // of U_1) are a 32-byte digest after one pad block: one pre-padded
+    // block serves every compression
+    uint8_t block[SHA256::BLOCK_SIZE] = {0};
+    block[32] = 0x80;
+    block[62] = 0x03;   // (64 + 32) * 8 = 768 bits
+
+    // U_1: inner hash of S || INT(i), continuing from the ipad state
+    {
+        std::vector<uint8_t> message(salt);
+        uint8_t counter[4];
+        storeBE32(counter, blockIndex);
+        message.insert(message.end(), counter, counter + 4);
+
+        const uint64_t bits = (SHA256::BLOCK_SIZE + message.size()) * 8;
+        message.push_back(0x80);
+        while (message.size() % SHA256::BLOCK_SIZE != 56) message.push_back(0);
+        for (int i = 7; i >= 0; i--) message.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+
+        uint32_t state[8];
+        std::memcpy(state, hmac.inner, sizeof(state));
+        SHA256::compress(state, message.data(), message.size() / SHA256::BLOCK_SIZE);
+        for (int i = 0; i < 8; i++) {
+            storeBE32(block + 4 * i, state[i]);
+        }
+        finishDigestBlock(hmac.outer, block, u);
+
+        secureWipe(state, sizeof(state));
+        secureWipe(message.data(), message.size());
+    }
+
+    std::memcpy(out, u, SHA256::DIGEST_SIZE);
+
+    // U_2..U_c
+    for (uint32_t iter = 1; iter < iterations; iter++) {
+        std::memcpy(block, u, SHA256::DIGEST_SIZE);
+        finishDigestBlock(hmac.inner, block, block);
+        finishDigestBlock(hmac.outer, block, u);
+        for (size_t i = 0; i < SHA256::DIGEST_SIZE; i++) {
+            out[i] ^= u[i];
+        }
+        if (progress && iter % PBKDF2::PROGRESS_INTERVAL == 0) {
+            (*progress)(iter, iterations);
+        }
+    }
+
+    secureWipe(u, sizeof(u));
+    secureWipe(block, sizeof(block));
+}
+
+} // namespace
+
+SecureBuffer PBKDF2::deriveKey(const char* password, size_t passwordLength, const std::vector<uint8_t>& salt,
+                               uint32_t iterations, size_t length, const ProgressFn& progress) {
+    if (iterations == 0) {
+        throw std::invalid_argument("PBKDF2 iteration count must be positive");
+    }
+    PERF_SCOPE(PerfOp::DERIVE_KEY);
+
+    const HmacKey hmac(password, passwordLength);
+    const size_t blocks = (length + SHA256::DIGEST_SIZE - 1) / SHA256::DIGEST_SIZE;
+    SecureBuffer derived(blocks * SHA256::DIGEST_SIZE);
+
+    // Blocks share nothing but the read-only pad states: first block on
+    // this thread, the rest on workers
+    std::vector<std::thread> workers;
+    for (size_t b = 1; b < blocks; b++) {
+        try {
+            workers.emplace_back(computeBlock, std::cref(hmac), std::cref(salt), static_cast<uint32_t>(b + 1),
+                                 iterations, derived.data() + b * SHA256::DIGEST_SIZE,
+                                 static_cast<const ProgressFn*>(nullptr));
+        } catch (const std::system_error&) {
+            // No thread available; compute inline
+            computeBlock(hmac, salt, static_cast<uint32_t>(b + 1), iterations,
+                         derived.data() + b * SHA256::DIGEST_SIZE);
+        }
+    }
+    // Blocks run at the same pace, so the first one stands in for the whole
+    computeBlock(hmac, salt, 1, iterations, derived.data(), progress ? &progress : nullptr);
+    for (std::thread& t : workers) {
+        t.join();
+    }
+
+    derived.resize(length);   // The tail is wiped with the buffer
+    return derived;
+}
+
+uint32_t PBKDF2::calibrateIterations(uint32_t targetMillis) {
+    using Clock = std::chrono::steady_clock;
+
+    const HmacKey hmac("calibration", 11);
+    const std::vector<uint8_t> salt(16, 0);
+    uint8_t out[SHA256::DIGEST_SIZE];
+
+    // Grow the probe until it is long enough to time reliably
+    uint32_t probe = 4096;
+    double elapsed = 0.0;
+    for (;;) {
+        auto start = Clock::now();
+        computeBlock(hmac, salt, 1, probe, out);
+        elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (elapsed >= 50.0 || probe >= MAX_ITERATIONS / 2) break;
+        probe *= 2;
+    }
+
+    double estimate = elapsed > 0.0 ? probe * (targetMillis / elapsed) : MAX_ITERATIONS;
+    if (estimate < MIN_ITERATIONS) return MIN_ITERATIONS;
+    if (estimate > MAX_ITERATIONS) return MAX_ITERATIONS;
+    return static_cast<uint32_t>(estimate);
+}
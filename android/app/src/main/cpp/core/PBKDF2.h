@@ -0,0 +1,52 @@
+#ifndef PBKDF2_H
+#define PBKDF2_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "SecureArena.h"
+
+/**
+ * @brief PBKDF2-HMAC-SHA256 (RFC 8018)
+ *
+ * The HMAC inner/outer pad states are hashed once per derivation, so each
+ * iteration costs exactly two SHA-256 compressions. Output blocks are
+ * independent and are computed on parallel threads.
+ */
+class PBKDF2 {
+public:
+    static constexpr uint32_t DEFAULT_ITERATIONS = 310000;
+    static constexpr uint32_t MIN_ITERATIONS = 100000;
+    static constexpr uint32_t MAX_ITERATIONS = 10000000;
+
+    /**
+     * @brief Progress callback: (iterations done, iterations total) for the first block
+     *
+     * Called from the deriving thread roughly every PROGRESS_INTERVAL iterations.
+     */
+    using ProgressFn = std::function<void(uint32_t done, uint32_t total)>;
+    static constexpr uint32_t PROGRESS_INTERVAL = 8192;
+
+    /**
+     * @brief Derive `length` bytes from password and salt, into locked memory
+     */
+    static SecureBuffer deriveKey(const char* password, size_t passwordLength, const std::vector<uint8_t>& salt,
+                                  uint32_t iterations, size_t length, const ProgressFn& progress = ProgressFn());
+    static SecureBuffer deriveKey(const std::string& password, const std::vector<uint8_t>& salt,
+                                  uint32_t iterations, size_t length, const ProgressFn& progress = ProgressFn()) {
+        return deriveKey(password.data(), password.size(), salt, iterations, length, progress);
+    }
+
+    /**
+     * @brief Iteration count that takes about targetMillis on this device
+     *
+     * Blocks run in parallel, so this is also the wall-clock cost of a
+     * derivation of up to as many blocks as there are cores. Clamped to
+     * [MIN_ITERATIONS, MAX_ITERATIONS].
+     */
+    static uint32_t calibrateIterations(uint32_t targetMillis);
+};
+
+#endif // PBKDF2_H
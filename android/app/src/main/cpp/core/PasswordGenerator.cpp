@@ -1,71 +1,269 @@
 #include "PasswordGenerator.h"
-#include <algorithm>
-#include <chrono>
+#include "Wordlist.h"
+#include <limits>
+#include <stdexcept>
+#include <utility>
 
-PasswordGenerator::PasswordGenerator() {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    rng.seed(seed);
+namespace {
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
 }
 
-std::string PasswordGenerator::generateRandom(int length) {
-    std::string password;
-    const std::string allChars = uppercase + lowercase + numbers + symbols;
+constexpr std::string_view UPPERCASE = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+constexpr std::string_view LOWERCASE = "abcdefghijklmnopqrstuvwxyz";
+constexpr std::string_view NUMBERS = "0123456789";
+constexpr std::string_view SYMBOLS = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+constexpr std::string_view AMBIGUOUS = "0Oo1lI|";
+
+constexpr bool isSymbol(unsigned char c) {
+    return c >= 0x21 && c <= 0x7E &&
+           !(c >= '0' && c <= '9') && !(c >= 'A' && c <= 'Z') && !(c >= 'a' && c <= 'z');
+}
+
+/** @brief Offsets of the words in Wordlist::WORDS, built at compile time */
+struct WordTable {
+    uint16_t offsets[Wordlist::WORD_COUNT + 1] = {};   // Last entry: one past the blob
+};
+
+constexpr size_t countWords() {
+    size_t words = 1;
+    for (size_t i = 0; i + 1 < sizeof(Wordlist::WORDS); ++i) {
+        if (Wordlist::WORDS[i] == ' ') ++words;
+    }
+    return words;
+}
+
+constexpr WordTable buildWordTable() {
+    WordTable table;
+    size_t word = 0;
+    for (size_t i = 0; i + 1 < sizeof(Wordlist::WORDS); ++i) {
+        if (Wordlist::WORDS[i] == ' ') table.offsets[++word] = static_cast<uint16_t>(i + 1);
+    }
+    table.offsets[Wordlist::WORD_COUNT] = static_cast<uint16_t>(sizeof(Wordlist::WORDS));
+    return table;
+}
+
+static_assert(countWords() == Wordlist::WORD_COUNT, "Wordlist::WORD_COUNT does not match the blob");
+static_assert(sizeof(Wordlist::WORDS) <= std::numeric_limits<uint16_t>::max(), "Wordlist too large for 16-bit offsets");
+constexpr WordTable WORD_TABLE = buildWordTable();
+
+inline std::string_view word(size_t i) {
+    const size_t begin = WORD_TABLE.offsets[i];
+    return std::string_view(Wordlist::WORDS + begin, WORD_TABLE.offsets[i + 1] - 1 - begin);
+}
+
+inline char pick(SecureRandom& rng, std::string_view set) {
+    return set[rng.uniform(static_cast<uint32_t>(set.size()))];
+}
+
+} // namespace
 
-    // Ensure at least one of each type
-    password += getRandomChar(uppercase);
-    password += getRandomChar(lowercase);
-    password += getRandomChar(numbers);
-    password += getRandomChar(symbols);
+CompiledPolicy::CompiledPolicy(const GenerationPolicy& policy) {
+    bool excluded[256] = {};
+    for (unsigned char c : policy.exclude) excluded[c] = true;
+    if (policy.excludeAmbiguous) {
+        for (unsigned char c : AMBIGUOUS) excluded[c] = true;
+    }
 
-    // Fill remaining length
-    for(int i = 4; i < length; i++) {
-        password += getRandomChar(allChars);
+    bool symbolAllowed[256] = {};
+    if (policy.allowedSymbols.empty()) {
+        for (unsigned char c : SYMBOLS) symbolAllowed[c] = true;
+    } else {
+        for (unsigned char c : policy.allowedSymbols) symbolAllowed[c] = isSymbol(c);
     }
 
-    return shuffleString(password);
+    const bool none = !policy.uppercase && !policy.lowercase && !policy.digits && !policy.symbols;
+    const bool enabled[CLASS_COUNT] = {
+        policy.uppercase || none, policy.lowercase || none, policy.digits || none, policy.symbols || none,
+    };
+
+    // Symbols keep the order given (or SYMBOLS's); the rest are alphabetical
+    const std::string_view symbolOrder = policy.allowedSymbols.empty() ? SYMBOLS
+                                                                        : std::string_view(policy.allowedSymbols);
+    const std::string_view sources[CLASS_COUNT] = {UPPERCASE, LOWERCASE, NUMBERS, symbolOrder};
+
+    uint16_t size = 0;
+    for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+        classBegin[c] = size;
+        if (!enabled[c]) continue;
+        for (unsigned char ch : sources[c]) {
+            if (excluded[ch] || masks[ch] != 0) continue;   // Excluded or listed twice
+            if (c == SYMBOL && !symbolAllowed[ch]) continue;
+            masks[ch] = static_cast<uint8_t>(1u << c);
+            chars[size++] = static_cast<char>(ch);
+        }
+        // Nothing enabled means "anything", with no class forced in
+        if (policy.requireEachClass && !none && size > classBegin[c]) required |= static_cast<uint8_t>(1u << c);
+    }
+    classBegin[CLASS_COUNT] = size;
+
+    if (size == 0) throw std::invalid_argument("Generation policy leaves no characters to use");
+
+    letterFirst = policy.startWithLetter;
+    const bool hasLetter = classBegin[DIGIT] > classBegin[UPPER];
+    if (letterFirst && !hasLetter) throw std::invalid_argument("Generation policy needs a leading letter but allows none");
+
+    // Room for one character of every required class, plus the leading
+    // letter if no required letter class can take that spot
+    size_t minimum = 0;
+    for (uint8_t c = 0; c < CLASS_COUNT; ++c) minimum += (required >> c) & 1u;
+    if (letterFirst && (required & ((1u << UPPER) | (1u << LOWER))) == 0) ++minimum;
+
+    const size_t wanted = policy.length > 0 ? static_cast<size_t>(policy.length) : 0;
+    passwordLength = wanted < minimum ? minimum : wanted;
+}
+
+bool CompiledPolicy::accepts(std::string_view password) const {
+    uint8_t seen = 0;
+    for (char c : password) {
+        const uint8_t mask = classMask(c);
+        if (mask == 0) return false;
+        seen |= mask;
+    }
+    if (letterFirst && !password.empty() && (classMask(password[0]) & ((1u << UPPER) | (1u << LOWER))) == 0) {
+        return false;
+    }
+    return (seen & required) == required;
+}
+
+PasswordBatch::PasswordBatch(size_t count, size_t length)
+    : data(count * length), count(count), stride(length) {}
+
+PasswordBatch::~PasswordBatch() {
+    wipe();
+}
+
+PasswordBatch::PasswordBatch(PasswordBatch&& other) noexcept
+    : data(std::move(other.data)), count(other.count), stride(other.stride) {
+    other.count = 0;
+    other.stride = 0;
+}
+
+PasswordBatch& PasswordBatch::operator=(PasswordBatch&& other) noexcept {
+    if (this != &other) {
+        wipe();
+        data = std::move(other.data);
+        count = std::exchange(other.count, 0);
+        stride = std::exchange(other.stride, 0);
+    }
+    return *this;
+}
+
+void PasswordBatch::wipe() {
+    if (!data.empty()) secureWipe(data.data(), data.size());
+}
+
+std::string PasswordGenerator::generateRandom(int length) {
+    GenerationPolicy policy;
+    policy.length = length;
+    return generate(policy);
 }
 
 std::string PasswordGenerator::generateFromFavorite(const std::string& favorite, int length) {
+    // Favourite characters weigh by how often they occur, as before
     std::string base = favorite;
-    base += numbers;
-    base += symbols;
+    base.append(NUMBERS.data(), NUMBERS.size());
+    base.append(SYMBOLS.data(), SYMBOLS.size());
 
+    // Independent picks: a shuffle afterwards would not change the distribution
     std::string password;
-    for(int i = 0; i < length; i++) {
-        password += getRandomChar(base);
+    password.reserve(length > 0 ? length : 0);
+    for (int i = 0; i < length; i++) {
+        password += pick(rng, base);
     }
 
-    return shuffleString(password);
+    secureWipe(&base[0], base.size());
+    return password;
 }
 
 std::string PasswordGenerator::generateMemorable() {
-    std::vector<std::string> words = {"Red", "Blue", "Green", "Sun", "Moon", "Star", "Fast", "Strong"};
     std::string password;
+    password.reserve(3 * 8 + 2);
 
-    for(int i = 0; i < 3; i++) {
-        password += words[std::uniform_int_distribution<int>(0, words.size()-1)(rng)];
-        if(i < 2) password += "-";
+    for (int i = 0; i < 3; i++) {
+        const std::string_view w = word(rng.uniform(static_cast<uint32_t>(Wordlist::WORD_COUNT)));
+        password += static_cast<char>(w[0] - 'a' + 'A');
+        password.append(w.data() + 1, w.size() - 1);
+        if (i < 2) password += "-";
     }
 
-    password += std::to_string(std::uniform_int_distribution<int>(10, 99)(rng));
+    password += std::to_string(10 + rng.uniform(90));
     return password;
 }
 
 std::string PasswordGenerator::generatePin(int length) {
     std::string pin;
-    for(int i = 0; i < length; i++) {
-        pin += getRandomChar(numbers);
+    pin.reserve(length > 0 ? length : 0);
+    for (int i = 0; i < length; i++) {
+        pin += pick(rng, NUMBERS);
     }
     return pin;
 }
 
-char PasswordGenerator::getRandomChar(const std::string& charSet) {
-    std::uniform_int_distribution<int> dist(0, charSet.size() - 1);
-    return charSet[dist(rng)];
+std::string PasswordGenerator::generate(const GenerationPolicy& policy) {
+    return generate(CompiledPolicy(policy));
 }
 
-std::string PasswordGenerator::shuffleString(const std::string& input) {
-    std::string output = input;
-    std::shuffle(output.begin(), output.end(), rng);
-    return output;
-}
\ No newline at end of file
+std::string PasswordGenerator::generate(const CompiledPolicy& policy) {
+    std::string password(policy.length(), '\0');
+    generateInto(policy, &password[0]);
+    return password;
+}
+
+PasswordBatch PasswordGenerator::generateBatch(size_t count, const GenerationPolicy& policy) {
+    return generateBatch(count, CompiledPolicy(policy));
+}
+
+PasswordBatch PasswordGenerator::generateBatch(size_t count, const CompiledPolicy& policy) {
+    const size_t length = policy.length();
+    if (length > 0 && count > std::numeric_limits<size_t>::max() / length) {
+        throw std::length_error("Password batch too large");
+    }
+
+    PasswordBatch batch(count, length);
+    for (size_t i = 0; i < count; ++i) generateInto(policy, batch.slot(i));
+    return batch;
+}
+
+void PasswordGenerator::generateInto(const CompiledPolicy& policy, char* out) {
+    const size_t length = policy.length();
+    const std::string_view any = policy.alphabet();
+    const std::string_view letters(any.data(), policy.classAlphabet(CompiledPolicy::UPPER).size() +
+                                               policy.classAlphabet(CompiledPolicy::LOWER).size());
+
+    // Distinct random positions for the required classes. Digits and symbols
+    // go first since a leading letter bars them from position 0; there are
+    // at most four, so rejection on collisions is cheap.
+    static constexpr CompiledPolicy::CharClass placementOrder[] = {
+        CompiledPolicy::DIGIT, CompiledPolicy::SYMBOL, CompiledPolicy::UPPER, CompiledPolicy::LOWER,
+    };
+    size_t reservedAt[CompiledPolicy::CLASS_COUNT];
+    CompiledPolicy::CharClass reservedClass[CompiledPolicy::CLASS_COUNT];
+    size_t reserved = 0;
+    for (CompiledPolicy::CharClass c : placementOrder) {
+        if ((policy.requiredMask() & (1u << c)) == 0) continue;
+        const bool letter = c == CompiledPolicy::UPPER || c == CompiledPolicy::LOWER;
+        const size_t first = policy.startsWithLetter() && !letter ? 1 : 0;
+        size_t position;
+        bool taken;
+        do {
+            position = first + rng.uniform(static_cast<uint32_t>(length - first));
+            taken = false;
+            for (size_t r = 0; r < reserved; ++r) taken |= reservedAt[r] == position;
+        } while (taken);
+        reservedAt[reserved] = position;
+        reservedClass[reserved++] = c;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        std::string_view from = (i == 0 && policy.startsWithLetter()) ? letters : any;
+        for (size_t r = 0; r < reserved; ++r) {
+            if (reservedAt[r] == i) from = policy.classAlphabet(reservedClass[r]);
+        }
+        out[i] = pick(rng, from);
+    }
+}
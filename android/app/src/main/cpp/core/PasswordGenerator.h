@@ -1,30 +1,137 @@
 #ifndef PASSWORD_GENERATOR_H
 #define PASSWORD_GENERATOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <random>
+#include <string_view>
 #include <vector>
+#include "SecureRandom.h"
+
+/** @brief Which characters a generated password may (and must) contain */
+struct GenerationPolicy {
+    int length = 16;
+    bool uppercase = true;
+    bool lowercase = true;
+    bool digits = true;
+    bool symbols = true;
+    /** At least one character from every enabled class; length grows to fit if needed */
+    bool requireEachClass = true;
+    /** Leave out look-alikes: 0 O o 1 l I | */
+    bool excludeAmbiguous = false;
+    /** Characters never to use */
+    std::string exclude;
+    /** Site rule: the only symbols the site accepts; empty means the default set */
+    std::string allowedSymbols;
+    /** Site rule: the first character must be a letter */
+    bool startWithLetter = false;
+};
+
+/**
+ * @brief A GenerationPolicy resolved once into flat lookup tables
+ *
+ * The alphabet is one array grouped by class (upper, lower, digit, symbol),
+ * so both "any character" and "a character of class c" are a single
+ * uniform pick from a contiguous range. Every byte also has a precomputed
+ * class mask, which makes checking a password against the policy one table
+ * lookup per character.
+ *
+ * Enabled classes that the exclusions empty are dropped. If no class is
+ * enabled, all four are used and none is required.
+ */
+class CompiledPolicy {
+public:
+    enum CharClass : uint8_t { UPPER, LOWER, DIGIT, SYMBOL, CLASS_COUNT };
+
+    /** @throws std::invalid_argument if no character, or no leading letter, is left */
+    explicit CompiledPolicy(const GenerationPolicy& policy);
+
+    size_t length() const { return passwordLength; }
+    size_t alphabetSize() const { return classBegin[CLASS_COUNT]; }
+    std::string_view alphabet() const { return std::string_view(chars, alphabetSize()); }
+    std::string_view classAlphabet(CharClass c) const {
+        return std::string_view(chars + classBegin[c], classBegin[c + 1] - classBegin[c]);
+    }
+    /** @brief Bit (1 << CharClass) of an allowed character, 0 otherwise */
+    uint8_t classMask(char c) const { return masks[static_cast<uint8_t>(c)]; }
+    uint8_t requiredMask() const { return required; }
+    bool startsWithLetter() const { return letterFirst; }
+
+    /** @brief Whether `password` could have come from this policy (length aside) */
+    bool accepts(std::string_view password) const;
 
-class PasswordGenerator {
 private:
-    std::mt19937 rng;
+    char chars[256] = {};
+    uint16_t classBegin[CLASS_COUNT + 1] = {};
+    uint8_t masks[256] = {};
+    uint8_t required = 0;
+    bool letterFirst = false;
+    size_t passwordLength = 0;
+};
+
+/**
+ * @brief Many generated passwords of equal length in one contiguous buffer
+ *
+ * Password i is the `length()` bytes at i * length(). The buffer is wiped
+ * on destruction; callers copy out only what they keep.
+ */
+class PasswordBatch {
+public:
+    PasswordBatch() = default;
+    PasswordBatch(size_t count, size_t length);
+    ~PasswordBatch();
 
-    const std::string uppercase = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-    const std::string lowercase = "abcdefghijklmnopqrstuvwxyz";
-    const std::string numbers = "0123456789";
-    const std::string symbols = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+    PasswordBatch(PasswordBatch&& other) noexcept;
+    PasswordBatch& operator=(PasswordBatch&& other) noexcept;
+    PasswordBatch(const PasswordBatch&) = delete;
+    PasswordBatch& operator=(const PasswordBatch&) = delete;
+
+    size_t size() const { return count; }
+    size_t length() const { return stride; }
+    std::string_view operator[](size_t i) const { return std::string_view(data.data() + i * stride, stride); }
+
+    char* slot(size_t i) { return data.data() + i * stride; }
+
+private:
+    std::vector<char> data;
+    size_t count = 0;
+    size_t stride = 0;
+
+    void wipe();
+};
+
+/**
+ * @brief Password, PIN and passphrase generation on a ChaCha20 CSPRNG
+ *
+ * Characters are picked by rejection sampling from a CompiledPolicy's
+ * alphabet, so every allowed character is equally likely. Required classes
+ * get distinct random positions up front, and the password is then written
+ * in one pass: no fill-then-shuffle copy. Memorable passwords draw from
+ * the embedded Wordlist.
+ */
+class PasswordGenerator {
+private:
+    SecureRandom rng;
 
 public:
-    PasswordGenerator();
+    PasswordGenerator() = default;
 
     std::string generateRandom(int length = 16);
     std::string generateFromFavorite(const std::string& favorite, int length = 12);
     std::string generateMemorable();
     std::string generatePin(int length = 6);
 
+    std::string generate(const GenerationPolicy& policy);
+    std::string generate(const CompiledPolicy& policy);
+    /**
+     * @brief `count` passwords for one policy, generated into a single buffer
+     * @throws std::length_error if the batch would not fit in memory
+     */
+    PasswordBatch generateBatch(size_t count, const GenerationPolicy& policy);
+    PasswordBatch generateBatch(size_t count, const CompiledPolicy& policy);
+
 private:
-    char getRandomChar(const std::string& charSet);
-    std::string shuffleString(const std::string& input);
+    void generateInto(const CompiledPolicy& policy, char* out);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -103,178 +103,481 @@
 //    return ss.str();
 //}
 #include "PasswordManager.h"
+#include "BackupStream.h"
+#include "CipherContext.h"
+#include "DatabaseManager.h"
+#include "JsonWriter.h"
+#include "RecordCompression.h"
+#include "RecordMigration.h"
+#include "RekeyMigration.h"
+#include "KeyRotation.h"
 #include <algorithm>
-#include <sstream>
-#include <sqlite3.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
-#include <filesystem>
 
-PasswordManager::PasswordManager() : databasePath("") {}
+namespace {
 
-void PasswordManager::setDatabasePath(const std::string& path) {
-    databasePath = path;
-    if (!databasePath.empty()) {
-        initializeDatabase();
-        loadPasswordsFromDatabase();
+using JsonFields = std::map<std::string, std::string>;
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
     }
 }
 
-bool PasswordManager::initializeDatabase() {
-    if (databasePath.empty()) return false;
+// Plaintext from a restored backup goes back to rest as a GCM record,
+// compressed when it is long enough to gain; `plain` is wiped once sealed
+std::string sealSecret(const CipherContext& keys, std::string plain) {
+    std::string record = RecordCompression::seal(keys, reinterpret_cast<const uint8_t*>(plain.data()), plain.size(),
+                                                  RecordCompression::Dictionary::TEXT);
+    secureWipe(&plain[0], plain.size());
+    return record;
+}
 
-    sqlite3* db;
-    int rc = sqlite3_open(databasePath.c_str(), &db);
+void putInt(std::string& out, uint64_t value, size_t bytes) {
+    char raw[8];
+    for (size_t i = 0; i < bytes; ++i) raw[i] = static_cast<char>(value >> (8 * i));
+    out.append(raw, bytes);
+}
 
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
-        return false;
-    }
+void putBytes(std::string& out, const std::string& bytes) {
+    putInt(out, bytes.size(), 4);
+    out.append(bytes);
+}
 
-    const char* createTableSQL =
-            "CREATE TABLE IF NOT EXISTS passwords ("
-            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-            "title TEXT NOT NULL, "
-            "username TEXT NOT NULL, "
-            "password TEXT NOT NULL, "
-            "category INTEGER NOT NULL, "
-            "website TEXT, "
-            "notes TEXT, "
-            "created_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
-            "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP);";
-
-    char* errMsg = 0;
-    rc = sqlite3_exec(db, createTableSQL, 0, 0, &errMsg);
-
-    if (rc != SQLITE_OK) {
-        std::cerr << "SQL error: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
-        sqlite3_close(db);
+/**
+ * @brief Append a secret as a raw GCM record (ChangeSet encoding)
+ *
+ * A stored record is copied without decrypting it. Anything else is
+ * revealed and sealed under `keys`, which are fetched on first need.
+ * False when that needs keys that are not loaded.
+ */
+template <typename Read>
+bool putSealed(std::string& out, const LazySecret& sealed, Read read, std::shared_ptr<const CipherContext>& keys) {
+    if (!sealed.empty() && sealed.encoding() == LazySecret::Encoding::RECORD) {
+        putBytes(out, sealed.ciphertext());
+        return true;
+    }
+    std::string plain = read();
+    if (plain.empty()) {
+        putInt(out, 0, 4);
+        return true;
+    }
+    if (!keys) keys = CipherContext::current();
+    if (!keys) {
+        secureWipe(&plain[0], plain.size());
         return false;
     }
-
-    sqlite3_close(db);
+    putBytes(out, sealSecret(*keys, std::move(plain)));
     return true;
 }
 
-bool PasswordManager::loadPasswordsFromDatabase() {
-    if (databasePath.empty()) return false;
+void sealSecrets(const CipherContext& keys, PasswordEntry& entry) {
+    if (!entry.isPasswordEncrypted() && !entry.getPassword().empty()) {
+        entry.setEncryptedPassword(sealSecret(keys, entry.getPassword()), LazySecret::Encoding::RECORD);
+    }
+    if (!entry.areNotesEncrypted() && !entry.getNotes().empty()) {
+        entry.setEncryptedNotes(sealSecret(keys, entry.getNotes()), LazySecret::Encoding::RECORD);
+    }
+}
 
-    sqlite3* db;
-    int rc = sqlite3_open(databasePath.c_str(), &db);
+/**
+ * @brief Minimal JSON reader for importFromJson
+ *
+ * Accepts either a bare array of entry objects or an object holding one
+ * under "passwords" (the shape exportToJson writes). Each entry's scalar
+ * fields are collected as text; nested values and nulls are skipped.
+ * Values nested deeper than MAX_DEPTH fail the read instead of the stack.
+ */
+class JsonImportReader {
+public:
+    static constexpr size_t MAX_DEPTH = 64;
 
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
-        return false;
+    explicit JsonImportReader(const std::string& text) : s(text), pos(0), depth(0), tooDeep(false) {}
+
+    bool nestedTooDeep() const { return tooDeep; }
+
+    bool readEntries(std::vector<JsonFields>& out) {
+        skipSpace();
+        if (peek() == '[') {
+            if (!readEntryArray(out)) return false;
+        } else if (peek() == '{') {
+            ++pos;
+            bool found = false;
+            skipSpace();
+            if (peek() == '}') { ++pos; return false; }
+            while (true) {
+                std::string key;
+                if (!readString(key) || !expect(':')) return false;
+                skipSpace();
+                if (key == "passwords" && peek() == '[') {
+                    if (!readEntryArray(out)) return false;
+                    found = true;
+                } else if (!skipValue()) {
+                    return false;
+                }
+                skipSpace();
+                if (peek() == ',') { ++pos; continue; }
+                if (!expect('}')) return false;
+                break;
+            }
+            if (!found) return false;
+        } else {
+            return false;
+        }
+        skipSpace();
+        return pos == s.size();
     }
 
-    const char* selectSQL = "SELECT id, title, username, password, category, website, notes FROM passwords;";
-    sqlite3_stmt* stmt;
+private:
+    const std::string& s;
+    size_t pos;
+    size_t depth;
+    bool tooDeep;
 
-    rc = sqlite3_prepare_v2(db, selectSQL, -1, &stmt, 0);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_close(db);
-        return false;
+    char peek() const { return pos < s.size() ? s[pos] : '\0'; }
+
+    void skipSpace() {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) ++pos;
     }
 
-    passwords.clear(); // Clear existing passwords before loading from database
+    bool expect(char c) {
+        skipSpace();
+        if (peek() != c) return false;
+        ++pos;
+        return true;
+    }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        const char* title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        const char* username = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        const char* password = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        int category = sqlite3_column_int(stmt, 4);
-        const char* website = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        const char* notes = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
+    bool readEntryArray(std::vector<JsonFields>& out) {
+        if (!expect('[')) return false;
+        skipSpace();
+        if (peek() == ']') { ++pos; return true; }
+        while (true) {
+            JsonFields fields;
+            if (!readObject(fields)) return false;
+            out.push_back(std::move(fields));
+            skipSpace();
+            if (peek() == ',') { ++pos; continue; }
+            return expect(']');
+        }
+    }
 
-        PasswordEntry entry(
-                title ? title : "",
-                username ? username : "",
-                password ? password : "",
-                static_cast<Category>(category),
-                website ? website : "",
-                notes ? notes : ""
-        );
-        entry.setId(id); // Set the ID from database
+    bool readObject(JsonFields& fields) {
+        if (!expect('{')) return false;
+        skipSpace();
+        if (peek() == '}') { ++pos; return true; }
+        while (true) {
+            std::string key;
+            if (!readString(key) || !expect(':')) return false;
+            skipSpace();
+            char c = peek();
+            if (c == '"') {
+                std::string value;
+                if (!readString(value)) return false;
+                fields[key] = std::move(value);
+            } else if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f') {
+                size_t start = pos;
+                if (!skipValue()) return false;
+                fields[key] = s.substr(start, pos - start);
+            } else if (!skipValue()) {
+                return false;
+            }
+            skipSpace();
+            if (peek() == ',') { ++pos; continue; }
+            return expect('}');
+        }
+    }
 
-        passwords.push_back(entry);
+    static void appendUtf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
     }
 
-    sqlite3_finalize(stmt);
-    sqlite3_close(db);
-    return true;
+    bool readHex4(uint32_t& value) {
+        if (pos + 4 > s.size()) return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = s[pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    bool readString(std::string& out) {
+        if (!expect('"')) return false;
+        while (pos < s.size()) {
+            char c = s[pos++];
+            if (c == '"') return true;
+            if (c != '\\') { out += c; continue; }
+            if (pos >= s.size()) return false;
+            char e = s[pos++];
+            switch (e) {
+                case '"': case '\\': case '/': out += e; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!readHex4(cp)) return false;
+                    if (cp >= 0xD800 && cp < 0xDC00) {
+                        uint32_t low;
+                        if (pos + 2 > s.size() || s[pos] != '\\' || s[pos + 1] != 'u') return false;
+                        pos += 2;
+                        if (!readHex4(low) || low < 0xDC00 || low >= 0xE000) return false;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return false;
+    }
+
+    bool skipValue() {
+        skipSpace();
+        char c = peek();
+        if (c == '"') {
+            std::string ignored;
+            return readString(ignored);
+        }
+        if (c == '{' || c == '[') {
+            if (depth == MAX_DEPTH) {
+                tooDeep = true;
+                return false;
+            }
+            ++depth;
+            bool ok = c == '{' ? skipObject() : skipArray();
+            --depth;
+            return ok;
+        }
+        size_t start = pos;
+        while (pos < s.size() && (std::isalnum(static_cast<unsigned char>(s[pos])) ||
+                                  s[pos] == '-' || s[pos] == '+' || s[pos] == '.')) ++pos;
+        return pos > start;
+    }
+
+    bool skipObject() {
+        JsonFields ignored;
+        return readObject(ignored);
+    }
+
+    bool skipArray() {
+        ++pos;
+        skipSpace();
+        if (peek() == ']') { ++pos; return true; }
+        while (true) {
+            if (!skipValue()) return false;
+            skipSpace();
+            if (peek() == ',') { ++pos; continue; }
+            return expect(']');
+        }
+    }
+};
+
+std::string field(const JsonFields& fields, const char* key) {
+    auto it = fields.find(key);
+    return it != fields.end() ? it->second : std::string();
 }
 
-bool PasswordManager::savePasswordToDatabase(const PasswordEntry& entry) {
-    if (databasePath.empty()) return false;
+Category categoryFromField(const std::string& value) {
+    if (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos) {
+        int index = std::atoi(value.c_str());
+        if (index >= 0 && index <= static_cast<int>(Category::OTHER)) return static_cast<Category>(index);
+        return Category::OTHER;
+    }
+    return PasswordEntry::stringToCategory(value);
+}
 
-    sqlite3* db;
-    int rc = sqlite3_open(databasePath.c_str(), &db);
+// Assembles rows for visitors into one scratch entry, so a scan reuses its
+// string storage instead of allocating a full entry per row
+class RowLoader {
+public:
+    explicit RowLoader(const EntryStore& store) : store(store) {}
 
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
-        return false;
+    const PasswordEntry& operator()(size_t index) {
+        if (scratch) {
+            store.load(index, *scratch);
+        } else {
+            scratch.emplace(store.entry(index));
+        }
+        return *scratch;
     }
 
-    const char* insertSQL =
-            "INSERT INTO passwords (title, username, password, category, website, notes) "
-            "VALUES (?, ?, ?, ?, ?, ?);";
+private:
+    const EntryStore& store;
+    std::optional<PasswordEntry> scratch;
+};
 
-    sqlite3_stmt* stmt;
-    rc = sqlite3_prepare_v2(db, insertSQL, -1, &stmt, 0);
+// Visits the entries behind index ids; ids without an entry are skipped
+size_t visitIds(const EntryStore& store, const std::vector<std::string_view>& ids,
+                const PasswordManager::EntryVisitor& visit) {
+    RowLoader load(store);
+    size_t visited = 0;
+    for (std::string_view id : ids) {
+        const size_t index = store.indexOf(EntryStore::keyFor(id));
+        if (index != EntryStore::NOT_FOUND) {
+            visit(load(index));
+            ++visited;
+        }
+    }
+    return visited;
+}
+
+} // namespace
 
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_close(db);
+PasswordManager::PasswordManager() : databasePath(""), passwordsLoaded(false) {}
+
+PasswordManager::~PasswordManager() = default;
+
+void PasswordManager::setDatabasePath(const std::string& path) {
+    databasePath = path;
+    passwords.clear();
+    passwordsLoaded = false;
+    searchIndex.clear();
+    vaultIndex.clear();
+    if (!databasePath.empty()) {
+        // Rows are not read here: list views page through loadPage() and
+        // the full set is loaded the first time an operation needs it
+        initializeDatabase();
+    }
+}
+
+bool PasswordManager::initializeDatabase() {
+    if (databasePath.empty()) return false;
+
+    // One connection for the manager's lifetime; re-pointing the path
+    // closes the old connection and its cached statements.
+    recordMigration.reset();
+    rekeyMigration.reset();
+    database = std::make_unique<DatabaseManager>(databasePath);
+    if (!database->isDatabaseOpen()) {
+        std::cerr << "Can't open database: " << databasePath << std::endl;
+        database.reset();
         return false;
     }
+    if (database->needsRecordMigration()) {
+        recordMigration = std::make_unique<RecordMigration>(databasePath);
+    }
+    startRekey();
+    return true;
+}
 
-    sqlite3_bind_text(stmt, 1, entry.getTitle().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, entry.getUsername().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, entry.getPassword().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int(stmt, 4, static_cast<int>(entry.getCategory()));
-    sqlite3_bind_text(stmt, 5, entry.getWebsite().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 6, entry.getNotes().c_str(), -1, SQLITE_STATIC);
+bool PasswordManager::isMigratingRecords() const {
+    return recordMigration && recordMigration->isRunning();
+}
 
-    rc = sqlite3_step(stmt);
-    bool success = (rc == SQLITE_DONE);
+void PasswordManager::collectRekey() {
+    if (rekeyMigration && rekeyMigration->hasEnded()) {
+        // Cached entries may still hold records under keys that are now retired
+        rekeyMigration.reset();
+        passwordsLoaded = false;
+    }
+}
 
-    sqlite3_finalize(stmt);
-    sqlite3_close(db);
+bool PasswordManager::startRekey() {
+    if (!database) return false;
+    if (isRekeying()) return true;
+    collectRekey();
+    if (KeyRotation::pending() == 0) return false;
+    rekeyMigration = std::make_unique<RekeyMigration>(databasePath);
+    return true;
+}
 
-    return success;
+bool PasswordManager::isRekeying() const {
+    return rekeyMigration && rekeyMigration->isRunning();
 }
 
-bool PasswordManager::deletePasswordFromDatabase(int id) {
-    if (databasePath.empty()) return false;
+bool PasswordManager::loadPasswordsFromDatabase() {
+    if (!database) return false;
 
-    sqlite3* db;
-    int rc = sqlite3_open(databasePath.c_str(), &db);
+    std::vector<PasswordEntry> rows = database->getAllPasswords();
+    passwordsLoaded = true;
 
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
-        return false;
+    passwords.clear();
+    passwords.reserve(rows.size());
+    searchIndex.clear();
+    vaultIndex.clear();
+
+    // Normalise every website to its registrable domain in one parallel pass
+    std::vector<std::string_view> websites;
+    websites.reserve(rows.size());
+    for (const auto& entry : rows) websites.emplace_back(entry.getWebsite());
+    std::vector<std::string> domains = VaultIndex::registrableDomains(websites);
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        PasswordEntry& entry = rows[i];
+        const std::string& id = entry.getId();
+        searchIndex.add(id, entry.getTitle(), entry.getUsername(), entry.getWebsite());
+        vaultIndex.addNormalized(id, entry.getCategory(), std::move(domains[i]), entry.getModifiedDate());
+        const EntryStore::Key key = EntryStore::keyFor(id);
+        passwords.put(key, std::move(entry));
     }
+    return true;
+}
 
-    const char* deleteSQL = "DELETE FROM passwords WHERE id = ?;";
-    sqlite3_stmt* stmt;
+void PasswordManager::indexEntry(const PasswordEntry& entry) {
+    const std::string& id = entry.getId();
+    const std::string& website = entry.getWebsite();
+    searchIndex.add(id, entry.getTitle(), entry.getUsername(), website);
+    vaultIndex.add(id, entry.getCategory(), website, entry.getModifiedDate());
+}
 
-    rc = sqlite3_prepare_v2(db, deleteSQL, -1, &stmt, 0);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_close(db);
-        return false;
+std::vector<PasswordEntry> PasswordManager::entriesForIds(const std::vector<std::string_view>& ids) const {
+    std::vector<PasswordEntry> result;
+    result.reserve(ids.size());
+    for (std::string_view id : ids) {
+        if (std::optional<PasswordEntry> entry = passwords.find(EntryStore::keyFor(id))) {
+            result.push_back(std::move(*entry));
+        }
     }
+    return result;
+}
 
-    sqlite3_bind_int(stmt, 1, id);
-    rc = sqlite3_step(stmt);
-    bool success = (rc == SQLITE_DONE);
+void PasswordManager::ensurePasswordsLoaded() {
+    collectRekey();
+    if (!passwordsLoaded && database) {
+        loadPasswordsFromDatabase();
+    }
+}
+
+bool PasswordManager::savePasswordToDatabase(PasswordEntry& entry) {
+    if (!database) return false;
 
-    sqlite3_finalize(stmt);
-    sqlite3_close(db);
+    int64_t id = database->savePassword(entry);
+    if (id < 0) return false;
 
-    return success;
+    entry.setId(std::to_string(id));
+    return true;
+}
+
+bool PasswordManager::deletePasswordFromDatabase(int64_t id) {
+    if (!database) return false;
+
+    return database->deletePassword(id);
 }
 
 bool PasswordManager::addPassword(const std::string& title, const std::string& username,
@@ -283,10 +586,14 @@ bool PasswordManager::addPassword(const std::string& title, const std::string& u
     try {
         PasswordEntry newEntry(title, username, password, category, website, notes);
 
-        // Save to database first
+        // Save to database first; the insert hands back the row id, so the
+        // entry can join the in-memory list without reloading the table
         if (savePasswordToDatabase(newEntry)) {
-            // If successful, add to memory and reload to get the auto-incremented ID
-            loadPasswordsFromDatabase();
+            if (passwordsLoaded) {
+                indexEntry(newEntry);
+                const EntryStore::Key key = EntryStore::keyFor(newEntry.getId());
+                passwords.put(key, std::move(newEntry));
+            }
             return true;
         }
         return false;
@@ -295,54 +602,208 @@ bool PasswordManager::addPassword(const std::string& title, const std::string& u
     }
 }
 
-bool PasswordManager::deletePassword(int id) {
+bool PasswordManager::deletePassword(int64_t id) {
     // Delete from database first
-    if (deletePasswordFromDatabase(id)) {
-        // If successful, delete from memory
-        for(auto it = passwords.begin(); it != passwords.end(); ++it) {
-            if(it->getId() == id) {
-                passwords.erase(it);
-                return true;
-            }
+    if (!deletePasswordFromDatabase(id)) {
+        return false;
+    }
+
+    // If successful, delete from memory
+    const std::string key = std::to_string(id);
+    searchIndex.remove(key);
+    vaultIndex.remove(key);
+    passwords.erase(static_cast<EntryStore::Key>(id));
+    return true;
+}
+
+bool PasswordManager::updatePassword(const PasswordEntry& entry) {
+    if (!database || !database->updatePassword(entry)) {
+        return false;
+    }
+
+    if (passwordsLoaded) {
+        if (passwords.update(EntryStore::keyFor(entry.getId()), entry)) {
+            indexEntry(entry);
         }
     }
-    return false;
+    return true;
+}
+
+std::vector<PasswordEntry> PasswordManager::getAllPasswords() {
+    ensurePasswordsLoaded();
+    return passwords.entries();
+}
+
+std::vector<PasswordSummary> PasswordManager::loadPage(size_t offset, size_t limit, PasswordSortKey sortKey) {
+    if (!database) return {};
+
+    return database->loadPage(offset, limit, sortKey);
+}
+
+std::optional<PasswordSecrets> PasswordManager::loadSecrets(int64_t id) {
+    if (!database) return std::nullopt;
+
+    return database->getSecretsById(id);
+}
+
+std::optional<PasswordEntry> PasswordManager::getPasswordById(int64_t id) {
+    if (passwordsLoaded) {
+        return passwords.find(static_cast<EntryStore::Key>(id));
+    }
+    if (!database) return std::nullopt;
+
+    return database->getPasswordById(id);
+}
+
+int PasswordManager::getTotalCount() {
+    if (passwordsLoaded || !database) {
+        return static_cast<int>(passwords.size());
+    }
+    int64_t count = database->countPasswords();
+    return count < 0 ? 0 : static_cast<int>(count);
 }
 
 // Rest of your existing methods remain the same...
 std::vector<PasswordEntry> PasswordManager::getPasswordsByCategory(Category category) {
+    ensurePasswordsLoaded();
+    return entriesForIds(vaultIndex.idsInCategory(category));
+}
+
+size_t PasswordManager::getCategoryCount(Category category) {
+    ensurePasswordsLoaded();
+    return vaultIndex.countInCategory(category);
+}
+
+std::vector<PasswordEntry> PasswordManager::getPasswordsForDomain(const std::string& url) {
+    ensurePasswordsLoaded();
+    return entriesForIds(vaultIndex.idsForDomain(url));
+}
+
+std::vector<std::string_view> PasswordManager::getPasswordIdsForDomain(const std::string& url) {
+    ensurePasswordsLoaded();
+    return vaultIndex.idsForDomain(url);
+}
+
+std::vector<PasswordEntry> PasswordManager::getPasswordsForPackage(const std::string& package) {
+    ensurePasswordsLoaded();
+    return entriesForIds(vaultIndex.idsForPackage(package));
+}
+
+std::vector<std::string_view> PasswordManager::getPasswordIdsForPackage(const std::string& package) {
+    ensurePasswordsLoaded();
+    return vaultIndex.idsForPackage(package);
+}
+
+std::vector<PasswordEntry> PasswordManager::getRecentPasswords(size_t limit) {
+    ensurePasswordsLoaded();
+    return entriesForIds(vaultIndex.recentlyModified(limit));
+}
+
+std::vector<PasswordEntry> PasswordManager::searchPasswords(const std::string& query) {
+    ensurePasswordsLoaded();
     std::vector<PasswordEntry> result;
-    for(const auto& entry : passwords) {
-        if(entry.getCategory() == category) {
-            result.push_back(entry);
+    if(query.empty()) return passwords.entries();
+
+    std::vector<SearchIndex::Hit> hits = searchIndex.search(query);
+    if (hits.empty()) return result;
+
+    // Hits are already ranked; each resolves to its entry by id
+    result.reserve(hits.size());
+    for (const SearchIndex::Hit& hit : hits) {
+        if (std::optional<PasswordEntry> entry = passwords.find(EntryStore::keyFor(hit.id))) {
+            result.push_back(std::move(*entry));
         }
     }
     return result;
 }
 
-std::vector<PasswordEntry> PasswordManager::searchPasswords(const std::string& query) {
-    std::vector<PasswordEntry> result;
-    if(query.empty()) return passwords;
+std::vector<SearchIndex::Hit> PasswordManager::searchPasswordIds(const std::string& query, size_t limit) {
+    ensurePasswordsLoaded();
+    return searchIndex.search(query, limit);
+}
 
-    std::string lowerQuery = query;
-    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+size_t PasswordManager::forEachPassword(const EntryVisitor& visit, const EntryFilter& filter) {
+    ensurePasswordsLoaded();
+    RowLoader load(passwords);
+    size_t visited = 0;
+    for (size_t index = 0; index < passwords.size(); ++index) {
+        const PasswordEntry& entry = load(index);
+        if (filter && !filter(entry)) continue;
+        visit(entry);
+        ++visited;
+    }
+    return visited;
+}
 
-    for(const auto& entry : passwords) {
-        std::string title = entry.getTitle();
-        std::string username = entry.getUsername();
-        std::string website = entry.getWebsite();
+size_t PasswordManager::forEachPasswordFrom(size_t start, const PageVisitor& visit) {
+    ensurePasswordsLoaded();
+    RowLoader load(passwords);
+    size_t visited = 0;
+    for (size_t index = start; index < passwords.size(); ++index) {
+        ++visited;
+        if (!visit(load(index))) break;
+    }
+    return visited;
+}
 
-        std::transform(title.begin(), title.end(), title.begin(), ::tolower);
-        std::transform(username.begin(), username.end(), username.begin(), ::tolower);
-        std::transform(website.begin(), website.end(), website.begin(), ::tolower);
+size_t PasswordManager::forEachRow(const RowVisitor& visit, std::optional<Category> category) {
+    ensurePasswordsLoaded();
+    size_t visited = 0;
+    for (size_t index = 0; index < passwords.size(); ++index) {
+        // The filter reads the category column alone
+        if (category && passwords.category(index) != *category) continue;
+        visit(passwords.row(index));
+        ++visited;
+    }
+    return visited;
+}
+
+size_t PasswordManager::forEachInCategory(Category category, const EntryVisitor& visit) {
+    ensurePasswordsLoaded();
+    return visitIds(passwords, vaultIndex.idsInCategory(category), visit);
+}
 
-        if(title.find(lowerQuery) != std::string::npos ||
-           username.find(lowerQuery) != std::string::npos ||
-           website.find(lowerQuery) != std::string::npos) {
-            result.push_back(entry);
+size_t PasswordManager::forEachMatchForUrl(const std::string& url, const EntryVisitor& visit) {
+    ensurePasswordsLoaded();
+    return visitIds(passwords, vaultIndex.idsForDomain(url), visit);
+}
+
+size_t PasswordManager::forEachMatchForPackage(const std::string& package, const EntryVisitor& visit) {
+    ensurePasswordsLoaded();
+    return visitIds(passwords, vaultIndex.idsForPackage(package), visit);
+}
+
+size_t PasswordManager::forEachById(const int64_t* ids, size_t count, const EntryVisitor& visit) {
+    ensurePasswordsLoaded();
+    RowLoader load(passwords);
+    size_t visited = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t id = ids[i];
+        if (id <= 0) continue;
+        const size_t index = passwords.indexOf(static_cast<EntryStore::Key>(id));
+        if (index != EntryStore::NOT_FOUND) {
+            visit(load(index));
+            ++visited;
         }
     }
-    return result;
+    return visited;
+}
+
+size_t PasswordManager::forEachSearchResult(const std::string& query, const EntryVisitor& visit, size_t limit) {
+    // Like searchPasswords, an empty query matches every entry
+    if (query.empty()) return forEachPassword(visit);
+
+    ensurePasswordsLoaded();
+    RowLoader load(passwords);
+    size_t visited = 0;
+    for (const SearchIndex::Hit& hit : searchIndex.search(query, limit)) {
+        const size_t index = passwords.indexOf(EntryStore::keyFor(hit.id));
+        if (index != EntryStore::NOT_FOUND) {
+            visit(load(index));
+            ++visited;
+        }
+    }
+    return visited;
 }
 
 std::string PasswordManager::analyzePassword(const std::string& password) {
@@ -350,14 +811,23 @@ std::string PasswordManager::analyzePassword(const std::string& password) {
 }
 
 std::map<std::string, int> PasswordManager::getCategoryStats() {
+    ensurePasswordsLoaded();
     std::map<std::string, int> stats;
-    for(const auto& entry : passwords) {
-        std::string category = entry.getCategoryString();
-        stats[category]++;
+    // Built from the running counts: one insert per non-empty category
+    const auto& counts = vaultIndex.categoryCountTable();
+    for (size_t c = 0; c < counts.size(); ++c) {
+        if (counts[c] > 0) {
+            stats[PasswordEntry::categoryToString(static_cast<Category>(c))] = static_cast<int>(counts[c]);
+        }
     }
     return stats;
 }
 
+VaultAuditReport PasswordManager::auditVault(const VaultAuditOptions& options) {
+    ensurePasswordsLoaded();
+    return VaultAuditor::audit(passwords.entries(), options);
+}
+
 std::string PasswordManager::generateRandomPassword(int length) {
     return generator.generateRandom(length);
 }
@@ -374,15 +844,225 @@ std::string PasswordManager::generatePin(int length) {
     return generator.generatePin(length);
 }
 
+std::string PasswordManager::generatePassword(const GenerationPolicy& policy) {
+    return generator.generate(policy);
+}
+
+PasswordBatch PasswordManager::generatePasswords(size_t count, const GenerationPolicy& policy) {
+    return generator.generateBatch(count, policy);
+}
+
 std::string PasswordManager::exportToJson() {
-    std::stringstream ss;
-    ss << "{\"passwords\":[";
+    ensurePasswordsLoaded();
+    JsonWriter json;
+    writeExport(json);
+    return json.take();
+}
+
+bool PasswordManager::exportToFile(const std::string& path) {
+    ensurePasswordsLoaded();
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Export failed: can't open " << path << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    {
+        JsonWriter json([&](const char* data, size_t size) {
+            if (ok && std::fwrite(data, 1, size, file) != size) ok = false;
+        });
+        writeExport(json);
+    }   // Writer flushes its last chunk here
+
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) std::cerr << "Export failed: write error on " << path << std::endl;
+    return ok;
+}
+
+void PasswordManager::writeExport(JsonWriter& json) const {
+    json.beginObject().key("passwords").beginArray();
+    RowLoader load(passwords);
+    for (size_t index = 0; index < passwords.size(); ++index) {
+        load(index).writeJson(json);
+    }
+    json.endArray().endObject();
+}
+
+bool PasswordManager::importFromJson(const std::string& jsonData, const ProgressFn& progress) {
+    if (!database) return false;
+
+    std::vector<JsonFields> records;
+    JsonImportReader reader(jsonData);
+    if (!reader.readEntries(records)) {
+        std::cerr << (reader.nestedTooDeep() ? "Import failed: JSON nested too deeply" : "Import failed: malformed JSON")
+                  << std::endl;
+        return false;
+    }
+
+    std::vector<PasswordEntry> entries;
+    entries.reserve(records.size());
+    for (const JsonFields& record : records) {
+        std::string website = field(record, "website");
+        if (website.empty()) website = field(record, "url");
+
+        PasswordEntry entry(field(record, "title"), field(record, "username"), field(record, "password"),
+                            categoryFromField(field(record, "category")), website, field(record, "notes"));
+
+        std::string created = field(record, "createdDate");
+        std::string modified = field(record, "modifiedDate");
+        if (!created.empty()) entry.setCreatedDate(static_cast<time_t>(std::atoll(created.c_str())));
+        if (!modified.empty()) entry.setModifiedDate(static_cast<time_t>(std::atoll(modified.c_str())));
+
+        entries.push_back(std::move(entry));
+    }
+
+    const size_t count = entries.size();
+    return addPasswords(std::move(entries), nullptr, progress) == count;
+}
+
+size_t PasswordManager::addPasswords(std::vector<PasswordEntry> entries, std::vector<int64_t>* ids,
+                                     const ProgressFn& progress) {
+    std::vector<int64_t> rowIds;
+    if (!ids) ids = &rowIds;
+    ids->clear();
+    if (!database) return 0;
+
+    DatabaseManager::BatchOptions options;
+    options.progress = progress;
+    size_t saved = database->savePasswords(entries, options, ids);
+
+    if (passwordsLoaded) {
+        passwords.reserve(passwords.size() + saved);
+        for (size_t i = 0; i < saved; ++i) {
+            entries[i].setId(std::to_string((*ids)[i]));
+            indexEntry(entries[i]);
+            passwords.put(static_cast<EntryStore::Key>((*ids)[i]), std::move(entries[i]));
+        }
+    }
+    return saved;
+}
+
+bool PasswordManager::backupDatabase(const std::string& backupPath) {
+    if (!database) return false;
+
+    return database->backupTo(backupPath);
+}
+
+bool PasswordManager::restoreDatabase(const std::string& backupPath, const ProgressFn& progress) {
+    if (!database) return false;
+
+    bool restored = database->restoreFrom(backupPath, progress);
+    if (restored) {
+        // Drop the stale in-memory copy; it reloads on next use
+        passwords.clear();
+        passwordsLoaded = false;
+        searchIndex.clear();
+        vaultIndex.clear();
+    }
+    return restored;
+}
+
+bool PasswordManager::backupEncrypted(int fd, const ProgressFn& progress) {
+    if (!database) return false;
 
-    for(size_t i = 0; i < passwords.size(); ++i) {
-        ss << passwords[i].toJson();
-        if(i != passwords.size() - 1) ss << ",";
+    std::shared_ptr<const CipherContext> keys = CipherContext::current();
+    if (!keys) {
+        std::cerr << "Backup failed: encryption keys are not loaded" << std::endl;
+        return false;
     }
+    const int64_t total = database->countPasswords();
+    if (total < 0) return false;
+
+    BackupWriter writer(fd, keys, static_cast<uint64_t>(total));
+    size_t done = 0;
+    bool read = database->forEachPassword([&](PasswordEntry&& entry) {
+        if (!writer.add(std::move(entry))) return false;
+        if (progress && ++done % 256 == 0) progress(done, static_cast<size_t>(total));
+        return true;
+    });
+    bool written = writer.finish();   // Always joins the stages, even after a read error
+    if (read && written && progress) progress(done, static_cast<size_t>(total));
+    return read && written;
+}
+
+bool PasswordManager::restoreEncrypted(int fd, const ProgressFn& progress) {
+    if (!database) return false;
+
+    std::shared_ptr<const CipherContext> keys = CipherContext::current();
+    BackupReader reader(fd, keys);
+    if (!reader.isValid()) return false;
+
+    const size_t total = static_cast<size_t>(reader.expectedRows());
+    size_t done = 0;
+    bool restored = database->replaceAllFrom([&](std::vector<PasswordEntry>& batch) {
+        if (!reader.next(batch)) return false;
+        for (PasswordEntry& entry : batch) sealSecrets(*keys, entry);
+        done += batch.size();
+        if (progress && !batch.empty()) progress(done, total);
+        return true;
+    });
+    if (restored) {
+        passwords.clear();
+        passwordsLoaded = false;
+        searchIndex.clear();
+        vaultIndex.clear();
+    }
+    return restored;
+}
+
+bool PasswordManager::changesSince(int64_t since, ChangeSet& out, size_t limit) {
+    out = ChangeSet();
+    out.nextSeq = since;
+    if (!database) return false;
 
-    ss << "]}";
-    return ss.str();
-}
\ No newline at end of file
+    const int64_t floor = database->journalFloor();
+    if (floor < 0) return false;
+    out.snapshot = since < floor;
+
+    // One extra row tells whether another page follows
+    std::vector<JournalChange> changes;
+    if (!database->changesSince(since, limit ? limit + 1 : 0, changes)) return false;
+    if (limit && changes.size() > limit) {
+        changes.resize(limit);
+        out.more = true;
+    }
+
+    std::shared_ptr<const CipherContext> keys;
+    try {
+        for (const JournalChange& change : changes) {
+            putInt(out.records, static_cast<uint64_t>(change.seq), 8);
+            putInt(out.records, static_cast<uint64_t>(change.id), 8);
+            putInt(out.records, change.entry ? 0 : 1, 1);
+            if (const auto& entry = change.entry) {
+                putInt(out.records, static_cast<uint64_t>(entry->getCategory()), 1);
+                putInt(out.records, static_cast<uint64_t>(entry->getCreatedDate()), 8);
+                putInt(out.records, static_cast<uint64_t>(entry->getModifiedDate()), 8);
+                putBytes(out.records, entry->getTitle());
+                putBytes(out.records, entry->getUsername());
+                putBytes(out.records, entry->getWebsite());
+                if (!putSealed(out.records, entry->getSealedPassword(), [&] { return entry->getPassword(); }, keys) ||
+                    !putSealed(out.records, entry->getSealedNotes(), [&] { return entry->getNotes(); }, keys)) {
+                    std::cerr << "Change journal read failed: encryption keys are not loaded" << std::endl;
+                    out = ChangeSet();
+                    return false;
+                }
+            }
+            out.nextSeq = change.seq;
+            ++out.count;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Change journal read failed: " << e.what() << std::endl;
+        out = ChangeSet();
+        return false;
+    }
+    return true;
+}
+
+int64_t PasswordManager::changeSequence() {
+    return database ? database->journalHead() : -1;
+}
+
+bool PasswordManager::compactChanges(int64_t acknowledged) {
+    return database && database->compactJournal(acknowledged);
+}
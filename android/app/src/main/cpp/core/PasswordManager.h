@@ -48,58 +48,231 @@
 
 #include "../models/PasswordEntry.h"
 #include "PasswordGenerator.h"
+#include "SearchIndex.h"
+#include "VaultIndex.h"
+#include "EntryStore.h"
+#include "VaultAuditor.h"
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+class DatabaseManager;
+class JsonWriter;
+class RecordMigration;
+class RekeyMigration;
+
+/**
+ * @brief One page of the change journal, encoded for upload
+ *
+ * `records` holds `count` changes, little-endian:
+ *
+ *   u64 seq | u64 row id | u8 kind (0 upsert, 1 delete)
+ *   upsert only: u8 category | u64 created | u64 modified |
+ *                u32-prefixed title, username and website |
+ *                u32-prefixed password and notes GCM records (empty when unset)
+ *
+ * Secrets travel as raw SimpleAES records under the vault key, possibly
+ * compressed (see RecordCompression: readers open them with
+ * RecordCompression::open). Records stored as BLOBs are copied as they
+ * are; only secrets stored in another form are sealed on the way out.
+ */
+struct ChangeSet {
+    std::string records;
+    size_t count = 0;
+    /** Pass back as `since` for the next page */
+    int64_t nextSeq = 0;
+    /** More changes follow nextSeq */
+    bool more = false;
+    /**
+     * `since` was below the journal floor, so deletions may be missing. The
+     * pages of this pass list every live entry; whatever the reader holds
+     * that they do not list has been deleted.
+     */
+    bool snapshot = false;
+};
 
 class PasswordManager {
 private:
-    std::vector<PasswordEntry> passwords;
+    // Keyed by row id: O(1) lookup, update and delete; hot list-view
+    // columns stored apart from secrets and notes
+    EntryStore passwords;
     PasswordGenerator generator;
     std::string databasePath;
+    std::unique_ptr<DatabaseManager> database;
+    // Converts base64 TEXT secrets of older databases to BLOB records
+    std::unique_ptr<RecordMigration> recordMigration;
+    // Re-encrypts secrets under the new key after a master password change
+    std::unique_ptr<RekeyMigration> rekeyMigration;
+    // Full entries are only materialised when an operation needs all of them
+    bool passwordsLoaded;
+    // Indexes over `passwords`, kept in step with every change to it
+    SearchIndex searchIndex;
+    VaultIndex vaultIndex;
 
-    // Database methods
+    // Database methods (delegate to the connection owned by `database`)
     bool initializeDatabase();
     bool loadPasswordsFromDatabase();
-    bool savePasswordToDatabase(const PasswordEntry& entry);
-    bool deletePasswordFromDatabase(int id);
+    void ensurePasswordsLoaded();
+    /** @brief Drop an ended re-key and, with it, the entries cached before it */
+    void collectRekey();
+    void indexEntry(const PasswordEntry& entry);
+    void writeExport(JsonWriter& json) const;
+    std::vector<PasswordEntry> entriesForIds(const std::vector<std::string_view>& ids) const;
+    bool savePasswordToDatabase(PasswordEntry& entry);
+    bool deletePasswordFromDatabase(int64_t id);
 
 public:
+    /** @brief Bulk import/restore progress: rows committed so far out of total */
+    using ProgressFn = std::function<void(size_t done, size_t total)>;
+    /** @brief Visitors see entries in place; the reference is only valid during the call */
+    using EntryVisitor = std::function<void(const PasswordEntry& entry)>;
+    using EntryFilter = std::function<bool(const PasswordEntry& entry)>;
+    /** @brief Returns false to end the page */
+    using PageVisitor = std::function<bool(const PasswordEntry& entry)>;
+    /** @brief Row visitors see list-view columns only; the views are valid during the call */
+    using RowVisitor = std::function<void(const EntryRow& row)>;
+
     PasswordManager();
+    ~PasswordManager();
 
     // Set database path (call this before any operations)
     void setDatabasePath(const std::string& path);
+    /** @brief Whether the background TEXT-to-BLOB record migration is still running */
+    bool isMigratingRecords() const;
+    /**
+     * @brief Start re-encrypting the vault if a master password change left it pending
+     *
+     * Also done by setDatabasePath; call it after a change made while the
+     * database was open. Returns whether a re-key is running.
+     */
+    bool startRekey();
+    /** @brief Whether records sealed under a retired key are still being re-encrypted */
+    bool isRekeying() const;
 
     // Password operations
     bool addPassword(const std::string& title, const std::string& username,
                      const std::string& password, Category category,
                      const std::string& website = "", const std::string& notes = "");
+    /**
+     * @brief Insert many entries through batched transactions
+     *
+     * Stops at the first failing row, as DatabaseManager::savePasswords
+     * does, and returns how many were committed. `ids` receives their row
+     * ids in input order.
+     */
+    size_t addPasswords(std::vector<PasswordEntry> entries, std::vector<int64_t>* ids = nullptr,
+                        const ProgressFn& progress = ProgressFn());
 
-    bool deletePassword(int id);
-    std::vector<PasswordEntry> getAllPasswords() const { return passwords; }
+    bool deletePassword(int64_t id);
+    /** @brief Persist edits made through PasswordEntry setters (matched by id) */
+    bool updatePassword(const PasswordEntry& entry);
+    std::vector<PasswordEntry> getAllPasswords();
+
+    // Paged access for list views: summaries only, secrets fetched per entry
+    std::vector<PasswordSummary> loadPage(size_t offset, size_t limit,
+                                          PasswordSortKey sortKey = PasswordSortKey::TITLE);
+    std::optional<PasswordSecrets> loadSecrets(int64_t id);
+    std::optional<PasswordEntry> getPasswordById(int64_t id);
 
     // Search and filter
     std::vector<PasswordEntry> getPasswordsByCategory(Category category);
+    size_t getCategoryCount(Category category);
+    /** @brief Entries whose website shares the registrable domain of url (autofill) */
+    std::vector<PasswordEntry> getPasswordsForDomain(const std::string& url);
+    std::vector<std::string_view> getPasswordIdsForDomain(const std::string& url);
+    /** @brief Entries saved for an Android app package, or its reversed domain (autofill) */
+    std::vector<PasswordEntry> getPasswordsForPackage(const std::string& package);
+    std::vector<std::string_view> getPasswordIdsForPackage(const std::string& package);
+    /** @brief Most recently modified first; limit 0 returns all */
+    std::vector<PasswordEntry> getRecentPasswords(size_t limit);
     std::vector<PasswordEntry> searchPasswords(const std::string& query);
+    /** @brief Ranked ids only, for search-as-you-type without copying entries */
+    std::vector<SearchIndex::Hit> searchPasswordIds(const std::string& query, size_t limit = 0);
+
+    // Non-copying iteration: visitors must not call back into the manager.
+    // Each returns the number of entries visited.
+    size_t forEachPassword(const EntryVisitor& visit, const EntryFilter& filter = nullptr);
+    /**
+     * @brief Entries from position `start` on, until `visit` returns false
+     *
+     * Entries before `start` are not loaded at all. The entry refused by
+     * `visit` counts as visited.
+     */
+    size_t forEachPasswordFrom(size_t start, const PageVisitor& visit);
+    /**
+     * @brief Id, title, username, website, category and dates of every entry
+     *
+     * For list rendering: reads the hot columns only, never a secret or a
+     * note. `category` limits it to one category.
+     */
+    size_t forEachRow(const RowVisitor& visit, std::optional<Category> category = std::nullopt);
+    size_t forEachInCategory(Category category, const EntryVisitor& visit);
+    size_t forEachSearchResult(const std::string& query, const EntryVisitor& visit, size_t limit = 0);
+    /** @brief Autofill candidates for a page URL or an app package (see VaultIndex) */
+    size_t forEachMatchForUrl(const std::string& url, const EntryVisitor& visit);
+    size_t forEachMatchForPackage(const std::string& package, const EntryVisitor& visit);
+    /** @brief Entries for the given row ids, in request order; unknown ids are skipped */
+    size_t forEachById(const int64_t* ids, size_t count, const EntryVisitor& visit);
 
     // Analysis
     std::string analyzePassword(const std::string& password);
     std::map<std::string, int> getCategoryStats();
+    /** @brief Weak, reused and near-duplicate passwords across the whole vault */
+    VaultAuditReport auditVault(const VaultAuditOptions& options = VaultAuditOptions());
 
     // Generation
     std::string generateRandomPassword(int length = 16);
     std::string generateFromFavorite(const std::string& favorite, int length = 12);
     std::string generateMemorablePassword();
     std::string generatePin(int length = 6);
+    std::string generatePassword(const GenerationPolicy& policy);
+    /** @brief `count` passwords for one policy in a single wiped-on-destruction buffer */
+    PasswordBatch generatePasswords(size_t count, const GenerationPolicy& policy);
 
     // Data management
     std::string exportToJson();
-    bool importFromJson(const std::string& jsonData);
-    int getTotalCount() const { return passwords.size(); }
+    /** @brief Stream the same document to a file in bounded chunks */
+    bool exportToFile(const std::string& path);
+    bool importFromJson(const std::string& jsonData, const ProgressFn& progress = ProgressFn());
+    int getTotalCount();
 
     // Database management
     bool backupDatabase(const std::string& backupPath);
-    bool restoreDatabase(const std::string& backupPath);
+    bool restoreDatabase(const std::string& backupPath, const ProgressFn& progress = ProgressFn());
+    /**
+     * @brief Stream an encrypted logical backup (see BackupStream) to `fd`
+     *
+     * Rows are read, serialized, encrypted and written in a pipeline, so
+     * memory stays flat at any vault size. Needs the vault keys to be loaded.
+     * `fd` is written sequentially and left open.
+     */
+    bool backupEncrypted(int fd, const ProgressFn& progress = ProgressFn());
+    /**
+     * @brief Replace the vault with a backupEncrypted stream read from `fd`
+     *
+     * Every chunk is authenticated before it is applied and the rows go in
+     * one transaction, so a damaged or truncated stream changes nothing.
+     * Restored secrets are sealed as records under the current key.
+     */
+    bool restoreEncrypted(int fd, const ProgressFn& progress = ProgressFn());
+
+    // Incremental sync over the change journal (see DatabaseManager)
+    /**
+     * @brief The latest change of each entry changed after `since`, at most `limit`
+     *
+     * Cost follows the number of changed entries, not the vault size.
+     * False if the journal cannot be read, or if a secret needs sealing
+     * and the keys are not loaded.
+     */
+    bool changesSince(int64_t since, ChangeSet& out, size_t limit = 256);
+    /** @brief Latest journal sequence number (0 before any change), -1 without a database */
+    int64_t changeSequence();
+    /** @brief Compact the journal once the sync peer holds everything up to `acknowledged` */
+    bool compactChanges(int64_t acknowledged);
 };
 
 #endif
\ No newline at end of file
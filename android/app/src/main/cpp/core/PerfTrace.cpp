@@ -0,0 +1,139 @@
+#include "PerfTrace.h"
+#include "JsonWriter.h"
+#include <atomic>
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+
+namespace {
+
+struct alignas(64) OpCounters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalNanos{0};
+    std::atomic<uint64_t> maxNanos{0};
+    std::atomic<uint64_t> buckets[PerfStats::BUCKETS] = {};
+};
+
+OpCounters g_counters[static_cast<size_t>(PerfOp::COUNT)];
+
+const char* const OP_NAMES[] = {"keySetup", "deriveKey", "encrypt", "decrypt", "vaultLoad", "search", "cryptBatch"};
+static_assert(sizeof(OP_NAMES) / sizeof(OP_NAMES[0]) == static_cast<size_t>(PerfOp::COUNT),
+              "every PerfOp needs a name");
+
+size_t bucketFor(uint64_t nanos) {
+    if (nanos >> PerfStats::BUCKET_SHIFT == 0) return 0;
+    const size_t log2 = 63 - static_cast<size_t>(__builtin_clzll(nanos));
+    const size_t bucket = log2 - (PerfStats::BUCKET_SHIFT - 1);
+    return bucket < PerfStats::BUCKETS ? bucket : PerfStats::BUCKETS - 1;
+}
+
+uint64_t bucketUpperBound(size_t bucket) {
+    return uint64_t(1) << (bucket + PerfStats::BUCKET_SHIFT);
+}
+
+// ATrace_* arrived in API 23; resolve them at runtime so lower minSdk
+// builds still load, and skip tracing where they are missing
+struct Tracer {
+    bool (*isEnabled)() = nullptr;
+    void (*beginSection)(const char* name) = nullptr;
+    void (*endSection)() = nullptr;
+
+    Tracer() {
+#ifdef __ANDROID__
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) return;
+        isEnabled = reinterpret_cast<bool (*)()>(dlsym(lib, "ATrace_isEnabled"));
+        beginSection = reinterpret_cast<void (*)(const char*)>(dlsym(lib, "ATrace_beginSection"));
+        endSection = reinterpret_cast<void (*)()>(dlsym(lib, "ATrace_endSection"));
+        if (!isEnabled || !beginSection || !endSection) {
+            isEnabled = nullptr;
+        }
+        // libandroid stays loaded for the life of the process
+#endif
+    }
+
+    bool active() const { return isEnabled && isEnabled(); }
+};
+
+const Tracer& tracer() {
+    static const Tracer instance;
+    return instance;
+}
+
+} // namespace
+
+void PerfStats::record(PerfOp op, uint64_t nanos) noexcept {
+    OpCounters& c = g_counters[static_cast<size_t>(op)];
+    c.count.fetch_add(1, std::memory_order_relaxed);
+    c.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    c.buckets[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t seen = c.maxNanos.load(std::memory_order_relaxed);
+    while (nanos > seen && !c.maxNanos.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void PerfStats::reset() noexcept {
+    for (OpCounters& c : g_counters) {
+        c.count.store(0, std::memory_order_relaxed);
+        c.totalNanos.store(0, std::memory_order_relaxed);
+        c.maxNanos.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : c.buckets) bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* PerfStats::name(PerfOp op) {
+    const size_t index = static_cast<size_t>(op);
+    return index < static_cast<size_t>(PerfOp::COUNT) ? OP_NAMES[index] : "unknown";
+}
+
+std::string PerfStats::json() {
+    JsonWriter json;
+    json.beginObject().member("enabled", SECUREFLOW_PERF_STATS != 0);
+    json.key("ops").beginObject();
+    for (size_t op = 0; op < static_cast<size_t>(PerfOp::COUNT); ++op) {
+        const OpCounters& c = g_counters[op];
+        uint64_t histogram[BUCKETS];
+        uint64_t samples = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            histogram[b] = c.buckets[b].load(std::memory_order_relaxed);
+            samples += histogram[b];
+        }
+        if (samples == 0) continue;
+
+        // Percentiles from the same snapshot as the histogram they describe
+        auto percentile = [&](uint64_t permille) {
+            const uint64_t rank = (samples * permille + 999) / 1000;
+            uint64_t seen = 0;
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                seen += histogram[b];
+                if (seen >= rank) return bucketUpperBound(b);
+            }
+            return bucketUpperBound(BUCKETS - 1);
+        };
+
+        json.key(OP_NAMES[op]).beginObject()
+            .member("count", c.count.load(std::memory_order_relaxed))
+            .member("totalNs", c.totalNanos.load(std::memory_order_relaxed))
+            .member("maxNs", c.maxNanos.load(std::memory_order_relaxed))
+            .member("p50Ns", percentile(500))
+            .member("p90Ns", percentile(900))
+            .member("p99Ns", percentile(990));
+        json.key("histogram").beginArray();
+        for (uint64_t n : histogram) json.value(n);
+        json.endArray().endObject();
+    }
+    json.endObject().endObject();
+    return json.take();
+}
+
+PerfScope::PerfScope(PerfOp op) noexcept
+    : op(op), traced(tracer().active()), start(std::chrono::steady_clock::now()) {
+    if (traced) tracer().beginSection(PerfStats::name(op));
+}
+
+PerfScope::~PerfScope() {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (traced) tracer().endSection();
+    PerfStats::record(op, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
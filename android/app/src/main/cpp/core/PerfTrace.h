@@ -0,0 +1,97 @@
+#ifndef PERFTRACE_H
+#define PERFTRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Compile-time switch for all instrumentation. With 0, PERF_SCOPE expands to
+// nothing and the stats report "enabled": false. CMake sets it (on for
+// Debug builds only); other builds follow NDEBUG.
+#ifndef SECUREFLOW_PERF_STATS
+#ifdef NDEBUG
+#define SECUREFLOW_PERF_STATS 0
+#else
+#define SECUREFLOW_PERF_STATS 1
+#endif
+#endif
+
+/** @brief Instrumented operations; each has its own counters and trace section name */
+enum class PerfOp : uint8_t {
+    KEY_SETUP = 0,    // Password to published CipherContext, KDF included
+    DERIVE_KEY,       // One PBKDF2::deriveKey run
+    ENCRYPT,          // One single-field FFI encryption (cpp_encrypt_aes*)
+    DECRYPT,          // One single-field FFI decryption (cpp_decrypt_aes*)
+    VAULT_LOAD,       // Loading every entry from SQLite or the vault file
+    SEARCH,           // One SearchIndex query
+    CRYPT_BATCH,      // One FFI batch of encryptions, decryptions or reseals
+    COUNT
+};
+
+/**
+ * @brief Process-wide, lock-free latency counters per PerfOp
+ *
+ * Scopes sit on API entry points, never on per-record primitives: a vault
+ * load or batch is one sample, however many records it touches.
+ * Each operation keeps a count, total and maximum latency and a log2
+ * histogram in relaxed atomics, on its own cache line. Recording costs a
+ * few uncontended atomic adds. Readers get a consistent-enough snapshot
+ * for diagnostics, not an exact one.
+ */
+class PerfStats {
+public:
+    /** Bucket 0 is < 2^BUCKET_SHIFT ns (256 ns); bucket i covers [2^(i+7), 2^(i+8)) ns; the last is open-ended */
+    static constexpr size_t BUCKETS = 32;
+    static constexpr unsigned BUCKET_SHIFT = 8;
+
+    static void record(PerfOp op, uint64_t nanos) noexcept;
+    static void reset() noexcept;
+
+    /**
+     * @brief Stats as JSON
+     *
+     *   {"enabled":true,"ops":{"encrypt":{"count":..,"totalNs":..,"maxNs":..,
+     *    "p50Ns":..,"p90Ns":..,"p99Ns":..,"histogram":[..]},...}}
+     *
+     * Percentiles are bucket upper bounds, so they are accurate to a factor
+     * of two. Operations that never ran are left out.
+     */
+    static std::string json();
+
+    /** @brief Stable name used in JSON and as the trace section name */
+    static const char* name(PerfOp op);
+};
+
+/**
+ * @brief Times a scope into PerfStats and marks it as an ATrace section
+ *
+ * On Android the section shows up in Perfetto/systrace captures that
+ * include the app's atrace category. The ATrace functions are looked up
+ * at runtime, so older API levels simply skip tracing. Begin and end run
+ * on the constructing thread, as ATrace requires.
+ */
+class PerfScope {
+public:
+    explicit PerfScope(PerfOp op) noexcept;
+    ~PerfScope();
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    const PerfOp op;
+    const bool traced;
+    const std::chrono::steady_clock::time_point start;
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+
+#if SECUREFLOW_PERF_STATS
+#define PERF_SCOPE(op) PerfScope PERF_CONCAT(perfScope_, __LINE__)(op)
+#else
+#define PERF_SCOPE(op) ((void)0)
+#endif
+
+#endif // PERFTRACE_H
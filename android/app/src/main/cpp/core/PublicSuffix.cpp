@@ -0,0 +1,210 @@
+#include "PublicSuffix.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Space-separated PSL rules, one group per registry. Single-label TLDs are
+// left out: the implicit "*" rule already treats them as public suffixes.
+// "*.x" marks every child of x as a suffix, "!y.x" exempts one of them.
+constexpr const char* const RULES[] = {
+    // ICANN country-code registries
+    "ac.ae co.ae gov.ae mil.ae net.ae org.ae sch.ae",
+    "com.ar edu.ar gob.ar gov.ar int.ar mil.ar net.ar org.ar tur.ar",
+    "ac.at co.at gv.at or.at",
+    "asn.au com.au edu.au gov.au id.au net.au org.au",
+    "*.bd",
+    "com.br edu.br gov.br net.br org.br art.br blog.br eco.br emp.br ind.br inf.br",
+    "ab.ca bc.ca mb.ca nb.ca nf.ca nl.ca ns.ca nt.ca nu.ca on.ca pe.ca qc.ca sk.ca yk.ca gc.ca",
+    "*.ck !www.ck",
+    "co.cl gob.cl gov.cl mil.cl",
+    "ac.cn com.cn edu.cn gov.cn mil.cn net.cn org.cn",
+    "com.co edu.co gov.co mil.co net.co nom.co org.co",
+    "com.cy gov.cy net.cy org.cy",
+    "com.ec edu.ec gob.ec gov.ec net.ec org.ec",
+    "com.eg edu.eg eun.eg gov.eg mil.eg net.eg org.eg sci.eg",
+    "com.es edu.es gob.es nom.es org.es",
+    "*.er",
+    "asso.fr com.fr gouv.fr nom.fr prd.fr tm.fr",
+    "com.gh edu.gh gov.gh org.gh",
+    "com.gr edu.gr gov.gr net.gr org.gr",
+    "com.hk edu.hk gov.hk idv.hk net.hk org.hk",
+    "ac.id co.id go.id mil.id my.id net.id or.id sch.id web.id",
+    "ac.il co.il gov.il idf.il k12.il muni.il net.il org.il",
+    "ac.in co.in edu.in firm.in gen.in gov.in ind.in mil.in net.in nic.in org.in res.in",
+    "ac.ir co.ir gov.ir id.ir net.ir org.ir sch.ir",
+    "edu.it gov.it",
+    "ac.jp ad.jp co.jp ed.jp go.jp gr.jp lg.jp ne.jp or.jp",
+    "*.kawasaki.jp *.kitakyushu.jp *.kobe.jp *.nagoya.jp *.sapporo.jp *.sendai.jp *.yokohama.jp",
+    "!city.kawasaki.jp !city.kitakyushu.jp !city.kobe.jp !city.nagoya.jp !city.sapporo.jp",
+    "!city.sendai.jp !city.yokohama.jp",
+    "ac.ke co.ke go.ke info.ke me.ke mobi.ke ne.ke or.ke sc.ke",
+    "*.kh",
+    "ac.kr co.kr es.kr go.kr hs.kr kg.kr mil.kr ms.kr ne.kr or.kr pe.kr re.kr sc.kr",
+    "com.kw edu.kw gov.kw net.kw org.kw",
+    "com.lb edu.lb gov.lb net.lb org.lb",
+    "ac.lk com.lk edu.lk gov.lk net.lk org.lk",
+    "com.mt edu.mt gov.mt net.mt org.mt",
+    "com.mx edu.mx gob.mx net.mx org.mx",
+    "com.my edu.my gov.my mil.my name.my net.my org.my",
+    "com.ng edu.ng gov.ng mil.ng net.ng org.ng sch.ng",
+    "*.np",
+    "ac.nz co.nz cri.nz geek.nz gen.nz govt.nz health.nz iwi.nz kiwi.nz maori.nz mil.nz net.nz org.nz"
+    " parliament.nz school.nz",
+    "com.pe edu.pe gob.pe mil.pe net.pe nom.pe org.pe",
+    "com.ph edu.ph gov.ph mil.ph net.ph ngo.ph org.ph",
+    "com.pk edu.pk gob.pk gov.pk net.pk org.pk",
+    "com.pl edu.pl gov.pl info.pl net.pl org.pl",
+    "com.pt edu.pt gov.pt org.pt",
+    "com.qa edu.qa gov.qa net.qa org.qa",
+    "co.rs edu.rs gov.rs in.rs org.rs",
+    "ac.ru edu.ru gov.ru int.ru mil.ru",
+    "com.sa edu.sa gov.sa med.sa net.sa org.sa pub.sa sch.sa",
+    "com.sg edu.sg gov.sg net.sg org.sg per.sg",
+    "ac.th co.th go.th in.th mi.th net.th or.th",
+    "av.tr bbs.tr bel.tr biz.tr com.tr dr.tr edu.tr gen.tr gov.tr info.tr k12.tr net.tr org.tr tel.tr",
+    "com.tw edu.tw gov.tw idv.tw mil.tw net.tw org.tw",
+    "com.ua edu.ua gov.ua in.ua net.ua org.ua",
+    "ac.uk co.uk gov.uk ltd.uk me.uk net.uk nhs.uk org.uk plc.uk police.uk *.sch.uk",
+    "dni.us fed.us isa.us kids.us nsn.us",
+    "com.uy edu.uy gub.uy net.uy org.uy",
+    "com.ve edu.ve gob.ve net.ve org.ve",
+    "com.vn edu.vn gov.vn net.vn org.vn",
+    "ac.za co.za edu.za gov.za law.za mil.za net.za nom.za org.za school.za web.za",
+    // Hosting platforms: each subdomain is a different owner
+    "appspot.com blogspot.com cloudfront.net azurewebsites.net elasticbeanstalk.com herokuapp.com",
+    "firebaseapp.com web.app github.io gitlab.io netlify.app vercel.app pages.dev workers.dev",
+    "fly.dev onrender.com glitch.me myshopify.com wixsite.com ngrok.io s3.amazonaws.com",
+    "*.compute.amazonaws.com blogspot.co.uk",
+};
+
+enum NodeFlags : uint8_t {
+    RULE = 1,        // This node ends a rule
+    EXCEPTION = 2,   // "!" rule: this label is registrable, not a suffix
+    WILDCARD = 4,    // "*" rule below this node: every child label is a suffix
+};
+
+struct Node {
+    std::string_view label;
+    uint32_t firstChild = 0;
+    uint32_t childCount = 0;
+    uint8_t flags = 0;
+};
+
+class Trie {
+public:
+    Trie() {
+        // Build a pointer tree, then lay it out breadth-first so siblings are contiguous
+        struct Builder {
+            uint8_t flags = 0;
+            std::map<std::string_view, std::unique_ptr<Builder>> children;   // Sorted by label
+        };
+        Builder root;
+        for (const char* group : RULES) {
+            std::string_view rules(group);
+            while (!rules.empty()) {
+                size_t space = rules.find(' ');
+                std::string_view rule = rules.substr(0, space);
+                rules.remove_prefix(space == std::string_view::npos ? rules.size() : space + 1);
+                if (rule.empty()) continue;
+
+                uint8_t flag = RULE;
+                if (rule.front() == '!') {
+                    flag = EXCEPTION;
+                    rule.remove_prefix(1);
+                } else if (rule.compare(0, 2, "*.") == 0) {
+                    flag = WILDCARD;
+                    rule.remove_prefix(2);
+                }
+                Builder* node = &root;
+                while (!rule.empty()) {
+                    size_t dot = rule.rfind('.');
+                    std::string_view label = rule.substr(dot == std::string_view::npos ? 0 : dot + 1);
+                    rule.remove_suffix(dot == std::string_view::npos ? rule.size() : rule.size() - dot);
+                    std::unique_ptr<Builder>& child = node->children[label];
+                    if (!child) child = std::make_unique<Builder>();
+                    node = child.get();
+                }
+                node->flags |= flag;
+            }
+        }
+
+        nodes.emplace_back();
+        std::vector<const Builder*> queue{&root};
+        for (size_t i = 0; i < queue.size(); ++i) {
+            nodes[i].flags = queue[i]->flags;
+            nodes[i].firstChild = static_cast<uint32_t>(nodes.size());
+            nodes[i].childCount = static_cast<uint32_t>(queue[i]->children.size());
+            for (const auto& child : queue[i]->children) {
+                Node node;
+                node.label = child.first;
+                nodes.push_back(node);
+                queue.push_back(child.second.get());
+            }
+        }
+    }
+
+    /** @brief Child of `parent` with `label`, or 0 (the root is never a child) */
+    uint32_t child(uint32_t parent, std::string_view label) const {
+        const Node& p = nodes[parent];
+        auto begin = nodes.begin() + p.firstChild;
+        auto end = begin + p.childCount;
+        auto it = std::lower_bound(begin, end, label, [](const Node& n, std::string_view l) { return n.label < l; });
+        return (it != end && it->label == label) ? static_cast<uint32_t>(it - nodes.begin()) : 0;
+    }
+
+    uint8_t flags(uint32_t node) const { return nodes[node].flags; }
+
+private:
+    std::vector<Node> nodes;
+};
+
+const Trie& trie() {
+    static const Trie instance;
+    return instance;
+}
+
+/** @brief Offset in `host` where its public suffix starts; 0 when the whole host is one */
+size_t suffixStart(std::string_view host) {
+    const Trie& t = trie();
+    size_t start = std::string_view::npos;
+    uint32_t node = 0;
+    size_t labelEnd = host.size();
+
+    for (;;) {
+        const size_t dot = labelEnd == 0 ? std::string_view::npos : host.rfind('.', labelEnd - 1);
+        const size_t labelBegin = dot == std::string_view::npos ? 0 : dot + 1;
+        const std::string_view label = host.substr(labelBegin, labelEnd - labelBegin);
+        if (start == std::string_view::npos) start = labelBegin;   // Implicit "*" rule
+
+        const uint32_t child = t.child(node, label);
+        if (child && (t.flags(child) & EXCEPTION)) {
+            return labelEnd + 1;   // The suffix is what lies right of this label
+        }
+        if (t.flags(node) & WILDCARD) start = labelBegin;
+        if (child && (t.flags(child) & RULE)) start = labelBegin;
+
+        if (!child || dot == std::string_view::npos) break;
+        node = child;
+        labelEnd = dot;
+    }
+    return start;
+}
+
+} // namespace
+
+std::string_view PublicSuffix::suffix(std::string_view host) {
+    if (host.empty()) return host;
+    return host.substr(suffixStart(host));
+}
+
+std::string_view PublicSuffix::registrableDomain(std::string_view host) {
+    if (host.empty()) return host;
+    const size_t start = suffixStart(host);
+    if (start < 2) return std::string_view();   // The host is a public suffix
+    const size_t dot = host.rfind('.', start - 2);
+    return host.substr(dot == std::string_view::npos ? 0 : dot + 1);
+}
@@ -0,0 +1,35 @@
+#ifndef PUBLICSUFFIX_H
+#define PUBLICSUFFIX_H
+
+#include <string_view>
+
+/**
+ * @brief Public suffix lookup over an embedded subset of the Public Suffix List
+ *
+ * The rules (ICANN country-code registries, wildcard and exception rules,
+ * and hosting platforms whose subdomains belong to different owners, such
+ * as github.io) are string literals in PublicSuffix.cpp. On first use they
+ * are compiled into a flat trie keyed by label from the right. Siblings
+ * are contiguous and sorted, and labels are views into the literals, so a
+ * lookup walks the host's labels once with a binary search per level and
+ * never allocates. Hosts without a matching rule fall back to the PSL's
+ * implicit "*" rule: the top-level label is the public suffix.
+ *
+ * Inputs are lower-case ASCII hosts without a trailing dot (punycode for
+ * IDNs). Thread-safe.
+ */
+class PublicSuffix {
+public:
+    /**
+     * @brief Public suffix plus one label ("shop.example.co.uk" -> "example.co.uk")
+     *
+     * Empty when the host is itself a public suffix or has a single label.
+     * The result is a view into `host`.
+     */
+    static std::string_view registrableDomain(std::string_view host);
+
+    /** @brief Public suffix of the host ("example.co.uk" -> "co.uk") */
+    static std::string_view suffix(std::string_view host);
+};
+
+#endif // PUBLICSUFFIX_H
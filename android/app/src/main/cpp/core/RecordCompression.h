@@ -0,0 +1,111 @@
+#ifndef RECORDCOMPRESSION_H
+#define RECORDCOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "SecureArena.h"
+#include "SimpleAES.h"
+
+/**
+ * @brief Compression stage in front of raw record encryption
+ *
+ * Compressed payloads are "varint plain length | LZ4 block" and the record
+ * header flags say so (SimpleAES::RECORD_FLAG_*), so every record describes
+ * itself and uncompressed records from older builds read as before.
+ *
+ * Whether to compress is decided per record: inputs below a minimum size
+ * are sealed as they are, large inputs are first probed on a sample and
+ * skipped when it does not shrink, and the result is kept only if it
+ * saves at least 1/16 of the input. Random passwords and already
+ * compressed data therefore cost one cheap attempt at most.
+ *
+ * Short notes rarely repeat themselves but do repeat common phrases, so
+ * they are compressed against a built-in text dictionary
+ * (Dictionary::TEXT). Its contents are part of the record format: it may
+ * only ever be extended by a new flag, never edited.
+ *
+ * Compressed bytes are as sensitive as the plaintext: intermediates live
+ * in SecureBuffer and are wiped.
+ */
+class RecordCompression {
+public:
+    enum class Dictionary {
+        NONE,   // Bulk data (backup chunks)
+        TEXT    // Short user text: notes, secrets
+    };
+
+    /** Inputs below this are never compressed */
+    static constexpr size_t MIN_INPUT = 64;
+    static constexpr size_t MIN_INPUT_TEXT = 24;
+    /** Inputs above this are probed on their first SAMPLE_SIZE bytes first */
+    static constexpr size_t SAMPLE_SIZE = 4096;
+    /** Largest plaintext unpack() will expand to */
+    static constexpr size_t MAX_PLAIN = 64u * 1024 * 1024;
+
+    /**
+     * @brief Compress `plain` into `packed` if it is worth it
+     * @return Record flags for the packed payload, or 0 when `plain` should
+     *         be sealed as it is (`packed` is then left empty)
+     */
+    static uint8_t pack(const uint8_t* plain, size_t length, Dictionary dictionary, SecureBuffer& packed);
+
+    /**
+     * @brief Expand a payload written with record flags `flags`
+     * @throws std::runtime_error if the payload is malformed or flags are unknown
+     */
+    static void unpack(uint8_t flags, const uint8_t* payload, size_t length, std::string& out);
+
+    /**
+     * @brief Raw record of `plain` under `keys`, compressed when worthwhile
+     *
+     * `Keys` is SimpleAES or CipherContext (primary key). `context` is
+     * authenticated with the record, see SimpleAES::encryptRecord.
+     */
+    template <typename Keys>
+    static std::string seal(const Keys& keys, const uint8_t* plain, size_t length, Dictionary dictionary,
+                            const uint8_t* context = nullptr, size_t contextLength = 0) {
+        SecureBuffer packed;
+        const uint8_t flags = pack(plain, length, dictionary, packed);
+        if (flags != 0) {
+            plain = packed.data();
+            length = packed.size();
+        }
+        std::string record(SimpleAES::recordSize(length), '\0');
+        keys.encryptRecord(plain, length, reinterpret_cast<uint8_t*>(&record[0]), record.size(), flags, context,
+                           contextLength);
+        return record;
+    }
+
+    /**
+     * @brief Plaintext of any raw record, compressed or not; the caller wipes it
+     * @throws std::runtime_error as Keys::decryptRecord, or if the payload is malformed
+     */
+    template <typename Keys>
+    static std::string open(const Keys& keys, const uint8_t* record, size_t length,
+                            const uint8_t* context = nullptr, size_t contextLength = 0) {
+        std::string plain(length > SimpleAES::RECORD_OVERHEAD ? length - SimpleAES::RECORD_OVERHEAD : 0, '\0');
+        uint8_t flags = 0;
+        try {
+            plain.resize(keys.decryptRecord(record, length, reinterpret_cast<uint8_t*>(&plain[0]), plain.size(),
+                                            &flags, context, contextLength));
+        } catch (...) {
+            SecureArena::wipe(&plain[0], plain.size());
+            throw;
+        }
+        if (flags == 0) return plain;
+
+        std::string expanded;
+        try {
+            unpack(flags, reinterpret_cast<const uint8_t*>(plain.data()), plain.size(), expanded);
+        } catch (...) {
+            SecureArena::wipe(&plain[0], plain.size());
+            throw;
+        }
+        SecureArena::wipe(&plain[0], plain.size());
+        return expanded;
+    }
+};
+
+#endif // RECORDCOMPRESSION_H
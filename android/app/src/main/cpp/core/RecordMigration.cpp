@@ -0,0 +1,58 @@
+#include "RecordMigration.h"
+#include "DatabaseManager.h"
+#include <iostream>
+#include <utility>
+
+RecordMigration::RecordMigration(std::string databasePath, size_t batchSize, ProgressFn progress)
+    : databasePath(std::move(databasePath)),
+      batchSize(batchSize == 0 ? DEFAULT_BATCH : batchSize),
+      progress(std::move(progress)),
+      worker(&RecordMigration::run, this) {}
+
+RecordMigration::~RecordMigration() {
+    stop();
+    wait();
+}
+
+void RecordMigration::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    wake.notify_all();
+}
+
+void RecordMigration::wait() {
+    if (worker.joinable()) worker.join();
+}
+
+void RecordMigration::run() {
+    DatabaseManager database(databasePath);
+    size_t examined = 0;
+    bool finished = false;
+
+    if (database.isDatabaseOpen()) {
+        int64_t cursor = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            lock.unlock();
+            const size_t rows = database.migrateRecords(cursor, batchSize);
+            examined += rows;
+            if (rows == 0) {
+                finished = !database.needsRecordMigration();
+                lock.lock();
+                break;
+            }
+            if (progress) progress(examined, false);
+
+            lock.lock();
+            wake.wait_for(lock, BATCH_PAUSE, [this] { return stopRequested; });
+        }
+    }
+
+    if (finished) {
+        std::cout << "Record migration finished after " << examined << " rows" << std::endl;
+    }
+    if (progress) progress(examined, finished);
+    running.store(false, std::memory_order_release);
+}
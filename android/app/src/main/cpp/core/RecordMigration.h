@@ -0,0 +1,62 @@
+#ifndef RECORDMIGRATION_H
+#define RECORDMIGRATION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Background conversion of base64 record TEXT rows to BLOB records
+ *
+ * Runs DatabaseManager::migrateRecords on a worker thread through its own
+ * connection to the vault file. WAL lets the foreground connection keep
+ * reading throughout. Each batch is one short write transaction, followed
+ * by a pause so foreground saves get the write lock. Nothing is decrypted:
+ * the migration only strips the base64 layer, so it can run while the vault
+ * is locked. When the pass completes, the database is stamped with
+ * RECORD_SCHEMA_VERSION. An interrupted pass starts again on the next launch.
+ */
+class RecordMigration {
+public:
+    /** @brief Rows examined so far; the final call has `finished` set if the pass completed */
+    using ProgressFn = std::function<void(size_t examined, bool finished)>;
+
+    static constexpr size_t DEFAULT_BATCH = 256;
+    static constexpr std::chrono::milliseconds BATCH_PAUSE{20};
+
+    /** @brief Start migrating the database at databasePath */
+    explicit RecordMigration(std::string databasePath, size_t batchSize = DEFAULT_BATCH,
+                             ProgressFn progress = ProgressFn());
+    /** @brief Stops after the running batch and joins the worker */
+    ~RecordMigration();
+
+    RecordMigration(const RecordMigration&) = delete;
+    RecordMigration& operator=(const RecordMigration&) = delete;
+
+    /** @brief Ask the worker to stop after the running batch; does not wait */
+    void stop();
+    /** @brief Block until the worker has exited */
+    void wait();
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+private:
+    void run();
+
+    const std::string databasePath;
+    const size_t batchSize;
+    const ProgressFn progress;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopRequested = false;
+    std::atomic<bool> running{true};
+    std::thread worker;   // Last: started once everything above is set up
+};
+
+#endif // RECORDMIGRATION_H
@@ -0,0 +1,170 @@
+#include "RekeyMigration.h"
+#include "CipherContext.h"
+#include "CryptoWorkerPool.h"
+#include "DatabaseManager.h"
+#include "KeyRotation.h"
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <utility>
+
+struct RekeyMigration::Engine {
+    enum class Outcome { NEXT, RETRY, FINISHED, FAILED };
+
+    const std::string databasePath;
+    const size_t batchSize;
+    const ProgressFn progress;
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    bool stopRequested = false;
+    bool busy = false;      // A batch is running
+    bool running = true;    // The pass has not ended
+
+    // Touched only by the running batch
+    std::unique_ptr<DatabaseManager> database;
+    uint64_t rotation = 0;
+    int64_t cursor = 0;
+    size_t examined = 0;
+    RekeyTally pass;   // Current pass over the table
+    bool fullPass = false;   // It started at the first row, not at a checkpoint
+
+    Engine(std::string databasePath, size_t batchSize, ProgressFn progress)
+        : databasePath(std::move(databasePath)), batchSize(batchSize), progress(std::move(progress)) {}
+
+    Outcome advance();
+};
+
+RekeyMigration::Engine::Outcome RekeyMigration::Engine::advance() {
+    const std::shared_ptr<const CipherContext> keys = CipherContext::current();
+    if (!keys) return Outcome::RETRY;   // Locked
+    const uint64_t pending = KeyRotation::pending();
+    if (pending == 0) return Outcome::FINISHED;
+
+    // After a restart the unlock publishes the bare new keys; put the
+    // retiring ones back behind them for every reader
+    const std::shared_ptr<const CipherContext> rotating = KeyRotation::resume(keys);
+    if (!rotating->isRotating()) {
+        std::cerr << "Re-key stopped: the rotation state does not open under the current keys" << std::endl;
+        return Outcome::FAILED;
+    }
+    if (rotating != keys) CipherContext::replace(keys, rotating);
+
+    if (!database) {
+        database = std::make_unique<DatabaseManager>(databasePath);
+        if (!database->isDatabaseOpen()) {
+            database.reset();
+            return Outcome::RETRY;
+        }
+    }
+    if (pending != rotation) {
+        // New engine or a newer password change: pick up that rotation's checkpoint
+        const int64_t checkpoint = database->rekeyCheckpoint(pending);
+        if (checkpoint < 0) return Outcome::RETRY;
+        rotation = pending;
+        cursor = checkpoint;
+        pass = RekeyTally();
+        fullPass = checkpoint == 0;
+    }
+
+    const int64_t rows = database->rekeyRecords(*rotating, rotation, cursor, batchSize, &pass);
+    if (rows < 0) return Outcome::RETRY;
+    if (rows > 0) {
+        examined += static_cast<size_t>(rows);
+        return Outcome::NEXT;
+    }
+
+    // Foreground saves may have written rows already passed with records
+    // they held under a retiring key; only a whole pass with nothing to
+    // rewrite proves none are left
+    if (pass.rewritten > 0 || !fullPass) {
+        cursor = 0;
+        pass = RekeyTally();
+        fullPass = true;
+        return Outcome::NEXT;
+    }
+    if (pass.unreadable > 0) {
+        // Dropping the retiring keys could strand records a key loaded
+        // later (a legacy one) still opens; the next engine tries again
+        std::cerr << "Re-key left " << pass.unreadable << " records that no key opens; keeping the old keys"
+                  << std::endl;
+        return Outcome::FAILED;
+    }
+    // The vault is done; FFI callers may still hold old ciphertexts, and
+    // the rotation ends once they have confirmed too
+    if (KeyRotation::confirm(rotation, KeyRotation::STORE_VAULT, rotating) !=
+        KeyRotation::Confirmation::STALE) {
+        return Outcome::FINISHED;
+    }
+    // Another change began meanwhile; its keys cover this rotation's too
+    return KeyRotation::pending() != rotation ? Outcome::NEXT : Outcome::FAILED;
+}
+
+RekeyMigration::RekeyMigration(std::string databasePath, size_t batchSize, ProgressFn progress)
+    : engine(std::make_shared<Engine>(std::move(databasePath), batchSize == 0 ? DEFAULT_BATCH : batchSize,
+                                      std::move(progress))) {
+    std::shared_ptr<Engine> shared = engine;
+    CryptoWorkerPool::shared().post([shared] { step(shared); });
+}
+
+RekeyMigration::~RekeyMigration() {
+    stop();
+    wait();
+    // No batch can start after stop(), so the connection is ours to close
+    engine->database.reset();
+}
+
+void RekeyMigration::stop() {
+    {
+        std::lock_guard<std::mutex> lock(engine->mutex);
+        engine->stopRequested = true;
+    }
+    engine->idle.notify_all();
+}
+
+void RekeyMigration::wait() {
+    std::unique_lock<std::mutex> lock(engine->mutex);
+    engine->idle.wait(lock, [this] { return !engine->busy && (!engine->running || engine->stopRequested); });
+}
+
+bool RekeyMigration::isRunning() const {
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    return engine->running && !engine->stopRequested;
+}
+
+bool RekeyMigration::hasEnded() const {
+    std::lock_guard<std::mutex> lock(engine->mutex);
+    return !engine->running;
+}
+
+void RekeyMigration::step(const std::shared_ptr<Engine>& engine) {
+    {
+        std::lock_guard<std::mutex> lock(engine->mutex);
+        if (engine->stopRequested || !engine->running) return;
+        engine->busy = true;
+    }
+
+    const Engine::Outcome outcome = engine->advance();
+    const bool ended = outcome == Engine::Outcome::FINISHED || outcome == Engine::Outcome::FAILED;
+    if (ended) {
+        engine->database.reset();
+        if (outcome == Engine::Outcome::FINISHED) {
+            std::cout << "Re-key finished after " << engine->examined << " rows" << std::endl;
+        }
+    }
+    if (engine->progress && (ended || outcome == Engine::Outcome::NEXT)) {
+        engine->progress(engine->examined, outcome == Engine::Outcome::FINISHED);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(engine->mutex);
+        engine->busy = false;
+        if (ended) engine->running = false;
+    }
+    engine->idle.notify_all();
+
+    if (!ended) {
+        const auto pause = outcome == Engine::Outcome::NEXT ? BATCH_PAUSE : RETRY_PAUSE;
+        CryptoWorkerPool::shared().post([engine] { step(engine); }, pause);
+    }
+}
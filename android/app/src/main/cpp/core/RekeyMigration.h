@@ -0,0 +1,71 @@
+#ifndef REKEYMIGRATION_H
+#define REKEYMIGRATION_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Background re-encryption of the vault after a master password change
+ *
+ * Runs DatabaseManager::rekeyRecords in small batches through its own
+ * connection to the vault file, one task per batch on the low-priority
+ * background lane of CryptoWorkerPool, so it never competes with unlock or
+ * the UI. The app stays fully usable meanwhile: the published context is
+ * rotating, reads fall back to the retiring keys and every write already
+ * uses the new one.
+ *
+ * Progress survives process death twice over. KeyRotation keeps the
+ * retiring keys until the pass completes, and each batch commits its
+ * checkpoint (rotation id, last row id) with the rows it rewrote, so a new
+ * engine resumes after the last committed batch. While the vault is locked
+ * no keys are published and the engine idles until they are.
+ *
+ * The pass repeats until a whole one, from the first row, rewrites nothing,
+ * which covers rows saved behind the cursor from entries still holding old
+ * records; only then are the retiring keys dropped. A pass that meets
+ * records no key opens ends without dropping them, and the next engine
+ * (the next unlock) tries again. Cached entries must be reloaded after the
+ * pass ends (see hasEnded()).
+ */
+class RekeyMigration {
+public:
+    /** @brief Rows examined so far; the final call has `finished` set if the pass completed */
+    using ProgressFn = std::function<void(size_t examined, bool finished)>;
+
+    static constexpr size_t DEFAULT_BATCH = 64;
+    static constexpr std::chrono::milliseconds BATCH_PAUSE{30};
+    /** @brief Poll interval while locked or after a failed batch */
+    static constexpr std::chrono::milliseconds RETRY_PAUSE{1000};
+
+    /** @brief Start re-keying the database at databasePath */
+    explicit RekeyMigration(std::string databasePath, size_t batchSize = DEFAULT_BATCH,
+                            ProgressFn progress = ProgressFn());
+    /** @brief Stops after the running batch and closes the engine's connection */
+    ~RekeyMigration();
+
+    RekeyMigration(const RekeyMigration&) = delete;
+    RekeyMigration& operator=(const RekeyMigration&) = delete;
+
+    /** @brief Ask the engine to stop after the running batch; does not wait */
+    void stop();
+    /** @brief Block until the pass has ended, or no batch is running after stop() */
+    void wait();
+
+    bool isRunning() const;
+    /** @brief Whether the pass has ended, finished or failed (not merely stopped) */
+    bool hasEnded() const;
+
+private:
+    struct Engine;
+
+    /** @brief Run one batch and post the next */
+    static void step(const std::shared_ptr<Engine>& engine);
+
+    // Shared with the queued task, which may outlive this object
+    std::shared_ptr<Engine> engine;
+};
+
+#endif // REKEYMIGRATION_H
@@ -0,0 +1,171 @@
+#include "SHA256.h"
+#include <cstring>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+
+const uint32_t SHA256::IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+// Portable kernel: 16-word rolling message schedule, state kept in locals
+static void compressPortable(uint32_t state[8], const uint8_t* blocks, size_t count) {
+    uint32_t w[16];
+
+    for (size_t blk = 0; blk < count; blk++, blocks += SHA256::BLOCK_SIZE) {
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int i = 0; i < 64; i++) {
+            uint32_t wi;
+            if (i < 16) {
+                wi = w[i] = loadBE32(blocks + 4 * i);
+            } else {
+                uint32_t w15 = w[(i - 15) & 15];
+                uint32_t w2 = w[(i - 2) & 15];
+                uint32_t s0 = rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3);
+                uint32_t s1 = rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10);
+                wi = w[i & 15] = w[i & 15] + s0 + w[(i - 7) & 15] + s1;
+            }
+
+            uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + S1 + ch + K[i] + wi;
+            uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = S0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+static SHA256CompressFn detectCompress() {
+#if defined(__aarch64__) && defined(__linux__)
+    if (SHA256CompressFn arm = sha256ArmCompress()) {
+        if (getauxval(AT_HWCAP) & HWCAP_SHA2) return arm;
+    }
+#endif
+    return compressPortable;
+}
+
+static SHA256CompressFn compressKernel() {
+    static const SHA256CompressFn kernel = detectCompress();
+    return kernel;
+}
+
+void SHA256::compress(uint32_t st[8], const uint8_t* blocks, size_t count) {
+    compressKernel()(st, blocks, count);
+}
+
+const char* SHA256::backendName() {
+    return compressKernel() == compressPortable ? "portable" : "ARMv8-SHA2";
+}
+
+SHA256::~SHA256() {
+    volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(this);
+    for (size_t i = 0; i < sizeof(*this); i++) {
+        p[i] = 0;
+    }
+}
+
+void SHA256::reset() {
+    std::memcpy(state, IV, sizeof(state));
+    buffered = 0;
+    totalLength = 0;
+}
+
+void SHA256::update(const uint8_t* data, size_t length) {
+    totalLength += length;
+
+    if (buffered > 0) {
+        size_t take = BLOCK_SIZE - buffered;
+        if (take > length) take = length;
+        std::memcpy(buffer + buffered, data, take);
+        buffered += take;
+        data += take;
+        length -= take;
+        if (buffered < BLOCK_SIZE) return;
+        compress(state, buffer, 1);
+        buffered = 0;
+    }
+
+    // Whole blocks go straight from the caller's memory
+    size_t blocks = length / BLOCK_SIZE;
+    if (blocks > 0) {
+        compress(state, data, blocks);
+        data += blocks * BLOCK_SIZE;
+        length -= blocks * BLOCK_SIZE;
+    }
+
+    std::memcpy(buffer, data, length);
+    buffered = length;
+}
+
+void SHA256::finish(uint8_t digest[DIGEST_SIZE]) {
+    const uint64_t bits = totalLength * 8;
+
+    buffer[buffered++] = 0x80;
+    if (buffered > BLOCK_SIZE - 8) {
+        std::memset(buffer + buffered, 0, BLOCK_SIZE - buffered);
+        compress(state, buffer, 1);
+        buffered = 0;
+    }
+    std::memset(buffer + buffered, 0, BLOCK_SIZE - 8 - buffered);
+    storeBE32(buffer + 56, static_cast<uint32_t>(bits >> 32));
+    storeBE32(buffer + 60, static_cast<uint32_t>(bits));
+    compress(state, buffer, 1);
+
+    for (int i = 0; i < 8; i++) {
+        storeBE32(digest + 4 * i, state[i]);
+    }
+    reset();
+}
+
+void SHA256::hash(const uint8_t* data, size_t length, uint8_t digest[DIGEST_SIZE]) {
+    SHA256 ctx;
+    ctx.update(data, length);
+    ctx.finish(digest);
+}
@@ -0,0 +1,57 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Defined in SHA256Arm.cpp; returns nullptr when that translation unit was
+// built without the ARMv8 SHA2 instruction set flags
+typedef void (*SHA256CompressFn)(uint32_t state[8], const uint8_t* blocks, size_t count);
+SHA256CompressFn sha256ArmCompress();
+
+/**
+ * @brief SHA-256 (FIPS 180-4)
+ *
+ * The compression function runs on ARMv8 SHA2 instructions when the CPU
+ * reports them (getauxval HWCAP_SHA2) and on a portable C++ kernel otherwise.
+ */
+class SHA256 {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    SHA256() { reset(); }
+    ~SHA256();
+
+    void reset();
+    void update(const uint8_t* data, size_t length);
+    void finish(uint8_t digest[DIGEST_SIZE]);
+
+    /**
+     * @brief One-shot digest
+     */
+    static void hash(const uint8_t* data, size_t length, uint8_t digest[DIGEST_SIZE]);
+
+    /**
+     * @brief Run the compression function over whole 64-byte blocks
+     */
+    static void compress(uint32_t state[8], const uint8_t* blocks, size_t count);
+
+    /**
+     * @brief Initial hash value H(0)
+     */
+    static const uint32_t IV[8];
+
+    /**
+     * @brief Name of the compression backend in use ("ARMv8-SHA2" or "portable")
+     */
+    static const char* backendName();
+
+private:
+    uint32_t state[8];
+    uint8_t buffer[BLOCK_SIZE];
+    size_t buffered;
+    uint64_t totalLength;
+};
+
+#endif // SHA256_H
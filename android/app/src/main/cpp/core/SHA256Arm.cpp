@@ -0,0 +1,77 @@
+#include "SHA256.h"
+
+// Built with -march=armv8-a+crypto (see CMakeLists.txt). Only reached after
+// getauxval reports HWCAP_SHA2, so nothing here runs on CPUs without it.
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+
+#include <arm_neon.h>
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// Four rounds: SHA256H/SHA256H2 update ABCD/EFGH from W+K for rounds i..i+3
+static inline void fourRounds(uint32x4_t& abcd, uint32x4_t& efgh, uint32x4_t wk) {
+    uint32x4_t saved = abcd;
+    abcd = vsha256hq_u32(abcd, efgh, wk);
+    efgh = vsha256h2q_u32(efgh, saved, wk);
+}
+
+static void compressArm(uint32_t state[8], const uint8_t* blocks, size_t count) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+
+    for (size_t blk = 0; blk < count; blk++, blocks += SHA256::BLOCK_SIZE) {
+        const uint32x4_t abcdSaved = abcd;
+        const uint32x4_t efghSaved = efgh;
+
+        // Message words are big-endian
+        uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks)));
+        uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16)));
+        uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 32)));
+        uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 48)));
+
+        // Rounds 0-47 also extend the schedule (SHA256SU0/SU1)
+        for (int i = 0; i < 48; i += 16) {
+            fourRounds(abcd, efgh, vaddq_u32(m0, vld1q_u32(K + i)));
+            m0 = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3);
+            fourRounds(abcd, efgh, vaddq_u32(m1, vld1q_u32(K + i + 4)));
+            m1 = vsha256su1q_u32(vsha256su0q_u32(m1, m2), m3, m0);
+            fourRounds(abcd, efgh, vaddq_u32(m2, vld1q_u32(K + i + 8)));
+            m2 = vsha256su1q_u32(vsha256su0q_u32(m2, m3), m0, m1);
+            fourRounds(abcd, efgh, vaddq_u32(m3, vld1q_u32(K + i + 12)));
+            m3 = vsha256su1q_u32(vsha256su0q_u32(m3, m0), m1, m2);
+        }
+
+        // Rounds 48-63
+        fourRounds(abcd, efgh, vaddq_u32(m0, vld1q_u32(K + 48)));
+        fourRounds(abcd, efgh, vaddq_u32(m1, vld1q_u32(K + 52)));
+        fourRounds(abcd, efgh, vaddq_u32(m2, vld1q_u32(K + 56)));
+        fourRounds(abcd, efgh, vaddq_u32(m3, vld1q_u32(K + 60)));
+
+        abcd = vaddq_u32(abcd, abcdSaved);
+        efgh = vaddq_u32(efgh, efghSaved);
+    }
+
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+SHA256CompressFn sha256ArmCompress() {
+    return compressArm;
+}
+
+#else
+
+SHA256CompressFn sha256ArmCompress() {
+    return nullptr;
+}
+
+#endif
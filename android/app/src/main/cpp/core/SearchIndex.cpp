@@ -0,0 +1,185 @@
+#include "SearchIndex.h"
+#include "PerfTrace.h"
+#include <algorithm>
+
+namespace {
+
+inline char foldAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+void normalizeInto(std::string_view text, std::string& out) {
+    out.resize(text.size());
+    std::transform(text.begin(), text.end(), out.begin(), foldAscii);
+}
+
+inline uint32_t trigramAt(const char* p) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<uint8_t>(p[2]));
+}
+
+void collectTrigrams(std::string_view text, std::vector<uint32_t>& out) {
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        out.push_back(trigramAt(text.data() + i));
+    }
+}
+
+} // namespace
+
+void SearchIndex::add(const std::string& id, std::string_view title, std::string_view username,
+                      std::string_view website) {
+    uint32_t slot;
+    auto existing = idToSlot.find(id);
+    if (existing != idToSlot.end()) {
+        slot = existing->second;
+        unlink(slot);
+    } else if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(docs.size());
+        docs.emplace_back();
+    }
+
+    Doc& doc = docs[slot];
+    doc.id = id;
+    normalizeInto(title, doc.fields[static_cast<size_t>(Field::TITLE)]);
+    normalizeInto(username, doc.fields[static_cast<size_t>(Field::USERNAME)]);
+    normalizeInto(website, doc.fields[static_cast<size_t>(Field::WEBSITE)]);
+    doc.live = true;
+
+    doc.trigrams.clear();
+    for (const std::string& field : doc.fields) collectTrigrams(field, doc.trigrams);
+    std::sort(doc.trigrams.begin(), doc.trigrams.end());
+    doc.trigrams.erase(std::unique(doc.trigrams.begin(), doc.trigrams.end()), doc.trigrams.end());
+
+    for (uint32_t gram : doc.trigrams) {
+        std::vector<uint32_t>& list = postings[gram];
+        // Fresh slots append; reused slots land in the middle
+        if (list.empty() || list.back() < slot) {
+            list.push_back(slot);
+        } else {
+            list.insert(std::lower_bound(list.begin(), list.end(), slot), slot);
+        }
+    }
+
+    idToSlot[doc.id] = slot;
+}
+
+void SearchIndex::unlink(uint32_t slot) {
+    Doc& doc = docs[slot];
+    for (uint32_t gram : doc.trigrams) {
+        auto it = postings.find(gram);
+        if (it == postings.end()) continue;
+        std::vector<uint32_t>& list = it->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), slot);
+        if (pos != list.end() && *pos == slot) list.erase(pos);
+        if (list.empty()) postings.erase(it);
+    }
+    doc.trigrams.clear();
+    doc.live = false;
+}
+
+bool SearchIndex::remove(const std::string& id) {
+    auto it = idToSlot.find(id);
+    if (it == idToSlot.end()) return false;
+
+    const uint32_t slot = it->second;
+    idToSlot.erase(it);
+    unlink(slot);
+    docs[slot].id.clear();
+    for (std::string& field : docs[slot].fields) field.clear();
+    freeSlots.push_back(slot);
+    return true;
+}
+
+void SearchIndex::clear() {
+    docs.clear();
+    freeSlots.clear();
+    idToSlot.clear();
+    postings.clear();
+}
+
+bool SearchIndex::bestMatch(const Doc& doc, std::string_view needle, Hit& hit) const {
+    // Fields are checked in rank order, so the first field that matches wins
+    for (size_t f = 0; f < FIELD_COUNT; ++f) {
+        size_t pos = std::string_view(doc.fields[f]).find(needle);
+        if (pos != std::string_view::npos) {
+            hit.id = doc.id;
+            hit.field = static_cast<Field>(f);
+            hit.position = static_cast<uint32_t>(pos);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::search(std::string_view query, size_t limit) const {
+    std::vector<Hit> hits;
+    if (query.empty() || idToSlot.empty()) return hits;
+    PERF_SCOPE(PerfOp::SEARCH);
+
+    std::string needle;
+    normalizeInto(query, needle);
+
+    // Slot of every hit, kept alongside for a stable tiebreak
+    std::vector<uint32_t> hitSlots;
+    Hit hit{};
+
+    if (needle.size() < 3) {
+        for (uint32_t slot = 0; slot < docs.size(); ++slot) {
+            if (docs[slot].live && bestMatch(docs[slot], needle, hit)) {
+                hits.push_back(hit);
+                hitSlots.push_back(slot);
+            }
+        }
+    } else {
+        std::vector<uint32_t> grams;
+        collectTrigrams(needle, grams);
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+        std::vector<const std::vector<uint32_t>*> lists;
+        lists.reserve(grams.size());
+        for (uint32_t gram : grams) {
+            auto it = postings.find(gram);
+            if (it == postings.end()) return hits;   // Some trigram occurs nowhere
+            lists.push_back(&it->second);
+        }
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+        // Walk the shortest list; probe the others, which only get longer
+        for (uint32_t slot : *lists.front()) {
+            bool inAll = true;
+            for (size_t i = 1; i < lists.size() && inAll; ++i) {
+                inAll = std::binary_search(lists[i]->begin(), lists[i]->end(), slot);
+            }
+            // Trigrams can all be present without being contiguous; confirm
+            if (inAll && bestMatch(docs[slot], needle, hit)) {
+                hits.push_back(hit);
+                hitSlots.push_back(slot);
+            }
+        }
+    }
+
+    std::vector<uint32_t> order(hits.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    auto ranksBefore = [&](uint32_t a, uint32_t b) {
+        if (hits[a].field != hits[b].field) return hits[a].field < hits[b].field;
+        if (hits[a].position != hits[b].position) return hits[a].position < hits[b].position;
+        return hitSlots[a] < hitSlots[b];
+    };
+    if (limit != 0 && limit < order.size()) {
+        std::partial_sort(order.begin(), order.begin() + limit, order.end(), ranksBefore);
+        order.resize(limit);
+    } else {
+        std::sort(order.begin(), order.end(), ranksBefore);
+    }
+
+    std::vector<Hit> ranked;
+    ranked.reserve(order.size());
+    for (uint32_t i : order) ranked.push_back(hits[i]);
+    return ranked;
+}
@@ -0,0 +1,80 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Incrementally maintained trigram index over entry title, username and website
+ *
+ * Fields are lower-cased (ASCII) once when an entry is added or updated.
+ * Each distinct trigram of an entry maps to a sorted posting list of entry
+ * slots, so a query of three or more characters only verifies the entries
+ * that contain all of its trigrams; shorter queries scan the stored
+ * normalized fields, which stays cheap for a few thousand entries.
+ *
+ * Queries allocate per call and per hit, never per indexed entry.
+ * Not thread-safe; the owner serialises access.
+ */
+class SearchIndex {
+public:
+    enum class Field : uint8_t {
+        TITLE,
+        USERNAME,
+        WEBSITE
+    };
+    static constexpr size_t FIELD_COUNT = 3;
+
+    /**
+     * @brief One matching entry and where its best match is
+     *
+     * `id` views the index's own copy and stays valid until the index is
+     * next modified.
+     */
+    struct Hit {
+        std::string_view id;
+        Field field;
+        uint32_t position;
+    };
+
+    /** @brief Add an entry, or replace it if the id is already indexed */
+    void add(const std::string& id, std::string_view title, std::string_view username, std::string_view website);
+    void update(const std::string& id, std::string_view title, std::string_view username, std::string_view website) {
+        add(id, title, username, website);
+    }
+    /** @brief Drop an entry; returns false when the id was not indexed */
+    bool remove(const std::string& id);
+    void clear();
+
+    /**
+     * @brief Ids of entries containing `query` (case-insensitive) in any field
+     *
+     * Ranked by field (title, then username, then website), then by match
+     * position (prefix matches first); remaining ties keep a stable order.
+     * `limit` of 0 means no limit.
+     */
+    std::vector<Hit> search(std::string_view query, size_t limit = 0) const;
+
+    size_t size() const { return idToSlot.size(); }
+
+private:
+    struct Doc {
+        std::string id;
+        std::string fields[FIELD_COUNT];   // Normalized text
+        std::vector<uint32_t> trigrams;    // Sorted, distinct
+        bool live = false;
+    };
+
+    std::vector<Doc> docs;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> idToSlot;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+
+    void unlink(uint32_t slot);
+    bool bestMatch(const Doc& doc, std::string_view needle, Hit& hit) const;
+};
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,160 @@
+#include "SecretCache.h"
+#include <algorithm>
+#include <atomic>
+#include "CryptoWorkerPool.h"
+
+static void wipeString(SecureString& s) {
+    SecureArena::wipe(&s[0], s.size());
+    s.clear();
+}
+
+SecretCache::SecretCache(size_t capacity, Clock::duration ttl)
+    : capacity(capacity), ttl(ttl), nextExpiry(Clock::time_point::max()), sweepPosted(false),
+      anchor(std::make_shared<Anchor>()), hits(0), misses(0), evictions(0), expirations(0) {
+    anchor->cache = this;
+}
+
+SecretCache::~SecretCache() {
+    {
+        std::lock_guard<std::mutex> lock(anchor->mutex);
+        anchor->cache = nullptr;
+    }
+    clear();
+}
+
+void SecretCache::dropLocked(NodeList::iterator it) {
+    wipeString(it->plaintext);
+    index.erase(it->key);
+    lru.erase(it);
+}
+
+void SecretCache::trimLocked() {
+    while (lru.size() > capacity) {
+        dropLocked(std::prev(lru.end()));
+        ++evictions;
+    }
+}
+
+size_t SecretCache::purgeExpiredLocked(Clock::time_point now) {
+    if (now < nextExpiry) return 0;
+    size_t purged = 0;
+    nextExpiry = Clock::time_point::max();
+    for (auto it = lru.begin(); it != lru.end();) {
+        auto next = std::next(it);
+        if (now >= it->expires) {
+            dropLocked(it);
+            ++purged;
+        } else {
+            nextExpiry = std::min(nextExpiry, it->expires);
+        }
+        it = next;
+    }
+    expirations += purged;
+    return purged;
+}
+
+void SecretCache::scheduleSweepLocked() {
+    if (sweepPosted || lru.empty()) return;
+    const Clock::duration wait = std::max(nextExpiry - Clock::now(), Clock::duration::zero());
+    try {
+        std::weak_ptr<Anchor> weak = anchor;
+        CryptoWorkerPool::shared().post([weak] {
+            std::shared_ptr<Anchor> held = weak.lock();
+            if (!held) return;
+            std::lock_guard<std::mutex> lock(held->mutex);
+            if (held->cache) held->cache->sweep();
+        }, std::chrono::ceil<std::chrono::milliseconds>(wait));
+        sweepPosted = true;
+    } catch (const std::exception&) {
+        // No background thread: expiry still happens on the next get()
+    }
+}
+
+void SecretCache::sweep() {
+    std::lock_guard<std::mutex> lock(mutex);
+    sweepPosted = false;
+    purgeExpiredLocked(Clock::now());
+    scheduleSweepLocked();
+}
+
+std::string SecretCache::get(uint64_t key, const LoadFn& load) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        purgeExpiredLocked(Clock::now());
+        auto found = index.find(key);
+        if (found != index.end()) {
+            NodeList::iterator it = found->second;
+            if (Clock::now() < it->expires) {
+                lru.splice(lru.begin(), lru, it);
+                ++hits;
+                return std::string(it->plaintext.data(), it->plaintext.size());
+            }
+            dropLocked(it);
+            ++expirations;
+        }
+        ++misses;
+    }
+
+    std::string plaintext = load();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) return plaintext;
+
+    // Another thread may have loaded the same key meanwhile; keep the newer copy
+    auto found = index.find(key);
+    if (found != index.end()) dropLocked(found->second);
+
+    const Clock::time_point expires = Clock::now() + ttl;
+    lru.push_front(Node{key, SecureString(plaintext.data(), plaintext.size()), expires});
+    index[key] = lru.begin();
+    nextExpiry = std::min(nextExpiry, expires);
+    trimLocked();
+    scheduleSweepLocked();
+    return plaintext;
+}
+
+void SecretCache::erase(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found != index.end()) dropLocked(found->second);
+}
+
+void SecretCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Node& node : lru) wipeString(node.plaintext);
+    lru.clear();
+    index.clear();
+    nextExpiry = Clock::time_point::max();
+}
+
+size_t SecretCache::purgeExpired() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return purgeExpiredLocked(Clock::now());
+}
+
+void SecretCache::configure(size_t newCapacity, Clock::duration newTtl) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = newCapacity;
+    ttl = newTtl;
+    trimLocked();
+}
+
+SecretCache::Stats SecretCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Stats{hits, misses, evictions, expirations, lru.size()};
+}
+
+void SecretCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hits = misses = evictions = expirations = 0;
+}
+
+uint64_t SecretCache::nextKey() {
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+SecretCache& SecretCache::shared() {
+    static SecretCache cache;
+    return cache;
+}
@@ -0,0 +1,121 @@
+#ifndef SECRETCACHE_H
+#define SECRETCACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "SecureArena.h"
+
+/**
+ * @brief Small LRU of decrypted secrets with a fixed time-to-live
+ *
+ * LazySecret fields decrypt through here so that opening the same entry
+ * twice costs one decryption, while the number of plaintexts in RAM and the
+ * time any of them stays there are both bounded. The TTL counts from when a
+ * value was decrypted and is not extended by hits. Cached plaintext lives in
+ * SecureArena and is wiped when it leaves (eviction, expiry, erase, clear).
+ *
+ * Expired entries go on the next get() once one is due, and a sweep posted
+ * to the CryptoWorkerPool background thread removes them even when the
+ * cache is not used again.
+ *
+ * Thread-safe. Decryption runs outside the lock, so a slow load does not
+ * block hits on other keys.
+ */
+class SecretCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using LoadFn = std::function<std::string()>;
+
+    static constexpr size_t DEFAULT_CAPACITY = 32;
+    static constexpr Clock::duration DEFAULT_TTL = std::chrono::seconds(60);
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;     // Dropped to make room
+        uint64_t expirations;   // Dropped because the TTL ran out
+        size_t size;
+
+        double hitRate() const {
+            const uint64_t lookups = hits + misses;
+            return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+        }
+    };
+
+    explicit SecretCache(size_t capacity = DEFAULT_CAPACITY, Clock::duration ttl = DEFAULT_TTL);
+    ~SecretCache();
+
+    SecretCache(const SecretCache&) = delete;
+    SecretCache& operator=(const SecretCache&) = delete;
+
+    /**
+     * @brief Cached plaintext for key, calling load() on a miss
+     *
+     * Exceptions from load() propagate and nothing is cached.
+     */
+    std::string get(uint64_t key, const LoadFn& load);
+
+    /** @brief Wipe and drop one key (no-op when absent) */
+    void erase(uint64_t key);
+
+    /** @brief Wipe and drop everything, e.g. when the keys are released */
+    void clear();
+
+    /** @brief Wipe entries whose TTL has run out; returns how many went */
+    size_t purgeExpired();
+
+    /** @brief Change limits; shrinking evicts least recently used entries */
+    void configure(size_t capacity, Clock::duration ttl);
+
+    Stats stats() const;
+    void resetStats();
+
+    /** @brief Fresh key for a new cached field (never reused) */
+    static uint64_t nextKey();
+
+    /** @brief Process-wide cache used by LazySecret */
+    static SecretCache& shared();
+
+private:
+    struct Node {
+        uint64_t key;
+        SecureString plaintext;
+        Clock::time_point expires;
+    };
+    using NodeList = std::list<Node>;
+
+    // Lets a posted sweep outlive the cache: it finds `cache` null
+    struct Anchor {
+        std::mutex mutex;
+        SecretCache* cache;
+    };
+
+    mutable std::mutex mutex;
+    NodeList lru;   // Most recently used first
+    std::unordered_map<uint64_t, NodeList::iterator> index;
+    size_t capacity;
+    Clock::duration ttl;
+    Clock::time_point nextExpiry;   // Earliest expiry in lru, max() when empty
+    bool sweepPosted;
+    std::shared_ptr<Anchor> anchor;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t expirations;
+
+    void dropLocked(NodeList::iterator it);
+    void trimLocked();
+    size_t purgeExpiredLocked(Clock::time_point now);
+    void scheduleSweepLocked();
+    void sweep();
+};
+
+#endif // SECRETCACHE_H
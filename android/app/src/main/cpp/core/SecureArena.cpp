@@ -0,0 +1,103 @@
+#include "SecureArena.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+SecureArena::SecureArena(size_t capacity) {
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    const size_t page = pageSize > 0 ? static_cast<size_t>(pageSize) : 4096;
+    const size_t usable = (capacity + page - 1) / page * page;
+    if (usable == 0) return;
+
+    void* region = mmap(nullptr, usable + 2 * page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) return;   // Everything falls back to the heap
+
+    mapping = static_cast<uint8_t*>(region);
+    mappingSize = usable + 2 * page;
+    if (mprotect(mapping + page, usable, PROT_READ | PROT_WRITE) != 0) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        return;
+    }
+    base = mapping + page;
+    limit = usable;
+
+    locked = mlock(base, limit) == 0;
+#ifdef MADV_DONTDUMP
+    madvise(base, limit, MADV_DONTDUMP);
+#endif
+}
+
+SecureArena::~SecureArena() {
+    if (!mapping) return;
+    wipe(base, bump);
+    if (locked) munlock(base, limit);
+    munmap(mapping, mappingSize);
+}
+
+size_t SecureArena::classFor(size_t size) {
+    size_t cls = 0;
+    for (size_t block = MIN_BLOCK; block < size; block <<= 1) ++cls;
+    return cls;
+}
+
+void* SecureArena::allocate(size_t size) {
+    if (size == 0) size = 1;
+    if (size <= MAX_BLOCK && base) {
+        const size_t cls = classFor(size);
+        const size_t blockSize = MIN_BLOCK << cls;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (FreeBlock* block = freeLists[cls]) {
+            freeLists[cls] = block->next;
+            block->next = nullptr;
+            return block;
+        }
+        // Blocks are bumped at multiples of their own size, so each one is
+        // aligned to it; the gap left to get there is not reused
+        const size_t offset = (bump + blockSize - 1) & ~(blockSize - 1);
+        if (offset + blockSize <= limit) {
+            bump = offset + blockSize;
+            return base + offset;
+        }
+    }
+    return ::operator new(size);
+}
+
+void SecureArena::deallocate(void* p, size_t size) noexcept {
+    if (!p) return;
+    if (!owns(p)) {
+        wipe(p, size);
+        ::operator delete(p);
+        return;
+    }
+
+    const size_t cls = classFor(size == 0 ? 1 : size);
+    wipe(p, MIN_BLOCK << cls);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = freeLists[cls];
+    freeLists[cls] = block;
+}
+
+bool SecureArena::owns(const void* p) const {
+    const uint8_t* at = static_cast<const uint8_t*>(p);
+    return base && at >= base && at < base + limit;
+}
+
+size_t SecureArena::used() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bump;
+}
+
+SecureArena& SecureArena::shared() {
+    // Never destroyed: static SecureStrings and caches release their blocks
+    // during exit, possibly after this function's own static would be gone
+    static SecureArena* arena = new SecureArena();
+    return *arena;
+}
+
+void SecureArena::wipe(void* data, size_t length) noexcept {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    while (length--) *p++ = 0;
+}
@@ -0,0 +1,135 @@
+#ifndef SECUREARENA_H
+#define SECUREARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Locked, guard-paged memory for keys and decrypted secrets
+ *
+ * One region is mapped on first use, with a PROT_NONE guard page on either
+ * side. It is mlock'ed so it never reaches swap, and it is left out of
+ * core dumps. Blocks come in power-of-two classes from MIN_BLOCK to
+ * MAX_BLOCK. A freed block is wiped and pushed on its class's free list;
+ * new blocks are bumped off the region. Larger requests, and requests made
+ * once the region is full, fall back to the ordinary heap; they are still
+ * wiped on release but are not locked.
+ *
+ * mlock is best effort: RLIMIT_MEMLOCK is small for app processes, which is
+ * why the region is too. isLocked() reports whether it took. Thread-safe.
+ */
+class SecureArena {
+public:
+    static constexpr size_t MIN_BLOCK = 16;
+    static constexpr size_t MAX_BLOCK = 4096;
+    /** Fits the traditional 64 KiB RLIMIT_MEMLOCK */
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    explicit SecureArena(size_t capacity = DEFAULT_CAPACITY);
+    ~SecureArena();
+
+    SecureArena(const SecureArena&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+
+    /** @brief At least `size` bytes, 16-byte aligned; throws std::bad_alloc */
+    void* allocate(size_t size);
+    /** @brief Wipe and release a block; `size` is the one passed to allocate() */
+    void deallocate(void* p, size_t size) noexcept;
+
+    /** @brief Whether p points into the locked region (not a heap fallback) */
+    bool owns(const void* p) const;
+    bool isLocked() const { return locked; }
+    size_t capacity() const { return limit; }
+    /** @brief Region bytes bumped so far, free-listed blocks included */
+    size_t used() const;
+
+    /** @brief Process-wide arena behind SecureAllocator */
+    static SecureArena& shared();
+
+    /** @brief Zeroize through a volatile pointer so the stores are not optimized away */
+    static void wipe(void* data, size_t length) noexcept;
+
+private:
+    static constexpr size_t CLASS_COUNT = 9;   // 16, 32, ..., 4096
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    uint8_t* mapping = nullptr;   // Includes both guard pages
+    size_t mappingSize = 0;
+    uint8_t* base = nullptr;      // First usable byte
+    size_t limit = 0;
+    size_t bump = 0;
+    bool locked = false;
+    FreeBlock* freeLists[CLASS_COUNT] = {};
+    mutable std::mutex mutex;
+
+    static size_t classFor(size_t size);
+};
+
+/**
+ * @brief std allocator over SecureArena::shared()
+ *
+ * Every release is wiped, including the old buffer left behind when a
+ * container grows.
+ */
+template <typename T>
+struct SecureAllocator {
+    using value_type = T;
+
+    SecureAllocator() noexcept = default;
+    template <typename U>
+    SecureAllocator(const SecureAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(SecureArena::shared().allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        SecureArena::shared().deallocate(p, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const SecureAllocator<T>&, const SecureAllocator<U>&) noexcept { return true; }
+template <typename T, typename U>
+bool operator!=(const SecureAllocator<T>&, const SecureAllocator<U>&) noexcept { return false; }
+
+/** @brief Byte buffer for key material; wiped when released or regrown */
+using SecureBuffer = std::vector<uint8_t, SecureAllocator<uint8_t>>;
+
+/**
+ * @brief String for passwords and plaintext secrets
+ *
+ * Heap storage comes from SecureArena. Short values sit in the string's
+ * own small-string buffer instead, so the destructor also wipes whatever
+ * capacity the object holds inline.
+ */
+class SecureString : public std::basic_string<char, std::char_traits<char>, SecureAllocator<char>> {
+public:
+    using Base = std::basic_string<char, std::char_traits<char>, SecureAllocator<char>>;
+    using Base::Base;
+    using Base::operator=;
+
+    SecureString() = default;
+    SecureString(const SecureString&) = default;
+    SecureString(SecureString&& other) noexcept : Base(std::move(other)) {}
+    SecureString& operator=(const SecureString&) = default;
+    SecureString& operator=(SecureString&& other) noexcept {
+        wipeLocal();
+        Base::operator=(std::move(other));
+        return *this;
+    }
+    ~SecureString() { wipeLocal(); }
+
+private:
+    void wipeLocal() noexcept { SecureArena::wipe(&(*this)[0], capacity()); }
+};
+
+#endif // SECUREARENA_H
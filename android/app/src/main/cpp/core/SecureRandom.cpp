@@ -0,0 +1,189 @@
+#include "SecureRandom.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__APPLE__) || defined(__OpenBSD__) || defined(__FreeBSD__) || defined(__NetBSD__)
+#include <stdlib.h>
+#define SECURE_RANDOM_ARC4RANDOM 1
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+inline uint32_t rotl(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+inline void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+    a += b; d ^= a; d = rotl(d, 16);
+    c += d; b ^= c; b = rotl(b, 12);
+    a += b; d ^= a; d = rotl(d, 8);
+    c += d; b ^= c; b = rotl(b, 7);
+}
+
+inline void storeLE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// RFC 8439 block function with a 64-bit counter and zero nonce: every key
+// is used for one refill only, so the nonce never has to vary
+void chachaBlock(const uint32_t key[8], uint64_t counter, uint8_t out[64]) {
+    uint32_t state[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0,
+    };
+    uint32_t x[16];
+    std::memcpy(x, state, sizeof(x));
+
+    for (int round = 0; round < 10; ++round) {
+        quarterRound(x[0], x[4], x[8], x[12]);
+        quarterRound(x[1], x[5], x[9], x[13]);
+        quarterRound(x[2], x[6], x[10], x[14]);
+        quarterRound(x[3], x[7], x[11], x[15]);
+        quarterRound(x[0], x[5], x[10], x[15]);
+        quarterRound(x[1], x[6], x[11], x[12]);
+        quarterRound(x[2], x[7], x[8], x[13]);
+        quarterRound(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) storeLE32(out + 4 * i, x[i] + state[i]);
+
+    secureWipe(x, sizeof(x));
+    secureWipe(state, sizeof(state));
+}
+
+} // namespace
+
+void SecureRandom::systemEntropy(uint8_t* out, size_t length) {
+#if defined(SECURE_RANDOM_ARC4RANDOM)
+    arc4random_buf(out, length);
+#elif defined(__linux__)
+    size_t got = 0;
+#if defined(SYS_getrandom)
+    // Raw syscall: bionic only wraps getrandom() from API 28
+    while (got < length) {
+        long n = syscall(SYS_getrandom, out + got, length - got, 0);
+        if (n > 0) {
+            got += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;   // ENOSYS on pre-3.17 kernels: fall back below
+        }
+    }
+#endif
+    if (got < length) {
+        int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("No system entropy source available");
+        while (got < length) {
+            ssize_t n = read(fd, out + got, length - got);
+            if (n > 0) {
+                got += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                close(fd);
+                throw std::runtime_error("Failed to read /dev/urandom");
+            }
+        }
+        close(fd);
+    }
+#else
+#error "SecureRandom: no system entropy source for this platform"
+#endif
+}
+
+SecureRandom::SecureRandom() {
+    reseed();
+}
+
+SecureRandom::~SecureRandom() {
+    secureWipe(key, sizeof(key));
+    secureWipe(buffer, sizeof(buffer));
+}
+
+void SecureRandom::reseed() {
+    uint8_t seed[KEY_SIZE];
+    systemEntropy(seed, sizeof(seed));
+    for (size_t i = 0; i < 8; ++i) key[i] = loadLE32(seed + 4 * i);
+    secureWipe(seed, sizeof(seed));
+
+    counter = 0;
+    available = 0;
+    sinceReseed = 0;
+}
+
+void SecureRandom::refill() {
+    if (sinceReseed >= RESEED_INTERVAL) reseed();
+
+    for (size_t b = 0; b < BUFFER_BLOCKS; ++b) {
+        chachaBlock(key, counter++, buffer + b * BLOCK_SIZE);
+    }
+    // Fast key erasure: the first 32 bytes become the next key and are wiped
+    for (size_t i = 0; i < 8; ++i) key[i] = loadLE32(buffer + 4 * i);
+    secureWipe(buffer, KEY_SIZE);
+    counter = 0;
+
+    available = sizeof(buffer) - KEY_SIZE;
+    sinceReseed += available;
+}
+
+void SecureRandom::fill(uint8_t* out, size_t length) {
+    while (length > 0) {
+        if (available == 0) refill();
+        const size_t take = length < available ? length : available;
+        uint8_t* from = buffer + sizeof(buffer) - available;
+        std::memcpy(out, from, take);
+        secureWipe(from, take);   // Served bytes never linger in the buffer
+        available -= take;
+        out += take;
+        length -= take;
+    }
+}
+
+uint32_t SecureRandom::next32() {
+    uint8_t bytes[4];
+    fill(bytes, sizeof(bytes));
+    return loadLE32(bytes);
+}
+
+uint32_t SecureRandom::uniform(uint32_t bound) {
+    if (bound <= 1) return 0;
+
+    // Lemire's multiply-shift with rejection: unbiased, and the division
+    // for the rejection threshold only runs when a draw lands near it
+    if (bound <= 256) {
+        // Byte-sized draws for charset picks
+        uint32_t m = uint32_t(nextByte()) * bound;
+        if ((m & 0xFF) < bound) {
+            const uint32_t threshold = (256 - bound) % bound;
+            while ((m & 0xFF) < threshold) m = uint32_t(nextByte()) * bound;
+        }
+        return m >> 8;
+    }
+
+    uint64_t m = uint64_t(next32()) * bound;
+    if (static_cast<uint32_t>(m) < bound) {
+        const uint32_t threshold = (0u - bound) % bound;
+        while (static_cast<uint32_t>(m) < threshold) m = uint64_t(next32()) * bound;
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
@@ -0,0 +1,74 @@
+#ifndef SECURERANDOM_H
+#define SECURERANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Buffered CSPRNG: ChaCha20 keystream with fast key erasure
+ *
+ * Seeded from the OS: getrandom(2) on Linux and Android, falling back to
+ * /dev/urandom on kernels that lack it, and arc4random_buf on Apple and the
+ * BSDs. Each refill produces BUFFER_BLOCKS ChaCha20 blocks. The first 32
+ * bytes rekey the generator at once and the rest are served from the
+ * buffer, so a later memory disclosure cannot reveal earlier output. The
+ * generator reseeds from the OS every RESEED_INTERVAL bytes.
+ *
+ * Satisfies UniformRandomBitGenerator, so it can drive std::shuffle.
+ * uniform() uses rejection sampling. Not thread-safe: give each thread its
+ * own instance.
+ */
+class SecureRandom {
+public:
+    using result_type = uint32_t;
+
+    static constexpr size_t BUFFER_BLOCKS = 8;
+    static constexpr size_t RESEED_INTERVAL = 1 << 20;
+
+    SecureRandom();
+    ~SecureRandom();
+
+    SecureRandom(const SecureRandom&) = delete;
+    SecureRandom& operator=(const SecureRandom&) = delete;
+
+    void fill(uint8_t* out, size_t length);
+    uint32_t next32();
+
+    /** @brief Uniform in [0, bound), no modulo bias; bound 0 returns 0 */
+    uint32_t uniform(uint32_t bound);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()() { return next32(); }
+
+    /**
+     * @brief Read `length` bytes of OS entropy
+     * @throws std::runtime_error if no source is available
+     */
+    static void systemEntropy(uint8_t* out, size_t length);
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t KEY_SIZE = 32;
+
+    uint32_t key[8];
+    uint64_t counter = 0;
+    uint8_t buffer[BUFFER_BLOCKS * BLOCK_SIZE];
+    size_t available = 0;          // Unread bytes at the end of buffer
+    size_t sinceReseed = 0;
+
+    void reseed();
+    void refill();
+
+    // Hot path for uniform(): one byte without the memcpy loop of fill()
+    uint8_t nextByte() {
+        if (available == 0) refill();
+        volatile uint8_t* from = buffer + sizeof(buffer) - available--;
+        const uint8_t b = *from;
+        *from = 0;
+        return b;
+    }
+};
+
+#endif // SECURERANDOM_H
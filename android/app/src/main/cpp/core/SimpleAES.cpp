@@ -1,12 +1,17 @@
 #include "SimpleAES.h"
+#include "AESHardware.h"
+#include "Base64.h"
+#include "SecureArena.h"
+#include "SecureRandom.h"
 #include <stdexcept>
+#include <algorithm>
 #include <random>
 #include <cstring>
 #include <sstream>
 #include <iomanip>
 
 // AES S-box
-static const uint8_t sbox[256] = {
+static constexpr uint8_t sbox[256] = {
     0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
     0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
     0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
@@ -26,7 +31,7 @@ static const uint8_t sbox[256] = {
 };
 
 // AES inverse S-box
-static const uint8_t inv_sbox[256] = {
+static constexpr uint8_t inv_sbox[256] = {
     0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
     0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
     0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
@@ -50,19 +55,15 @@ static const uint8_t rcon[11] = {
     0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
 };
 
-// Base64 encoding table
-static const char base64_chars[] = 
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
 // GF(2^8) multiplication helper function (forward declaration before use)
-static uint8_t gf_mul(uint8_t a, uint8_t b) {
+static constexpr uint8_t gf_mul(uint8_t a, uint8_t b) {
     uint8_t p = 0;
     for (int i = 0; i < 8; i++) {
         if (b & 1) {
             p ^= a;
         }
         bool hi_bit_set = (a & 0x80) != 0;
-        a <<= 1;
+        a = static_cast<uint8_t>(a << 1);
         if (hi_bit_set) {
             a ^= 0x1B; // x^8 + x^4 + x^3 + x + 1
         }
@@ -71,105 +72,134 @@ static uint8_t gf_mul(uint8_t a, uint8_t b) {
     return p;
 }
 
-SimpleAES::SimpleAES(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv)
-    : key(key), iv(iv) {
+static inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+#ifndef SIMPLEAES_REFERENCE_ROUNDS
+// ============================================================================
+// T-table round engine
+// ============================================================================
+// Each table entry fuses SubBytes and the MixColumns column multiply for one
+// state byte, so a full round is 16 lookups + XORs per block. Te1..Te3 are
+// byte rotations of Te0, which absorbs ShiftRows into the choice of source
+// column. Tables are generated at compile time from the S-box above, so
+// they cannot drift from the reference path. Only encryption has a fast
+// path: GCM runs the block cipher forwards for both directions.
+
+static constexpr uint32_t rotr8(uint32_t x) {
+    return (x >> 8) | (x << 24);
+}
+
+struct RoundTables {
+    uint32_t t0[256];
+    uint32_t t1[256];
+    uint32_t t2[256];
+    uint32_t t3[256];
+};
+
+static constexpr RoundTables makeEncryptTables() {
+    RoundTables t{};
+    for (int i = 0; i < 256; i++) {
+        uint8_t s = sbox[i];
+        uint32_t w = (static_cast<uint32_t>(gf_mul(s, 2)) << 24) |
+                     (static_cast<uint32_t>(s) << 16) |
+                     (static_cast<uint32_t>(s) << 8) |
+                     static_cast<uint32_t>(gf_mul(s, 3));
+        t.t0[i] = w;
+        t.t1[i] = rotr8(w);
+        t.t2[i] = rotr8(rotr8(w));
+        t.t3[i] = rotr8(rotr8(rotr8(w)));
+    }
+    return t;
+}
+
+alignas(64) static constexpr RoundTables Te = makeEncryptTables();
+#endif // SIMPLEAES_REFERENCE_ROUNDS
+
+// Zeroize through a volatile pointer so the stores are not optimized away
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    while (length--) {
+        *p++ = 0;
+    }
+}
+
+// Validates sizes before the raw constructor reads them
+static const uint8_t* checkedKey(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv) {
     if (key.size() != 32) {
         throw std::invalid_argument("Key must be 32 bytes for AES-256");
     }
     if (iv.size() != 16) {
         throw std::invalid_argument("IV must be 16 bytes");
     }
+    return key.data();
 }
 
-std::vector<uint8_t> SimpleAES::generateRandomBytes(size_t length) {
-    std::vector<uint8_t> bytes(length);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (size_t i = 0; i < length; ++i) {
-        bytes[i] = static_cast<uint8_t>(dis(gen));
-    }
-    return bytes;
-}
+SimpleAES::SimpleAES(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv)
+    : SimpleAES(checkedKey(key, iv), iv.data()) {}
 
-std::string SimpleAES::base64Encode(const std::vector<uint8_t>& data) {
-    std::string encoded;
-    int val = 0;
-    int valb = -6;
-    
-    for (uint8_t c : data) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            encoded.push_back(base64_chars[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
-    }
-    
-    if (valb > -6) {
-        encoded.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-    }
+SimpleAES::SimpleAES(const uint8_t key[32], const uint8_t iv[16]) {
+    std::memcpy(this->iv, iv, sizeof(this->iv));
     
-    while (encoded.size() % 4) {
-        encoded.push_back('=');
-    }
+    // Expand the schedule once; every encrypt/decrypt reuses it
+    keyExpansion(key, encRoundKeys);
     
-    return encoded;
+    // GCM hash key H = E_K(0^128)
+    uint8_t h[16] = {0};
+    aesEncryptBlock(h, h, encRoundKeys);
+    ghash.setKey(h);
+    secureWipe(h, sizeof(h));
 }
 
-std::vector<uint8_t> SimpleAES::base64Decode(const std::string& encoded) {
-    std::vector<uint8_t> decoded;
-    std::vector<int> T(256, -1);
-    
-    for (int i = 0; i < 64; i++) {
-        T[base64_chars[i]] = i;
-    }
-    
-    int val = 0;
-    int valb = -8;
-    
-    for (unsigned char c : encoded) {
-        if (T[c] == -1) break;
-        val = (val << 6) + T[c];
-        valb += 6;
-        if (valb >= 0) {
-            decoded.push_back((val >> valb) & 0xFF);
-            valb -= 8;
-        }
-    }
-    
-    return decoded;
+SimpleAES::~SimpleAES() {
+    secureWipe(encRoundKeys, sizeof(encRoundKeys));
+    secureWipe(iv, sizeof(iv));
 }
 
-std::vector<uint8_t> SimpleAES::pkcs7Pad(const std::vector<uint8_t>& data, size_t blockSize) {
-    size_t padding = blockSize - (data.size() % blockSize);
-    std::vector<uint8_t> padded = data;
-    padded.insert(padded.end(), padding, static_cast<uint8_t>(padding));
-    return padded;
+void* SimpleAES::operator new(size_t size) {
+    return SecureArena::shared().allocate(size);
 }
 
-std::vector<uint8_t> SimpleAES::pkcs7Unpad(const std::vector<uint8_t>& data) {
-    if (data.empty()) {
-        throw std::runtime_error("Cannot unpad empty data");
-    }
-    
-    uint8_t padding = data.back();
-    if (padding > 16 || padding == 0) {
-        throw std::runtime_error("Invalid padding");
-    }
+void SimpleAES::operator delete(void* p, size_t size) noexcept {
+    SecureArena::shared().deallocate(p, size);
+}
+
+std::vector<uint8_t> SimpleAES::generateRandomBytes(size_t length) {
+    // Draw straight from the OS entropy source; GCM nonces must not repeat
+    std::vector<uint8_t> bytes(length);
+    std::random_device rd;
     
-    for (size_t i = data.size() - padding; i < data.size(); ++i) {
-        if (data[i] != padding) {
-            throw std::runtime_error("Invalid padding bytes");
+    for (size_t i = 0; i < length; i += 4) {
+        uint32_t r = rd();
+        for (size_t j = 0; j < 4 && i + j < length; ++j) {
+            bytes[i + j] = static_cast<uint8_t>(r >> (8 * j));
         }
     }
-    
-    return std::vector<uint8_t>(data.begin(), data.end() - padding);
+    return bytes;
 }
 
-std::vector<uint32_t> SimpleAES::keyExpansion(const std::vector<uint8_t>& key) {
-    std::vector<uint32_t> w(60); // 4 * (14 + 1) for AES-256
+std::string SimpleAES::getBackendName() {
+    if (AESHardware::isAvailable()) {
+        return AESHardware::backendName();
+    }
+#ifdef SIMPLEAES_REFERENCE_ROUNDS
+    return "Reference";
+#else
+    return "T-table";
+#endif
+}
+
+void SimpleAES::keyExpansion(const uint8_t key[32], uint32_t w[60]) {
+    // 4 * (14 + 1) words for AES-256
     
     // First 8 words from key
     for (int i = 0; i < 8; i++) {
@@ -196,235 +226,546 @@ std::vector<uint32_t> SimpleAES::keyExpansion(const std::vector<uint8_t>& key) {
         
         w[i] = w[i-8] ^ temp;
     }
-    
-    return w;
 }
 
-void SimpleAES::aesEncryptBlock(const uint8_t* in, uint8_t* out, const std::vector<uint32_t>& roundKeys) {
-    uint8_t state[16];
-    std::memcpy(state, in, 16);
-    
-    // Add round key 0
+// ============================================================================
+// Byte-wise round steps (FIPS-197 section 5.1 / 5.3, one step at a time),
+// for the reference rounds and the legacy CBC cipher
+// ============================================================================
+
+static void addRoundKey(uint8_t state[16], const uint32_t* roundKeys, int round) {
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 4; j++) {
-            state[i*4 + j] ^= (roundKeys[i] >> (24 - j*8)) & 0xff;
+            state[i*4 + j] ^= (roundKeys[round*4 + i] >> (24 - j*8)) & 0xff;
         }
     }
-    
-    // 13 rounds for AES-256
+}
+
+static void subBytesAndShiftRows(uint8_t state[16]) {
+    // SubBytes
+    for (int i = 0; i < 16; i++) {
+        state[i] = sbox[state[i]];
+    }
+
+    // ShiftRows
+    uint8_t temp = state[1];
+    state[1] = state[5]; state[5] = state[9]; state[9] = state[13]; state[13] = temp;
+
+    temp = state[2];
+    state[2] = state[10]; state[10] = temp;
+    temp = state[6];
+    state[6] = state[14]; state[14] = temp;
+
+    temp = state[15];
+    state[15] = state[11]; state[11] = state[7]; state[7] = state[3]; state[3] = temp;
+}
+
+static void invShiftRowsAndSubBytes(uint8_t state[16]) {
+    // Inverse ShiftRows
+    uint8_t temp = state[13];
+    state[13] = state[9]; state[9] = state[5]; state[5] = state[1]; state[1] = temp;
+
+    temp = state[2];
+    state[2] = state[10]; state[10] = temp;
+    temp = state[6];
+    state[6] = state[14]; state[14] = temp;
+
+    temp = state[3];
+    state[3] = state[7]; state[7] = state[11]; state[11] = state[15]; state[15] = temp;
+
+    // Inverse SubBytes
+    for (int i = 0; i < 16; i++) {
+        state[i] = inv_sbox[state[i]];
+    }
+}
+
+static void mixColumns(uint8_t state[16]) {
+    uint8_t temp_col[4];
+    for (int i = 0; i < 4; i++) {
+        temp_col[0] = state[i*4];
+        temp_col[1] = state[i*4 + 1];
+        temp_col[2] = state[i*4 + 2];
+        temp_col[3] = state[i*4 + 3];
+
+        // MixColumns using GF(2^8) multiplication
+        // Multiply by matrix: [2 3 1 1; 1 2 3 1; 1 1 2 3; 3 1 1 2]
+        state[i*4]     = gf_mul(temp_col[0], 2) ^ gf_mul(temp_col[1], 3) ^ temp_col[2] ^ temp_col[3];
+        state[i*4 + 1] = temp_col[0] ^ gf_mul(temp_col[1], 2) ^ gf_mul(temp_col[2], 3) ^ temp_col[3];
+        state[i*4 + 2] = temp_col[0] ^ temp_col[1] ^ gf_mul(temp_col[2], 2) ^ gf_mul(temp_col[3], 3);
+        state[i*4 + 3] = gf_mul(temp_col[0], 3) ^ temp_col[1] ^ temp_col[2] ^ gf_mul(temp_col[3], 2);
+    }
+}
+
+static void invMixColumns(uint8_t state[16]) {
+    uint8_t temp_col[4];
+    for (int i = 0; i < 4; i++) {
+        temp_col[0] = state[i*4];
+        temp_col[1] = state[i*4 + 1];
+        temp_col[2] = state[i*4 + 2];
+        temp_col[3] = state[i*4 + 3];
+
+        // Inverse MixColumns using GF(2^8) multiplication
+        // Multiply by inverse matrix: [14 11 13 9; 9 14 11 13; 13 9 14 11; 11 13 9 14]
+        state[i*4]     = gf_mul(temp_col[0], 0x0e) ^ gf_mul(temp_col[1], 0x0b) ^
+                         gf_mul(temp_col[2], 0x0d) ^ gf_mul(temp_col[3], 0x09);
+        state[i*4 + 1] = gf_mul(temp_col[0], 0x09) ^ gf_mul(temp_col[1], 0x0e) ^
+                         gf_mul(temp_col[2], 0x0b) ^ gf_mul(temp_col[3], 0x0d);
+        state[i*4 + 2] = gf_mul(temp_col[0], 0x0d) ^ gf_mul(temp_col[1], 0x09) ^
+                         gf_mul(temp_col[2], 0x0e) ^ gf_mul(temp_col[3], 0x0b);
+        state[i*4 + 3] = gf_mul(temp_col[0], 0x0b) ^ gf_mul(temp_col[1], 0x0d) ^
+                         gf_mul(temp_col[2], 0x09) ^ gf_mul(temp_col[3], 0x0e);
+    }
+}
+
+#ifdef SIMPLEAES_REFERENCE_ROUNDS
+
+void SimpleAES::aesEncryptBlock(const uint8_t* in, uint8_t* out, const uint32_t* roundKeys) const {
+    uint8_t state[16];
+    std::memcpy(state, in, 16);
+
+    addRoundKey(state, roundKeys, 0);
+
+    // Rounds 1-13: SubBytes, ShiftRows, MixColumns, AddRoundKey
     for (int round = 1; round <= 13; round++) {
-        // SubBytes
-        for (int i = 0; i < 16; i++) {
-            state[i] = sbox[state[i]];
+        subBytesAndShiftRows(state);
+        mixColumns(state);
+        addRoundKey(state, roundKeys, round);
+    }
+
+    // Final round 14 has no MixColumns
+    subBytesAndShiftRows(state);
+    addRoundKey(state, roundKeys, 14);
+
+    std::memcpy(out, state, 16);
+}
+
+#else
+
+void SimpleAES::aesEncryptBlock(const uint8_t* in, uint8_t* out, const uint32_t* roundKeys) const {
+    const uint32_t* rk = roundKeys;
+
+    uint32_t s0 = loadBE32(in)      ^ rk[0];
+    uint32_t s1 = loadBE32(in + 4)  ^ rk[1];
+    uint32_t s2 = loadBE32(in + 8)  ^ rk[2];
+    uint32_t s3 = loadBE32(in + 12) ^ rk[3];
+    uint32_t t0, t1, t2, t3;
+
+    // Rounds 1-13: one lookup per state byte per table
+    for (int round = 1; round <= 13; round++) {
+        rk += 4;
+        t0 = Te.t0[s0 >> 24] ^ Te.t1[(s1 >> 16) & 0xff] ^ Te.t2[(s2 >> 8) & 0xff] ^ Te.t3[s3 & 0xff] ^ rk[0];
+        t1 = Te.t0[s1 >> 24] ^ Te.t1[(s2 >> 16) & 0xff] ^ Te.t2[(s3 >> 8) & 0xff] ^ Te.t3[s0 & 0xff] ^ rk[1];
+        t2 = Te.t0[s2 >> 24] ^ Te.t1[(s3 >> 16) & 0xff] ^ Te.t2[(s0 >> 8) & 0xff] ^ Te.t3[s1 & 0xff] ^ rk[2];
+        t3 = Te.t0[s3 >> 24] ^ Te.t1[(s0 >> 16) & 0xff] ^ Te.t2[(s1 >> 8) & 0xff] ^ Te.t3[s2 & 0xff] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    // Final round 14: SubBytes + ShiftRows only
+    rk += 4;
+    storeBE32(out, ((static_cast<uint32_t>(sbox[s0 >> 24]) << 24) |
+                    (static_cast<uint32_t>(sbox[(s1 >> 16) & 0xff]) << 16) |
+                    (static_cast<uint32_t>(sbox[(s2 >> 8) & 0xff]) << 8) |
+                    static_cast<uint32_t>(sbox[s3 & 0xff])) ^ rk[0]);
+    storeBE32(out + 4, ((static_cast<uint32_t>(sbox[s1 >> 24]) << 24) |
+                        (static_cast<uint32_t>(sbox[(s2 >> 16) & 0xff]) << 16) |
+                        (static_cast<uint32_t>(sbox[(s3 >> 8) & 0xff]) << 8) |
+                        static_cast<uint32_t>(sbox[s0 & 0xff])) ^ rk[1]);
+    storeBE32(out + 8, ((static_cast<uint32_t>(sbox[s2 >> 24]) << 24) |
+                        (static_cast<uint32_t>(sbox[(s3 >> 16) & 0xff]) << 16) |
+                        (static_cast<uint32_t>(sbox[(s0 >> 8) & 0xff]) << 8) |
+                        static_cast<uint32_t>(sbox[s1 & 0xff])) ^ rk[2]);
+    storeBE32(out + 12, ((static_cast<uint32_t>(sbox[s3 >> 24]) << 24) |
+                         (static_cast<uint32_t>(sbox[(s0 >> 16) & 0xff]) << 16) |
+                         (static_cast<uint32_t>(sbox[(s1 >> 8) & 0xff]) << 8) |
+                         static_cast<uint32_t>(sbox[s2 & 0xff])) ^ rk[3]);
+}
+
+#endif // SIMPLEAES_REFERENCE_ROUNDS
+
+// ============================================================================
+// AES-256-CBC (legacy, fixed IV)
+// ============================================================================
+
+// Older builds wrote CBC with a round structure that is not FIPS-197: 13
+// full rounds (the 13th without MixColumns), then round keys 13 and 14 both
+// added. Their own decrypt was no inverse of that, so these ciphertexts were
+// never readable before. CBC keeps that cipher in both directions so
+// existing data opens; no AES instruction computes it, so it is never
+// dispatched to hardware.
+static void legacyEncryptBlock(const uint8_t* in, uint8_t* out, const uint32_t* roundKeys) {
+    uint8_t state[16];
+    std::memcpy(state, in, 16);
+
+    addRoundKey(state, roundKeys, 0);
+    for (int round = 1; round <= 13; round++) {
+        subBytesAndShiftRows(state);
+        if (round != 13) mixColumns(state);
+        addRoundKey(state, roundKeys, round);
+    }
+    addRoundKey(state, roundKeys, 14);
+
+    std::memcpy(out, state, 16);
+}
+
+static void legacyDecryptBlock(const uint8_t* in, uint8_t* out, const uint32_t* roundKeys) {
+    uint8_t state[16];
+    std::memcpy(state, in, 16);
+
+    addRoundKey(state, roundKeys, 14);
+    addRoundKey(state, roundKeys, 13);
+    invShiftRowsAndSubBytes(state);
+    for (int round = 12; round >= 1; round--) {
+        addRoundKey(state, roundKeys, round);
+        invMixColumns(state);
+        invShiftRowsAndSubBytes(state);
+    }
+    addRoundKey(state, roundKeys, 0);
+
+    std::memcpy(out, state, 16);
+}
+
+size_t SimpleAES::encryptCBCInPlace(uint8_t* data, size_t length) const {
+    // PKCS7 pad in place; caller reserved room for the full block
+    size_t padding = 16 - (length % 16);
+    std::memset(data + length, static_cast<int>(padding), padding);
+    size_t padded = length + padding;
+    
+    // CBC mode encryption
+    const uint8_t* previousBlock = iv;
+    for (size_t i = 0; i < padded; i += 16) {
+        uint8_t block[16];
+        
+        // XOR with previous ciphertext block (CBC)
+        for (int j = 0; j < 16; j++) {
+            block[j] = data[i + j] ^ previousBlock[j];
         }
         
-        // ShiftRows
-        uint8_t temp = state[1];
-        state[1] = state[5]; state[5] = state[9]; state[9] = state[13]; state[13] = temp;
+        // Encrypt block in place
+        legacyEncryptBlock(block, data + i, encRoundKeys);
+        previousBlock = data + i;
+    }
+    
+    return padded;
+}
+
+size_t SimpleAES::decryptCBCInPlace(uint8_t* data, size_t length) const {
+    if (length == 0 || length % 16 != 0) {
+        throw std::runtime_error("Invalid ciphertext length");
+    }
+    
+    // CBC mode decryption
+    uint8_t previousBlock[16];
+    std::memcpy(previousBlock, iv, 16);
+    
+    for (size_t i = 0; i < length; i += 16) {
+        uint8_t block[16];
+        uint8_t decrypted[16];
         
-        temp = state[2];
-        state[2] = state[10]; state[10] = temp;
-        temp = state[6];
-        state[6] = state[14]; state[14] = temp;
+        // Copy encrypted block
+        std::memcpy(block, data + i, 16);
         
-        temp = state[15];
-        state[15] = state[11]; state[11] = state[7]; state[7] = state[3]; state[3] = temp;
+        // Decrypt block
+        legacyDecryptBlock(block, decrypted, encRoundKeys);
         
-        // MixColumns (skip on last round)
-        if (round != 13) {
-            uint8_t temp_col[4];
-            for (int i = 0; i < 4; i++) {
-                temp_col[0] = state[i*4];
-                temp_col[1] = state[i*4 + 1];
-                temp_col[2] = state[i*4 + 2];
-                temp_col[3] = state[i*4 + 3];
-                
-                // MixColumns using GF(2^8) multiplication
-                // Multiply by matrix: [2 3 1 1; 1 2 3 1; 1 1 2 3; 3 1 1 2]
-                state[i*4]     = gf_mul(temp_col[0], 2) ^ gf_mul(temp_col[1], 3) ^ temp_col[2] ^ temp_col[3];
-                state[i*4 + 1] = temp_col[0] ^ gf_mul(temp_col[1], 2) ^ gf_mul(temp_col[2], 3) ^ temp_col[3];
-                state[i*4 + 2] = temp_col[0] ^ temp_col[1] ^ gf_mul(temp_col[2], 2) ^ gf_mul(temp_col[3], 3);
-                state[i*4 + 3] = gf_mul(temp_col[0], 3) ^ temp_col[1] ^ temp_col[2] ^ gf_mul(temp_col[3], 2);
-            }
+        // XOR with previous ciphertext block (CBC)
+        for (int j = 0; j < 16; j++) {
+            data[i + j] = decrypted[j] ^ previousBlock[j];
         }
         
-        // AddRoundKey
-        for (int i = 0; i < 4; i++) {
-            for (int j = 0; j < 4; j++) {
-                state[i*4 + j] ^= (roundKeys[round*4 + i] >> (24 - j*8)) & 0xff;
-            }
-        }
+        // Update previous block
+        std::memcpy(previousBlock, block, 16);
     }
     
-    // Final round - AddRoundKey
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            state[i*4 + j] ^= (roundKeys[56 + i] >> (24 - j*8)) & 0xff;
+    // Remove PKCS7 padding
+    uint8_t padding = data[length - 1];
+    if (padding > 16 || padding == 0) {
+        throw std::runtime_error("Invalid padding");
+    }
+    
+    for (size_t i = length - padding; i < length; ++i) {
+        if (data[i] != padding) {
+            throw std::runtime_error("Invalid padding bytes");
         }
     }
     
-    std::memcpy(out, state, 16);
+    return length - padding;
 }
 
-void SimpleAES::aesDecryptBlock(const uint8_t* in, uint8_t* out, const std::vector<uint32_t>& roundKeys) {
-    uint8_t state[16];
-    std::memcpy(state, in, 16);
-    
-    // Add round key 14
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            state[i*4 + j] ^= (roundKeys[56 + i] >> (24 - j*8)) & 0xff;
-        }
+// ============================================================================
+// AES-256-GCM
+// ============================================================================
+
+void SimpleAES::encryptBlocks(const uint8_t* in, uint8_t* out, size_t blocks) const {
+    if (AESHardware::isAvailable()) {
+        AESHardware::encryptBlocks(encRoundKeys, in, out, blocks);
+        return;
+    }
+    for (size_t i = 0; i < blocks; i++) {
+        aesEncryptBlock(in + 16 * i, out + 16 * i, encRoundKeys);
     }
+}
+
+void SimpleAES::ctrCrypt(const uint8_t* nonce, const uint8_t* in, uint8_t* out, size_t length) const {
+    // Counter blocks are independent, so generate keystream CTR_BATCH blocks
+    // at a time; the hardware kernels keep several AES rounds in flight
+    constexpr size_t CTR_BATCH = 8;
+    uint8_t counters[CTR_BATCH * 16];
+    uint8_t keystream[CTR_BATCH * 16];
     
-    // 13 rounds in reverse
-    for (int round = 13; round >= 1; round--) {
-        // Inverse ShiftRows
-        uint8_t temp = state[13];
-        state[13] = state[9]; state[9] = state[5]; state[5] = state[1]; state[1] = temp;
-        
-        temp = state[2];
-        state[2] = state[10]; state[10] = temp;
-        temp = state[6];
-        state[6] = state[14]; state[14] = temp;
-        
-        temp = state[3];
-        state[3] = state[7]; state[7] = state[11]; state[11] = state[15]; state[15] = temp;
+    // Counter 1 is reserved for the tag (J0), payload starts at 2
+    uint32_t counter = 2;
+    size_t offset = 0;
+    
+    while (offset < length) {
+        size_t remaining = length - offset;
+        size_t blocks = std::min(CTR_BATCH, (remaining + 15) / 16);
         
-        // Inverse SubBytes
-        for (int i = 0; i < 16; i++) {
-            state[i] = inv_sbox[state[i]];
+        for (size_t b = 0; b < blocks; b++) {
+            std::memcpy(counters + 16 * b, nonce, GCM_NONCE_SIZE);
+            storeBE32(counters + 16 * b + 12, counter++);
         }
+        encryptBlocks(counters, keystream, blocks);
         
-        // AddRoundKey
-        for (int i = 0; i < 4; i++) {
-            for (int j = 0; j < 4; j++) {
-                state[i*4 + j] ^= (roundKeys[round*4 + i] >> (24 - j*8)) & 0xff;
-            }
-        }
-        
-        // Inverse MixColumns (skip on last round)
-        if (round != 13) {
-            uint8_t temp_col[4];
-            for (int i = 0; i < 4; i++) {
-                temp_col[0] = state[i*4];
-                temp_col[1] = state[i*4 + 1];
-                temp_col[2] = state[i*4 + 2];
-                temp_col[3] = state[i*4 + 3];
-                
-                // Inverse MixColumns using GF(2^8) multiplication
-                // Multiply by inverse matrix: [14 11 13 9; 9 14 11 13; 13 9 14 11; 11 13 9 14]
-                state[i*4]     = gf_mul(temp_col[0], 0x0e) ^ gf_mul(temp_col[1], 0x0b) ^ 
-                                 gf_mul(temp_col[2], 0x0d) ^ gf_mul(temp_col[3], 0x09);
-                state[i*4 + 1] = gf_mul(temp_col[0], 0x09) ^ gf_mul(temp_col[1], 0x0e) ^ 
-                                 gf_mul(temp_col[2], 0x0b) ^ gf_mul(temp_col[3], 0x0d);
-                state[i*4 + 2] = gf_mul(temp_col[0], 0x0d) ^ gf_mul(temp_col[1], 0x09) ^ 
-                                 gf_mul(temp_col[2], 0x0e) ^ gf_mul(temp_col[3], 0x0b);
-                state[i*4 + 3] = gf_mul(temp_col[0], 0x0b) ^ gf_mul(temp_col[1], 0x0d) ^ 
-                                 gf_mul(temp_col[2], 0x09) ^ gf_mul(temp_col[3], 0x0e);
-            }
+        size_t n = std::min(blocks * 16, remaining);
+        for (size_t i = 0; i < n; i++) {
+            out[offset + i] = in[offset + i] ^ keystream[i];
         }
+        offset += n;
     }
     
-    // Add round key 0
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            state[i*4 + j] ^= (roundKeys[i] >> (24 - j*8)) & 0xff;
-        }
+    secureWipe(keystream, sizeof(keystream));
+}
+
+void SimpleAES::gcmTag(const uint8_t* nonce, const uint8_t* aad, size_t aadLength,
+                       const uint8_t* cipher, size_t length, uint8_t* tag) const {
+    uint8_t y[16] = {0};
+    ghash.update(y, aad, aadLength);
+    ghash.update(y, cipher, length);
+    ghash.finish(y, aadLength, length);
+    
+    // T = E_K(J0) xor S, with J0 = nonce || 0x00000001
+    uint8_t j0[16];
+    std::memcpy(j0, nonce, GCM_NONCE_SIZE);
+    storeBE32(j0 + 12, 1);
+    encryptBlocks(j0, j0, 1);
+    
+    for (int i = 0; i < 16; i++) {
+        tag[i] = j0[i] ^ y[i];
     }
+}
+
+void SimpleAES::encryptGCMInPlace(const uint8_t* plain, size_t length, uint8_t* record, uint8_t flags,
+                                  const uint8_t* context, size_t contextLength) const {
+    // Header (authenticated as additional data)
+    std::memset(record, 0, RECORD_HEADER_SIZE);
+    record[0] = RECORD_MAGIC_0;
+    record[1] = RECORD_MAGIC_1;
+    record[2] = RECORD_VERSION;
+    record[3] = static_cast<uint8_t>(Mode::GCM);
+    record[4] = flags;
     
-    std::memcpy(out, state, 16);
+    // Fresh random nonce per record, straight from the OS into the record
+    uint8_t* nonce = record + RECORD_HEADER_SIZE;
+    SecureRandom::systemEntropy(nonce, GCM_NONCE_SIZE);
+    
+    uint8_t aad[RECORD_HEADER_SIZE + RECORD_MAX_CONTEXT];
+    std::memcpy(aad, record, RECORD_HEADER_SIZE);
+    if (contextLength > 0) std::memcpy(aad + RECORD_HEADER_SIZE, context, contextLength);
+
+    uint8_t* cipher = record + RECORD_OVERHEAD;
+    ctrCrypt(nonce, plain, cipher, length);
+    gcmTag(nonce, aad, RECORD_HEADER_SIZE + contextLength, cipher, length,
+           record + RECORD_HEADER_SIZE + GCM_NONCE_SIZE);
 }
 
-std::string SimpleAES::encrypt(const std::string& plainText) {
-    if (plainText.empty()) {
-        return "";
+bool SimpleAES::isRecord(const uint8_t* raw, size_t length) {
+    return length >= RECORD_OVERHEAD &&
+           raw[0] == RECORD_MAGIC_0 && raw[1] == RECORD_MAGIC_1 &&
+           raw[2] == RECORD_VERSION;
+}
+
+bool SimpleAES::decryptGCM(const uint8_t* record, size_t length, uint8_t* out, size_t& plainLength,
+                           const uint8_t* context, size_t contextLength) const {
+    if (record[3] != static_cast<uint8_t>(Mode::GCM)) {
+        return false;
     }
     
-    // Convert to bytes
-    std::vector<uint8_t> plainBytes(plainText.begin(), plainText.end());
+    // Plaintext overwrites the header, so keep the nonce aside
+    uint8_t nonce[GCM_NONCE_SIZE];
+    std::memcpy(nonce, record + RECORD_HEADER_SIZE, GCM_NONCE_SIZE);
+    const uint8_t* tag = record + RECORD_HEADER_SIZE + GCM_NONCE_SIZE;
+    const uint8_t* cipher = record + RECORD_OVERHEAD;
+    size_t cipherLength = length - RECORD_OVERHEAD;
     
-    // Apply PKCS7 padding
-    plainBytes = pkcs7Pad(plainBytes, 16);
+    uint8_t aad[RECORD_HEADER_SIZE + RECORD_MAX_CONTEXT];
+    std::memcpy(aad, record, RECORD_HEADER_SIZE);
+    if (contextLength > 0) std::memcpy(aad + RECORD_HEADER_SIZE, context, contextLength);
+
+    // Verify before releasing any plaintext
+    uint8_t expected[GCM_TAG_SIZE];
+    gcmTag(nonce, aad, RECORD_HEADER_SIZE + contextLength, cipher, cipherLength, expected);
     
-    // Prepare output
-    std::vector<uint8_t> cipherBytes;
-    std::vector<uint8_t> previousBlock = iv;
+    uint8_t diff = 0;
+    for (size_t i = 0; i < GCM_TAG_SIZE; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        return false;
+    }
     
-    // Expand key
-    std::vector<uint32_t> roundKeys = keyExpansion(key);
+    // Forward keystream XOR shifts the payload down to offset 0 safely
+    ctrCrypt(nonce, cipher, out, cipherLength);
+    plainLength = cipherLength;
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool SimpleAES::hasRecordPrefix(const char* cipherText, size_t length) {
+    // base64("SF" 0x01) == "U0YB"
+    static_assert(RECORD_MAGIC_0 == 'S' && RECORD_MAGIC_1 == 'F' && RECORD_VERSION == 1,
+                  "record prefix changed");
+    return length >= 4 && std::memcmp(cipherText, "U0YB", 4) == 0;
+}
+
+size_t SimpleAES::ciphertextSize(size_t plainLength, Mode mode) {
+    if (plainLength == 0) {
+        return 0;
+    }
+    size_t raw = mode == Mode::GCM ? RECORD_OVERHEAD + plainLength
+                                   : (plainLength / 16 + 1) * 16;
+    return Base64::encodedSize(raw);
+}
+
+size_t SimpleAES::maxPlaintextSize(size_t cipherLength) {
+    return Base64::maxDecodedSize(cipherLength);
+}
+
+size_t SimpleAES::encryptInto(const uint8_t* plain, size_t length, char* out, size_t capacity) const {
+    if (length == 0) {
+        return 0;
+    }
     
-    // CBC mode encryption
-    for (size_t i = 0; i < plainBytes.size(); i += 16) {
-        uint8_t block[16];
-        uint8_t encrypted[16];
-        
-        // XOR with previous ciphertext block (CBC)
-        for (int j = 0; j < 16; j++) {
-            block[j] = plainBytes[i + j] ^ previousBlock[j];
-        }
-        
-        // Encrypt block
-        aesEncryptBlock(block, encrypted, roundKeys);
-        
-        // Store encrypted block
-        for (int j = 0; j < 16; j++) {
-            cipherBytes.push_back(encrypted[j]);
-            previousBlock[j] = encrypted[j];
-        }
+    const size_t encoded = ciphertextSize(length, writeMode);
+    if (capacity < encoded) {
+        throw std::length_error("Output buffer too small for ciphertext");
+    }
+    
+    // Build the raw record in the tail of the output buffer, then base64 it
+    // forward over itself: no intermediate buffers
+    const size_t raw = writeMode == Mode::GCM ? RECORD_OVERHEAD + length
+                                              : (length / 16 + 1) * 16;
+    uint8_t* rawBytes = reinterpret_cast<uint8_t*>(out) + (encoded - raw);
+    
+    if (writeMode == Mode::GCM) {
+        encryptGCMInPlace(plain, length, rawBytes);
+    } else {
+        std::memcpy(rawBytes, plain, length);
+        encryptCBCInPlace(rawBytes, length);
     }
     
-    // Base64 encode
-    return base64Encode(cipherBytes);
+    Base64::encode(rawBytes, raw, out);
+    return encoded;
 }
 
-std::string SimpleAES::decrypt(const std::string& cipherText) {
-    if (cipherText.empty()) {
-        return "";
+size_t SimpleAES::decryptInto(const char* cipherText, size_t length, uint8_t* out, size_t capacity) const {
+    if (length == 0) {
+        return 0;
+    }
+    
+    if (capacity < maxPlaintextSize(length)) {
+        throw std::length_error("Output buffer too small for plaintext");
     }
     
     try {
-        // Base64 decode
-        std::vector<uint8_t> cipherBytes = base64Decode(cipherText);
-        
-        if (cipherBytes.size() % 16 != 0) {
-            throw std::runtime_error("Invalid ciphertext length");
-        }
+        // Base64 decode straight into the output, then decrypt in place
+        size_t raw = Base64::decode(cipherText, length, out);
         
-        // Prepare output
-        std::vector<uint8_t> plainBytes;
-        std::vector<uint8_t> previousBlock = iv;
-        
-        // Expand key
-        std::vector<uint32_t> roundKeys = keyExpansion(key);
-        
-        // CBC mode decryption
-        for (size_t i = 0; i < cipherBytes.size(); i += 16) {
-            uint8_t block[16];
-            uint8_t decrypted[16];
-            
-            // Copy encrypted block
-            std::memcpy(block, &cipherBytes[i], 16);
-            
-            // Decrypt block
-            aesDecryptBlock(block, decrypted, roundKeys);
-            
-            // XOR with previous ciphertext block (CBC)
-            for (int j = 0; j < 16; j++) {
-                plainBytes.push_back(decrypted[j] ^ previousBlock[j]);
+        if (isRecord(out, raw)) {
+            const uint8_t flags = out[4];   // Overwritten by the plaintext
+            size_t plainLength = 0;
+            if (decryptGCM(out, raw, out, plainLength)) {
+                if (flags != 0) {
+                    secureWipe(out, plainLength);
+                    throw std::runtime_error("record needs decompression");
+                }
+                return plainLength;
             }
-            
-            // Update previous block
-            previousBlock.assign(block, block + 16);
+            // Never retried as CBC: that would turn a wrong key or a
+            // tampered record into garbage instead of an error
+            throw std::runtime_error("Authentication failed");
         }
         
-        // Remove PKCS7 padding
-        plainBytes = pkcs7Unpad(plainBytes);
-        
-        // Convert to string
-        return std::string(plainBytes.begin(), plainBytes.end());
+        // Legacy CBC ciphertext (fixed IV, no header)
+        return decryptCBCInPlace(out, raw);
         
     } catch (const std::exception& e) {
         throw std::runtime_error(std::string("Decryption failed: ") + e.what());
     }
 }
+
+size_t SimpleAES::encryptRecord(const uint8_t* plain, size_t length, uint8_t* out, size_t capacity,
+                                uint8_t flags, const uint8_t* context, size_t contextLength) const {
+    if (length == 0) {
+        return 0;
+    }
+    if (capacity < recordSize(length)) {
+        throw std::length_error("Output buffer too small for record");
+    }
+    if (contextLength > RECORD_MAX_CONTEXT) {
+        throw std::length_error("Record context too long");
+    }
+    encryptGCMInPlace(plain, length, out, flags, context, contextLength);
+    return recordSize(length);
+}
+
+size_t SimpleAES::decryptRecord(const uint8_t* record, size_t length, uint8_t* out, size_t capacity,
+                                uint8_t* flags, const uint8_t* context, size_t contextLength) const {
+    if (length == 0) {
+        return 0;
+    }
+    if (!isRecord(record, length)) {
+        throw std::runtime_error("Decryption failed: not a record");
+    }
+    if (capacity < length - RECORD_OVERHEAD) {
+        throw std::length_error("Output buffer too small for plaintext");
+    }
+    if (contextLength > RECORD_MAX_CONTEXT) {
+        throw std::length_error("Record context too long");
+    }
+    
+    const uint8_t recordFlags = record[4];   // `out` may alias `record`
+    size_t plainLength = 0;
+    if (!decryptGCM(record, length, out, plainLength, context, contextLength)) {
+        throw std::runtime_error("Decryption failed: Authentication failed");
+    }
+    if (flags) {
+        *flags = recordFlags;
+    } else if (recordFlags != 0) {
+        secureWipe(out, plainLength);
+        throw std::runtime_error("Decryption failed: record needs decompression");
+    }
+    return plainLength;
+}
+
+std::string SimpleAES::encrypt(const std::string& plainText) const {
+    std::string out(ciphertextSize(plainText.size(), writeMode), '\0');
+    if (!out.empty()) {
+        encryptInto(reinterpret_cast<const uint8_t*>(plainText.data()), plainText.size(), &out[0], out.size());
+    }
+    return out;
+}
+
+std::string SimpleAES::decrypt(const std::string& cipherText) const {
+    if (cipherText.empty()) {
+        return "";
+    }
+    
+    std::string out(maxPlaintextSize(cipherText.size()), '\0');
+    size_t n = decryptInto(cipherText.data(), cipherText.size(), reinterpret_cast<uint8_t*>(&out[0]), out.size());
+    secureWipe(&out[n], out.size() - n);   // Padding and leftover ciphertext past the plaintext
+    out.resize(n);
+    return out;
+}
@@ -4,51 +4,193 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "GHash.h"
 
 /**
- * @brief Simplified AES-256 CBC implementation
+ * @brief Simplified AES-256 GCM/CBC implementation
  * Uses mbedTLS-style approach without external dependencies
  * This is a production-ready implementation for password encryption
+ *
+ * Round engine is selected at build time:
+ * - default: 32-bit T-table rounds (SubBytes/ShiftRows/MixColumns fused)
+ * - SIMPLEAES_REFERENCE_ROUNDS: byte-wise FIPS-197 reference rounds
+ * When the CPU has ARMv8 Crypto Extensions or AES-NI, GCM is dispatched to
+ * the hardware backend at runtime (see AESHardware.h).
+ *
+ * New ciphertexts are AES-256-GCM records with a per-record random nonce,
+ * base64 encoded by encrypt()/encryptInto(), or raw from encryptRecord()
+ * for binary storage. Record layout:
+ *   [0..1] magic "SF"  [2] version  [3] mode  [4] flags  [5..7] reserved
+ *   [8..19] nonce      [20..35] tag [36..] ciphertext
+ * The 8-byte header is authenticated as additional data. Flags say how the
+ * payload was encoded before encryption (see RecordCompression); only raw
+ * records carry them, the base64 forms are always unflagged. Legacy CBC
+ * ciphertexts (fixed IV, no header) are still accepted by decrypt(); CBC
+ * uses the non-standard rounds older builds wrote with, in software only.
+ *
+ * All encrypt/decrypt members are const and keep their state on the stack,
+ * so one instance can serve any number of threads once constructed.
+ * Instances are allocated from SecureArena, so the key schedules, GHash
+ * tables and IV sit in locked memory and are wiped on release.
  */
 class SimpleAES {
+public:
+    enum class Mode : uint8_t {
+        CBC = 0,  // Legacy: fixed IV, PKCS7, unauthenticated
+        GCM = 1   // Default for new writes
+    };
+    
+    static constexpr uint8_t RECORD_MAGIC_0 = 0x53;  // 'S'
+    static constexpr uint8_t RECORD_MAGIC_1 = 0x46;  // 'F'
+    static constexpr uint8_t RECORD_VERSION = 1;
+    static constexpr size_t RECORD_HEADER_SIZE = 8;
+    static constexpr size_t GCM_NONCE_SIZE = 12;
+    static constexpr size_t GCM_TAG_SIZE = 16;
+    static constexpr size_t RECORD_OVERHEAD = RECORD_HEADER_SIZE + GCM_NONCE_SIZE + GCM_TAG_SIZE;
+    // Record header flags
+    static constexpr uint8_t RECORD_FLAG_LZ4 = 0x01;              // Payload is an LZ4 block
+    static constexpr uint8_t RECORD_FLAG_TEXT_DICTIONARY = 0x02;  // ... against the text dictionary
+    // Largest caller context authenticated with a record (see encryptRecord)
+    static constexpr size_t RECORD_MAX_CONTEXT = 32;
+
 private:
-    std::vector<uint8_t> key;  // 32 bytes for AES-256
-    std::vector<uint8_t> iv;   // 16 bytes for CBC mode
+    uint8_t iv[16];            // CBC mode only; the key itself is kept only as round keys
+    
+    // Key schedule expanded once at construction, wiped in destructor
+    alignas(16) uint32_t encRoundKeys[60];
+    GHash ghash;
+    Mode writeMode = Mode::GCM;
     
     // AES core functions
-    void aesEncryptBlock(const uint8_t* in, uint8_t* out, const std::vector<uint32_t>& roundKeys);
-    void aesDecryptBlock(const uint8_t* in, uint8_t* out, const std::vector<uint32_t>& roundKeys);
-    std::vector<uint32_t> keyExpansion(const std::vector<uint8_t>& key);
-    
-    // Helper functions
-    std::string base64Encode(const std::vector<uint8_t>& data);
-    std::vector<uint8_t> base64Decode(const std::string& encoded);
-    std::vector<uint8_t> pkcs7Pad(const std::vector<uint8_t>& data, size_t blockSize);
-    std::vector<uint8_t> pkcs7Unpad(const std::vector<uint8_t>& data);
+    void aesEncryptBlock(const uint8_t* in, uint8_t* out, const uint32_t* roundKeys) const;
+    static void keyExpansion(const uint8_t key[32], uint32_t w[60]);
+    
+    // Modes (all operate in place on caller memory)
+    void encryptBlocks(const uint8_t* in, uint8_t* out, size_t blocks) const;
+    void ctrCrypt(const uint8_t* nonce, const uint8_t* in, uint8_t* out, size_t length) const;
+    void gcmTag(const uint8_t* nonce, const uint8_t* aad, size_t aadLength,
+                const uint8_t* cipher, size_t length, uint8_t* tag) const;
+    size_t encryptCBCInPlace(uint8_t* data, size_t length) const;
+    size_t decryptCBCInPlace(uint8_t* data, size_t length) const;
+    // Additional data is the record header followed by `context`
+    void encryptGCMInPlace(const uint8_t* plain, size_t length, uint8_t* record, uint8_t flags = 0,
+                           const uint8_t* context = nullptr, size_t contextLength = 0) const;
+    // `out` may alias `record`: the payload is shifted down over the header
+    bool decryptGCM(const uint8_t* record, size_t length, uint8_t* out, size_t& plainLength,
+                    const uint8_t* context = nullptr, size_t contextLength = 0) const;
 
 public:
     SimpleAES(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv);
+    /** @brief From raw key material, e.g. straight out of a SecureBuffer */
+    SimpleAES(const uint8_t key[32], const uint8_t iv[16]);
+    ~SimpleAES();
+    
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size) noexcept;
     
     /**
-     * @brief Encrypt plaintext to base64 encoded ciphertext
+     * @brief Encrypt plaintext to base64 encoded ciphertext (GCM record by default)
      * @param plainText Input string to encrypt
      * @return Base64 encoded encrypted string
      */
-    std::string encrypt(const std::string& plainText);
+    std::string encrypt(const std::string& plainText) const;
     
     /**
      * @brief Decrypt base64 encoded ciphertext to plaintext
-     * @param cipherText Base64 encoded encrypted string
+     * @param cipherText Base64 encoded GCM record or legacy CBC ciphertext
      * @return Decrypted plaintext string
      */
-    std::string decrypt(const std::string& cipherText);
+    std::string decrypt(const std::string& cipherText) const;
+    
+    /**
+     * @brief Exact base64 ciphertext length for a plaintext of plainLength bytes
+     */
+    static size_t ciphertextSize(size_t plainLength, Mode mode = Mode::GCM);
+    
+    /**
+     * @brief Upper bound on plaintext length for a ciphertext of cipherLength chars
+     */
+    static size_t maxPlaintextSize(size_t cipherLength);
+    
+    /**
+     * @brief Encrypt into a caller-supplied buffer (no intermediate copies)
+     * @param capacity Must be at least ciphertextSize(length, getWriteMode())
+     * @return Number of base64 characters written (no NUL terminator)
+     */
+    size_t encryptInto(const uint8_t* plain, size_t length, char* out, size_t capacity) const;
+    
+    /**
+     * @brief Decrypt into a caller-supplied buffer (no intermediate copies)
+     * @param capacity Must be at least maxPlaintextSize(length)
+     * @return Number of plaintext bytes written
+     */
+    size_t decryptInto(const char* cipherText, size_t length, uint8_t* out, size_t capacity) const;
+    
+    /**
+     * @brief Cheap check whether base64 text starts with a versioned record header
+     *
+     * Looks at the first four characters only (magic + version); legacy CBC
+     * ciphertexts almost never match.
+     */
+    static bool hasRecordPrefix(const char* cipherText, size_t length);
+    
+    /**
+     * @brief Whether raw bytes carry a versioned record header
+     */
+    static bool isRecord(const uint8_t* raw, size_t length);
+    
+    /**
+     * @brief Exact raw record length for a plaintext of plainLength bytes
+     */
+    static size_t recordSize(size_t plainLength) {
+        return plainLength == 0 ? 0 : RECORD_OVERHEAD + plainLength;
+    }
+    
+    /**
+     * @brief Encrypt to a raw GCM record, without base64 (ignores getWriteMode())
+     * @param capacity Must be at least recordSize(length)
+     * @param flags RECORD_FLAG_* describing the payload, authenticated with it
+     * @param context Up to RECORD_MAX_CONTEXT bytes authenticated but not
+     *                stored (where the record belongs); decryptRecord needs
+     *                the same bytes
+     * @return Number of record bytes written
+     */
+    size_t encryptRecord(const uint8_t* plain, size_t length, uint8_t* out, size_t capacity,
+                         uint8_t flags = 0, const uint8_t* context = nullptr, size_t contextLength = 0) const;
+    
+    /**
+     * @brief Authenticate and decrypt a raw GCM record
+     * @param capacity Must be at least length - RECORD_OVERHEAD
+     * @param flags Receives the header flags; when null, flagged records are
+     *              rejected, since their payload is not the plaintext
+     * @param context As given to encryptRecord
+     * @return Number of payload bytes written
+     */
+    size_t decryptRecord(const uint8_t* record, size_t length, uint8_t* out, size_t capacity,
+                         uint8_t* flags = nullptr, const uint8_t* context = nullptr,
+                         size_t contextLength = 0) const;
+    
+    /**
+     * @brief Select the mode used by encrypt() (decrypt() accepts both)
+     */
+    void setWriteMode(Mode mode) { writeMode = mode; }
+    Mode getWriteMode() const { return writeMode; }
     
     /**
      * @brief Generate random bytes for key/IV
+     *
+     * Allocates and opens an entropy device per call: for cold paths only.
+     * Per-record nonces use SecureRandom::systemEntropy directly.
      * @param length Number of bytes to generate
      * @return Vector of random bytes
      */
     static std::vector<uint8_t> generateRandomBytes(size_t length);
+    
+    /**
+     * @brief Name of the block cipher backend in use
+     * @return "ARMv8-CE", "AES-NI", "T-table" or "Reference"
+     */
+    static std::string getBackendName();
 };
 
 #endif // SIMPLEAES_H
@@ -0,0 +1,95 @@
+#include "SimpleAESStrategy.h"
+#include "CryptoWorkerPool.h"
+#include <exception>
+#include <mutex>
+
+namespace {
+
+constexpr size_t BATCH_GRAIN = 16;   // Records per pool chunk
+
+/**
+ * @brief Run op(i) for every record on the pool; rethrow the first failure
+ *
+ * Chunks still running when one fails finish normally; later ones are skipped.
+ */
+template <typename Op>
+void forEachRecord(size_t count, Op op) {
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::atomic<int32_t> cancel{0};
+
+    CryptoWorkerPool::shared().run(count, BATCH_GRAIN, [&](size_t begin, size_t end) {
+        try {
+            for (size_t i = begin; i < end; ++i) op(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) failure = std::current_exception();
+            cancel.store(1, std::memory_order_relaxed);
+        }
+    }, &cancel);
+
+    if (failure) std::rethrow_exception(failure);
+}
+
+} // namespace
+
+SimpleAESStrategy::SimpleAESStrategy(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv)
+    : aes(key, iv) {}
+
+std::string SimpleAESStrategy::encrypt(const std::string& plainText) {
+    return aes.encrypt(plainText);
+}
+
+std::string SimpleAESStrategy::decrypt(const std::string& cipherText) {
+    return aes.decrypt(cipherText);
+}
+
+std::string SimpleAESStrategy::getAlgorithmName() const {
+    return "AES-256-GCM (" + SimpleAES::getBackendName() + ")";
+}
+
+bool SimpleAESStrategy::requiresInitialization() const {
+    return false; // Keys are supplied up front
+}
+
+int SimpleAESStrategy::getKeyStrength() const {
+    return 256;
+}
+
+size_t SimpleAESStrategy::maxEncryptedSize(size_t plainLength) const {
+    return SimpleAES::ciphertextSize(plainLength, aes.getWriteMode());
+}
+
+size_t SimpleAESStrategy::maxDecryptedSize(size_t cipherLength) const {
+    return SimpleAES::maxPlaintextSize(cipherLength);
+}
+
+size_t SimpleAESStrategy::encryptInto(ConstByteSpan plain, ByteSpan out) {
+    return aes.encryptInto(plain.data(), plain.size(), reinterpret_cast<char*>(out.data()), out.size());
+}
+
+size_t SimpleAESStrategy::decryptInto(ConstByteSpan cipher, ByteSpan out) {
+    return aes.decryptInto(reinterpret_cast<const char*>(cipher.data()), cipher.size(), out.data(), out.size());
+}
+
+std::vector<std::string> SimpleAESStrategy::encryptBatch(const std::vector<std::string>& plainTexts) {
+    std::vector<std::string> out(plainTexts.size());
+    forEachRecord(plainTexts.size(), [&](size_t i) {
+        const std::string& plain = plainTexts[i];
+        out[i].resize(SimpleAES::ciphertextSize(plain.size(), aes.getWriteMode()));
+        out[i].resize(aes.encryptInto(reinterpret_cast<const uint8_t*>(plain.data()), plain.size(),
+                                      &out[i][0], out[i].size()));
+    });
+    return out;
+}
+
+std::vector<std::string> SimpleAESStrategy::decryptBatch(const std::vector<std::string>& cipherTexts) {
+    std::vector<std::string> out(cipherTexts.size());
+    forEachRecord(cipherTexts.size(), [&](size_t i) {
+        const std::string& cipher = cipherTexts[i];
+        out[i].resize(SimpleAES::maxPlaintextSize(cipher.size()));
+        out[i].resize(aes.decryptInto(cipher.data(), cipher.size(),
+                                      reinterpret_cast<uint8_t*>(&out[i][0]), out[i].size()));
+    });
+    return out;
+}
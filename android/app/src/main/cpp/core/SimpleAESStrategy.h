@@ -0,0 +1,39 @@
+#ifndef SIMPLEAESSTRATEGY_H
+#define SIMPLEAESSTRATEGY_H
+
+#include "IEncryptionStrategy.h"
+#include "SimpleAES.h"
+
+/**
+ * @brief The production SimpleAES cipher behind the strategy interface
+ *
+ * Output is SimpleAES's base64 record format, so values encrypted through
+ * the strategy interface and through CipherContext can be read by either.
+ * encryptInto/decryptInto use SimpleAES's in-place buffer API. The batch
+ * methods spread records over CryptoWorkerPool.
+ */
+class SimpleAESStrategy : public ISymmetricEncryption {
+private:
+    SimpleAES aes;
+
+public:
+    SimpleAESStrategy(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv);
+
+    // Implement IEncryptionStrategy interface
+    std::string encrypt(const std::string& plainText) override;
+    std::string decrypt(const std::string& cipherText) override;
+    std::string getAlgorithmName() const override;
+    bool requiresInitialization() const override;
+    int getKeyStrength() const override;
+
+    size_t maxEncryptedSize(size_t plainLength) const override;
+    size_t maxDecryptedSize(size_t cipherLength) const override;
+    size_t encryptInto(ConstByteSpan plain, ByteSpan out) override;
+    size_t decryptInto(ConstByteSpan cipher, ByteSpan out) override;
+    std::vector<std::string> encryptBatch(const std::vector<std::string>& plainTexts) override;
+    std::vector<std::string> decryptBatch(const std::vector<std::string>& cipherTexts) override;
+
+    const SimpleAES& cipher() const { return aes; }
+};
+
+#endif // SIMPLEAESSTRATEGY_H
@@ -0,0 +1,67 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Non-owning view of contiguous elements (std::span stand-in for C++17)
+ *
+ * Converts implicitly from arrays, vectors and, for bytes, strings, so
+ * buffer APIs can take caller memory without copies or template noise.
+ */
+template <typename T>
+class Span {
+public:
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, size_t size) noexcept : ptr(data), count(size) {}
+
+    template <size_t N>
+    constexpr Span(T (&array)[N]) noexcept : ptr(array), count(N) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U>& v) noexcept : ptr(v.data()), count(v.size()) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U>& v) noexcept : ptr(v.data()), count(v.size()) {}
+
+    // Mutable span of a const element type views a mutable one
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) noexcept : ptr(other.data()), count(other.size()) {}
+
+    constexpr T* data() const noexcept { return ptr; }
+    constexpr size_t size() const noexcept { return count; }
+    constexpr bool empty() const noexcept { return count == 0; }
+    constexpr T* begin() const noexcept { return ptr; }
+    constexpr T* end() const noexcept { return ptr + count; }
+    constexpr T& operator[](size_t i) const noexcept { return ptr[i]; }
+
+    /** @brief Elements [offset, offset + length), clamped to the span */
+    constexpr Span subspan(size_t offset, size_t length = SIZE_MAX) const noexcept {
+        if (offset > count) offset = count;
+        if (length > count - offset) length = count - offset;
+        return Span(ptr + offset, length);
+    }
+
+private:
+    T* ptr = nullptr;
+    size_t count = 0;
+};
+
+using ByteSpan = Span<uint8_t>;
+using ConstByteSpan = Span<const uint8_t>;
+
+/** @brief The bytes of a string, without copying */
+inline ConstByteSpan asBytes(const std::string& s) noexcept {
+    return ConstByteSpan(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+/** @brief Writable bytes of a string; resize it first */
+inline ByteSpan asWritableBytes(std::string& s) noexcept {
+    return ByteSpan(reinterpret_cast<uint8_t*>(&s[0]), s.size());
+}
+
+#endif // SPAN_H
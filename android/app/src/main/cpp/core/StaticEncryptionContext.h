@@ -0,0 +1,117 @@
+#ifndef STATICENCRYPTIONCONTEXT_H
+#define STATICENCRYPTIONCONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief EncryptionContext with the strategy bound at compile time
+ *
+ * Holds the strategy by value, so every call resolves statically, and the
+ * compiler can inline it even for IEncryptionStrategy subclasses. The
+ * strategy is initialized and validated once, at construction or
+ * setStrategy(). encrypt() and decrypt() pass straight through with no
+ * dispatch, validation or try/catch. Any exceptions come from the strategy
+ * unchanged.
+ *
+ * Strategy needs encrypt(const std::string&) and decrypt(const std::string&).
+ * Optional members are picked up when present:
+ * - requiresInitialization() / initialize() / validate(), as in IEncryptionStrategy
+ * - encryptInto / decryptInto with ciphertextSize / maxPlaintextSize, as in
+ *   SimpleAES. The string_view overloads then work on the caller's bytes
+ *   directly instead of copying them into a std::string first.
+ *
+ * Use AESContext for SimpleAES. The runtime EncryptionContext remains for
+ * the demos and tests that swap strategies.
+ */
+template <typename Strategy>
+class StaticEncryptionContext {
+private:
+    Strategy strategy;
+
+    template <typename S, typename = void>
+    struct HasInitialization : std::false_type {};
+    template <typename S>
+    struct HasInitialization<S, std::void_t<decltype(std::declval<S&>().requiresInitialization()),
+                                            decltype(std::declval<S&>().initialize())>> : std::true_type {};
+
+    template <typename S, typename = void>
+    struct HasValidate : std::false_type {};
+    template <typename S>
+    struct HasValidate<S, std::void_t<decltype(std::declval<const S&>().validate())>> : std::true_type {};
+
+    template <typename S, typename = void>
+    struct HasBuffers : std::false_type {};
+    template <typename S>
+    struct HasBuffers<S, std::void_t<
+        decltype(std::declval<const S&>().encryptInto(std::declval<const uint8_t*>(), size_t(), std::declval<char*>(), size_t())),
+        decltype(std::declval<const S&>().decryptInto(std::declval<const char*>(), size_t(), std::declval<uint8_t*>(), size_t())),
+        decltype(S::ciphertextSize(size_t(), std::declval<const S&>().getWriteMode())),
+        decltype(S::maxPlaintextSize(size_t())),
+        decltype(std::declval<const S&>().getWriteMode())>> : std::true_type {};
+
+    void prepare() {
+        if constexpr (HasInitialization<Strategy>::value) {
+            if (strategy.requiresInitialization()) strategy.initialize();
+        }
+        if constexpr (HasValidate<Strategy>::value) {
+            strategy.validate();
+        }
+    }
+
+public:
+    static constexpr bool hasBufferApi = HasBuffers<Strategy>::value;
+
+    template <typename... Args,
+              typename = std::enable_if_t<std::is_constructible<Strategy, Args&&...>::value>>
+    explicit StaticEncryptionContext(Args&&... args) : strategy(std::forward<Args>(args)...) {
+        prepare();
+    }
+
+    /** @brief Replace the strategy; validated once here, not per call */
+    void setStrategy(Strategy newStrategy) {
+        strategy = std::move(newStrategy);
+        prepare();
+    }
+
+    const Strategy& getStrategy() const { return strategy; }
+
+    // Non-const, like EncryptionContext: IEncryptionStrategy's encrypt/decrypt are not const
+    std::string encrypt(const std::string& plainText) { return strategy.encrypt(plainText); }
+    std::string decrypt(const std::string& cipherText) { return strategy.decrypt(cipherText); }
+
+    std::string encrypt(std::string_view plainText) {
+        if constexpr (hasBufferApi) {
+            std::string out(Strategy::ciphertextSize(plainText.size(), strategy.getWriteMode()), '\0');
+            out.resize(strategy.encryptInto(reinterpret_cast<const uint8_t*>(plainText.data()), plainText.size(),
+                                            &out[0], out.size()));
+            return out;
+        } else {
+            return strategy.encrypt(std::string(plainText));
+        }
+    }
+
+    std::string decrypt(std::string_view cipherText) {
+        if constexpr (hasBufferApi) {
+            std::string out(Strategy::maxPlaintextSize(cipherText.size()), '\0');
+            out.resize(strategy.decryptInto(cipherText.data(), cipherText.size(),
+                                            reinterpret_cast<uint8_t*>(&out[0]), out.size()));
+            return out;
+        } else {
+            return strategy.decrypt(std::string(cipherText));
+        }
+    }
+
+    std::string encrypt(const char* plainText) { return encrypt(std::string_view(plainText)); }
+    std::string decrypt(const char* cipherText) { return decrypt(std::string_view(cipherText)); }
+};
+
+class SimpleAES;
+/** @brief The production binding: SimpleAES with no per-field dispatch */
+using AESContext = StaticEncryptionContext<SimpleAES>;
+
+#endif // STATICENCRYPTIONCONTEXT_H
@@ -0,0 +1,696 @@
+#include "StorageManager.h"
+#include "CryptoWorkerPool.h"
+#include "PBKDF2.h"
+#include "PerfTrace.h"
+#include "RecordCompression.h"
+#include "SecureRandom.h"
+#include "SHA256.h"
+#include "SimpleAES.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+constexpr char MAGIC[8] = {'S', 'F', 'V', 'A', 'U', 'L', 'T', '\0'};
+constexpr size_t DIGEST_OFFSET = 48;
+constexpr size_t DIGEST_SIZE = 16;
+
+// Version 1: unkeyed SHA-256 digest, 16-byte index entries, records without context
+constexpr uint16_t VERSION_UNKEYED = 1;
+constexpr size_t INDEX_ENTRY_SIZE_V1 = 16;
+
+// HMAC key for the header and index: HMAC(vault key, label)
+constexpr char MAC_KEY_LABEL[] = "SecureFlow vault index";
+
+// Additional data of a record: kind, id, generation
+constexpr size_t RECORD_CONTEXT_SIZE = 9;
+
+// Record kinds stored in the index
+constexpr uint8_t KIND_VERIFIER = 0;
+constexpr uint8_t KIND_ENTRY = 1;
+constexpr uint8_t KIND_USER_DATA = 2;
+
+// Plaintext of record 0: decrypting it proves the password before any entry is read
+constexpr char VERIFIER_TEXT[] = "SecureFlow vault key check";
+constexpr size_t VERIFIER_LENGTH = sizeof(VERIFIER_TEXT) - 1;
+
+constexpr size_t PARALLEL_GRAIN = 32;
+constexpr size_t WRITE_BUFFER = 64 * 1024;
+
+inline void storeLE(uint8_t* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline uint64_t loadLE(const uint8_t* p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= uint64_t(p[i]) << (8 * i);
+    return v;
+}
+
+// User-data plaintext: key and value, each with a u32 length prefix
+void putString(std::string& out, const std::string& value) {
+    uint8_t length[4];
+    storeLE(length, value.size(), 4);
+    out.append(reinterpret_cast<const char*>(length), 4);
+    out.append(value);
+}
+
+class RecordReader {
+public:
+    explicit RecordReader(const std::string& data)
+        : p(reinterpret_cast<const uint8_t*>(data.data())), left(data.size()) {}
+
+    std::string string() {
+        need(4);
+        const size_t length = static_cast<size_t>(loadLE(p, 4));
+        advance(4);
+        need(length);
+        std::string value(reinterpret_cast<const char*>(p), length);
+        advance(length);
+        return value;
+    }
+
+private:
+    const uint8_t* p;
+    size_t left;
+
+    void need(size_t bytes) const {
+        if (bytes > left) throw std::runtime_error("Truncated vault record");
+    }
+    void advance(size_t bytes) {
+        p += bytes;
+        left -= bytes;
+    }
+};
+
+// Entry records hold exactly one PasswordEntry::appendBinary
+PasswordEntry parseEntry(const std::string& plain) {
+    size_t offset = 0;
+    std::optional<PasswordEntry> entry = PasswordEntry::readBinary(plain, offset);
+    if (!entry || offset != plain.size()) throw std::runtime_error("Malformed vault entry");
+    return std::move(*entry);
+}
+
+/** @brief HMAC-SHA-256 (RFC 2104), streamed; keys up to one block */
+class Hmac {
+public:
+    Hmac(const uint8_t* key, size_t length) {
+        uint8_t pad[SHA256::BLOCK_SIZE] = {0};
+        std::memcpy(pad, key, length);
+        for (uint8_t& b : pad) b ^= 0x36;
+        inner.update(pad, sizeof(pad));
+        for (uint8_t& b : pad) b ^= 0x36 ^ 0x5c;
+        outer.update(pad, sizeof(pad));
+        secureWipe(pad, sizeof(pad));
+    }
+
+    void update(const uint8_t* data, size_t length) { inner.update(data, length); }
+
+    void finish(uint8_t mac[SHA256::DIGEST_SIZE]) {
+        uint8_t digest[SHA256::DIGEST_SIZE];
+        inner.finish(digest);
+        outer.update(digest, sizeof(digest));
+        outer.finish(mac);
+        secureWipe(digest, sizeof(digest));
+    }
+
+private:
+    SHA256 inner;
+    SHA256 outer;
+};
+
+void putContext(uint8_t context[RECORD_CONTEXT_SIZE], uint8_t kind, uint32_t id, uint32_t generation) {
+    context[0] = kind;
+    storeLE(context + 1, id, 4);
+    storeLE(context + 5, generation, 4);
+}
+
+std::string sealRecord(const SimpleAES& key, const std::string& plain, uint8_t kind, uint32_t id,
+                       uint32_t generation) {
+    uint8_t context[RECORD_CONTEXT_SIZE];
+    putContext(context, kind, id, generation);
+    return RecordCompression::seal(key, reinterpret_cast<const uint8_t*>(plain.data()), plain.size(),
+                                   RecordCompression::Dictionary::TEXT, context, sizeof(context));
+}
+
+template <typename Op>
+void parallelFor(size_t count, Op op) {
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::atomic<int32_t> cancel{0};
+
+    CryptoWorkerPool::shared().run(count, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+        try {
+            for (size_t i = begin; i < end; ++i) op(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) failure = std::current_exception();
+            cancel.store(1, std::memory_order_relaxed);
+        }
+    }, &cancel);
+
+    if (failure) std::rethrow_exception(failure);
+}
+
+/**
+ * @brief Buffered writer to "<path>.tmp" that replaces `path` on commit()
+ *
+ * The temp file is fsync'ed before the rename and the directory after it,
+ * so the new contents are durable once commit() returns true. Dropped
+ * without commit(), the temp file is removed.
+ */
+class AtomicFileWriter {
+public:
+    explicit AtomicFileWriter(const std::string& path) : path(path), tempPath(path + ".tmp") {
+        fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            std::cerr << "Cannot create " << tempPath << ": " << std::strerror(errno) << std::endl;
+            failed = true;
+        }
+        buffer.reserve(WRITE_BUFFER);
+    }
+    ~AtomicFileWriter() {
+        if (fd >= 0) ::close(fd);
+        if (!committed) ::unlink(tempPath.c_str());
+    }
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    void write(const void* data, size_t length) {
+        if (failed) return;
+        if (buffer.size() + length > WRITE_BUFFER) flush();
+        if (length >= WRITE_BUFFER) {
+            writeAll(static_cast<const uint8_t*>(data), length);
+        } else {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            buffer.insert(buffer.end(), bytes, bytes + length);
+        }
+    }
+
+    bool commit() {
+        flush();
+        if (failed) return false;
+        const bool synced = ::fsync(fd) == 0;
+        const bool closed = ::close(fd) == 0;
+        fd = -1;
+        if (!synced || !closed) {
+            std::cerr << "Cannot sync " << tempPath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Cannot replace " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        committed = true;
+
+        // Make the rename itself durable; not fatal where directories cannot be synced
+        const size_t slash = path.find_last_of('/');
+        const std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + (slash == 0));
+        const int dirFd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+        if (dirFd >= 0) {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+        return true;
+    }
+
+private:
+    std::string path;
+    std::string tempPath;
+    int fd = -1;
+    bool failed = false;
+    bool committed = false;
+    std::vector<uint8_t> buffer;
+
+    void flush() {
+        if (failed || buffer.empty()) return;
+        writeAll(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    void writeAll(const uint8_t* data, size_t length) {
+        while (length > 0 && !failed) {
+            const ssize_t n = ::write(fd, data, length);
+            if (n > 0) {
+                data += n;
+                length -= static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                std::cerr << "Cannot write " << tempPath << ": " << std::strerror(errno) << std::endl;
+                failed = true;
+            }
+        }
+    }
+};
+
+} // namespace
+
+/** @brief Read-only mapping of a verified vault file */
+struct StorageManager::Vault {
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    uint16_t version = 0;
+    size_t entrySize = INDEX_ENTRY_SIZE;
+    std::array<uint8_t, SALT_SIZE> salt{};
+    uint32_t iterations = 0;
+    uint32_t recordCount = 0;
+    uint32_t generation = 0;
+    const uint8_t* index = nullptr;
+    std::vector<uint32_t> entries;   // Record numbers of KIND_ENTRY records, in file order
+    std::shared_ptr<const VaultKey> key;
+
+    Vault() = default;
+    ~Vault() {
+        if (base) ::munmap(const_cast<uint8_t*>(base), size);
+    }
+    Vault(const Vault&) = delete;
+    Vault& operator=(const Vault&) = delete;
+
+    uint8_t kind(size_t record) const { return index[record * entrySize + 12]; }
+    const uint8_t* data(size_t record) const {
+        return base + loadLE(index + record * entrySize, 8);
+    }
+    size_t length(size_t record) const {
+        return static_cast<size_t>(loadLE(index + record * entrySize + 8, 4));
+    }
+    // Record context; version 1 records have none
+    bool hasContext() const { return version != VERSION_UNKEYED; }
+    uint32_t id(size_t record) const {
+        return hasContext() ? static_cast<uint32_t>(loadLE(index + record * entrySize + 16, 4)) : 0;
+    }
+    uint32_t recordGeneration(size_t record) const {
+        return hasContext() ? static_cast<uint32_t>(loadLE(index + record * entrySize + 20, 4)) : 0;
+    }
+};
+
+StorageManager::StorageManager(const std::string& appDirectory, const std::string& masterPassword)
+    : storagePath(appDirectory.empty() ? std::string(VAULT_FILE) : appDirectory + "/" + VAULT_FILE),
+      masterPassword(masterPassword.data(), masterPassword.size()) {}
+
+StorageManager::~StorageManager() = default;
+
+bool StorageManager::fileExists(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0;
+}
+
+std::shared_ptr<const StorageManager::VaultKey> StorageManager::deriveKey(
+        const std::array<uint8_t, SALT_SIZE>& salt, uint32_t iterations) {
+    if (cipher && salt == cipherSalt && iterations == cipherIterations) return cipher;
+
+    SecureBuffer derived = PBKDF2::deriveKey(masterPassword.data(), masterPassword.size(),
+                                             std::vector<uint8_t>(salt.begin(), salt.end()), iterations, 48);
+    auto key = std::make_shared<VaultKey>();
+    // SimpleAES allocates itself in SecureArena; so does the SecureBuffer
+    key->aes.reset(new SimpleAES(derived.data(), derived.data() + 32));
+    key->mac.resize(SHA256::DIGEST_SIZE);
+    Hmac subkey(derived.data(), 32);
+    subkey.update(reinterpret_cast<const uint8_t*>(MAC_KEY_LABEL), sizeof(MAC_KEY_LABEL) - 1);
+    subkey.finish(key->mac.data());
+    return key;
+}
+
+std::unique_ptr<StorageManager::Vault> StorageManager::openVault(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Cannot open vault " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < HEADER_SIZE) {
+        std::cerr << "Not a vault file: " << path << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+
+    auto vault = std::make_unique<Vault>();
+    vault->size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, vault->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // The mapping keeps the file referenced
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Cannot map vault " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    vault->base = static_cast<const uint8_t*>(mapped);
+
+    // Header and index: everything is bounds-checked before a record is touched
+    const uint8_t* header = vault->base;
+    const uint64_t indexOffset = loadLE(header + 40, 8);
+    vault->version = static_cast<uint16_t>(loadLE(header + 8, 2));
+    vault->entrySize = vault->version == VERSION_UNKEYED ? INDEX_ENTRY_SIZE_V1 : INDEX_ENTRY_SIZE;
+    vault->recordCount = static_cast<uint32_t>(loadLE(header + 32, 4));
+    vault->generation = vault->hasContext() ? static_cast<uint32_t>(loadLE(header + 36, 4)) : 0;
+    vault->iterations = static_cast<uint32_t>(loadLE(header + 12, 4));
+    std::memcpy(vault->salt.data(), header + 16, SALT_SIZE);
+
+    const bool shapeOk = std::memcmp(header, MAGIC, sizeof(MAGIC)) == 0 &&
+                         (vault->version == FORMAT_VERSION || vault->version == VERSION_UNKEYED) &&
+                         vault->iterations >= PBKDF2::MIN_ITERATIONS &&
+                         vault->iterations <= PBKDF2::MAX_ITERATIONS &&
+                         vault->recordCount >= 1 &&
+                         indexOffset >= HEADER_SIZE && indexOffset <= vault->size &&
+                         (vault->size - indexOffset) == uint64_t(vault->recordCount) * vault->entrySize;
+    if (!shapeOk) {
+        std::cerr << "Unsupported or damaged vault header: " << path << std::endl;
+        return nullptr;
+    }
+    vault->index = vault->base + indexOffset;
+    const size_t indexSize = vault->recordCount * vault->entrySize;
+
+    // Version 1 only has an unkeyed digest, checked here; version 2 its HMAC, once the key is known
+    if (!vault->hasContext()) {
+        uint8_t zeroDigest[DIGEST_SIZE] = {0};
+        uint8_t digest[SHA256::DIGEST_SIZE];
+        SHA256 sha;
+        sha.update(header, DIGEST_OFFSET);
+        sha.update(zeroDigest, DIGEST_SIZE);
+        sha.update(vault->index, indexSize);
+        sha.finish(digest);
+        if (std::memcmp(digest, header + DIGEST_OFFSET, DIGEST_SIZE) != 0) {
+            std::cerr << "Vault index checksum mismatch: " << path << std::endl;
+            return nullptr;
+        }
+    }
+
+    try {
+        vault->key = deriveKey(vault->salt, vault->iterations);
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot derive the vault key: " << e.what() << std::endl;
+        return nullptr;
+    }
+    if (vault->hasContext()) {
+        uint8_t zeroDigest[DIGEST_SIZE] = {0};
+        uint8_t mac[SHA256::DIGEST_SIZE];
+        Hmac hmac(vault->key->mac.data(), vault->key->mac.size());
+        hmac.update(header, DIGEST_OFFSET);
+        hmac.update(zeroDigest, DIGEST_SIZE);
+        hmac.update(vault->index, indexSize);
+        hmac.finish(mac);
+        uint8_t diff = 0;
+        for (size_t i = 0; i < DIGEST_SIZE; ++i) diff |= mac[i] ^ header[DIGEST_OFFSET + i];
+        if (diff != 0) {
+            std::cerr << "Wrong master password or damaged vault index: " << path << std::endl;
+            return nullptr;
+        }
+    }
+
+    for (uint32_t r = 0; r < vault->recordCount; ++r) {
+        const uint64_t offset = loadLE(vault->index + r * vault->entrySize, 8);
+        const size_t length = vault->length(r);
+        const uint8_t kind = vault->kind(r);
+        const bool recordOk = offset >= HEADER_SIZE && offset <= indexOffset &&
+                              length >= SimpleAES::RECORD_OVERHEAD && length <= indexOffset - offset &&
+                              (kind == KIND_VERIFIER) == (r == 0) && kind <= KIND_USER_DATA;
+        if (!recordOk) {
+            std::cerr << "Vault index entry " << r << " is invalid: " << path << std::endl;
+            return nullptr;
+        }
+        if (kind == KIND_ENTRY) vault->entries.push_back(r);
+    }
+
+    try {
+        std::string check = readRecord(*vault, 0);
+        if (check != std::string(VERIFIER_TEXT, VERIFIER_LENGTH)) throw std::runtime_error("verifier mismatch");
+    } catch (const std::exception&) {
+        std::cerr << "Wrong master password or damaged vault: " << path << std::endl;
+        return nullptr;
+    }
+    return vault;
+}
+
+bool StorageManager::ensureOpen() {
+    if (vault) return true;
+    if (!fileExists(storagePath)) return false;
+
+    vault = openVault(storagePath);
+    if (!vault) return false;
+    cipher = vault->key;
+    cipherSalt = vault->salt;
+    cipherIterations = vault->iterations;
+    return true;
+}
+
+bool StorageManager::ensureWriteKey() {
+    if (ensureOpen()) return true;
+    // An existing file that cannot be opened is never overwritten with a new key
+    if (fileExists(storagePath)) return false;
+
+    if (!cipher) {
+        std::array<uint8_t, SALT_SIZE> salt;
+        SecureRandom::systemEntropy(salt.data(), salt.size());
+        cipher = deriveKey(salt, PBKDF2::DEFAULT_ITERATIONS);
+        cipherSalt = salt;
+        cipherIterations = PBKDF2::DEFAULT_ITERATIONS;
+    }
+    return true;
+}
+
+std::string StorageManager::readRecord(const Vault& v, uint32_t r) {
+    if (!v.hasContext()) return RecordCompression::open(*v.key->aes, v.data(r), v.length(r));
+    uint8_t context[RECORD_CONTEXT_SIZE];
+    putContext(context, v.kind(r), v.id(r), v.recordGeneration(r));
+    return RecordCompression::open(*v.key->aes, v.data(r), v.length(r), context, sizeof(context));
+}
+
+void StorageManager::addRecord(Commit& pending, uint8_t kind, const std::string& data) {
+    const uint32_t id = static_cast<uint32_t>(pending.records.size());
+    pending.sealed.push_back(sealRecord(*cipher->aes, data, kind, id, pending.generation));
+    const std::string& record = pending.sealed.back();
+    pending.records.push_back({kind, id, pending.generation, reinterpret_cast<const uint8_t*>(record.data()),
+                               record.size()});
+}
+
+void StorageManager::carryRecord(Commit& pending, uint32_t r) {
+    if (vault->hasContext()) {
+        pending.records.push_back({vault->kind(r), vault->id(r), vault->recordGeneration(r), vault->data(r),
+                                   vault->length(r)});
+        return;
+    }
+    // Version 1 record: sealed again, now bound to its slot
+    std::string plain = readRecord(*vault, r);
+    addRecord(pending, vault->kind(r), plain);
+    secureWipe(&plain[0], plain.size());
+}
+
+StorageManager::Commit StorageManager::startCommit() {
+    Commit pending;
+    pending.generation = (vault ? vault->generation : 0) + 1;
+    if (vault) {
+        carryRecord(pending, 0);
+    } else {
+        addRecord(pending, KIND_VERIFIER, std::string(VERIFIER_TEXT, VERIFIER_LENGTH));
+    }
+    return pending;
+}
+
+bool StorageManager::commit(const Commit& pending) {
+    const std::vector<PendingRecord>& records = pending.records;
+    uint64_t offset = HEADER_SIZE;
+    std::vector<uint8_t> index(records.size() * INDEX_ENTRY_SIZE, 0);
+    for (size_t r = 0; r < records.size(); ++r) {
+        uint8_t* slot = index.data() + r * INDEX_ENTRY_SIZE;
+        storeLE(slot, offset, 8);
+        storeLE(slot + 8, records[r].length, 4);
+        slot[12] = records[r].kind;
+        storeLE(slot + 16, records[r].id, 4);
+        storeLE(slot + 20, records[r].generation, 4);
+        offset += records[r].length;
+    }
+
+    uint8_t header[HEADER_SIZE] = {0};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    storeLE(header + 8, FORMAT_VERSION, 2);
+    storeLE(header + 12, cipherIterations, 4);
+    std::memcpy(header + 16, cipherSalt.data(), SALT_SIZE);
+    storeLE(header + 32, records.size(), 4);
+    storeLE(header + 36, pending.generation, 4);
+    storeLE(header + 40, offset, 8);
+
+    uint8_t mac[SHA256::DIGEST_SIZE];
+    Hmac hmac(cipher->mac.data(), cipher->mac.size());
+    hmac.update(header, HEADER_SIZE);   // MAC field is still zero
+    hmac.update(index.data(), index.size());
+    hmac.finish(mac);
+    std::memcpy(header + DIGEST_OFFSET, mac, DIGEST_SIZE);
+
+    {
+        AtomicFileWriter out(storagePath);
+        out.write(header, sizeof(header));
+        for (const PendingRecord& record : records) out.write(record.data, record.length);
+        out.write(index.data(), index.size());
+        if (!out.commit()) return false;
+    }
+
+    // Records may point into the old mapping, so it is only dropped now
+    vault.reset();
+    return ensureOpen();
+}
+
+bool StorageManager::savePasswords(const std::vector<PasswordEntry>& passwords) {
+    try {
+        if (!ensureWriteKey()) return false;
+
+        Commit pending = startCommit();
+        const uint32_t firstId = static_cast<uint32_t>(pending.records.size());
+        std::vector<std::string> sealed(passwords.size());
+        const SimpleAES& key = *cipher->aes;
+        parallelFor(passwords.size(), [&](size_t i) {
+            std::string plain;
+            passwords[i].appendBinary(plain);
+            sealed[i] = sealRecord(key, plain, KIND_ENTRY, firstId + static_cast<uint32_t>(i), pending.generation);
+            secureWipe(&plain[0], plain.size());
+        });
+
+        pending.records.reserve(passwords.size() + 1);
+        for (size_t i = 0; i < sealed.size(); ++i) {
+            pending.records.push_back({KIND_ENTRY, firstId + static_cast<uint32_t>(i), pending.generation,
+                                       reinterpret_cast<const uint8_t*>(sealed[i].data()), sealed[i].size()});
+        }
+        if (vault) {
+            for (uint32_t r = 1; r < vault->recordCount; ++r) {
+                if (vault->kind(r) == KIND_USER_DATA) carryRecord(pending, r);
+            }
+        }
+        return commit(pending);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to save vault: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::vector<PasswordEntry> StorageManager::loadPasswords() {
+    PERF_SCOPE(PerfOp::VAULT_LOAD);
+    std::vector<PasswordEntry> passwords;
+    if (!ensureOpen()) return passwords;
+
+    try {
+        const Vault& v = *vault;
+        std::vector<std::optional<PasswordEntry>> slots(v.entries.size());
+        parallelFor(v.entries.size(), [&](size_t i) {
+            std::string plain = readRecord(v, v.entries[i]);
+            slots[i] = parseEntry(plain);
+            secureWipe(&plain[0], plain.size());
+        });
+
+        passwords.reserve(slots.size());
+        for (auto& slot : slots) passwords.push_back(std::move(*slot));
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load vault: " << e.what() << std::endl;
+        passwords.clear();
+    }
+    return passwords;
+}
+
+size_t StorageManager::getPasswordCount() {
+    return ensureOpen() ? vault->entries.size() : 0;
+}
+
+std::optional<PasswordEntry> StorageManager::loadPassword(size_t index) {
+    if (!ensureOpen() || index >= vault->entries.size()) return std::nullopt;
+
+    try {
+        std::string plain = readRecord(*vault, vault->entries[index]);
+        PasswordEntry entry = parseEntry(plain);
+        secureWipe(&plain[0], plain.size());
+        return entry;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load vault entry " << index << ": " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+bool StorageManager::saveUserData(const std::string& key, const std::string& value) {
+    try {
+        if (!ensureWriteKey()) return false;
+
+        Commit pending = startCommit();
+        if (vault) {
+            for (uint32_t r = 1; r < vault->recordCount; ++r) {
+                if (vault->kind(r) == KIND_USER_DATA) {
+                    // Drop the previous value for this key
+                    std::string old = readRecord(*vault, r);
+                    RecordReader in(old);
+                    const bool replaced = in.string() == key;
+                    secureWipe(&old[0], old.size());
+                    if (replaced) continue;
+                }
+                carryRecord(pending, r);
+            }
+        }
+
+        std::string plain;
+        putString(plain, key);
+        putString(plain, value);
+        addRecord(pending, KIND_USER_DATA, plain);
+        secureWipe(&plain[0], plain.size());
+        return commit(pending);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to save user data: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::string StorageManager::loadUserData(const std::string& key) {
+    if (!ensureOpen()) return "";
+
+    try {
+        for (uint32_t r = 1; r < vault->recordCount; ++r) {
+            if (vault->kind(r) != KIND_USER_DATA) continue;
+            std::string plain = readRecord(*vault, r);
+            RecordReader in(plain);
+            std::string value;
+            const bool found = in.string() == key;
+            if (found) value = in.string();
+            secureWipe(&plain[0], plain.size());
+            if (found) return value;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load user data: " << e.what() << std::endl;
+    }
+    return "";
+}
+
+bool StorageManager::createBackup(const std::string& backupPath) {
+    if (!ensureOpen()) {
+        std::cerr << "No vault to back up" << std::endl;
+        return false;
+    }
+    AtomicFileWriter out(backupPath);
+    out.write(vault->base, vault->size);
+    return out.commit();
+}
+
+bool StorageManager::restoreBackup(const std::string& backupPath) {
+    // Fully verified (index checksum and key) before the live vault is touched
+    std::unique_ptr<Vault> backup = openVault(backupPath);
+    if (!backup) return false;
+
+    AtomicFileWriter out(storagePath);
+    out.write(backup->base, backup->size);
+    if (!out.commit()) return false;
+
+    // Adopt the backup's key so reopening does not derive it again
+    vault.reset();
+    cipher = backup->key;
+    cipherSalt = backup->salt;
+    cipherIterations = backup->iterations;
+    return ensureOpen();
+}
@@ -1,30 +1,137 @@
 #ifndef STORAGEMANAGER_H
 #define STORAGEMANAGER_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include "../models/PasswordEntry.h"
+#include "SecureArena.h"
 
+class SimpleAES;
+
+/**
+ * @brief SQLite-free vault store: one memory-mapped, encrypted file
+ *
+ * File layout (little-endian):
+ *   [0..63]   header: magic "SFVAULT\0", version, PBKDF2 iterations and
+ *             salt, record count, write generation, index offset, and an
+ *             HMAC-SHA-256 (first 128 bits) of the header and index
+ *   [64..]    records: one raw SimpleAES GCM record per entry, user-data
+ *             pair, or the key verifier (always record 0), compressed
+ *             when that pays (see RecordCompression)
+ *   [index]   INDEX_ENTRY_SIZE bytes per record: offset, length, kind,
+ *             and the record's id and generation
+ *
+ * The HMAC key is a subkey of the vault key, so only the password holder
+ * can write a header or index that opens. Each record is sealed with
+ * (kind, id, generation) as GCM additional data: a record moved to another
+ * slot, or replaced by an older copy of itself, fails authentication.
+ * id and generation are the record's position and the header generation
+ * of the write that sealed it; records carried over keep both.
+ *
+ * Opening maps the file, checks the shape of the header and index, derives
+ * the key once, verifies the HMAC and authenticates the small verifier
+ * record. Entries are not touched, so opening costs the same at any vault
+ * size. Version 1 files (16-byte index entries, unkeyed SHA-256, no record
+ * context) are still read; the next write converts them.
+ * loadPassword() decrypts one record straight from the mapping, and
+ * loadPasswords() decrypts all of them in parallel on CryptoWorkerPool.
+ *
+ * Each write goes to "<vault>.tmp", is fsync'ed, and is renamed over the
+ * vault, so a crash leaves either the old file or the new one. Records that
+ * a write does not change are copied as ciphertext without being decrypted.
+ * Not thread-safe.
+ */
 class StorageManager {
+public:
+    static constexpr size_t SALT_SIZE = 16;
+
 private:
+    struct Vault;
+    /** @brief Record key and the HMAC subkey for the header and index */
+    struct VaultKey {
+        std::unique_ptr<const SimpleAES> aes;
+        SecureBuffer mac;
+    };
+    /** @brief Ciphertext for one record of a commit: new, or still in the old mapping */
+    struct PendingRecord {
+        uint8_t kind;
+        uint32_t id;
+        uint32_t generation;
+        const uint8_t* data;
+        size_t length;
+    };
+    /** @brief Records of one write; new ciphertexts are owned by `sealed` */
+    struct Commit {
+        uint32_t generation = 0;
+        std::vector<PendingRecord> records;
+        std::deque<std::string> sealed;
+    };
+
     std::string storagePath;
-    std::string encryptionKey;
+    SecureString masterPassword;     // Kept to derive keys for restored backups
+    std::unique_ptr<Vault> vault;    // Mapping of storagePath, null until opened
+    // Key for the next write (the open vault's), with the parameters it was derived from
+    std::shared_ptr<const VaultKey> cipher;
+    std::array<uint8_t, SALT_SIZE> cipherSalt{};
+    uint32_t cipherIterations = 0;
 
-    std::string encryptData(const std::string& data);
-    std::string decryptData(const std::string& encryptedData);
+    /** @brief Seal `data` as the next record of `commit` */
+    void addRecord(Commit& commit, uint8_t kind, const std::string& data);
+    /** @brief Carry record `r` of the open vault into `commit`, as ciphertext when its format allows */
+    void carryRecord(Commit& commit, uint32_t r);
+    /** @brief Plaintext of record `r` of `v`; the caller wipes it */
+    static std::string readRecord(const Vault& v, uint32_t r);
     bool fileExists(const std::string& path);
 
+    /** @brief Map and verify a vault file; nullptr (with a message) if it is unusable */
+    std::unique_ptr<Vault> openVault(const std::string& path);
+    /** @brief Open storagePath if it exists; false when there is no usable vault */
+    bool ensureOpen();
+    /** @brief Set up `cipher` for a write: the open vault's key, or a fresh salt for a new vault */
+    bool ensureWriteKey();
+    /** @brief Key for a salt, reusing `cipher` when it matches instead of running PBKDF2 again */
+    std::shared_ptr<const VaultKey> deriveKey(const std::array<uint8_t, SALT_SIZE>& salt, uint32_t iterations);
+    /** @brief Write the records (ciphertext) atomically to storagePath and remap it */
+    bool commit(const Commit& pending);
+    /** @brief Next write's generation, with the verifier as record 0 */
+    Commit startCommit();
+
 public:
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr size_t INDEX_ENTRY_SIZE = 24;
+    static constexpr uint16_t FORMAT_VERSION = 2;
+    static constexpr const char* VAULT_FILE = "vault.sfv";
+
     StorageManager(const std::string& appDirectory, const std::string& masterPassword);
+    ~StorageManager();
 
+    StorageManager(const StorageManager&) = delete;
+    StorageManager& operator=(const StorageManager&) = delete;
+
+    /** @brief Replace every stored entry; user data is kept */
     bool savePasswords(const std::vector<PasswordEntry>& passwords);
+    /** @brief Every entry, empty when there is no vault or it cannot be opened */
     std::vector<PasswordEntry> loadPasswords();
 
+    /** @brief Number of stored entries, read from the index alone */
+    size_t getPasswordCount();
+    /** @brief Decrypt only the index-th entry */
+    std::optional<PasswordEntry> loadPassword(size_t index);
+
     bool saveUserData(const std::string& key, const std::string& value);
+    /** @brief Stored value, or "" when the key is absent */
     std::string loadUserData(const std::string& key);
 
+    /** @brief Copy the vault file as it is (already encrypted) to backupPath */
     bool createBackup(const std::string& backupPath);
+    /** @brief Verify a backup against the master password, then swap it in */
     bool restoreBackup(const std::string& backupPath);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,347 @@
+#include "StrengthAnalyzer.h"
+#include "BreachFilter.h"
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+// Automaton alphabet: 0 breaks every pattern, 1-26 are letters (case
+// folded), 27-36 are digits. Everything else maps to 0.
+constexpr size_t SYMBOLS = 37;
+
+constexpr std::array<uint8_t, 256> makeSymbolTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = static_cast<uint8_t>(1 + c - 'a');
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = static_cast<uint8_t>(1 + c - 'A');
+    for (int c = '0'; c <= '9'; ++c) table[c] = static_cast<uint8_t>(27 + c - '0');
+    return table;
+}
+
+// Same split as the old isupper/islower/isdigit chain in the "C" locale;
+// bytes >= 0x80 (UTF-8) count as special
+constexpr std::array<uint8_t, 256> makeClassTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = (c >= 'A' && c <= 'Z') ? 0 : (c >= 'a' && c <= 'z') ? 1 : (c >= '0' && c <= '9') ? 2 : 3;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> SYMBOL_OF = makeSymbolTable();
+constexpr std::array<uint8_t, 256> CLASS_OF = makeClassTable();
+
+using Pattern = StrengthAnalyzer::Pattern;
+
+const char* const KEYBOARD_WALKS[] = {
+    "qwer", "wert", "erty", "rtyu", "tyui", "yuio", "uiop", "asdf", "sdfg", "dfgh", "fghj", "ghjk",
+    "hjkl", "zxcv", "xcvb", "cvbn", "vbnm", "qwertz", "azerty", "qazwsx", "1qaz", "2wsx", "1q2w3e",
+};
+
+// Most frequent entries of public breached-password lists, lower-cased,
+// minus those already caught as digit runs or keyboard walks
+const char* const COMMON_WORDS[] = {
+    "password", "passw0rd", "letmein", "welcome", "admin", "login", "iloveyou", "monkey", "dragon",
+    "master", "sunshine", "princess", "football", "baseball", "soccer", "hockey", "shadow", "superman",
+    "batman", "trustno1", "whatever", "freedom", "secret", "hello", "charlie", "michael", "jordan",
+    "starwars", "computer", "internet", "summer", "winter", "flower", "cheese", "pepper", "ginger",
+    "killer", "hunter", "ranger", "buster", "thomas", "robert", "jennifer", "jessica", "ashley",
+    "daniel", "andrew", "joshua", "matthew", "nicole", "michelle", "mustang", "access", "default",
+    "changeme", "google", "samsung", "android", "pokemon", "naruto", "liverpool", "chelsea", "arsenal",
+    "blink182", "lovely", "loveme", "iloveu", "babygirl", "angel",
+};
+
+constexpr uint16_t NO_PATTERN = 0xFFFF;
+
+struct Automaton {
+    std::vector<std::array<uint16_t, SYMBOLS>> next;
+    std::vector<uint8_t> kinds;   // Bit per Pattern ending at the state, via dictionary links
+    std::vector<std::array<uint16_t, StrengthAnalyzer::PATTERN_COUNT>> longest;   // Pattern index per kind
+    std::vector<std::string> texts;
+
+    Automaton() {
+        addNode();
+        for (char a = '0'; a + 2 <= '9'; ++a) add({a, char(a + 1), char(a + 2)}, Pattern::SEQUENTIAL_DIGITS);
+        for (char a = '9'; a - 2 >= '0'; --a) add({a, char(a - 1), char(a - 2)}, Pattern::SEQUENTIAL_DIGITS);
+        for (char a = 'a'; a + 2 <= 'z'; ++a) add({a, char(a + 1), char(a + 2)}, Pattern::SEQUENTIAL_LETTERS);
+        for (const char* walk : KEYBOARD_WALKS) add(walk, Pattern::KEYBOARD_WALK);
+        for (const char* word : COMMON_WORDS) add(word, Pattern::COMMON_WORD);
+        link();
+    }
+
+    uint16_t addNode() {
+        next.emplace_back();
+        next.back().fill(0);
+        kinds.push_back(0);
+        longest.emplace_back();
+        longest.back().fill(NO_PATTERN);
+        return static_cast<uint16_t>(next.size() - 1);
+    }
+
+    void add(const std::string& text, Pattern kind) {
+        uint16_t node = 0;
+        for (char c : text) {
+            const uint8_t s = SYMBOL_OF[static_cast<uint8_t>(c)];
+            if (next[node][s] == 0) {
+                // addNode() may reallocate `next`, so look the slot up again after it
+                const uint16_t child = addNode();
+                next[node][s] = child;
+            }
+            node = next[node][s];
+        }
+        const size_t k = static_cast<size_t>(kind);
+        if (kinds[node] & (1u << k)) return;   // Listed twice
+        kinds[node] |= static_cast<uint8_t>(1u << k);
+        longest[node][k] = static_cast<uint16_t>(texts.size());
+        texts.push_back(text);
+    }
+
+    // Breadth-first: fold failure links into a full transition table and
+    // inherit the outputs of each state's longest proper suffix
+    void link() {
+        std::vector<uint16_t> fail(next.size(), 0);
+        std::queue<uint16_t> pending;
+        for (size_t s = 1; s < SYMBOLS; ++s) {
+            if (next[0][s] != 0) pending.push(next[0][s]);
+        }
+        while (!pending.empty()) {
+            const uint16_t node = pending.front();
+            pending.pop();
+            const uint16_t f = fail[node];
+            kinds[node] |= kinds[f];
+            for (size_t k = 0; k < StrengthAnalyzer::PATTERN_COUNT; ++k) {
+                if (longest[node][k] == NO_PATTERN) longest[node][k] = longest[f][k];
+            }
+            for (size_t s = 1; s < SYMBOLS; ++s) {
+                const uint16_t child = next[node][s];
+                if (child != 0) {
+                    fail[child] = next[f][s];
+                    pending.push(child);
+                } else {
+                    next[node][s] = next[f][s];
+                }
+            }
+        }
+    }
+};
+
+const Automaton& automaton() {
+    static const Automaton instance;
+    return instance;
+}
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+const char* suggestionPrefix(Pattern kind) {
+    switch (kind) {
+        case Pattern::SEQUENTIAL_DIGITS: return "Avoid sequential numbers (";
+        case Pattern::SEQUENTIAL_LETTERS: return "Avoid sequential letters (";
+        case Pattern::KEYBOARD_WALK: return "Avoid keyboard patterns like '";
+        case Pattern::COMMON_WORD: return "Avoid common words like '";
+        default: return "";
+    }
+}
+
+} // namespace
+
+StrengthAnalyzer::~StrengthAnalyzer() {
+    clear();
+}
+
+void StrengthAnalyzer::append(char c) {
+    const Automaton& a = automaton();
+    const uint8_t byte = static_cast<uint8_t>(c);
+
+    if (steps.size() == steps.capacity()) {
+        // Grow by hand so the old buffer is wiped rather than just freed
+        std::vector<Step> larger;
+        larger.reserve(std::max<size_t>(32, steps.capacity() * 2));
+        larger.assign(steps.begin(), steps.end());
+        secureWipe(steps.data(), steps.size() * sizeof(Step));
+        steps.swap(larger);
+    }
+
+    Step step;
+    step.state = a.next[steps.empty() ? 0 : steps.back().state][SYMBOL_OF[byte]];
+    step.run = (!steps.empty() && steps.back().byte == byte)
+               ? static_cast<uint16_t>(std::min<uint32_t>(steps.back().run + 1u, 0xFFFF)) : 1;
+    step.byte = byte;
+    step.kind = CLASS_OF[byte];
+    steps.push_back(step);
+
+    ++classCounts[step.kind];
+    const uint8_t kinds = a.kinds[step.state];
+    for (size_t k = 0; k < PATTERN_COUNT; ++k) {
+        if (kinds & (1u << k)) ++patternCounts[k];
+    }
+    if (step.run == 3) ++patternCounts[static_cast<size_t>(Pattern::REPEATED_CHARACTER)];
+}
+
+void StrengthAnalyzer::append(std::string_view text) {
+    for (char c : text) append(c);
+}
+
+void StrengthAnalyzer::removeLast(size_t count) {
+    const Automaton& a = automaton();
+    count = std::min(count, steps.size());
+    for (size_t i = 0; i < count; ++i) {
+        Step& step = steps.back();
+        --classCounts[step.kind];
+        const uint8_t kinds = a.kinds[step.state];
+        for (size_t k = 0; k < PATTERN_COUNT; ++k) {
+            if (kinds & (1u << k)) --patternCounts[k];
+        }
+        if (step.run == 3) --patternCounts[static_cast<size_t>(Pattern::REPEATED_CHARACTER)];
+        secureWipe(&step, sizeof(step));
+        steps.pop_back();
+    }
+}
+
+void StrengthAnalyzer::assign(std::string_view text) {
+    size_t common = 0;
+    const size_t limit = std::min(text.size(), steps.size());
+    while (common < limit && steps[common].byte == static_cast<uint8_t>(text[common])) ++common;
+
+    removeLast(steps.size() - common);
+    append(text.substr(common));
+}
+
+void StrengthAnalyzer::clear() {
+    secureWipe(steps.data(), steps.size() * sizeof(Step));
+    steps.clear();
+    classCounts.fill(0);
+    patternCounts.fill(0);
+}
+
+int StrengthAnalyzer::scoreFor(size_t length, const std::array<uint32_t, CLASS_COUNT>& classes,
+                               const std::array<uint32_t, PATTERN_COUNT>& patterns) {
+    if (length == 0) return 0;
+
+    int score = 0;
+    if (length >= 8) score += 25;
+    if (length >= 12) score += 15;
+    if (length >= 16) score += 10;
+
+    for (uint32_t count : classes) {
+        if (count >= 1) score += 15;   // Variety
+        if (count >= 2) score += 5;    // Distribution
+    }
+    // Cap first so a long password can't absorb the pattern penalties
+    score = std::min(100, score);
+    for (uint32_t count : patterns) {
+        if (count > 0) score -= PATTERN_PENALTY;
+    }
+    return std::max(0, score);
+}
+
+const char* StrengthAnalyzer::labelFor(int score) {
+    if (score >= 80) return "Very Strong";
+    if (score >= 60) return "Strong";
+    if (score >= 40) return "Moderate";
+    if (score >= 20) return "Weak";
+    return "Very Weak";
+}
+
+int StrengthAnalyzer::score() const {
+    return scoreFor(steps.size(), classCounts, patternCounts);
+}
+
+const char* StrengthAnalyzer::label() const {
+    return labelFor(score());
+}
+
+PasswordAnalysisResult StrengthAnalyzer::result() const {
+    PasswordAnalysisResult result;
+    result.score = score();
+
+    const size_t length = steps.size();
+    if (length == 0) {
+        result.strength = labelFor(result.score);
+        result.suggestions.push_back("Password cannot be empty");
+        return result;
+    }
+
+    if (std::shared_ptr<BreachFilter> filter = BreachFilter::shared()) {
+        std::string text(length, '\0');
+        for (size_t i = 0; i < length; ++i) text[i] = static_cast<char>(steps[i].byte);
+        result.breached = filter->check(text) == BreachFilter::Status::BREACHED;
+        secureWipe(&text[0], text.size());
+    }
+    if (result.breached) {
+        result.score = std::min(result.score, BREACHED_SCORE_CAP);
+        result.suggestions.push_back("This password appears in known data breaches; choose a different one");
+    }
+    result.strength = labelFor(result.score);
+
+    const uint32_t upper = classCounts[UPPER];
+    const uint32_t lower = classCounts[LOWER];
+    const uint32_t digits = classCounts[DIGIT];
+    const uint32_t special = classCounts[SPECIAL];
+
+    if (length < 8) {
+        result.suggestions.push_back("Make password longer (at least 8 characters)");
+    } else if (length < 12) {
+        result.suggestions.push_back("Consider using 12+ characters for better security");
+    }
+
+    if (upper == 0) {
+        result.suggestions.push_back("Add uppercase letters (A-Z)");
+    } else if (upper == 1) {
+        result.suggestions.push_back("Add more uppercase letters for better security");
+    }
+
+    if (lower == 0) {
+        result.suggestions.push_back("Add lowercase letters (a-z)");
+    }
+
+    if (digits == 0) {
+        result.suggestions.push_back("Add numbers (0-9)");
+    } else if (digits == 1) {
+        result.suggestions.push_back("Add more numbers for better security");
+    }
+
+    if (special == 0) {
+        result.suggestions.push_back("Add special characters (!@#$%^&*)");
+    } else if (special == 1) {
+        result.suggestions.push_back("Add more special characters for better security");
+    }
+
+    // Name the first match of each kind; the text comes from the pattern
+    // list, never from the password itself
+    const Automaton& a = automaton();
+    for (size_t k = 0; k < PATTERN_COUNT; ++k) {
+        if (patternCounts[k] == 0) continue;
+        const Pattern kind = static_cast<Pattern>(k);
+        if (kind == Pattern::REPEATED_CHARACTER) {
+            result.suggestions.push_back("Avoid repeating the same character");
+            continue;
+        }
+        for (const Step& step : steps) {
+            const uint16_t match = a.longest[step.state][k];
+            if (match == NO_PATTERN) continue;
+            const bool quoted = (kind == Pattern::KEYBOARD_WALK || kind == Pattern::COMMON_WORD);
+            result.suggestions.push_back(std::string(suggestionPrefix(kind)) + a.texts[match] + (quoted ? "'" : ")"));
+            break;
+        }
+    }
+
+    if (length <= 6 && digits > 0 && upper == 0 && special == 0) {
+        result.suggestions.push_back("Very short numeric passwords are easy to guess");
+    }
+
+    return result;
+}
+
+PasswordAnalysisResult StrengthAnalyzer::analyze(std::string_view password) {
+    return StrengthAnalyzer(password).result();
+}
+
+std::string StrengthAnalyzer::summary(std::string_view password) {
+    StrengthAnalyzer analyzer(password);
+    const int score = analyzer.score();
+    return std::string(labelFor(score)) + " (" + std::to_string(score) + "/100)";
+}
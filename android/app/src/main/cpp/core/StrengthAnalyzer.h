@@ -0,0 +1,103 @@
+#ifndef STRENGTHANALYZER_H
+#define STRENGTHANALYZER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../models/PasswordEntry.h"
+
+/**
+ * @brief Single-pass password strength scoring with an incremental mode
+ *
+ * Each byte is classified through a constant 256-entry table, so
+ * classification does not depend on the locale. Weak patterns are found by
+ * one step of an Aho-Corasick automaton per byte. The automaton covers
+ * digit and letter runs, keyboard walks and a list of common passwords,
+ * all matched case-insensitively. Three or more identical characters in a
+ * row also count as a weak pattern.
+ *
+ * The analyzer keeps one small record per character: the automaton state,
+ * the class and the current run length. append() and removeLast() are
+ * therefore O(1) per character, and score() is O(1). A live strength meter
+ * can feed keystrokes, or whole texts via assign(), without rescanning.
+ * The records hold the password bytes, and they are wiped on clear() and
+ * on destruction.
+ *
+ * Score: length and character variety earn points as before, capped at
+ * 100. Each kind of weak pattern found then costs PATTERN_PENALTY, down to
+ * a floor of 0.
+ *
+ * result() also looks the text up in BreachFilter::shared() when one is
+ * installed; a breached password is capped at BREACHED_SCORE_CAP. score()
+ * and summary() stay purely local.
+ */
+class StrengthAnalyzer {
+public:
+    enum class Pattern : uint8_t {
+        SEQUENTIAL_DIGITS,
+        SEQUENTIAL_LETTERS,
+        KEYBOARD_WALK,
+        COMMON_WORD,
+        REPEATED_CHARACTER,
+    };
+    static constexpr size_t PATTERN_COUNT = static_cast<size_t>(Pattern::REPEATED_CHARACTER) + 1;
+    static constexpr int PATTERN_PENALTY = 10;
+    static constexpr int BREACHED_SCORE_CAP = 10;   // "Very Weak"
+
+    enum CharClass : uint8_t { UPPER, LOWER, DIGIT, SPECIAL, CLASS_COUNT };
+
+    StrengthAnalyzer() = default;
+    explicit StrengthAnalyzer(std::string_view password) { append(password); }
+    ~StrengthAnalyzer();
+
+    StrengthAnalyzer(const StrengthAnalyzer&) = delete;
+    StrengthAnalyzer& operator=(const StrengthAnalyzer&) = delete;
+
+    void append(char c);
+    void append(std::string_view text);
+    /** @brief Drop the last `count` characters (fewer if shorter) */
+    void removeLast(size_t count = 1);
+    /**
+     * @brief Make the analysed text equal to `text`
+     *
+     * Only the part after the common prefix with the current text is
+     * redone, which is what a text field sends on each keystroke.
+     */
+    void assign(std::string_view text);
+    void clear();
+
+    size_t length() const { return steps.size(); }
+    int score() const;
+    /** @brief "Very Weak" .. "Very Strong" for the current score */
+    const char* label() const;
+    bool hasPattern(Pattern pattern) const { return patternCounts[static_cast<size_t>(pattern)] > 0; }
+    uint32_t classCount(CharClass charClass) const { return classCounts[charClass]; }
+
+    /** @brief Score, label and suggestions for the current text */
+    PasswordAnalysisResult result() const;
+
+    static PasswordAnalysisResult analyze(std::string_view password);
+    /** @brief "Label (score/100)", as shown next to an entry */
+    static std::string summary(std::string_view password);
+
+private:
+    struct Step {
+        uint16_t state;   // Automaton state after this character
+        uint16_t run;     // Length of the identical-character run ending here (saturating)
+        uint8_t byte;
+        uint8_t kind;     // CharClass
+    };
+
+    std::vector<Step> steps;
+    std::array<uint32_t, CLASS_COUNT> classCounts{};
+    std::array<uint32_t, PATTERN_COUNT> patternCounts{};
+
+    static int scoreFor(size_t length, const std::array<uint32_t, CLASS_COUNT>& classes,
+                        const std::array<uint32_t, PATTERN_COUNT>& patterns);
+    static const char* labelFor(int score);
+};
+
+#endif // STRENGTHANALYZER_H
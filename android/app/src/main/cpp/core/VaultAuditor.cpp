@@ -0,0 +1,320 @@
+#include "VaultAuditor.h"
+#include "BreachFilter.h"
+#include "CryptoWorkerPool.h"
+#include "SHA256.h"
+#include "StrengthAnalyzer.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
+    }
+}
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/** @brief Fresh random key material for one audit */
+struct AuditKey {
+    uint8_t hmac[SHA256::BLOCK_SIZE];
+    uint64_t shingleSeed = 0;
+    std::array<uint64_t, VaultAuditor::SIGNATURE_SIZE> minHashSeeds{};
+
+    AuditKey() {
+        std::random_device rd;
+        for (size_t i = 0; i < sizeof(hmac); i += 4) {
+            const uint32_t word = rd();
+            std::memcpy(hmac + i, &word, 4);
+        }
+        shingleSeed = (uint64_t(rd()) << 32) | rd();
+        for (uint64_t& seed : minHashSeeds) seed = (uint64_t(rd()) << 32) | rd();
+    }
+    ~AuditKey() { secureWipe(hmac, sizeof(hmac)); }
+
+    AuditKey(const AuditKey&) = delete;
+    AuditKey& operator=(const AuditKey&) = delete;
+};
+
+/** @brief First 128 bits of HMAC-SHA256(key, message); plenty to tell passwords apart */
+struct Digest {
+    uint64_t high = 0;
+    uint64_t low = 0;
+    bool operator==(const Digest& other) const { return high == other.high && low == other.low; }
+};
+
+struct DigestHash {
+    size_t operator()(const Digest& d) const { return static_cast<size_t>(d.high ^ mix64(d.low)); }
+};
+
+Digest keyedDigest(const uint8_t key[SHA256::BLOCK_SIZE], const std::string& message) {
+    uint8_t pad[SHA256::BLOCK_SIZE];
+    uint8_t inner[SHA256::DIGEST_SIZE];
+    uint8_t outer[SHA256::DIGEST_SIZE];
+
+    SHA256 sha;
+    for (size_t i = 0; i < sizeof(pad); ++i) pad[i] = key[i] ^ 0x36;
+    sha.update(pad, sizeof(pad));
+    sha.update(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+    sha.finish(inner);
+
+    sha.reset();
+    for (size_t i = 0; i < sizeof(pad); ++i) pad[i] = key[i] ^ 0x5c;
+    sha.update(pad, sizeof(pad));
+    sha.update(inner, sizeof(inner));
+    sha.finish(outer);
+
+    Digest digest{load64(outer), load64(outer + 8)};
+    secureWipe(pad, sizeof(pad));
+    secureWipe(inner, sizeof(inner));
+    secureWipe(outer, sizeof(outer));
+    return digest;
+}
+
+/** @brief What the audit keeps per entry once the plaintext is gone */
+struct Profile {
+    bool readable = false;
+    bool empty = false;
+    int score = 0;
+    Digest digest;
+    uint64_t breachKey = 0;           // SHA-1 prefix, only when a filter is installed
+    std::vector<uint64_t> shingles;   // Sorted, unique keyed trigram hashes
+    std::array<uint64_t, VaultAuditor::SIGNATURE_SIZE> signature{};
+};
+
+void buildShingles(const std::string& password, uint64_t seed, std::vector<uint64_t>& out) {
+    // Case-folded so "Summer2023" and "summer2024" still look alike
+    auto fold = [](char c) {
+        return static_cast<uint64_t>(static_cast<uint8_t>((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c));
+    };
+
+    out.clear();
+    if (password.size() < 3) {
+        uint64_t h = seed;
+        for (char c : password) h = mix64(h ^ fold(c));
+        out.push_back(h);
+        return;
+    }
+    out.reserve(password.size() - 2);
+    for (size_t i = 0; i + 3 <= password.size(); ++i) {
+        const uint64_t gram = (fold(password[i]) << 16) | (fold(password[i + 1]) << 8) | fold(password[i + 2]);
+        out.push_back(mix64(gram ^ seed));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+double jaccard(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+    size_t shared = 0;
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i] < b[j]) ++i;
+        else if (b[j] < a[i]) ++j;
+        else { ++shared; ++i; ++j; }
+    }
+    const size_t combined = a.size() + b.size() - shared;
+    return combined == 0 ? 0.0 : static_cast<double>(shared) / static_cast<double>(combined);
+}
+
+void profileEntry(const PasswordEntry& entry, const AuditKey& key, bool breachKeys, Profile& profile) {
+    std::string password;
+    try {
+        password = entry.getPassword();
+    } catch (...) {
+        return;   // Sealed and the keys are gone: leave it unreadable
+    }
+    profile.readable = true;
+    profile.empty = password.empty();
+    profile.score = StrengthAnalyzer(password).score();
+
+    if (!profile.empty) {
+        profile.digest = keyedDigest(key.hmac, password);
+        if (breachKeys) profile.breachKey = BreachFilter::keyFor(password);
+        buildShingles(password, key.shingleSeed, profile.shingles);
+        for (size_t k = 0; k < VaultAuditor::SIGNATURE_SIZE; ++k) {
+            uint64_t minimum = UINT64_MAX;
+            for (uint64_t shingle : profile.shingles) {
+                minimum = std::min(minimum, mix64(shingle ^ key.minHashSeeds[k]));
+            }
+            profile.signature[k] = minimum;
+        }
+    }
+    secureWipe(&password[0], password.size());
+}
+
+struct DisjointSets {
+    std::vector<uint32_t> parent;
+
+    explicit DisjointSets(size_t count) : parent(count) {
+        std::iota(parent.begin(), parent.end(), 0u);
+    }
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+};
+
+size_t labelIndex(int score) {
+    // Same thresholds as StrengthAnalyzer's labels
+    if (score >= 80) return 4;
+    if (score >= 60) return 3;
+    if (score >= 40) return 2;
+    if (score >= 20) return 1;
+    return 0;
+}
+
+} // namespace
+
+VaultAuditReport VaultAuditor::audit(const std::vector<PasswordEntry>& entries, const VaultAuditOptions& options) {
+    VaultAuditReport report;
+    report.totalEntries = entries.size();
+    if (entries.empty()) return report;
+
+    const AuditKey key;
+    const std::shared_ptr<BreachFilter> breachFilter =
+        options.checkBreaches ? BreachFilter::shared() : nullptr;
+    std::vector<Profile> profiles(entries.size());
+    CryptoWorkerPool::shared().run(entries.size(), 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) profileEntry(entries[i], key, breachFilter != nullptr, profiles[i]);
+    });
+
+    // Strength and exact reuse
+    long long scoreTotal = 0;
+    std::unordered_map<Digest, std::vector<uint32_t>, DigestHash> byDigest;
+    byDigest.reserve(entries.size());
+    for (uint32_t i = 0; i < profiles.size(); ++i) {
+        const Profile& p = profiles[i];
+        if (!p.readable) continue;
+
+        ++report.analyzedEntries;
+        scoreTotal += p.score;
+        ++report.strengthHistogram[labelIndex(p.score)];
+        if (p.score < options.weakBelow) {
+            ++report.weakEntries;
+            report.weakIds.push_back(entries[i].getId());
+        }
+        if (!p.empty) byDigest[p.digest].push_back(i);
+    }
+    if (report.analyzedEntries > 0) {
+        report.averageScore = static_cast<int>(scoreTotal / static_cast<long long>(report.analyzedEntries));
+    }
+
+    // One representative per distinct password takes part in the similarity pass
+    std::vector<uint32_t> representatives;
+    representatives.reserve(byDigest.size());
+    for (const auto& bucket : byDigest) representatives.push_back(bucket.second.front());   // Lowest index
+    std::sort(representatives.begin(), representatives.end());
+
+    for (uint32_t rep : representatives) {
+        const std::vector<uint32_t>& members = byDigest[profiles[rep].digest];
+        if (members.size() < 2) continue;
+
+        report.reusedEntries += members.size();
+        std::vector<std::string> group;
+        group.reserve(members.size());
+        for (uint32_t i : members) group.push_back(entries[i].getId());
+        report.reuseGroups.push_back(std::move(group));
+    }
+
+    // Breach corpus: one batch lookup per distinct password
+    std::vector<uint32_t> breached;
+    if (breachFilter) {
+        std::vector<uint64_t> keys(representatives.size());
+        for (size_t r = 0; r < representatives.size(); ++r) keys[r] = profiles[representatives[r]].breachKey;
+        std::vector<BreachFilter::Status> statuses(keys.size());
+        breachFilter->checkKeys(keys.data(), keys.size(), statuses.data());
+        secureWipe(keys.data(), keys.size() * sizeof(uint64_t));
+        for (Profile& p : profiles) p.breachKey = 0;
+
+        for (size_t r = 0; r < representatives.size(); ++r) {
+            const std::vector<uint32_t>& members = byDigest[profiles[representatives[r]].digest];
+            if (statuses[r] == BreachFilter::Status::BREACHED) {
+                breached.insert(breached.end(), members.begin(), members.end());
+            } else if (statuses[r] == BreachFilter::Status::UNKNOWN) {
+                report.breachUnknownEntries += members.size();
+            }
+        }
+        std::sort(breached.begin(), breached.end());
+    } else {
+        for (uint32_t rep : representatives) report.breachUnknownEntries += byDigest[profiles[rep].digest].size();
+    }
+    report.breachedEntries = breached.size();
+    for (uint32_t i : breached) report.breachedIds.push_back(entries[i].getId());
+
+    // Near-duplicates: band the signatures, verify candidates exactly
+    DisjointSets sets(profiles.size());
+    std::unordered_set<uint64_t> compared;
+    auto consider = [&](uint32_t a, uint32_t b) {
+        if (a > b) std::swap(a, b);
+        if (!compared.insert((uint64_t(a) << 32) | b).second) return;
+        if (jaccard(profiles[a].shingles, profiles[b].shingles) >= options.similarityThreshold) sets.unite(a, b);
+    };
+
+    const size_t bands = SIGNATURE_SIZE / BAND_ROWS;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+    for (size_t band = 0; band < bands; ++band) {
+        buckets.clear();
+        for (uint32_t i : representatives) {
+            uint64_t h = mix64(band + 1);
+            for (size_t r = 0; r < BAND_ROWS; ++r) h = mix64(h ^ profiles[i].signature[band * BAND_ROWS + r]);
+            buckets[h].push_back(i);
+        }
+        for (const auto& bucket : buckets) {
+            const std::vector<uint32_t>& members = bucket.second;
+            if (members.size() > MAX_BUCKET_SIZE) {
+                for (size_t m = 1; m < members.size(); ++m) consider(members[m - 1], members[m]);
+                continue;
+            }
+            for (size_t m = 0; m < members.size(); ++m) {
+                for (size_t n = m + 1; n < members.size(); ++n) consider(members[m], members[n]);
+            }
+        }
+    }
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> components;
+    for (uint32_t i : representatives) components[sets.find(i)].push_back(i);
+    std::vector<uint32_t> roots;
+    for (const auto& component : components) {
+        if (component.second.size() > 1) roots.push_back(component.first);
+    }
+    std::sort(roots.begin(), roots.end());   // Deterministic order: by first entry
+
+    for (uint32_t root : roots) {
+        // Each representative brings the entries that reuse its password
+        std::vector<std::string> group;
+        for (uint32_t rep : components[root]) {
+            for (uint32_t i : byDigest[profiles[rep].digest]) group.push_back(entries[i].getId());
+        }
+        report.similarEntries += group.size();
+        report.similarGroups.push_back(std::move(group));
+    }
+
+    return report;
+}
@@ -0,0 +1,80 @@
+#ifndef VAULTAUDITOR_H
+#define VAULTAUDITOR_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "../models/PasswordEntry.h"
+
+/** @brief Tuning for VaultAuditor::audit */
+struct VaultAuditOptions {
+    /** Entries scoring below this (StrengthAnalyzer scale) are reported as weak */
+    int weakBelow = 40;
+    /** Jaccard similarity of character trigrams at which two passwords count as near-duplicates */
+    double similarityThreshold = 0.6;
+    /** Look passwords up in BreachFilter::shared(), when one is installed */
+    bool checkBreaches = true;
+};
+
+/**
+ * @brief Vault health summary: counts plus the ids behind each finding
+ *
+ * Contains no password material. Groups list entry ids; every id appears in
+ * at most one reuse group and at most one similarity group.
+ */
+struct VaultAuditReport {
+    size_t totalEntries = 0;
+    size_t analyzedEntries = 0;     // Entries whose password could be read
+    size_t weakEntries = 0;
+    size_t reusedEntries = 0;       // Entries sharing their exact password with another
+    size_t similarEntries = 0;      // Entries in a near-duplicate group
+    size_t breachedEntries = 0;     // Entries whose password is in a breach corpus
+    size_t breachUnknownEntries = 0;   // Not checked: no filter, or its shard is not installed yet
+    int averageScore = 0;
+    // Entries per StrengthAnalyzer label: Very Weak, Weak, Moderate, Strong, Very Strong
+    std::array<size_t, 5> strengthHistogram{};
+
+    std::vector<std::string> weakIds;
+    std::vector<std::string> breachedIds;
+    std::vector<std::vector<std::string>> reuseGroups;
+    std::vector<std::vector<std::string>> similarGroups;
+};
+
+/**
+ * @brief Batch audit of a whole vault for weak, reused and similar passwords
+ *
+ * Per-entry work runs in parallel on CryptoWorkerPool. Each password is
+ * read once (decrypting it if sealed) and reduced to four things:
+ * - a strength score
+ * - an HMAC-SHA256 digest under a random per-audit key
+ * - keyed hashes of its lower-cased trigrams
+ * - a MinHash signature over those hashes
+ * The plaintext is then wiped.
+ *
+ * With a breach filter installed, each distinct password's SHA-1 key goes
+ * through one BreachFilter::checkKeys batch, and every entry sharing a
+ * breached password is reported.
+ *
+ * Exact reuse is found by grouping digests in a hash table. Near-duplicates
+ * come from locality-sensitive hashing: signatures are cut into bands, and
+ * only entries that collide in some band are compared, using the exact
+ * Jaccard similarity of their trigram sets. This avoids the O(n^2)
+ * all-pairs comparison. Since the key is new for every audit, no digest
+ * means anything afterwards.
+ */
+class VaultAuditor {
+public:
+    static constexpr size_t SIGNATURE_SIZE = 32;
+    // 16 bands of 2 rows: a pair at Jaccard 0.6 becomes a candidate >99.9% of
+    // the time; unrelated passwords rarely share a trigram, so few others do
+    static constexpr size_t BAND_ROWS = 2;
+    // Members of larger LSH buckets are only compared with their successor,
+    // which bounds the work when many passwords share a common stem
+    static constexpr size_t MAX_BUCKET_SIZE = 64;
+
+    static VaultAuditReport audit(const std::vector<PasswordEntry>& entries,
+                                  const VaultAuditOptions& options = VaultAuditOptions());
+};
+
+#endif // VAULTAUDITOR_H
@@ -0,0 +1,230 @@
+#include "VaultIndex.h"
+#include <algorithm>
+#include "CryptoWorkerPool.h"
+#include "PublicSuffix.h"
+
+namespace {
+
+inline char foldAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Websites saved by Android autofill for apps rather than sites
+constexpr std::string_view APP_SCHEMES[] = {"androidapp://", "android://"};
+
+// Below this many websites the pool's wake-up costs more than it saves
+constexpr size_t PARALLEL_MIN = 256;
+constexpr size_t PARALLEL_GRAIN = 64;
+
+std::string_view stripAppScheme(std::string_view url) {
+    for (std::string_view scheme : APP_SCHEMES) {
+        if (url.size() > scheme.size() && std::equal(scheme.begin(), scheme.end(), url.begin(),
+                                                     [](char a, char b) { return a == foldAscii(b); })) {
+            return url.substr(scheme.size());
+        }
+    }
+    return std::string_view();
+}
+
+bool isIpLiteral(std::string_view host) {
+    if (!host.empty() && host.front() == '[') return true;   // IPv6
+    return !host.empty() && host.find_first_not_of("0123456789.") == std::string_view::npos;
+}
+
+} // namespace
+
+std::string VaultIndex::registrableDomain(std::string_view url) {
+    std::string_view package = stripAppScheme(url);
+    if (!package.empty()) return packageDomain(package);
+
+    // Host part: after "scheme://" and "user:pass@", before port, path, query or fragment
+    size_t start = url.find("://");
+    start = (start == std::string_view::npos) ? 0 : start + 3;
+    size_t end = url.find_first_of("/?#", start);
+    if (end == std::string_view::npos) end = url.size();
+    std::string_view authority = url.substr(start, end - start);
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) authority.remove_prefix(at + 1);
+
+    std::string_view host = authority;
+    if (!host.empty() && host.front() == '[') {
+        size_t close = host.find(']');
+        host = host.substr(0, close == std::string_view::npos ? host.size() : close + 1);
+    } else {
+        size_t colon = host.find(':');
+        if (colon != std::string_view::npos) host = host.substr(0, colon);
+    }
+    while (!host.empty() && (host.back() == '.' || host.back() == ' ')) host.remove_suffix(1);
+    while (!host.empty() && host.front() == ' ') host.remove_prefix(1);
+
+    std::string domain(host.size(), '\0');
+    std::transform(host.begin(), host.end(), domain.begin(), foldAscii);
+    if (domain.empty() || isIpLiteral(domain)) return domain;
+
+    std::string_view registrable = PublicSuffix::registrableDomain(domain);
+    if (!registrable.empty() && registrable.size() < domain.size()) {
+        domain.erase(0, domain.size() - registrable.size());
+    }
+    return domain;
+}
+
+std::string VaultIndex::packageDomain(std::string_view package) {
+    size_t end = package.find_first_of("/?#");
+    if (end != std::string_view::npos) package = package.substr(0, end);
+
+    // "com.paypal.android" -> "android.paypal.com"
+    std::string host;
+    host.reserve(package.size());
+    while (!package.empty()) {
+        size_t dot = package.rfind('.');
+        std::string_view label = package.substr(dot == std::string_view::npos ? 0 : dot + 1);
+        if (!label.empty()) {
+            if (!host.empty()) host += '.';
+            for (char c : label) host += foldAscii(c);
+        }
+        package.remove_suffix(dot == std::string_view::npos ? package.size() : package.size() - dot);
+    }
+    std::string_view registrable = PublicSuffix::registrableDomain(host);
+    return registrable.empty() ? std::string() : std::string(registrable);
+}
+
+std::vector<std::string> VaultIndex::registrableDomains(const std::vector<std::string_view>& websites) {
+    std::vector<std::string> domains(websites.size());
+    auto normalize = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) domains[i] = registrableDomain(websites[i]);
+    };
+    if (websites.size() < PARALLEL_MIN) {
+        normalize(0, websites.size());
+    } else {
+        CryptoWorkerPool::shared().run(websites.size(), PARALLEL_GRAIN, normalize);
+    }
+    return domains;
+}
+
+void VaultIndex::add(const std::string& id, Category category, std::string_view website, time_t modified) {
+    addNormalized(id, category, registrableDomain(website), modified);
+}
+
+void VaultIndex::addNormalized(const std::string& id, Category category, std::string domain, time_t modified) {
+    uint32_t slot;
+    auto existing = idToSlot.find(id);
+    if (existing != idToSlot.end()) {
+        slot = existing->second;
+        unlink(slot);
+    } else if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    // Out-of-range values (e.g. from an old database) count as OTHER
+    const size_t c = static_cast<size_t>(category) < CATEGORY_COUNT
+                     ? static_cast<size_t>(category) : static_cast<size_t>(Category::OTHER);
+
+    Slot& s = slots[slot];
+    s.id = id;
+    s.domain = std::move(domain);
+    s.category = static_cast<Category>(c);
+    s.modified = modified;
+    s.live = true;
+
+    std::vector<uint64_t>& bits = categoryBits[c];
+    if (bits.size() <= slot / 64) bits.resize(slot / 64 + 1, 0);
+    bits[slot / 64] |= uint64_t(1) << (slot % 64);
+    ++categoryCounts[c];
+
+    if (!s.domain.empty()) domainSlots[s.domain].push_back(slot);
+    byModified.emplace(modified, slot);
+
+    idToSlot[s.id] = slot;
+}
+
+void VaultIndex::unlink(uint32_t slot) {
+    Slot& s = slots[slot];
+    const size_t c = static_cast<size_t>(s.category);
+
+    categoryBits[c][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    --categoryCounts[c];
+
+    if (!s.domain.empty()) {
+        auto it = domainSlots.find(s.domain);
+        if (it != domainSlots.end()) {
+            std::vector<uint32_t>& list = it->second;
+            list.erase(std::remove(list.begin(), list.end(), slot), list.end());
+            if (list.empty()) domainSlots.erase(it);
+        }
+    }
+    byModified.erase(std::make_pair(s.modified, slot));
+    s.live = false;
+}
+
+bool VaultIndex::remove(const std::string& id) {
+    auto it = idToSlot.find(id);
+    if (it == idToSlot.end()) return false;
+
+    const uint32_t slot = it->second;
+    idToSlot.erase(it);
+    unlink(slot);
+    slots[slot].id.clear();
+    slots[slot].domain.clear();
+    freeSlots.push_back(slot);
+    return true;
+}
+
+void VaultIndex::clear() {
+    slots.clear();
+    freeSlots.clear();
+    idToSlot.clear();
+    for (auto& bits : categoryBits) bits.clear();
+    categoryCounts.fill(0);
+    domainSlots.clear();
+    byModified.clear();
+}
+
+std::vector<std::string_view> VaultIndex::idsInCategory(Category category) const {
+    std::vector<std::string_view> ids;
+    const size_t c = static_cast<size_t>(category);
+    if (c >= CATEGORY_COUNT) return ids;
+
+    ids.reserve(categoryCounts[c]);
+    const std::vector<uint64_t>& bits = categoryBits[c];
+    for (size_t word = 0; word < bits.size(); ++word) {
+        uint64_t w = bits[word];
+        while (w) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctzll(w));
+            ids.emplace_back(slots[word * 64 + bit].id);
+            w &= w - 1;
+        }
+    }
+    return ids;
+}
+
+std::vector<std::string_view> VaultIndex::idsInDomain(const std::string& domain) const {
+    std::vector<std::string_view> ids;
+    auto it = domainSlots.find(domain);
+    if (it == domainSlots.end()) return ids;
+
+    ids.reserve(it->second.size());
+    for (uint32_t slot : it->second) ids.emplace_back(slots[slot].id);
+    return ids;
+}
+
+std::vector<std::string_view> VaultIndex::idsForDomain(std::string_view url) const {
+    return idsInDomain(registrableDomain(url));
+}
+
+std::vector<std::string_view> VaultIndex::idsForPackage(std::string_view package) const {
+    return idsInDomain(packageDomain(package));
+}
+
+std::vector<std::string_view> VaultIndex::recentlyModified(size_t limit) const {
+    std::vector<std::string_view> ids;
+    const size_t count = (limit == 0 || limit > byModified.size()) ? byModified.size() : limit;
+    ids.reserve(count);
+    for (auto it = byModified.rbegin(); it != byModified.rend() && ids.size() < count; ++it) {
+        ids.emplace_back(slots[it->second].id);
+    }
+    return ids;
+}
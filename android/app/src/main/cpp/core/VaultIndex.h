@@ -0,0 +1,103 @@
+#ifndef VAULTINDEX_H
+#define VAULTINDEX_H
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../models/PasswordEntry.h"
+
+/**
+ * @brief Secondary indexes over the vault: category, registrable domain, modification time
+ *
+ * Each indexed entry gets a dense slot. Categories are bitsets over those
+ * slots with running counts, so counting is O(1) and listing is a word scan.
+ * Domains map to the slots whose website has that registrable domain, which
+ * is what autofill asks for while a page loads. A set ordered by
+ * (modified, slot) serves the "recent" view without sorting.
+ *
+ * Not thread-safe; the owner serialises access. Returned id views point at
+ * the index's own copies and stay valid until it is next modified.
+ */
+class VaultIndex {
+public:
+    static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(Category::OTHER) + 1;
+
+    /** @brief Add an entry, or re-index it if the id is already present */
+    void add(const std::string& id, Category category, std::string_view website, time_t modified);
+    /** @brief add() with the registrable domain already computed (see registrableDomains()) */
+    void addNormalized(const std::string& id, Category category, std::string domain, time_t modified);
+    /** @brief Drop an entry; returns false when the id was not indexed */
+    bool remove(const std::string& id);
+    void clear();
+
+    size_t size() const { return idToSlot.size(); }
+    size_t countInCategory(Category category) const { return categoryCounts[static_cast<size_t>(category)]; }
+    const std::array<size_t, CATEGORY_COUNT>& categoryCountTable() const { return categoryCounts; }
+
+    /** @brief Ids in one category, in slot order */
+    std::vector<std::string_view> idsInCategory(Category category) const;
+
+    /**
+     * @brief Ids whose website shares the registrable domain of `url`
+     *
+     * `url` may be a full URL, a host or a bare domain; returns an empty
+     * list when nothing is stored for it.
+     */
+    std::vector<std::string_view> idsForDomain(std::string_view url) const;
+
+    /**
+     * @brief Ids stored for an Android app package
+     *
+     * Matches websites saved as "androidapp://<package>" as well as sites
+     * sharing the domain the package name spells in reverse
+     * ("com.paypal.android.p2pmobile" -> "paypal.com").
+     */
+    std::vector<std::string_view> idsForPackage(std::string_view package) const;
+
+    /** @brief Most recently modified ids first; `limit` of 0 means all */
+    std::vector<std::string_view> recentlyModified(size_t limit) const;
+
+    /**
+     * @brief Lower-cased registrable domain of a URL or host ("" if none)
+     *
+     * Strips scheme, credentials, port and path, then keeps the public
+     * suffix plus one label (see PublicSuffix). IP literals and hosts that
+     * are themselves a public suffix or a single label are returned whole.
+     * "androidapp://<package>" websites map through packageDomain().
+     */
+    static std::string registrableDomain(std::string_view url);
+
+    /** @brief Registrable domain of the reversed package name ("" if none) */
+    static std::string packageDomain(std::string_view package);
+
+    /** @brief registrableDomain() of each website, spread over the crypto worker pool */
+    static std::vector<std::string> registrableDomains(const std::vector<std::string_view>& websites);
+
+private:
+    struct Slot {
+        std::string id;
+        std::string domain;
+        Category category = Category::OTHER;
+        time_t modified = 0;
+        bool live = false;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> idToSlot;
+    std::array<std::vector<uint64_t>, CATEGORY_COUNT> categoryBits;
+    std::array<size_t, CATEGORY_COUNT> categoryCounts{};
+    std::unordered_map<std::string, std::vector<uint32_t>> domainSlots;
+    std::set<std::pair<time_t, uint32_t>> byModified;
+
+    void unlink(uint32_t slot);
+    std::vector<std::string_view> idsInDomain(const std::string& domain) const;
+};
+
+#endif // VAULTINDEX_H
@@ -0,0 +1,59 @@
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+#include <cstddef>
+
+/**
+ * @brief Embedded wordlist for memorable passwords
+ *
+ * 512 distinct common English words, lower case, 3-7 letters, separated by
+ * single spaces and sorted. 512 words give exactly 9 bits of entropy per
+ * word. PasswordGenerator builds the offset table at compile time.
+ */
+namespace Wordlist {
+
+constexpr size_t WORD_COUNT = 512;
+
+constexpr char WORDS[] =
+    "able acid acorn acre actor adult agate agent alarm album alert alley alpine amber "
+    "anchor angle ankle anvil apple apron archer arena armor arrow aspen atlas attic autumn "
+    "award axis bacon badge badger bagel baker ball ballad bamboo banana band banjo banner "
+    "barn barrel basil basket bay beach beacon bean bear beaver bed beetle bell belt bench "
+    "berry bike birch bird bison blade blaze bloom bluff board boat bobcat bolt bonnet bonus "
+    "book boot bottle bowl brain branch brass bread breeze brick bridge bronze brook broom "
+    "brush bubble bucket buckle buddy bugle bundle bunny burrow butter button cabin cable "
+    "cactus cadet calico camel camera camp canal candle candy canoe canyon cape carbon cargo "
+    "carpet carrot cashew castle cattle cavern cedar celery cellar cement chair chalk chapel "
+    "cheese cherry chess chorus cider cinema circle circus citrus clam clay cliff clock "
+    "cloud clover coach coast cobalt cobble cocoa coffee comet cookie copper coral cork "
+    "cotton cougar county cousin crab cradle crane crater crayon cream creek crest crown "
+    "dagger daisy dancer dawn delta desert desk dinner doctor donkey dragon drawer dream "
+    "drum duck dune eagle earth easel echo elbow elder elk elm ember empire engine fable "
+    "falcon farmer fence fern ferry fiddle field fiesta fig finch fjord flag flame fleece "
+    "flute foam fog forest forge fossil fox frost galaxy garden garlic garnet gate gecko "
+    "geyser giant ginger glade globe glove goat goblet gold goose gopher grape gravel grove "
+    "guitar gull hammer harbor harp hatch haven hawk hazel heart hedge helmet heron hill "
+    "hive holly honey hook hornet horse hotel hummus icicle igloo iris island ivory jacket "
+    "jaguar jelly jewel jigsaw jungle kayak kelp kernel kettle kite kitten kiwi koala ladder "
+    "lagoon lake lark laser lava legend lemon lemur lentil letter lichen lily lime linen "
+    "lion lizard llama locket lodge loom lotus lumber lynx macaw magnet mango maple marble "
+    "market marsh meadow melon mesa meteor mint mirror mitten mole monkey moon moose mosaic "
+    "moss motor muffin mural museum nectar needle nest nickel noodle north nova novel nutmeg "
+    "oak oasis ocean ocelot olive onion opal orange orbit orchid osprey otter owl oyster "
+    "paddle palace panda paper parade parrot pasta pastel peach peanut pearl pebble pecan "
+    "pencil peony pepper petal piano pickle pigeon pillow pilot pine pirate pixel planet "
+    "plaza plum plume pocket poem polar pond pony poppy porch potato prism puffin puppet "
+    "puzzle quail quartz quill quiver rabbit radar radio raft rain ranch raven reef relic "
+    "ribbon ridge ripple river robin robot rocket rose ruby saddle sage sail salmon sand "
+    "satin saturn scarf school scout seal shadow shell shield ship shore sierra silver "
+    "sketch sled snail snow socket sofa sonnet spark spice spider spoon spring sprout spruce "
+    "stable star statue stone storm stream studio sugar summer summit sun sunset swan swift "
+    "syrup table tablet tango tapir teapot temple tennis thyme tidal tiger timber toast "
+    "toffee tomato topaz torch tower trail train trout tulip tundra tunnel turnip turtle "
+    "valley velvet vessel vine violet violin waffle wagon walnut walrus wasp water weasel "
+    "whale wheat whistle willow window winter wizard wolf wombat wren yacht yarn yeti yogurt "
+    "zebra zephyr zinc";
+
+} // namespace Wordlist
+
+#endif // WORDLIST_H
@@ -1,58 +1,154 @@
 #include "XOREncryptionStrategy.h"
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace {
+
+// "00".."ff" as two chars per byte, and hex digit values with 0xF0 marking
+// anything that is not a hex digit
+constexpr std::array<char, 512> makeHexPairs() {
+    constexpr char digits[] = "0123456789abcdef";
+    std::array<char, 512> table{};
+    for (int b = 0; b < 256; ++b) {
+        table[2 * b] = digits[b >> 4];
+        table[2 * b + 1] = digits[b & 0x0F];
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> makeNibbles() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        if (c >= '0' && c <= '9') table[c] = static_cast<uint8_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') table[c] = static_cast<uint8_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') table[c] = static_cast<uint8_t>(c - 'A' + 10);
+        else table[c] = 0xF0;
+    }
+    return table;
+}
+
+constexpr std::array<char, 512> HEX_PAIRS = makeHexPairs();
+constexpr std::array<uint8_t, 256> NIBBLES = makeNibbles();
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store64(uint8_t* p, uint64_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+} // namespace
 
 XOREncryptionStrategy::XOREncryptionStrategy(const std::string& xorKey) 
     : key(xorKey) {
     if (key.empty()) {
         key = "DefaultKey"; // Ensure key is never empty
     }
+    expandKey();
 }
 
-std::string XOREncryptionStrategy::xorOperation(const std::string& input) const {
-    std::string result;
-    result.reserve(input.size());
-    
-    size_t keyLen = key.length();
-    for (size_t i = 0; i < input.length(); ++i) {
-        result += input[i] ^ key[i % keyLen];
+void XOREncryptionStrategy::expandKey() {
+    keyStream.resize(key.length() + 8);
+    for (size_t i = 0; i < keyStream.size(); ++i) {
+        keyStream[i] = key[i % key.length()];
     }
-    
-    return result;
+}
+
+size_t XOREncryptionStrategy::xorInto(const uint8_t* in, uint8_t* out, size_t length, size_t offset) const {
+    const uint8_t* stream = reinterpret_cast<const uint8_t*>(keyStream.data());
+    const size_t keyLen = key.length();
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        store64(out + i, load64(in + i) ^ load64(stream + offset));
+        offset += 8;
+        while (offset >= keyLen) offset -= keyLen;
+    }
+    for (; i < length; ++i) {
+        out[i] = in[i] ^ stream[offset];
+        if (++offset == keyLen) offset = 0;
+    }
+    return offset;
 }
 
 std::string XOREncryptionStrategy::encrypt(const std::string& plainText) {
-    if (plainText.empty()) {
-        return "";
+    // Hex for readable storage/transmission; empty stays empty
+    std::string cipherText(maxEncryptedSize(plainText.size()), '\0');
+    encryptInto(asBytes(plainText), asWritableBytes(cipherText));
+    return cipherText;
+}
+
+std::string XOREncryptionStrategy::decrypt(const std::string& cipherText) {
+    std::string plainText(maxDecryptedSize(cipherText.size()), '\0');
+    decryptInto(asBytes(cipherText), asWritableBytes(plainText));
+    return plainText;
+}
+
+size_t XOREncryptionStrategy::encryptInto(ConstByteSpan plain, ByteSpan out) {
+    const size_t length = plain.size();
+    if (out.size() < length * 2) {
+        throw std::length_error("Output buffer too small for ciphertext");
     }
 
-    // XOR the plaintext
-    std::string xored = xorOperation(plainText);
-    
-    // Convert to hex for readable storage/transmission
-    std::stringstream ss;
-    for (unsigned char c : xored) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+    // XOR a block a word at a time, then expand each byte to its hex pair
+    uint8_t block[256];
+    char* hex = reinterpret_cast<char*>(out.data());
+    size_t offset = 0;
+    for (size_t done = 0; done < length; done += sizeof(block)) {
+        const size_t n = std::min(sizeof(block), length - done);
+        offset = xorInto(plain.data() + done, block, n, offset);
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(hex + 2 * (done + i), &HEX_PAIRS[2 * block[i]], 2);
+        }
     }
-    
-    return ss.str();
+    return length * 2;
 }
 
-std::string XOREncryptionStrategy::decrypt(const std::string& cipherText) {
-    if (cipherText.empty()) {
-        return "";
+size_t XOREncryptionStrategy::decryptInto(ConstByteSpan cipher, ByteSpan out) {
+    if (cipher.size() % 2 != 0) {
+        throw std::invalid_argument("XOR ciphertext must have an even number of hex digits");
+    }
+    const size_t length = cipher.size() / 2;
+    if (out.size() < length) {
+        throw std::length_error("Output buffer too small for plaintext");
     }
 
-    // Convert hex back to binary
-    std::string binary;
-    for (size_t i = 0; i < cipherText.length(); i += 2) {
-        std::string byteString = cipherText.substr(i, 2);
-        char byte = static_cast<char>(std::stoi(byteString, nullptr, 16));
-        binary += byte;
+    // Decode all pairs first; one flag check at the end instead of a branch per digit
+    uint8_t invalid = 0;
+    for (size_t i = 0; i < length; ++i) {
+        const uint8_t high = NIBBLES[cipher[2 * i]];
+        const uint8_t low = NIBBLES[cipher[2 * i + 1]];
+        invalid |= high | low;
+        out[i] = static_cast<uint8_t>((high << 4) | (low & 0x0F));
+    }
+    if (invalid & 0xF0) {
+        throw std::invalid_argument("XOR ciphertext is not valid hex");
+    }
+
+    xorInto(out.data(), out.data(), length, 0);
+    return length;
+}
+
+std::vector<std::string> XOREncryptionStrategy::encryptBatch(const std::vector<std::string>& plainTexts) {
+    std::vector<std::string> out(plainTexts.size());
+    for (size_t i = 0; i < plainTexts.size(); ++i) {
+        out[i].resize(maxEncryptedSize(plainTexts[i].size()));
+        encryptInto(asBytes(plainTexts[i]), asWritableBytes(out[i]));
+    }
+    return out;
+}
+
+std::vector<std::string> XOREncryptionStrategy::decryptBatch(const std::vector<std::string>& cipherTexts) {
+    std::vector<std::string> out(cipherTexts.size());
+    for (size_t i = 0; i < cipherTexts.size(); ++i) {
+        out[i].resize(maxDecryptedSize(cipherTexts[i].size()));
+        decryptInto(asBytes(cipherTexts[i]), asWritableBytes(out[i]));
     }
-    
-    // XOR to decrypt (XOR is symmetric)
-    return xorOperation(binary);
+    return out;
 }
 
 std::string XOREncryptionStrategy::getAlgorithmName() const {
@@ -70,5 +166,6 @@ int XOREncryptionStrategy::getKeyStrength() const {
 void XOREncryptionStrategy::setKey(const std::string& newKey) {
     if (!newKey.empty()) {
         key = newKey;
+        expandKey();
     }
 }
@@ -19,8 +19,16 @@
 class XOREncryptionStrategy : public IEncryptionStrategy {
 private:
     std::string key;
+    // key repeated to key.length() + 8 bytes: the 8 key bytes for any
+    // position p are at keyStream[p % key.length()], one unaligned load
+    std::string keyStream;
     
-    std::string xorOperation(const std::string& input) const;
+    void expandKey();
+    /**
+     * @brief out = in ^ key, with in[0] meeting key[offset]; in and out may alias
+     * @return Key offset for the byte after the last one
+     */
+    size_t xorInto(const uint8_t* in, uint8_t* out, size_t length, size_t offset) const;
 
 public:
     /**
@@ -36,6 +44,15 @@ public:
     bool requiresInitialization() const override;
     int getKeyStrength() const override;
 
+    // Buffer and batch forms: lower-case hex, two characters per byte
+    size_t maxEncryptedSize(size_t plainLength) const override { return plainLength * 2; }
+    size_t maxDecryptedSize(size_t cipherLength) const override { return cipherLength / 2; }
+    size_t encryptInto(ConstByteSpan plain, ByteSpan out) override;
+    /** @throws std::invalid_argument if the input is not an even-length hex string */
+    size_t decryptInto(ConstByteSpan cipher, ByteSpan out) override;
+    std::vector<std::string> encryptBatch(const std::vector<std::string>& plainTexts) override;
+    std::vector<std::string> decryptBatch(const std::vector<std::string>& cipherTexts) override;
+
     // XOR-specific methods
     void setKey(const std::string& newKey);
     std::string getKey() const { return key; }
@@ -0,0 +1,63 @@
+#include "LazySecret.h"
+#include "../core/CipherContext.h"
+#include "../core/RecordCompression.h"
+#include "../core/SecretCache.h"
+#include <cstring>
+#include <stdexcept>
+
+// Zeroize through a volatile pointer so the stores are not optimized away
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    while (length--) *p++ = 0;
+}
+
+static std::string decryptField(const std::string& ciphertext, LazySecret::Encoding encoding) {
+    std::shared_ptr<const CipherContext> context = CipherContext::current();
+    if (!context) {
+        throw std::runtime_error("Encryption keys are not loaded");
+    }
+
+    if (encoding == LazySecret::Encoding::RECORD) {
+        return RecordCompression::open(*context, reinterpret_cast<const uint8_t*>(ciphertext.data()),
+                                       ciphertext.size());
+    }
+
+    std::string plain(SimpleAES::maxPlaintextSize(ciphertext.size()), '\0');
+    size_t length = 0;
+    try {
+        length = context->decryptInto(ciphertext.data(), ciphertext.size(), reinterpret_cast<uint8_t*>(&plain[0]),
+                                      plain.size());
+    } catch (...) {
+        secureWipe(&plain[0], plain.size());
+        throw;
+    }
+
+    // Padding capacity beyond the plaintext would otherwise keep stale bytes
+    secureWipe(&plain[length], plain.size() - length);
+    plain.resize(length);
+    return plain;
+}
+
+LazySecret::Sealed::~Sealed() {
+    SecretCache::shared().erase(cacheKey);
+}
+
+LazySecret::LazySecret(std::string ciphertext, Encoding encoding)
+    : sealed(std::make_shared<const Sealed>(SecretCache::nextKey(), std::move(ciphertext), encoding)) {}
+
+const std::string& LazySecret::ciphertext() const {
+    static const std::string none;
+    return sealed ? sealed->ciphertext : none;
+}
+
+std::string LazySecret::reveal() const {
+    if (!sealed) return "";
+
+    // Holding `held` keeps the slot alive for the duration of the load
+    std::shared_ptr<const Sealed> held = sealed;
+    return SecretCache::shared().get(held->cacheKey, [&held] { return decryptField(held->ciphertext, held->encoding); });
+}
+
+void LazySecret::forget() const {
+    if (sealed) SecretCache::shared().erase(sealed->cacheKey);
+}
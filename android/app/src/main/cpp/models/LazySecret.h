@@ -0,0 +1,58 @@
+#ifndef LAZYSECRET_H
+#define LAZYSECRET_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Encrypted field that decrypts on first read
+ *
+ * Holds only the ciphertext: base64 text, or a raw SimpleAES record as read
+ * from a BLOB column, which skips the base64 decode. reveal() decrypts it with the currently
+ * published CipherContext and parks the plaintext in SecretCache::shared(),
+ * so repeated reads are cheap but the plaintext still expires and is wiped.
+ * Copies share the ciphertext and the cache slot; the slot is wiped when the
+ * last copy goes away.
+ */
+class LazySecret {
+public:
+    enum class Encoding : uint8_t {
+        BASE64,   // SimpleAES::encrypt output (GCM record or legacy CBC)
+        RECORD    // Raw GCM record bytes
+    };
+
+    LazySecret() = default;
+    explicit LazySecret(std::string ciphertext, Encoding encoding = Encoding::BASE64);
+
+    bool empty() const { return !sealed; }
+
+    /** @brief Stored ciphertext in encoding() form (empty when no secret is set) */
+    const std::string& ciphertext() const;
+    Encoding encoding() const { return sealed ? sealed->encoding : Encoding::BASE64; }
+
+    /**
+     * @brief Plaintext, decrypting on a cache miss
+     * @throws std::runtime_error when keys are not loaded or decryption fails
+     */
+    std::string reveal() const;
+
+    /** @brief Wipe the cached plaintext now; the next reveal() decrypts again */
+    void forget() const;
+
+private:
+    struct Sealed {
+        uint64_t cacheKey;
+        std::string ciphertext;
+        Encoding encoding;
+
+        Sealed(uint64_t key, std::string text, Encoding encoding)
+            : cacheKey(key), ciphertext(std::move(text)), encoding(encoding) {}
+        ~Sealed();
+    };
+
+    std::shared_ptr<const Sealed> sealed;
+};
+
+#endif // LAZYSECRET_H
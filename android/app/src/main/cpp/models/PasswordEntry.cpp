@@ -1,16 +1,16 @@
 #include "PasswordEntry.h"
-#include <sstream>
+#include "../core/JsonWriter.h"
+#include "../core/StrengthAnalyzer.h"
 #include <algorithm>
-#include <cctype>
 #include <chrono>
+#include <cstdint>
 #include <random>
 #include <vector>
 
-PasswordEntry::PasswordEntry(const std::string& title, const std::string& username,
-                             const std::string& password, Category category,
-                             const std::string& website, const std::string& notes)
-        : title(title), username(username), password(password), website(website),
-          category(category), notes(notes) {
+PasswordEntry::PasswordEntry(std::string title, std::string username, std::string password,
+                             Category category, std::string website, std::string notes)
+        : title(std::move(title)), username(std::move(username)), password(std::move(password)),
+          website(std::move(website)), category(category), notes(std::move(notes)) {
 
     
     id = generateId();
@@ -23,153 +23,166 @@ PasswordEntry::PasswordEntry(const std::string& title, const std::string& userna
     calculateStrength();
 }
 
+void PasswordEntry::setEncryptedPassword(const std::string& ciphertext, LazySecret::Encoding encoding) {
+    password.assign(password.size(), '\0');
+    password.clear();
+    sealedPassword = LazySecret(ciphertext, encoding);
+    strength.clear();
+    strengthStale = false;
+}
+
+void PasswordEntry::setEncryptedNotes(const std::string& ciphertext, LazySecret::Encoding encoding) {
+    notes.assign(notes.size(), '\0');
+    notes.clear();
+    sealedNotes = LazySecret(ciphertext, encoding);
+}
+
 std::string PasswordEntry::getCategoryString() const {
     return categoryToString(category);
 }
 
 void PasswordEntry::calculateStrength() {
-    strength = analyzeStrength(password);
+    // Deferred: rows loaded for a list view never have their strength shown
+    strengthStale = true;
 }
 
-PasswordAnalysisResult PasswordEntry::analyzePasswordDetailed(const std::string& password) {
-    PasswordAnalysisResult result;
-    result.score = 0;
-    result.strength = "Very Weak";
-
-    if (password.empty()) {
-        result.suggestions.push_back("Password cannot be empty");
-        return result;
-    }
-
-    // Character type analysis
-    bool hasUpper = false, hasLower = false, hasDigit = false, hasSpecial = false;
-    int upperCount = 0, lowerCount = 0, digitCount = 0, specialCount = 0;
-
-    for(char c : password) {
-        if(std::isupper(c)) { hasUpper = true; upperCount++; }
-        else if(std::islower(c)) { hasLower = true; lowerCount++; }
-        else if(std::isdigit(c)) { hasDigit = true; digitCount++; }
-        else if(!std::isalnum(c)) { hasSpecial = true; specialCount++; }
+const std::string& PasswordEntry::getStrength() const {
+    if (strengthStale) {
+        strength = analyzeStrength(password);
+        strengthStale = false;
     }
+    return strength;
+}
 
-    // Length scoring
-    int length = password.length();
-    if(length >= 8) result.score += 25;
-    if(length >= 12) result.score += 15;
-    if(length >= 16) result.score += 10;
-
-    // Character variety scoring
-    if(hasUpper) result.score += 15;
-    if(hasLower) result.score += 15;
-    if(hasDigit) result.score += 15;
-    if(hasSpecial) result.score += 15;
-
-    // Additional scoring for character distribution
-    if (upperCount >= 2) result.score += 5;
-    if (lowerCount >= 2) result.score += 5;
-    if (digitCount >= 2) result.score += 5;
-    if (specialCount >= 2) result.score += 5;
-
-    // Determine strength level
-    if(result.score >= 80) result.strength = "Very Strong";
-    else if(result.score >= 60) result.strength = "Strong";
-    else if(result.score >= 40) result.strength = "Moderate";
-    else if(result.score >= 20) result.strength = "Weak";
-    else result.strength = "Very Weak";
-
-    // Generate suggestions
-    if (length < 8) {
-        result.suggestions.push_back("Make password longer (at least 8 characters)");
-    } else if (length < 12) {
-        result.suggestions.push_back("Consider using 12+ characters for better security");
-    }
+PasswordAnalysisResult PasswordEntry::analyzePasswordDetailed(const std::string& password) {
+    return StrengthAnalyzer::analyze(password);
+}
 
-    if (!hasUpper) {
-        result.suggestions.push_back("Add uppercase letters (A-Z)");
-    } else if (upperCount == 1) {
-        result.suggestions.push_back("Add more uppercase letters for better security");
-    }
+std::string PasswordEntry::analyzeStrength(const std::string& password) {
+    return StrengthAnalyzer::summary(password);
+}
 
-    if (!hasLower) {
-        result.suggestions.push_back("Add lowercase letters (a-z)");
+// Get detailed analysis as JSON
+std::string PasswordEntry::getDetailedAnalysisJson(const std::string& password) {
+    StrengthAnalyzer analyzer(password);
+    PasswordAnalysisResult result = analyzer.result();
+
+    JsonWriter json;
+    json.beginObject()
+        .member("score", result.score)
+        .member("strength", result.strength)
+        .key("suggestions").beginArray();
+    for (const std::string& suggestion : result.suggestions) {
+        json.value(suggestion);
     }
+    json.endArray()
+        .member("length", password.length())
+        .member("hasUpper", analyzer.classCount(StrengthAnalyzer::UPPER) > 0)
+        .member("hasLower", analyzer.classCount(StrengthAnalyzer::LOWER) > 0)
+        .member("hasDigit", analyzer.classCount(StrengthAnalyzer::DIGIT) > 0)
+        .member("hasSpecial", analyzer.classCount(StrengthAnalyzer::SPECIAL) > 0)
+        .member("breached", result.breached)
+        .endObject();
+
+    return json.take();
+}
 
-    if (!hasDigit) {
-        result.suggestions.push_back("Add numbers (0-9)");
-    } else if (digitCount == 1) {
-        result.suggestions.push_back("Add more numbers for better security");
-    }
+std::string PasswordEntry::toJson() const {
+    JsonWriter json;
+    writeJson(json);
+    return json.take();
+}
 
-    if (!hasSpecial) {
-        result.suggestions.push_back("Add special characters (!@#$%^&*)");
-    } else if (specialCount == 1) {
-        result.suggestions.push_back("Add more special characters for better security");
-    }
+void PasswordEntry::writeJson(JsonWriter& out) const {
+    out.beginObject()
+       .member("id", id)
+       .member("title", title)
+       .member("username", username)
+       .member("website", website)
+       .member("category", getCategoryString())
+       .member("strength", getStrength())
+       .member("notes", getNotes())
+       .member("createdDate", static_cast<int64_t>(createdDate))
+       .member("modifiedDate", static_cast<int64_t>(modifiedDate))
+       .endObject();
+}
 
-    // Check for common patterns
-    if (password.find("123") != std::string::npos) {
-        result.suggestions.push_back("Avoid sequential numbers (123)");
-    }
-    if (password.find("abc") != std::string::npos) {
-        result.suggestions.push_back("Avoid sequential letters (abc)");
-    }
-    if (password.find("password") != std::string::npos) {
-        result.suggestions.push_back("Avoid common words like 'password'");
-    }
+namespace {
 
-    // Check for personal information patterns
-    if (password.length() <= 6 && hasDigit && !hasUpper && !hasSpecial) {
-        result.suggestions.push_back("Very short numeric passwords are easy to guess");
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        p[i] = 0;
     }
-
-    return result;
 }
 
-std::string PasswordEntry::analyzeStrength(const std::string& password) {
-    PasswordAnalysisResult result = analyzePasswordDetailed(password);
-    return result.strength + " (" + std::to_string(result.score) + "/100)";
+void putInt(std::string& out, uint64_t value, size_t bytes) {
+    char raw[8];
+    for (size_t i = 0; i < bytes; ++i) raw[i] = static_cast<char>(value >> (8 * i));
+    out.append(raw, bytes);
 }
 
-// Get detailed analysis as JSON
-std::string PasswordEntry::getDetailedAnalysisJson(const std::string& password) {
-    PasswordAnalysisResult result = analyzePasswordDetailed(password);
-
-    std::stringstream ss;
-    ss << "{";
-    ss << "\"score\":" << result.score << ",";
-    ss << "\"strength\":\"" << result.strength << "\",";
-    ss << "\"suggestions\":[";
+void putString(std::string& out, const std::string& value) {
+    putInt(out, value.size(), 4);
+    out.append(value);
+}
 
-    for(size_t i = 0; i < result.suggestions.size(); ++i) {
-        ss << "\"" << result.suggestions[i] << "\"";
-        if(i != result.suggestions.size() - 1) ss << ",";
-    }
+bool getInt(std::string_view data, size_t& offset, size_t bytes, uint64_t& value) {
+    if (bytes > data.size() - offset) return false;
+    value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= uint64_t(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+    offset += bytes;
+    return true;
+}
 
-    ss << "],";
-    ss << "\"length\":" << password.length() << ",";
-    ss << "\"hasUpper\":" << (result.suggestions.empty() ? "false" : "true") << ",";
-    ss << "\"hasLower\":" << (result.suggestions.empty() ? "false" : "true") << ",";
-    ss << "\"hasDigit\":" << (result.suggestions.empty() ? "false" : "true") << ",";
-    ss << "\"hasSpecial\":" << (result.suggestions.empty() ? "false" : "true");
-    ss << "}";
+bool getString(std::string_view data, size_t& offset, std::string& value) {
+    uint64_t length = 0;
+    if (!getInt(data, offset, 4, length) || length > data.size() - offset) return false;
+    value.assign(data.data() + offset, static_cast<size_t>(length));
+    offset += static_cast<size_t>(length);
+    return true;
+}
 
-    return ss.str();
+} // namespace
+
+void PasswordEntry::appendBinary(std::string& out) const {
+    putInt(out, static_cast<uint64_t>(category), 1);
+    putInt(out, static_cast<uint64_t>(createdDate), 8);
+    putInt(out, static_cast<uint64_t>(modifiedDate), 8);
+    putString(out, id);
+    putString(out, title);
+    putString(out, username);
+    std::string secret = getPassword();
+    putString(out, secret);
+    secureWipe(&secret[0], secret.size());
+    putString(out, website);
+    secret = getNotes();
+    putString(out, secret);
+    secureWipe(&secret[0], secret.size());
 }
 
-std::string PasswordEntry::toJson() const {
-    std::stringstream ss;
-    ss << "{"
-       << "\"id\":\"" << id << "\","
-       << "\"title\":\"" << title << "\","
-       << "\"username\":\"" << username << "\","
-       << "\"website\":\"" << website << "\","
-       << "\"category\":\"" << getCategoryString() << "\","
-       << "\"strength\":\"" << strength << "\","
-       << "\"notes\":\"" << notes << "\","
-       << "\"createdDate\":" << createdDate << ","
-       << "\"modifiedDate\":" << modifiedDate
-       << "}";
-    return ss.str();
+std::optional<PasswordEntry> PasswordEntry::readBinary(std::string_view data, size_t& offset) {
+    uint64_t kind = 0, created = 0, modified = 0;
+    std::string fields[6];   // id, title, username, password, website, notes
+    size_t at = offset;
+    bool ok = at <= data.size() &&
+              getInt(data, at, 1, kind) && getInt(data, at, 8, created) && getInt(data, at, 8, modified) &&
+              kind <= static_cast<uint64_t>(Category::OTHER);
+    for (size_t i = 0; ok && i < 6; ++i) ok = getString(data, at, fields[i]);
+
+    std::optional<PasswordEntry> entry;
+    if (ok) {
+        // Moved, so the plaintext secrets are not copied on the way in
+        entry.emplace(std::move(fields[1]), std::move(fields[2]), std::move(fields[3]),
+                      static_cast<Category>(kind), std::move(fields[4]), std::move(fields[5]));
+        entry->setId(std::move(fields[0]));
+        entry->setCreatedDate(static_cast<time_t>(created));
+        entry->setModifiedDate(static_cast<time_t>(modified));
+        offset = at;
+    }
+    secureWipe(&fields[3][0], fields[3].size());
+    secureWipe(&fields[5][0], fields[5].size());
+    return entry;
 }
 
 Category PasswordEntry::stringToCategory(const std::string& categoryStr) {
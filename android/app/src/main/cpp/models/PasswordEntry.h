@@ -3,7 +3,14 @@
 
 #include <string>
 #include <ctime>
+#include <optional>
+#include <string_view>
+#include <utility>
 #include <vector>
+#include "LazySecret.h"
+
+class JsonWriter;
+class EntryStore;
 
 enum class Category {
     BANKING,
@@ -19,6 +26,33 @@ struct PasswordAnalysisResult {
     int score;
     std::string strength;
     std::vector<std::string> suggestions;
+    bool breached = false;   // Found by the installed BreachFilter
+};
+
+/** @brief List-view columns of an entry; password and notes stay in the database */
+struct PasswordSummary {
+    std::string id;
+    std::string title;
+    std::string username;
+    std::string website;
+    Category category;
+    time_t modifiedDate;
+};
+
+/** @brief Secret columns of an entry, fetched on demand by id */
+struct PasswordSecrets {
+    std::string password;
+    std::string notes;
+};
+
+/** @brief Orderings offered by paged loading; ties break on id */
+enum class PasswordSortKey {
+    TITLE,
+    USERNAME,
+    WEBSITE,
+    CATEGORY,
+    RECENTLY_MODIFIED,
+    ID
 };
 
 class PasswordEntry {
@@ -30,55 +64,84 @@ private:
     std::string website;
     Category category;
     std::string notes;
-    std::string strength;
+    // Encrypted alternatives to password/notes, decrypted on first read
+    LazySecret sealedPassword;
+    LazySecret sealedNotes;
+    // Derived from the password on first read after it changes
+    mutable std::string strength;
+    mutable bool strengthStale = true;
     time_t createdDate;
     time_t modifiedDate;
 
+    // Keeps id, title, username and website in its column pools (hot/cold split)
+    friend class EntryStore;
+
 public:
-    PasswordEntry(const std::string& title, const std::string& username,
-                  const std::string& password, Category category = Category::OTHER,
-                  const std::string& website = "", const std::string& notes = "");
-
-    std::string getId() const { return id; }
-    std::string getTitle() const { return title; }
-    std::string getUsername() const { return username; }
-    std::string getPassword() const { return password; }
-    std::string getWebsite() const { return website; }
+    /** @brief Fields are taken by value: pass temporaries or std::move to avoid copies */
+    PasswordEntry(std::string title, std::string username, std::string password,
+                  Category category = Category::OTHER, std::string website = std::string(),
+                  std::string notes = std::string());
+
+    // Plain fields are returned by reference: valid while the entry lives
+    // and is not modified. Password and notes may be decrypted on demand,
+    // so they stay by value.
+    const std::string& getId() const { return id; }
+    const std::string& getTitle() const { return title; }
+    const std::string& getUsername() const { return username; }
+    std::string getPassword() const { return sealedPassword.empty() ? password : sealedPassword.reveal(); }
+    const std::string& getWebsite() const { return website; }
     Category getCategory() const { return category; }
     std::string getCategoryString() const;
-    std::string getNotes() const { return notes; }
-    std::string getStrength() const { return strength; }
+    std::string getNotes() const { return sealedNotes.empty() ? notes : sealedNotes.reveal(); }
+    const std::string& getStrength() const;
     time_t getCreatedDate() const { return createdDate; }
     time_t getModifiedDate() const { return modifiedDate; }
 
     // Setters
-    void setId(const std::string& newId) { id = newId; }
-    void setTitle(const std::string& newTitle) {
-        title = newTitle;
+    void setId(std::string newId) { id = std::move(newId); }
+    void setTitle(std::string newTitle) {
+        title = std::move(newTitle);
         updateModifiedDate();
-        calculateStrength();
     }
-    void setUsername(const std::string& newUsername) {
-        username = newUsername;
+    void setUsername(std::string newUsername) {
+        username = std::move(newUsername);
         updateModifiedDate();
     }
-    void setPassword(const std::string& newPassword) {
-        password = newPassword;
+    void setPassword(std::string newPassword) {
+        password = std::move(newPassword);
+        sealedPassword = LazySecret();
         updateModifiedDate();
         calculateStrength();
     }
-    void setWebsite(const std::string& newWebsite) {
-        website = newWebsite;
+    void setWebsite(std::string newWebsite) {
+        website = std::move(newWebsite);
         updateModifiedDate();
     }
     void setCategory(Category newCategory) {
         category = newCategory;
         updateModifiedDate();
     }
-    void setNotes(const std::string& newNotes) {
-        notes = newNotes;
+    void setNotes(std::string newNotes) {
+        notes = std::move(newNotes);
+        sealedNotes = LazySecret();
         updateModifiedDate();
     }
+    /**
+     * @brief Store ciphertext for lazy decryption instead of plaintext
+     *
+     * Meant for loading stored rows, so the modified date is left alone.
+     * Strength stays unset until a plaintext password is assigned.
+     */
+    void setEncryptedPassword(const std::string& ciphertext,
+                              LazySecret::Encoding encoding = LazySecret::Encoding::BASE64);
+    void setEncryptedNotes(const std::string& ciphertext,
+                           LazySecret::Encoding encoding = LazySecret::Encoding::BASE64);
+    bool isPasswordEncrypted() const { return !sealedPassword.empty(); }
+    bool areNotesEncrypted() const { return !sealedNotes.empty(); }
+    /** @brief Sealed forms, for storing the ciphertext without decrypting it */
+    const LazySecret& getSealedPassword() const { return sealedPassword; }
+    const LazySecret& getSealedNotes() const { return sealedNotes; }
+
     void setCreatedDate(time_t date) { createdDate = date; }
     void setModifiedDate(time_t date) { modifiedDate = date; }
 
@@ -89,6 +152,23 @@ public:
 
     // JSON conversion
     std::string toJson() const;
+    /** @brief Write this entry as one JSON object into an existing document */
+    void writeJson(JsonWriter& out) const;
+
+    // Binary record form, used inside encrypted vault and backup records
+    /**
+     * @brief Append this entry: category (u8), created and modified dates
+     * (u64), then id, title, username, password, website and notes, each with
+     * a u32 length prefix; all little-endian
+     *
+     * Sealed secrets are decrypted into `out`, which the caller must wipe.
+     */
+    void appendBinary(std::string& out) const;
+    /**
+     * @brief Parse one entry at `offset` and advance past it
+     * @return nullopt if the data is truncated or malformed
+     */
+    static std::optional<PasswordEntry> readBinary(std::string_view data, size_t& offset);
 
     // Database helper methods
     static Category stringToCategory(const std::string& categoryStr);
@@ -1,25 +1,84 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <condition_variable>
 #include <cstring>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <system_error>
+#include <thread>
 #include "core/SimpleAES.h"
+#include "core/BreachFilter.h"
+#include "core/PBKDF2.h"
+#include "core/CipherContext.h"
+#include "core/CryptoWorkerPool.h"
+#include "core/JsonWriter.h"
+#include "core/KeyRotation.h"
+#include "core/PerfTrace.h"
+#include "core/SecretCache.h"
+#include "core/SecureArena.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// The library builds with -fvisibility=hidden; only what Dart looks up by
+// name is exported
+#define FFI_EXPORT __attribute__((visibility("default")))
 
-static SimpleAES* g_aes = nullptr;
 static std::string g_keyFile = "/data/data/com.example.last_final/aes_key.bin";
 static std::string g_ivFile = "/data/data/com.example.last_final/aes_iv.bin";
+static std::string g_kdfFile = "/data/data/com.example.last_final/kdf_params.bin";
+static std::string g_keyCacheFile = "/data/data/com.example.last_final/key_cache.bin";
+
+// PBKDF2 parameters persisted on first derivation: magic, iterations, salt,
+// flags. Version 1 files have no flags byte and read as no flags
+static const char KDF_MAGIC[4] = {'K', 'D', 'F', '2'};
+static const char KDF_MAGIC_V1[4] = {'K', 'D', 'F', '1'};
+static const uint32_t KDF_TARGET_MILLIS = 250;
+static const size_t KDF_SALT_SIZE = 16;
+// Pre-PBKDF2 key. With neither flag it is derived only once a legacy
+// ciphertext turns up, which sets KDF_FLAG_LEGACY_KEYS: from then on every
+// unlock derives it. KDF_FLAG_LEGACY_RETIRED (a new account, a password
+// change, cpp_retire_legacy_keys) stops deriving it for good
+static const uint8_t KDF_FLAG_LEGACY_KEYS = 0x01;
+static const uint8_t KDF_FLAG_LEGACY_RETIRED = 0x02;
+
+struct KdfParams {
+    uint32_t iterations = 0;
+    std::vector<uint8_t> salt;
+    uint8_t flags = 0;
+};
 
-static std::vector<uint8_t> deriveKey(const std::string& password, const std::vector<uint8_t>& salt, int iterations, size_t keyLen) {
-    std::vector<uint8_t> derived(keyLen);
-    std::vector<uint8_t> block(password.begin(), password.end());
+// Resume cache: the derived key material sealed (raw GCM record) under a
+// random resume key that only the platform keeps, wrapped by the Android
+// Keystore. Plaintext is magic, KDF iterations, the time it was sealed (so
+// it expires after KEY_CACHE_TTL) and the salt (so a recalibrated or reset
+// KDF invalidates it), then primary and legacy key material
+static const char KEY_CACHE_MAGIC[4] = {'K', 'C', 'H', '2'};
+static const size_t KEY_MATERIAL_SIZE = 48;   // AES-256 key + IV, as PBKDF2 derives it
+static const size_t RESUME_KEY_SIZE = KEY_MATERIAL_SIZE;
+static const size_t KEY_CACHE_PLAIN_SIZE = 4 + 4 + 8 + KDF_SALT_SIZE + 2 * KEY_MATERIAL_SIZE;
+static const std::chrono::seconds KEY_CACHE_TTL = std::chrono::hours(24);
+static_assert(2 * KEY_MATERIAL_SIZE == KeyRotation::MATERIAL_SIZE, "Rotation state seals the cached material layout");
+
+// Pre-PBKDF2 derivation; only used to read data written by older builds
+static SecureBuffer legacyDeriveKey(const SecureString& password, const std::vector<uint8_t>& salt, int iterations, size_t keyLen) {
+    SecureBuffer block(password.begin(), password.end());
     block.insert(block.end(), salt.begin(), salt.end());
     block.push_back(0);
     block.push_back(0);
     block.push_back(0);
     block.push_back(1);
-    std::vector<uint8_t> U = block;
-    std::vector<uint8_t> result(keyLen, 0);
+    SecureBuffer U = block;
+    SecureBuffer result(keyLen, 0);
 
     for (int iter = 0; iter < iterations; iter++) {
         uint8_t hash = 0;
@@ -39,62 +98,177 @@ static std::vector<uint8_t> deriveKey(const std::string& password, const std::ve
     return result;
 }
 
-static std::string g_userPassword = "";
-static bool g_keysInitialized = false;
+// Writer-side state, guarded by g_keyMutex. Readers never touch it: they
+// use CipherContext::current() and only fall back to waitForKeys() while no
+// context is published
+static SecureString g_userPassword;
+static SecureBuffer g_resumeKey;   // Set by each derivation until cpp_take_resume_key hands it out
+static SecureBuffer g_keyMaterial; // Behind the published keys; sealed as the retiring generation on a change
 
-extern "C" {
-    void cpp_set_user_password(const char* password) {
-        if (password) {
-            g_userPassword = std::string(password);
-            g_keysInitialized = false;
-            if (g_aes) {
-                delete g_aes;
-                g_aes = nullptr;
-            }
-            std::cout << "User password set\n";
-        }
+/**
+ * Key lifecycle. Derivation runs on a worker thread (cpp_derive_keys_async,
+ * cpp_set_user_password); encrypt/decrypt calls wait for it to finish
+ * instead of deriving on the caller's thread.
+ */
+enum KeyState : int32_t {
+    KEYS_IDLE = 0,
+    KEYS_DERIVING = 1,
+    KEYS_READY = 2,
+    KEYS_FAILED = 3
+};
+
+// Callback events for cpp_derive_keys_async
+enum KeyEvent : int32_t {
+    KEY_EVENT_PROGRESS = 0,   // progress = 0..100
+    KEY_EVENT_READY = 1,
+    KEY_EVENT_FAILED = 2
+};
+
+typedef void (*KeyDerivationCallback)(int32_t event, int32_t progress, void* user_data);
+
+static std::mutex g_keyMutex;
+static std::condition_variable g_keyReady;
+static KeyState g_keyState = KEYS_IDLE;
+static uint64_t g_keyGeneration = 0;   // Bumped on every password change/reset
+
+// In-flight operations keep their reference; the keys are wiped when the
+// last one finishes
+static void releaseKeys() {
+    CipherContext::publish(nullptr);
+    SecureBuffer().swap(g_keyMaterial);
+    // Plaintext decrypted under the old keys must not outlive them
+    SecretCache::shared().clear();
+}
+
+static bool loadKdfParams(KdfParams& params) {
+    std::ifstream in(g_kdfFile, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint8_t iter[4];
+    params.salt.assign(KDF_SALT_SIZE, 0);
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(iter), 4);
+    in.read(reinterpret_cast<char*>(params.salt.data()), KDF_SALT_SIZE);
+    if (!in) return false;
+    if (std::memcmp(magic, KDF_MAGIC, 4) == 0) {
+        char flags;
+        if (!in.read(&flags, 1)) return false;
+        params.flags = static_cast<uint8_t>(flags);
+    } else if (std::memcmp(magic, KDF_MAGIC_V1, 4) == 0) {
+        params.flags = 0;
+    } else {
+        return false;
     }
+
+    params.iterations = static_cast<uint32_t>(iter[0]) | (static_cast<uint32_t>(iter[1]) << 8) |
+                        (static_cast<uint32_t>(iter[2]) << 16) | (static_cast<uint32_t>(iter[3]) << 24);
+    return params.iterations >= PBKDF2::MIN_ITERATIONS && params.iterations <= PBKDF2::MAX_ITERATIONS;
+}
+
+static void saveKdfParams(const KdfParams& params) {
+    std::ofstream out(g_kdfFile, std::ios::binary | std::ios::trunc);
+    uint8_t iter[4] = {
+        static_cast<uint8_t>(params.iterations), static_cast<uint8_t>(params.iterations >> 8),
+        static_cast<uint8_t>(params.iterations >> 16), static_cast<uint8_t>(params.iterations >> 24)
+    };
+    out.write(KDF_MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(iter), 4);
+    out.write(reinterpret_cast<const char*>(params.salt.data()), params.salt.size());
+    out.put(static_cast<char>(params.flags));
 }
 
-static void initAES() {
-    if (g_aes != nullptr) return;
+static std::mutex g_kdfMutex;   // Serialises kdf_params.bin read-modify-write
 
-    if (g_userPassword.empty()) {
-        std::cerr << "ERROR: User password not set\n";
+// First derivation on a device calibrates the iteration count and picks a
+// random salt; both must then stay fixed for the keys to be reproducible.
+// A fresh file has no legacy flag: after an upgrade from a build that
+// wrote no parameters, the first legacy ciphertext read sets it
+static KdfParams currentKdfParams() {
+    std::lock_guard<std::mutex> lock(g_kdfMutex);
 
-        std::vector<uint8_t> key(32);
-        std::vector<uint8_t> iv(16);
+    KdfParams params;
+    if (loadKdfParams(params)) return params;
 
-        std::ifstream keyIn(g_keyFile, std::ios::binary);
-        std::ifstream ivIn(g_ivFile, std::ios::binary);
+    params.iterations = PBKDF2::calibrateIterations(KDF_TARGET_MILLIS);
+    params.salt = SimpleAES::generateRandomBytes(KDF_SALT_SIZE);
+    saveKdfParams(params);
+    std::cout << "KDF calibrated: " << params.iterations << " iterations\n";
+    return params;
+}
 
-        if (keyIn && ivIn) {
-            keyIn.read(reinterpret_cast<char*>(key.data()), 32);
-            ivIn.read(reinterpret_cast<char*>(iv.data()), 16);
-            keyIn.close();
-            ivIn.close();
+static std::shared_ptr<const CipherContext> loadFileKeys() {
+    std::vector<uint8_t> key(32);
+    std::vector<uint8_t> iv(16);
 
-            bool keysValid = false;
-            for (size_t i = 0; i < key.size(); i++) {
-                if (key[i] != 0) {
-                    keysValid = true;
-                    break;
-                }
-            }
+    std::ifstream keyIn(g_keyFile, std::ios::binary);
+    std::ifstream ivIn(g_ivFile, std::ios::binary);
 
-            if (keysValid) {
-                std::cout << "Using legacy file-based keys\n";
-                g_aes = new SimpleAES(key, iv);
-                return;
+    if (keyIn && ivIn) {
+        keyIn.read(reinterpret_cast<char*>(key.data()), 32);
+        ivIn.read(reinterpret_cast<char*>(iv.data()), 16);
+        keyIn.close();
+        ivIn.close();
+
+        bool keysValid = false;
+        for (size_t i = 0; i < key.size(); i++) {
+            if (key[i] != 0) {
+                keysValid = true;
+                break;
             }
         }
 
-        std::cerr << "No keys available\n";
-        return;
+        if (keysValid) {
+            std::cout << "Using legacy file-based keys\n";
+            // Older builds wrote their CBC ciphertexts under these keys too
+            return std::make_shared<const CipherContext>(std::unique_ptr<const SimpleAES>(new SimpleAES(key, iv)),
+                                                         std::unique_ptr<const SimpleAES>(new SimpleAES(key, iv)));
+        }
     }
 
-    std::cout << "Deriving encryption keys...\n";
+    std::cerr << "No keys available\n";
+    return nullptr;
+}
+
+// Key and IV are read in place; `derived` is wiped when it is released
+static std::unique_ptr<const SimpleAES> keyFromDerived(const SecureBuffer& derived) {
+    return std::unique_ptr<const SimpleAES>(new SimpleAES(derived.data(), derived.data() + 32));
+}
 
+// Nothing under the pre-PBKDF2 derivation needs reading any more
+static void retireLegacyKeys() {
+    std::lock_guard<std::mutex> lock(g_kdfMutex);
+    KdfParams params;
+    if (!loadKdfParams(params) || (params.flags & KDF_FLAG_LEGACY_RETIRED)) return;
+    params.flags = static_cast<uint8_t>((params.flags & ~KDF_FLAG_LEGACY_KEYS) | KDF_FLAG_LEGACY_RETIRED);
+    saveKdfParams(params);
+}
+
+// A legacy ciphertext turned up; unless retired meanwhile, unlocks derive
+// the legacy key from now on
+static void markLegacyKeys() {
+    std::lock_guard<std::mutex> lock(g_kdfMutex);
+    KdfParams params;
+    if (!loadKdfParams(params) || (params.flags & (KDF_FLAG_LEGACY_KEYS | KDF_FLAG_LEGACY_RETIRED))) return;
+    params.flags |= KDF_FLAG_LEGACY_KEYS;
+    saveKdfParams(params);
+}
+
+// Primary then legacy material; a legacy half equal to the primary one
+// means there is no separate legacy key (`loadLegacy` may derive it later)
+static std::shared_ptr<const CipherContext> contextFromMaterial(const uint8_t* material,
+                                                                CipherContext::LegacyLoader loadLegacy = nullptr) {
+    const uint8_t* legacy = material + KEY_MATERIAL_SIZE;
+    std::unique_ptr<const SimpleAES> legacyKey;
+    if (std::memcmp(material, legacy, KEY_MATERIAL_SIZE) != 0) legacyKey.reset(new SimpleAES(legacy, legacy + 32));
+    return std::make_shared<const CipherContext>(
+        std::unique_ptr<const SimpleAES>(new SimpleAES(material, material + 32)), std::move(legacyKey),
+        std::move(loadLegacy));
+}
+
+// Material for ciphertexts written before PBKDF2: 100k rounds of a byte
+// mixer, so only derived once such a ciphertext has turned up
+static SecureBuffer deriveLegacyMaterial(const SecureString& password) {
     std::string packageName = "com.example.last_final";
     std::vector<uint8_t> salt(packageName.begin(), packageName.end());
 
@@ -105,33 +279,566 @@ static void initAES() {
     salt.resize(16);
 
     int iterations = 100000;
-    std::vector<uint8_t> derived = deriveKey(g_userPassword, salt, iterations, 48);
+    return legacyDeriveKey(password, salt, iterations, KEY_MATERIAL_SIZE);
+}
 
-    std::vector<uint8_t> key(derived.begin(), derived.begin() + 32);
-    std::vector<uint8_t> iv(derived.begin() + 32, derived.begin() + 48);
+static void invalidateKeyCacheLocked();
 
-    g_aes = new SimpleAES(key, iv);
-    g_keysInitialized = true;
+// Runs on the thread that first reads a legacy ciphertext. The resume cache
+// was sealed without the key, so it goes; the next unlock derives from the
+// password again, legacy key included now that the flag is set. Keys
+// resumed from the cache have no password (empty): that read fails
+static CipherContext::LegacyLoader legacyLoaderFor(const SecureString& password) {
+    return [password]() -> std::unique_ptr<const SimpleAES> {
+        markLegacyKeys();
+        {
+            std::lock_guard<std::mutex> lock(g_keyMutex);
+            invalidateKeyCacheLocked();
+        }
+        if (password.empty()) return nullptr;
+        return keyFromDerived(deriveLegacyMaterial(password));
+    };
+}
+
+/**
+ * `material` receives the primary then the legacy key material, for the
+ * resume cache; the caller wipes it by releasing it. The legacy half
+ * repeats the primary unless KDF_FLAG_LEGACY_KEYS is set; while neither
+ * legacy flag is, the context loads the legacy key when it first needs it.
+ * `withLegacy` is false for a new password, which never had legacy data.
+ */
+static std::shared_ptr<const CipherContext> deriveFromPassword(const SecureString& password,
+                                                               const PBKDF2::ProgressFn& progress,
+                                                               SecureBuffer& material, bool withLegacy) {
+    PERF_SCOPE(PerfOp::KEY_SETUP);
+    std::cout << "Deriving encryption keys...\n";
+
+    KdfParams params = currentKdfParams();
+    SecureBuffer derived = PBKDF2::deriveKey(password.data(), password.size(), params.salt, params.iterations,
+                                             KEY_MATERIAL_SIZE, progress);
+    material.assign(derived.begin(), derived.end());
+    CipherContext::LegacyLoader loadLegacy;
+    if (withLegacy && (params.flags & KDF_FLAG_LEGACY_KEYS)) {
+        SecureBuffer legacy = deriveLegacyMaterial(password);
+        material.insert(material.end(), legacy.begin(), legacy.end());
+    } else {
+        material.insert(material.end(), derived.begin(), derived.end());
+        if (withLegacy && !(params.flags & KDF_FLAG_LEGACY_RETIRED)) loadLegacy = legacyLoaderFor(password);
+    }
+    auto context = contextFromMaterial(material.data(), std::move(loadLegacy));
 
     std::cout << "AES initialized\n";
+    return context;
+}
+
+static void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    while (length--) *p++ = 0;
+}
+
+// Caller holds g_keyMutex. The platform-held resume key stops working once
+// the sealed file is gone
+static void invalidateKeyCacheLocked() {
+    SecureBuffer().swap(g_resumeKey);
+    std::remove(g_keyCacheFile.c_str());
+}
+
+// Caller holds g_keyMutex. Seals `material` under a fresh resume key,
+// replacing any earlier cache; the key waits in g_resumeKey for the platform
+static void writeKeyCacheLocked(const SecureBuffer& material) {
+    KdfParams params;
+    if (material.size() != 2 * KEY_MATERIAL_SIZE || !loadKdfParams(params)) return;
+
+    SecureBuffer plain(KEY_CACHE_MAGIC, KEY_CACHE_MAGIC + 4);
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        plain.push_back(static_cast<uint8_t>(params.iterations >> shift));
+    }
+    const uint64_t sealedAt = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        plain.push_back(static_cast<uint8_t>(sealedAt >> shift));
+    }
+    plain.insert(plain.end(), params.salt.begin(), params.salt.end());
+    plain.insert(plain.end(), material.begin(), material.end());
+
+    std::vector<uint8_t> random = SimpleAES::generateRandomBytes(RESUME_KEY_SIZE);
+    SecureBuffer resumeKey(random.begin(), random.end());
+    secureWipe(random.data(), random.size());
+
+    std::vector<uint8_t> record(SimpleAES::recordSize(plain.size()));
+    keyFromDerived(resumeKey)->encryptRecord(plain.data(), plain.size(), record.data(), record.size());
+
+    // Temp file, fsync, rename: a crash leaves the old cache or the new one, never a torn file
+    const std::string temp = g_keyCacheFile + ".tmp";
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    bool written = fd >= 0;
+    for (size_t done = 0; written && done < record.size();) {
+        const ssize_t n = ::write(fd, record.data() + done, record.size() - done);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            written = false;
+        }
+    }
+    written = written && ::fsync(fd) == 0;
+    if (fd >= 0 && ::close(fd) != 0) written = false;
+    if (!written || std::rename(temp.c_str(), g_keyCacheFile.c_str()) != 0) {
+        std::cerr << "Failed to write key cache: " << std::strerror(errno) << "\n";
+        std::remove(temp.c_str());
+        std::remove(g_keyCacheFile.c_str());   // An older cache must not outlive new keys
+        return;
+    }
+    const size_t slash = g_keyCacheFile.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : g_keyCacheFile.substr(0, slash == 0 ? 1 : slash);
+    const int dirFd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    g_resumeKey.swap(resumeKey);
+}
+
+// Caller holds g_keyMutex. Keys from the resume cache, or nullptr when it is
+// missing, does not open under `resumeKey`, was sealed for other KDF params
+// or has expired (then it is deleted). `material` receives the cached key material
+static std::shared_ptr<const CipherContext> openKeyCacheLocked(const uint8_t* resumeKey, SecureBuffer& material) {
+    std::ifstream in(g_keyCacheFile, std::ios::binary);
+    if (!in) return nullptr;
+    std::vector<uint8_t> record(SimpleAES::recordSize(KEY_CACHE_PLAIN_SIZE) + 1);
+    in.read(reinterpret_cast<char*>(record.data()), record.size());
+    if (static_cast<size_t>(in.gcount()) != record.size() - 1) return nullptr;
+    record.pop_back();
+
+    KdfParams params;
+    if (!loadKdfParams(params)) return nullptr;
+
+    SecureBuffer plain(KEY_CACHE_PLAIN_SIZE);
+    try {
+        std::unique_ptr<const SimpleAES> sealer(new SimpleAES(resumeKey, resumeKey + 32));
+        if (sealer->decryptRecord(record.data(), record.size(), plain.data(), plain.size()) != plain.size()) {
+            return nullptr;
+        }
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+
+    const uint8_t* at = plain.data();
+    const uint32_t iterations = static_cast<uint32_t>(at[4]) | (static_cast<uint32_t>(at[5]) << 8) |
+                                (static_cast<uint32_t>(at[6]) << 16) | (static_cast<uint32_t>(at[7]) << 24);
+    uint64_t sealedAt = 0;
+    for (unsigned i = 0; i < 8; ++i) sealedAt |= static_cast<uint64_t>(at[8 + i]) << (8 * i);
+    if (std::memcmp(at, KEY_CACHE_MAGIC, 4) != 0 || iterations != params.iterations ||
+        std::memcmp(at + 16, params.salt.data(), KDF_SALT_SIZE) != 0) {
+        return nullptr;
+    }
+    // A clock set back counts as expired too
+    const uint64_t now = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    if (now < sealedAt || now - sealedAt > static_cast<uint64_t>(KEY_CACHE_TTL.count())) {
+        invalidateKeyCacheLocked();
+        return nullptr;
+    }
+
+    const uint8_t* primary = at + 16 + KDF_SALT_SIZE;
+    material.assign(primary, primary + 2 * KEY_MATERIAL_SIZE);
+    CipherContext::LegacyLoader loadLegacy;
+    if (!(params.flags & (KDF_FLAG_LEGACY_KEYS | KDF_FLAG_LEGACY_RETIRED))) loadLegacy = legacyLoaderFor(SecureString());
+    return contextFromMaterial(material.data(), std::move(loadLegacy));
+}
+
+/**
+ * With `previous` set this is a password change: the new keys are published
+ * only once KeyRotation has durably recorded `previous` as the retiring
+ * generation, and until then the old keys stay in use. `previousPassword`
+ * derives the old legacy key if none was needed yet; after the change no
+ * unlock derives it again.
+ */
+static void derivationWorker(SecureString password, uint64_t generation,
+                             KeyDerivationCallback callback, void* userData,
+                             std::shared_ptr<const CipherContext> previous, SecureBuffer previousMaterial,
+                             SecureString previousPassword) {
+    int32_t lastPercent = -1;
+    PBKDF2::ProgressFn progress;
+    if (callback) {
+        progress = [&](uint32_t done, uint32_t total) {
+            int32_t percent = static_cast<int32_t>((static_cast<uint64_t>(done) * 100) / total);
+            if (percent != lastPercent && percent < 100) {
+                lastPercent = percent;
+                callback(KEY_EVENT_PROGRESS, percent, userData);
+            }
+        };
+    }
+
+    std::shared_ptr<const CipherContext> context;
+    SecureBuffer material;
+    try {
+        // Nothing was ever written under the new password's legacy key; the
+        // old one travels in the retiring generation
+        context = deriveFromPassword(password, progress, material, !previous);
+        if (context && previous && !previousPassword.empty() &&
+            std::memcmp(previousMaterial.data(), previousMaterial.data() + KEY_MATERIAL_SIZE, KEY_MATERIAL_SIZE) == 0) {
+            KdfParams params;
+            if (loadKdfParams(params) && !(params.flags & KDF_FLAG_LEGACY_RETIRED)) {
+                SecureBuffer legacy = deriveLegacyMaterial(previousPassword);
+                std::copy(legacy.begin(), legacy.end(), previousMaterial.begin() + KEY_MATERIAL_SIZE);
+            }
+        }
+    } catch (const std::exception& e) {
+        context.reset();
+        std::cerr << "Key derivation failed\n";
+    }
+    previousPassword.clear();
+
+    bool current;
+    {
+        std::lock_guard<std::mutex> lock(g_keyMutex);
+        current = generation == g_keyGeneration;
+        if (current && previous) {
+            if (context) context = KeyRotation::begin(previous, previousMaterial, context);
+            if (context) {
+                g_userPassword.swap(password);
+                retireLegacyKeys();
+            } else {
+                std::cerr << "Master password change failed; keeping the old keys\n";
+            }
+        } else if (current && context) {
+            // A re-key interrupted by process death or a lock picks up its old keys again
+            context = KeyRotation::resume(context);
+        }
+        if (current && (context || !previous)) {
+            // Publish under the writer lock so a concurrent clear/reset
+            // cannot be overtaken by a stale derivation
+            CipherContext::publish(context);
+            g_keyState = context ? KEYS_READY : KEYS_FAILED;
+            if (context) {
+                g_keyMaterial.swap(material);
+                try {
+                    writeKeyCacheLocked(g_keyMaterial);
+                } catch (const std::exception& e) {
+                    std::cerr << "Failed to write key cache\n";
+                }
+            }
+        }
+    }
+    password.clear();   // Wiped when its block is released
+
+    if (!current) {
+        // Superseded by a newer password/reset while deriving
+        context.reset();
+    } else {
+        g_keyReady.notify_all();
+    }
+
+    if (callback) {
+        callback(context ? KEY_EVENT_READY : KEY_EVENT_FAILED, context ? 100 : 0, userData);
+    }
+}
+
+// Caller holds g_keyMutex. Drops current keys and derives from g_userPassword
+// on a worker; the callback (optional) fires from that worker thread
+static void startDerivationLocked(KeyDerivationCallback callback, void* userData) {
+    releaseKeys();
+    invalidateKeyCacheLocked();   // Rewritten once the new keys are derived
+    g_keyState = KEYS_DERIVING;
+    const uint64_t generation = ++g_keyGeneration;
+
+    try {
+        std::thread(derivationWorker, g_userPassword, generation, callback, userData,
+                    std::shared_ptr<const CipherContext>(), SecureBuffer(), SecureString()).detach();
+    } catch (const std::system_error&) {
+        g_keyState = KEYS_FAILED;
+        g_keyReady.notify_all();
+        if (callback) callback(KEY_EVENT_FAILED, 0, userData);
+    }
+}
+
+/**
+ * Slow path while no context is published: waits if a derivation is in
+ * flight (or has to be restarted after cpp_clear_keys); without a password
+ * the legacy key files are loaded directly.
+ */
+static std::shared_ptr<const CipherContext> waitForKeys() {
+    std::unique_lock<std::mutex> lock(g_keyMutex);
+
+    if (g_keyState == KEYS_IDLE) {
+        if (g_userPassword.empty()) {
+            std::shared_ptr<const CipherContext> context = loadFileKeys();
+            CipherContext::publish(context);
+            g_keyState = context ? KEYS_READY : KEYS_IDLE;
+        } else {
+            startDerivationLocked(nullptr, nullptr);
+        }
+    }
+
+    g_keyReady.wait(lock, [] { return g_keyState != KEYS_DERIVING; });
+    return CipherContext::current();
+}
+
+// Reader entry point: once keys are published, waits on no derivation,
+// only on CipherContext::current()'s brief pointer-copy lock
+static std::shared_ptr<const CipherContext> acquireKeys() {
+    std::shared_ptr<const CipherContext> context = CipherContext::current();
+    return context ? context : waitForKeys();
+}
+
+extern "C" {
+    FFI_EXPORT void cpp_set_user_password(const char* password) {
+        if (password) {
+            std::lock_guard<std::mutex> lock(g_keyMutex);
+            g_userPassword.assign(password);
+            startDerivationLocked(nullptr, nullptr);
+            std::cout << "User password set\n";
+        }
+    }
+
+    /**
+     * Start deriving keys for `password` on a native worker thread and
+     * return immediately. callback(event, progress, user_data) is invoked
+     * from that thread with KEY_EVENT_PROGRESS (progress 0..99) and then
+     * exactly one of KEY_EVENT_READY / KEY_EVENT_FAILED; it must be safe
+     * to call off the main thread (e.g. NativeCallable.listener). A later
+     * call (or reset/clear) supersedes an earlier one, which then reports
+     * KEY_EVENT_FAILED.
+     */
+    FFI_EXPORT void cpp_derive_keys_async(const char* password, KeyDerivationCallback callback, void* user_data) {
+        if (!password) return;
+        std::lock_guard<std::mutex> lock(g_keyMutex);
+        g_userPassword.assign(password);
+        startDerivationLocked(callback, user_data);
+    }
+
+    /**
+     * Change the master password without stranding existing ciphertexts.
+     * Needs unlocked keys (state ready); otherwise reports KEY_EVENT_FAILED
+     * at once. Keys for `password` are derived on a worker thread (callback
+     * as for cpp_derive_keys_async) while the old keys stay in use. Once
+     * the old keys are recorded as the retiring generation, the new keys
+     * are published: new writes use them and reads fall back to the old
+     * ones until every store has re-keyed: the vault (RekeyMigration, JNI
+     * builds) and the caller, for ciphertexts it keeps from this API (see
+     * cpp_reseal_aes_batch). That also holds after process death, as soon
+     * as keys for the new password are loaded again.
+     */
+    FFI_EXPORT void cpp_change_master_password(const char* password, KeyDerivationCallback callback,
+                                               void* user_data) {
+        if (!password) return;
+        std::unique_lock<std::mutex> lock(g_keyMutex);
+        std::shared_ptr<const CipherContext> previous = CipherContext::current();
+        if (g_keyState != KEYS_READY || !previous || g_keyMaterial.size() != KeyRotation::MATERIAL_SIZE) {
+            lock.unlock();
+            std::cerr << "Master password change needs unlocked keys\n";
+            if (callback) callback(KEY_EVENT_FAILED, 0, user_data);
+            return;
+        }
+        const uint64_t generation = ++g_keyGeneration;
+
+        try {
+            std::thread(derivationWorker, SecureString(password), generation, callback, user_data,
+                        std::move(previous), g_keyMaterial, g_userPassword).detach();
+        } catch (const std::system_error&) {
+            lock.unlock();
+            if (callback) callback(KEY_EVENT_FAILED, 0, user_data);
+        }
+    }
+
+    /**
+     * Id of the master password change still being re-keyed, 0 when none
+     */
+    FFI_EXPORT int64_t cpp_rekey_pending() {
+        return static_cast<int64_t>(KeyRotation::pending());
+    }
+
+    /**
+     * Current KeyState (0 idle, 1 deriving, 2 ready, 3 failed); never blocks
+     */
+    FFI_EXPORT int32_t cpp_keys_state() {
+        std::lock_guard<std::mutex> lock(g_keyMutex);
+        return g_keyState;
+    }
+
+    /**
+     * Resume cache. Every successful derivation seals the derived keys into
+     * key_cache.bin under a fresh random resume key. The platform takes that
+     * key once with cpp_take_resume_key (returns its length, 0 if none is
+     * pending, -length if capacity is too small) and keeps it wrapped by an
+     * Android Keystore key. On resume, cpp_resume_keys publishes the cached
+     * keys without running the KDF: 1 on success (state becomes ready), 0 if
+     * there is no valid cache for that key. The cache expires KEY_CACHE_TTL
+     * after it was sealed; cpp_clear_keys, cpp_reset_keys and any new
+     * password delete it sooner.
+     */
+    FFI_EXPORT int32_t cpp_take_resume_key(uint8_t* out, int32_t capacity) {
+        std::lock_guard<std::mutex> lock(g_keyMutex);
+        if (g_resumeKey.empty()) return 0;
+        const int32_t size = static_cast<int32_t>(g_resumeKey.size());
+        if (!out || capacity < size) return -size;
+        std::memcpy(out, g_resumeKey.data(), g_resumeKey.size());
+        SecureBuffer().swap(g_resumeKey);
+        return size;
+    }
+
+    FFI_EXPORT int32_t cpp_resume_keys(const uint8_t* resume_key, int32_t length) {
+        if (!resume_key || length != static_cast<int32_t>(RESUME_KEY_SIZE)) return 0;
+        PERF_SCOPE(PerfOp::KEY_SETUP);
+
+        std::lock_guard<std::mutex> lock(g_keyMutex);
+        SecureBuffer material;
+        std::shared_ptr<const CipherContext> context = openKeyCacheLocked(resume_key, material);
+        if (!context) {
+            std::cerr << "Key cache unavailable\n";
+            return 0;
+        }
+        releaseKeys();
+        ++g_keyGeneration;   // A derivation still in flight must not replace these
+        CipherContext::publish(KeyRotation::resume(context));
+        g_keyMaterial.swap(material);
+        g_keyState = KEYS_READY;
+        g_keyReady.notify_all();
+        std::cout << "Keys resumed from cache\n";
+        return 1;
+    }
+}
+
+enum class CryptOp {
+    ENCRYPT,
+    DECRYPT,
+    RESEAL    // Decrypt with any key generation, encrypt again with the primary key
+};
+
+// Output bound for one item: exact for encryption, upper bound otherwise
+static size_t outputBound(const CipherContext& keys, size_t length, CryptOp op) {
+    switch (op) {
+        case CryptOp::ENCRYPT: return SimpleAES::ciphertextSize(length, keys.aes().getWriteMode());
+        case CryptOp::DECRYPT: return SimpleAES::maxPlaintextSize(length);
+        case CryptOp::RESEAL:
+            return SimpleAES::ciphertextSize(SimpleAES::maxPlaintextSize(length), keys.aes().getWriteMode());
+    }
+    return 0;
+}
+
+static size_t cryptInto(const CipherContext& keys, const char* in, size_t length,
+                        uint8_t* out, size_t capacity, CryptOp op) {
+    switch (op) {
+        case CryptOp::ENCRYPT:
+            return keys.encryptInto(reinterpret_cast<const uint8_t*>(in), length, reinterpret_cast<char*>(out),
+                                    capacity);
+        case CryptOp::DECRYPT:
+            return keys.decryptInto(in, length, out, capacity);
+        case CryptOp::RESEAL: {
+            SecureBuffer plain(SimpleAES::maxPlaintextSize(length));
+            const size_t n = keys.decryptInto(in, length, plain.data(), plain.size());
+            return keys.encryptInto(plain.data(), n, reinterpret_cast<char*>(out), capacity);
+        }
+    }
+    return 0;
+}
+
+// Items per pool chunk: large enough to amortise claiming, small enough to
+// balance a few long entries (notes) against many short ones
+static const size_t BATCH_GRAIN = 16;
+
+// Arena header[1]: whether every item was attempted
+enum BatchStatus : int32_t {
+    BATCH_COMPLETE = 0,
+    BATCH_CANCELLED = 1   // Items not reached have length -1
+};
+
+static const uint8_t* runBatch(const char* const* inputs, const int32_t* lengths, int32_t count, CryptOp op,
+                               const std::atomic<int32_t>* cancel) {
+    if (!inputs || !lengths || count < 0) return nullptr;
+    PERF_SCOPE(PerfOp::CRYPT_BATCH);
+    try {
+        std::shared_ptr<const CipherContext> keys = acquireKeys();
+        if (!keys) {
+            std::cerr << "AES not initialized\n";
+            return nullptr;
+        }
+
+        // Every item gets a slot sized by its bound, so workers write in
+        // place without coordinating; slots are packed afterwards
+        const size_t headerSize = 2 * sizeof(int32_t) + static_cast<size_t>(count) * 2 * sizeof(int32_t);
+        std::vector<size_t> slots(static_cast<size_t>(count) + 1);
+        size_t capacity = headerSize;
+        for (int32_t i = 0; i < count; i++) {
+            slots[i] = capacity;
+            if (!inputs[i] || lengths[i] < 0) continue;
+            capacity += outputBound(*keys, static_cast<size_t>(lengths[i]), op) + 1;
+        }
+        slots[count] = capacity;
+        if (capacity > INT32_MAX) return nullptr;
+
+        uint8_t* arena = static_cast<uint8_t*>(std::malloc(capacity));
+        if (!arena) return nullptr;
+
+        int32_t* header = reinterpret_cast<int32_t*>(arena);
+        header[0] = count;
+        header[1] = 0;
+        int32_t* items = header + 2;
+        for (int32_t i = 0; i < count; i++) {
+            items[2 * i] = 0;
+            items[2 * i + 1] = -1;
+        }
+
+        const CipherContext& ctx = *keys;
+        bool complete = CryptoWorkerPool::shared().run(static_cast<size_t>(count), BATCH_GRAIN,
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    if (!inputs[i] || lengths[i] < 0) continue;
+                    try {
+                        size_t length = static_cast<size_t>(lengths[i]);
+                        size_t n = cryptInto(ctx, inputs[i], length, arena + slots[i],
+                                             slots[i + 1] - slots[i] - 1, op);
+                        arena[slots[i] + n] = '\0';
+                        items[2 * i + 1] = static_cast<int32_t>(n);
+                    } catch (const std::exception& e) {
+                        // Leave this item marked as failed, keep going
+                    }
+                }
+            }, cancel);
+
+        // Pack the slots front to back (moves only ever go left)
+        size_t offset = headerSize;
+        for (int32_t i = 0; i < count; i++) {
+            int32_t n = items[2 * i + 1];
+            if (n < 0) continue;
+            if (offset != slots[i]) {
+                std::memmove(arena + offset, arena + slots[i], static_cast<size_t>(n) + 1);
+            }
+            items[2 * i] = static_cast<int32_t>(offset);
+            offset += static_cast<size_t>(n) + 1;
+        }
+        header[1] = complete ? BATCH_COMPLETE : BATCH_CANCELLED;
+
+        // Offsets are arena-relative, so giving back the slack is safe
+        uint8_t* trimmed = static_cast<uint8_t*>(std::realloc(arena, offset));
+        return trimmed ? trimmed : arena;
+
+    } catch (const std::exception& e) {
+        std::cerr << "AES batch failed\n";
+        return nullptr;
+    }
 }
 
 extern "C" {
 
-    const char* cpp_encrypt_aes(const char* plain) {
+    FFI_EXPORT const char* cpp_encrypt_aes(const char* plain) {
         if (!plain) return nullptr;
+        PERF_SCOPE(PerfOp::ENCRYPT);
         try {
-            initAES();
-            if (!g_aes) {
+            std::shared_ptr<const CipherContext> keys = acquireKeys();
+            if (!keys) {
                 std::cerr << "AES not initialized\n";
                 return nullptr;
             }
 
-            std::string enc = g_aes->encrypt(std::string(plain));
-            char* out = static_cast<char*>(std::malloc(enc.size() + 1));
+            size_t length = std::strlen(plain);
+            size_t capacity = outputBound(*keys, length, CryptOp::ENCRYPT);
+            char* out = static_cast<char*>(std::malloc(capacity + 1));
             if (!out) return nullptr;
-            std::memcpy(out, enc.c_str(), enc.size());
-            out[enc.size()] = '\0';
+            size_t n = cryptInto(*keys, plain, length, reinterpret_cast<uint8_t*>(out), capacity, CryptOp::ENCRYPT);
+            out[n] = '\0';
             return out;
 
         } catch (const std::exception& e) {
@@ -140,50 +847,355 @@ extern "C" {
         }
     }
 
-    const char* cpp_decrypt_aes(const char* cipher) {
+    FFI_EXPORT const char* cpp_decrypt_aes(const char* cipher) {
         if (!cipher) return nullptr;
+        PERF_SCOPE(PerfOp::DECRYPT);
+        char* out = nullptr;
         try {
-            initAES();
-            if (!g_aes) {
+            std::shared_ptr<const CipherContext> keys = acquireKeys();
+            if (!keys) {
                 std::cerr << "AES not initialized\n";
                 return nullptr;
             }
 
-            std::string dec = g_aes->decrypt(std::string(cipher));
-            char* out = static_cast<char*>(std::malloc(dec.size() + 1));
+            size_t length = std::strlen(cipher);
+            size_t capacity = outputBound(*keys, length, CryptOp::DECRYPT);
+            out = static_cast<char*>(std::malloc(capacity + 1));
             if (!out) return nullptr;
-            std::memcpy(out, dec.c_str(), dec.size());
-            out[dec.size()] = '\0';
+            size_t n = cryptInto(*keys, cipher, length, reinterpret_cast<uint8_t*>(out), capacity, CryptOp::DECRYPT);
+            out[n] = '\0';
             return out;
 
         } catch (const std::exception& e) {
+            std::free(out);
             std::cerr << "AES decryption failed\n";
             return nullptr;
         }
     }
 
-    void cpp_reset_keys() {
-        if (g_aes) {
-            delete g_aes;
-            g_aes = nullptr;
+    /**
+     * Caller-buffer API: no allocation on the native side.
+     *
+     * cpp_aes_ciphertext_size returns the exact ciphertext length for a
+     * plaintext of `length` bytes (current write mode), and
+     * cpp_aes_plaintext_max_size an upper bound on the plaintext of a
+     * `length`-char ciphertext. The *_into functions write no NUL
+     * terminator and return the number of bytes written, or -1 on failure
+     * (including a buffer smaller than the size functions report).
+     */
+    FFI_EXPORT int32_t cpp_aes_ciphertext_size(int32_t length) {
+        if (length < 0) return -1;
+        std::shared_ptr<const CipherContext> keys = CipherContext::current();
+        size_t size = SimpleAES::ciphertextSize(static_cast<size_t>(length),
+                                                keys ? keys->aes().getWriteMode() : SimpleAES::Mode::GCM);
+        return size > INT32_MAX ? -1 : static_cast<int32_t>(size);
+    }
+
+    FFI_EXPORT int32_t cpp_aes_plaintext_max_size(int32_t length) {
+        if (length < 0) return -1;
+        size_t size = SimpleAES::maxPlaintextSize(static_cast<size_t>(length));
+        return size > INT32_MAX ? -1 : static_cast<int32_t>(size);
+    }
+
+    FFI_EXPORT int32_t cpp_encrypt_aes_into(const char* plain, int32_t length, char* out, int32_t capacity) {
+        if (!plain || !out || length < 0 || capacity < 0) return -1;
+        PERF_SCOPE(PerfOp::ENCRYPT);
+        try {
+            std::shared_ptr<const CipherContext> keys = acquireKeys();
+            if (!keys) return -1;
+            return static_cast<int32_t>(cryptInto(*keys, plain, static_cast<size_t>(length), reinterpret_cast<uint8_t*>(out),
+                                                  static_cast<size_t>(capacity), CryptOp::ENCRYPT));
+        } catch (const std::exception& e) {
+            return -1;
+        }
+    }
+
+    FFI_EXPORT int32_t cpp_decrypt_aes_into(const char* cipher, int32_t length, char* out, int32_t capacity) {
+        if (!cipher || !out || length < 0 || capacity < 0) return -1;
+        PERF_SCOPE(PerfOp::DECRYPT);
+        try {
+            std::shared_ptr<const CipherContext> keys = acquireKeys();
+            if (!keys) return -1;
+            return static_cast<int32_t>(cryptInto(*keys, cipher, static_cast<size_t>(length), reinterpret_cast<uint8_t*>(out),
+                                                  static_cast<size_t>(capacity), CryptOp::DECRYPT));
+        } catch (const std::exception& e) {
+            return -1;
+        }
+    }
+
+    /**
+     * Batch API: one FFI crossing and one allocation for many fields.
+     *
+     * inputs/lengths describe `count` strings (lengths in bytes, no NUL
+     * needed). The result is a single malloc'd arena, released with cpp_free:
+     *   int32_t count
+     *   int32_t status   (BatchStatus: 0 complete, 1 cancelled)
+     *   struct { int32_t offset; int32_t length; } items[count]
+     *   char data[]
+     * offset is relative to the arena start, each item is NUL-terminated,
+     * and length == -1 marks an item that failed. Returns nullptr if the
+     * keys are unavailable. Items are spread over the shared
+     * CryptoWorkerPool (big cores); the calling thread works too.
+     */
+    FFI_EXPORT const uint8_t* cpp_encrypt_aes_batch(const char* const* inputs, const int32_t* lengths, int32_t count) {
+        return runBatch(inputs, lengths, count, CryptOp::ENCRYPT, nullptr);
+    }
+
+    FFI_EXPORT const uint8_t* cpp_decrypt_aes_batch(const char* const* inputs, const int32_t* lengths, int32_t count) {
+        return runBatch(inputs, lengths, count, CryptOp::DECRYPT, nullptr);
+    }
+
+    /**
+     * Cancellable variants: cancel_flag is caller-owned native memory that
+     * another thread/isolate sets non-zero to stop the job. Chunks already
+     * running finish; the rest come back with length -1 and status 1.
+     */
+    FFI_EXPORT const uint8_t* cpp_encrypt_aes_batch_cancellable(const char* const* inputs, const int32_t* lengths,
+                                                     int32_t count, const int32_t* cancel_flag) {
+        // int32_t and a lock-free std::atomic<int32_t> share size and layout
+        return runBatch(inputs, lengths, count, CryptOp::ENCRYPT, reinterpret_cast<const std::atomic<int32_t>*>(cancel_flag));
+    }
+
+    FFI_EXPORT const uint8_t* cpp_decrypt_aes_batch_cancellable(const char* const* inputs, const int32_t* lengths,
+                                                     int32_t count, const int32_t* cancel_flag) {
+        return runBatch(inputs, lengths, count, CryptOp::DECRYPT, reinterpret_cast<const std::atomic<int32_t>*>(cancel_flag));
+    }
+
+    /**
+     * Re-key API for ciphertexts the caller stores itself. After a master
+     * password change, the caller takes the id from cpp_rekey_pending,
+     * passes everything it keeps through cpp_reseal_aes_batch (decrypt
+     * with any key generation, encrypt with the new key; same arena as the
+     * batch API), saves the results, then calls cpp_rekey_confirm(id).
+     * Confirm only once every item came back: one marked failed (-1) may
+     * still need a retiring key, and confirming drops those keys for good.
+     * The old keys are dropped once the vault has confirmed too: returns 1
+     * when that happened, 0 while the vault is still re-keying, -1 when
+     * `rotation` is not pending (any more; a newer change needs its own
+     * pass) or the keys are not loaded.
+     */
+    FFI_EXPORT const uint8_t* cpp_reseal_aes_batch(const char* const* inputs, const int32_t* lengths, int32_t count) {
+        return runBatch(inputs, lengths, count, CryptOp::RESEAL, nullptr);
+    }
+
+    FFI_EXPORT const uint8_t* cpp_reseal_aes_batch_cancellable(const char* const* inputs, const int32_t* lengths,
+                                                    int32_t count, const int32_t* cancel_flag) {
+        return runBatch(inputs, lengths, count, CryptOp::RESEAL, reinterpret_cast<const std::atomic<int32_t>*>(cancel_flag));
+    }
+
+    FFI_EXPORT int32_t cpp_rekey_confirm(int64_t rotation) {
+        std::shared_ptr<const CipherContext> keys = acquireKeys();
+        if (!keys || rotation == 0) return -1;
+        switch (KeyRotation::confirm(static_cast<uint64_t>(rotation), KeyRotation::STORE_CALLER, keys)) {
+            case KeyRotation::Confirmation::FINISHED: return 1;
+            case KeyRotation::Confirmation::WAITING: return 0;
+            case KeyRotation::Confirmation::STALE: break;
+        }
+        return -1;
+    }
+
+    /**
+     * Never derive the pre-PBKDF2 key again. It is otherwise derived only
+     * once a legacy ciphertext is read, then on every unlock. Call once
+     * nothing the caller holds needs it: on a new account, or after
+     * resealing data from older builds with cpp_reseal_aes_batch. Needs a
+     * completed derivation (the KDF parameters) and takes effect from the
+     * next one; a master password change retires it by itself.
+     */
+    FFI_EXPORT void cpp_retire_legacy_keys() {
+        retireLegacyKeys();
+    }
+
+    /**
+     * Worker threads available to batch jobs (plus the calling thread)
+     */
+    FFI_EXPORT int32_t cpp_crypto_worker_count() {
+        return static_cast<int32_t>(CryptoWorkerPool::shared().size());
+    }
+
+    /**
+     * KDF: cpp_kdf_iterations returns the PBKDF2 iteration count in use on
+     * this device (calibrating it on first call), cpp_kdf_calibrate the
+     * count that would take target_millis here without changing anything.
+     */
+    FFI_EXPORT int32_t cpp_kdf_iterations() {
+        try {
+            return static_cast<int32_t>(currentKdfParams().iterations);
+        } catch (const std::exception& e) {
+            return -1;
         }
+    }
+
+    FFI_EXPORT int32_t cpp_kdf_calibrate(int32_t target_millis) {
+        if (target_millis <= 0) return -1;
+        return static_cast<int32_t>(PBKDF2::calibrateIterations(static_cast<uint32_t>(target_millis)));
+    }
+
+    FFI_EXPORT void cpp_reset_keys() {
+        std::lock_guard<std::mutex> lock(g_keyMutex);
         std::remove(g_keyFile.c_str());
         std::remove(g_ivFile.c_str());
+        invalidateKeyCacheLocked();
         std::cout << "Reset encryption keys\n";
-        initAES();
+        if (g_userPassword.empty()) {
+            releaseKeys();
+            g_keyState = KEYS_IDLE;
+            ++g_keyGeneration;
+        } else {
+            // Re-derive in the background; crypto calls wait for it
+            startDerivationLocked(nullptr, nullptr);
+        }
     }
 
-    void cpp_free(const char* ptr) {
-        if (ptr) std::free((void*)ptr);
+    /**
+     * Perf stats: cpp_get_perf_stats returns per-operation counts, latency
+     * totals and log2 histograms as JSON (see PerfStats::json), released
+     * with cpp_free. cpp_reset_perf_stats zeroes them. With
+     * SECUREFLOW_PERF_STATS off the JSON reports "enabled": false and no ops.
+     */
+    FFI_EXPORT const char* cpp_get_perf_stats() {
+        try {
+            std::string stats = PerfStats::json();
+            char* out = static_cast<char*>(std::malloc(stats.size() + 1));
+            if (!out) return nullptr;
+            std::memcpy(out, stats.c_str(), stats.size() + 1);
+            return out;
+        } catch (const std::exception& e) {
+            return nullptr;
+        }
+    }
+
+    FFI_EXPORT void cpp_reset_perf_stats() {
+        PerfStats::reset();
+        SecretCache::shared().resetStats();
+    }
+
+    /**
+     * Decrypted-field cache stats as JSON (hits, misses, evictions,
+     * expirations, size, hitRate), released with cpp_free; zeroed by
+     * cpp_reset_perf_stats
+     */
+    FFI_EXPORT const char* cpp_get_secret_cache_stats() {
+        try {
+            const SecretCache::Stats stats = SecretCache::shared().stats();
+            char hitRate[16];
+            std::snprintf(hitRate, sizeof(hitRate), "%.4f", stats.hitRate());
+            JsonWriter json;
+            json.beginObject()
+                .member("hits", stats.hits)
+                .member("misses", stats.misses)
+                .member("evictions", stats.evictions)
+                .member("expirations", stats.expirations)
+                .member("size", stats.size)
+                .key("hitRate").raw(hitRate)
+                .endObject();
+            const std::string& text = json.str();
+            char* out = static_cast<char*>(std::malloc(text.size() + 1));
+            if (!out) return nullptr;
+            std::memcpy(out, text.c_str(), text.size() + 1);
+            return out;
+        } catch (const std::exception& e) {
+            return nullptr;
+        }
+    }
+
+    /**
+     * Offline breach check. cpp_breach_open installs the shard directory as
+     * the shared BreachFilter (also used by strength analysis and the vault
+     * audit); cpp_breach_close turns checks off. Statuses: 0 clear,
+     * 1 breached, 2 unknown (shard not installed), -1 no filter/bad input.
+     *
+     * cpp_breach_requested_shards returns a JSON array of shard indexes
+     * that lookups needed, released with cpp_free; download each and pass it
+     * to cpp_breach_install_shard (1 on success). cpp_breach_shard_generation
+     * reports an installed shard's corpus generation (0 when missing) for
+     * update checks.
+     */
+    FFI_EXPORT int32_t cpp_breach_open(const char* directory) {
+        if (!directory) return 0;
+        try {
+            BreachFilter::setShared(std::make_shared<BreachFilter>(directory));
+            return 1;
+        } catch (const std::exception& e) {
+            return 0;
+        }
+    }
+
+    FFI_EXPORT void cpp_breach_close() {
+        BreachFilter::setShared(nullptr);
+    }
+
+    FFI_EXPORT int32_t cpp_breach_check(const char* password, int32_t length) {
+        std::shared_ptr<BreachFilter> filter = BreachFilter::shared();
+        if (!filter || !password || length < 0) return -1;
+        return static_cast<int32_t>(filter->check(std::string_view(password, static_cast<size_t>(length))));
+    }
+
+    /**
+     * Statuses for `count` passwords into out[count]; returns count or -1
+     */
+    FFI_EXPORT int32_t cpp_breach_check_batch(const char* const* inputs, const int32_t* lengths,
+                                              int32_t count, uint8_t* out) {
+        std::shared_ptr<BreachFilter> filter = BreachFilter::shared();
+        if (!filter || !inputs || !lengths || !out || count < 0) return -1;
+        try {
+            std::vector<std::string_view> passwords(static_cast<size_t>(count));
+            for (int32_t i = 0; i < count; ++i) {
+                if (!inputs[i] || lengths[i] < 0) return -1;
+                passwords[i] = std::string_view(inputs[i], static_cast<size_t>(lengths[i]));
+            }
+            std::vector<BreachFilter::Status> statuses(passwords.size());
+            filter->check(passwords.data(), passwords.size(), statuses.data());
+            for (size_t i = 0; i < statuses.size(); ++i) out[i] = static_cast<uint8_t>(statuses[i]);
+            return count;
+        } catch (const std::exception& e) {
+            return -1;
+        }
     }
 
-    void cpp_clear_keys() {
-        if (g_aes) {
-            delete g_aes;
-            g_aes = nullptr;
+    FFI_EXPORT const char* cpp_breach_requested_shards() {
+        std::shared_ptr<BreachFilter> filter = BreachFilter::shared();
+        if (!filter) return nullptr;
+        try {
+            JsonWriter json;
+            json.beginArray();
+            for (uint32_t shard : filter->requestedShards()) json.value(shard);
+            json.endArray();
+            const std::string& text = json.str();
+            char* out = static_cast<char*>(std::malloc(text.size() + 1));
+            if (!out) return nullptr;
+            std::memcpy(out, text.c_str(), text.size() + 1);
+            return out;
+        } catch (const std::exception& e) {
+            return nullptr;
         }
+    }
+
+    FFI_EXPORT int64_t cpp_breach_shard_generation(int32_t shard) {
+        std::shared_ptr<BreachFilter> filter = BreachFilter::shared();
+        if (!filter || shard < 0 || static_cast<uint32_t>(shard) >= BreachFilter::SHARD_COUNT) return -1;
+        return static_cast<int64_t>(filter->shardGeneration(static_cast<uint32_t>(shard)));
+    }
+
+    FFI_EXPORT int32_t cpp_breach_install_shard(int32_t shard, const char* path) {
+        std::shared_ptr<BreachFilter> filter = BreachFilter::shared();
+        if (!filter || !path || shard < 0) return 0;
+        return filter->installShard(static_cast<uint32_t>(shard), path) ? 1 : 0;
+    }
+
+    FFI_EXPORT void cpp_free(const char* ptr) {
+        if (ptr) std::free((void*)ptr);
+    }
+
+    FFI_EXPORT void cpp_clear_keys() {
+        std::lock_guard<std::mutex> lock(g_keyMutex);
+        releaseKeys();
+        g_keyState = KEYS_IDLE;
+        ++g_keyGeneration;   // Discard any derivation still in flight
+        g_keyReady.notify_all();
         std::remove(g_keyFile.c_str());
         std::remove(g_ivFile.c_str());
+        invalidateKeyCacheLocked();
         std::cout << "Cleared AES keys\n";
     }
 }
@@ -0,0 +1,607 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "core/AESHardware.h"
+#include "core/Base64.h"
+#include "core/BreachFilter.h"
+#include "core/CipherContext.h"
+#include "core/EntryStore.h"
+#include "core/JsonWriter.h"
+#include "core/Lz4.h"
+#include "core/PBKDF2.h"
+#include "core/RecordCompression.h"
+#include "core/SearchIndex.h"
+#include "core/SimpleAES.h"
+#include "core/VaultIndex.h"
+#include "models/PasswordEntry.h"
+#ifdef PASSWORDCORE_BENCH_SQLITE
+#include "core/DatabaseManager.h"
+#endif
+
+/**
+ * @brief Micro and end-to-end benchmarks for passwordcore
+ *
+ * Covers SimpleAES per payload size and backend, PBKDF2 unlock, base64,
+ * breach-filter lookups, record compression, search and JSON export over synthetic vaults and, when built with SQLite,
+ * database insert/load. Results go to stdout (or --out) as one JSON
+ * document, so two runs can be diffed. Anything the library logs is sent
+ * to stderr instead.
+ *
+ *   passwordcore_bench [--quick] [--filter SUBSTRING] [--min-time-ms N]
+ *                      [--out FILE] [--tmpdir DIR]
+ *
+ * Each case is calibrated until one sample takes about min-time / SAMPLES,
+ * then SAMPLES samples are taken. The median and minimum ns per operation
+ * are reported.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int SAMPLES = 5;
+
+struct Options {
+    bool quick = false;
+    std::string filter;
+    double minTimeMs = 250;
+    std::string out;
+    std::string tmpdir;
+};
+
+struct Result {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> params;
+    uint64_t opsPerSample = 0;
+    double medianNs = 0;     // Per operation
+    double minNs = 0;
+    uint64_t bytesPerOp = 0;  // 0 when throughput does not apply
+};
+
+// Keeps the optimizer from discarding work whose result is otherwise unused
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// JsonWriter has no floating-point values; timings go in as raw numbers
+std::string fixed(double value, int decimals) {
+    char text[48];
+    std::snprintf(text, sizeof(text), "%.*f", decimals, value);
+    return text;
+}
+
+class Bench {
+public:
+    explicit Bench(const Options& options) : options(options) {}
+
+    bool enabled(const std::string& name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    /**
+     * @brief Time `op`, which performs `opsPerCall` operations per call
+     *
+     * Calls are repeated until a sample takes long enough to time reliably.
+     * Slow cases (a KDF run) end up at one call per sample.
+     */
+    void run(const std::string& name, std::vector<std::pair<std::string, std::string>> params,
+             uint64_t bytesPerOp, uint64_t opsPerCall, const std::function<void()>& op) {
+        if (!enabled(name)) return;
+        std::cerr << "bench " << name;
+        for (const auto& p : params) std::cerr << ' ' << p.first << '=' << p.second;
+        std::cerr << std::endl;
+
+        const double target = options.minTimeMs * 1e6 / SAMPLES;
+        uint64_t calls = 1;
+        for (;;) {
+            const Clock::time_point start = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) op();
+            const double ns = elapsedNs(start);
+            if (ns >= target || calls >= (uint64_t(1) << 40)) break;
+            // Aim a little past the target so calibration ends in one or two more rounds
+            const double scale = ns > 0 ? target * 1.2 / ns : 16.0;
+            calls = std::max(calls + 1, static_cast<uint64_t>(static_cast<double>(calls) * std::min(scale, 16.0)));
+        }
+
+        std::vector<double> perOp;
+        for (int s = 0; s < SAMPLES; ++s) {
+            const Clock::time_point start = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) op();
+            perOp.push_back(elapsedNs(start) / static_cast<double>(calls * opsPerCall));
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        Result result;
+        result.name = name;
+        result.params = std::move(params);
+        result.opsPerSample = calls * opsPerCall;
+        result.medianNs = perOp[SAMPLES / 2];
+        result.minNs = perOp.front();
+        result.bytesPerOp = bytesPerOp;
+        results.push_back(std::move(result));
+    }
+
+    void write(std::ostream& out) const {
+        JsonWriter json;
+        json.beginObject()
+            .member("suite", std::string_view("passwordcore_bench"))
+            .member("format", 1)
+            .member("quick", options.quick);
+        json.key("environment").beginObject()
+            .member("aesBackend", SimpleAES::getBackendName())
+            .member("aesHardware", AESHardware::isAvailable())
+            .member("base64Backend", Base64::backendName())
+#ifdef PASSWORDCORE_BENCH_SQLITE
+            .member("sqlite", true)
+#else
+            .member("sqlite", false)
+#endif
+            .member("samples", SAMPLES)
+            .key("minTimeMs").raw(fixed(options.minTimeMs, 0))
+            .endObject();
+        json.key("results").beginArray();
+        for (const Result& r : results) {
+            json.beginObject().member("name", r.name);
+            json.key("params").beginObject();
+            for (const auto& p : r.params) json.member(p.first, p.second);
+            json.endObject()
+                .member("ops", r.opsPerSample)
+                .key("medianNsPerOp").raw(fixed(r.medianNs, 1))
+                .key("minNsPerOp").raw(fixed(r.minNs, 1));
+            if (r.bytesPerOp) {
+                json.member("bytesPerOp", r.bytesPerOp)
+                    .key("medianMBps").raw(fixed(static_cast<double>(r.bytesPerOp) * 1e3 / r.medianNs, 1));
+            }
+            json.endObject();
+        }
+        json.endArray().endObject();
+        out << json.str() << '\n';
+    }
+
+private:
+    const Options& options;
+    std::vector<Result> results;
+};
+
+std::vector<size_t> vaultSizes(const Options& options) {
+    if (options.quick) return {1000, 10000};
+    return {1000, 10000, 100000};
+}
+
+// ============================================================================
+// SimpleAES
+// ============================================================================
+
+void benchAES(Bench& bench) {
+    const std::vector<uint8_t> key = SimpleAES::generateRandomBytes(32);
+    const std::vector<uint8_t> iv = SimpleAES::generateRandomBytes(16);
+    const SimpleAES aes(key, iv);
+    const size_t sizes[] = {16, 256, 4096, 65536};
+
+    std::vector<bool> modes;
+    if (AESHardware::isAvailable()) modes.push_back(true);
+    modes.push_back(false);
+
+    for (bool hardware : modes) {
+        AESHardware::setEnabled(hardware);
+        const std::string backend = SimpleAES::getBackendName();
+        for (size_t size : sizes) {
+            std::vector<uint8_t> plain(size, 0x5a), back(size);
+            std::vector<uint8_t> record(SimpleAES::recordSize(size));
+            const std::string bytes = std::to_string(size);
+
+            bench.run("aes.gcm.encrypt", {{"backend", backend}, {"bytes", bytes}}, size, 1, [&] {
+                keep(aes.encryptRecord(plain.data(), size, record.data(), record.size()));
+            });
+            aes.encryptRecord(plain.data(), size, record.data(), record.size());
+            bench.run("aes.gcm.decrypt", {{"backend", backend}, {"bytes", bytes}}, size, 1, [&] {
+                keep(aes.decryptRecord(record.data(), record.size(), back.data(), back.size()));
+            });
+        }
+
+        // The string API the entry fields go through: GCM record plus base64
+        const std::string field(24, 'p');
+        const std::string sealed = aes.encrypt(field);
+        bench.run("aes.field.encrypt", {{"backend", backend}, {"bytes", "24"}}, field.size(), 1, [&] {
+            keep(aes.encrypt(field));
+        });
+        bench.run("aes.field.decrypt", {{"backend", backend}, {"bytes", "24"}}, field.size(), 1, [&] {
+            keep(aes.decrypt(sealed));
+        });
+    }
+    AESHardware::setEnabled(true);
+}
+
+// ============================================================================
+// PBKDF2 unlock
+// ============================================================================
+
+void benchKDF(Bench& bench, const Options& options) {
+    const std::vector<uint8_t> salt = SimpleAES::generateRandomBytes(16);
+    const std::string password = "correct horse battery staple";
+    std::vector<uint32_t> counts = {PBKDF2::MIN_ITERATIONS};
+    if (!options.quick) counts.push_back(PBKDF2::DEFAULT_ITERATIONS);
+
+    for (uint32_t iterations : counts) {
+        // Key plus IV, as an unlock derives them
+        bench.run("kdf.pbkdf2.unlock", {{"iterations", std::to_string(iterations)}}, 0, 1, [&] {
+            SecureBuffer derived = PBKDF2::deriveKey(password, salt, iterations, 48);
+            keep(derived[0]);
+        });
+    }
+}
+
+// ============================================================================
+// Base64
+// ============================================================================
+
+void benchBase64(Bench& bench) {
+    const std::string backend = Base64::backendName();
+    for (size_t size : {size_t(48), size_t(4096), size_t(1) << 20}) {
+        const std::vector<uint8_t> data = SimpleAES::generateRandomBytes(size);
+        std::string text(Base64::encodedSize(size), '\0');
+        std::vector<uint8_t> back(Base64::maxDecodedSize(text.size()));
+        const std::string bytes = std::to_string(size);
+
+        bench.run("base64.encode", {{"backend", backend}, {"bytes", bytes}}, size, 1, [&] {
+            keep(Base64::encode(data.data(), data.size(), &text[0]));
+        });
+        bench.run("base64.decode", {{"backend", backend}, {"bytes", bytes}}, size, 1, [&] {
+            keep(Base64::decode(text.data(), text.size(), back.data()));
+        });
+    }
+}
+
+// ============================================================================
+// Breach filter
+// ============================================================================
+
+void benchBreach(Bench& bench, const Options& options) {
+    if (!bench.enabled("breach")) return;
+    const size_t corpus = options.quick ? 200000 : 2000000;
+    const std::string dir = options.tmpdir + "/passwordcore_bench_breach";
+    const std::string corpusSize = std::to_string(corpus);
+
+    // Corpus of "breached-<n>"; lookups below hit it or miss it on purpose
+    std::vector<std::vector<uint64_t>> byShard(BreachFilter::SHARD_COUNT);
+    for (size_t i = 0; i < corpus; ++i) {
+        const uint64_t key = BreachFilter::keyFor("breached-" + std::to_string(i));
+        byShard[BreachFilter::shardOf(key)].push_back(key);
+    }
+    if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return;
+    for (uint32_t shard = 0; shard < BreachFilter::SHARD_COUNT; ++shard) {
+        std::ofstream file(dir + "/" + BreachFilter::shardFileName(shard), std::ios::binary);
+        file << BreachFilter::buildShard(shard, std::move(byShard[shard]), 1);
+    }
+
+    {
+        const BreachFilter filter(dir);
+        const std::string hit = "breached-4242";
+        const std::string miss = "Tr0ub4dor&3-not-breached";
+        bench.run("breach.check", {{"corpus", corpusSize}, {"result", "hit"}}, 0, 1, [&] {
+            keep(filter.check(hit));
+        });
+        bench.run("breach.check", {{"corpus", corpusSize}, {"result", "miss"}}, 0, 1, [&] {
+            keep(filter.check(miss));
+        });
+
+        // Vault-audit shape: keys hashed up front, one batch over all of them
+        std::vector<uint64_t> keys;
+        for (size_t i = 0; i < 1000; ++i) {
+            keys.push_back(BreachFilter::keyFor((i % 2 ? "breached-" : "unique-") + std::to_string(i * 7919)));
+        }
+        std::vector<BreachFilter::Status> statuses(keys.size());
+        bench.run("breach.check_keys", {{"corpus", corpusSize}, {"batch", "1000"}}, 0, keys.size(), [&] {
+            filter.checkKeys(keys.data(), keys.size(), statuses.data());
+            keep(statuses[0]);
+        });
+    }
+    for (uint32_t shard = 0; shard < BreachFilter::SHARD_COUNT; ++shard) {
+        std::remove((dir + "/" + BreachFilter::shardFileName(shard)).c_str());
+    }
+    std::remove(dir.c_str());
+}
+
+// ============================================================================
+// Synthetic vaults: search, JSON export, SQLite
+// ============================================================================
+
+const char* const SITES[] = {"mail", "bank", "shop", "github", "forum", "cloud", "travel", "news"};
+
+std::vector<PasswordEntry> makeVault(size_t count) {
+    std::vector<PasswordEntry> vault;
+    vault.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const std::string n = std::to_string(i);
+        const std::string site = SITES[i % (sizeof(SITES) / sizeof(SITES[0]))];
+        vault.emplace_back(site + " account " + n, "user" + n + "@example.com", "Pw!" + n + "-x9Q",
+                           static_cast<Category>(i % 6), "https://" + site + n + ".example.com",
+                           i % 4 == 0 ? "recovery codes in the safe" : "");
+        vault.back().setId(n);
+    }
+    return vault;
+}
+
+// ============================================================================
+// Record compression
+// ============================================================================
+
+void benchCompress(Bench& bench) {
+    if (!bench.enabled("compress")) return;
+
+    const std::string noteText =
+        "Recovery codes:\n4f7a-19c2 88d1-0b3e 5e6c-a0f4 c3b9-7d21\nSecurity question: What city were you born in?\n"
+        "Answer: Tromso\nAccount number: 0042-118-7730\nSupport: +1 800 555 0199\nRenewal date: 2027-03-01\n";
+    // Backup chunk shape: serialized entries back to back
+    std::string chunkText;
+    for (const PasswordEntry& entry : makeVault(2000)) entry.appendBinary(chunkText);
+    const std::vector<uint8_t> noise = SimpleAES::generateRandomBytes(4096);
+
+    struct Input {
+        const char* name;
+        const uint8_t* data;
+        size_t size;
+        RecordCompression::Dictionary dictionary;
+    };
+    const Input inputs[] = {
+        {"note", reinterpret_cast<const uint8_t*>(noteText.data()), noteText.size(), RecordCompression::Dictionary::TEXT},
+        {"chunk", reinterpret_cast<const uint8_t*>(chunkText.data()), chunkText.size(), RecordCompression::Dictionary::NONE},
+        {"random", noise.data(), noise.size(), RecordCompression::Dictionary::NONE},
+    };
+
+    const SimpleAES aes(SimpleAES::generateRandomBytes(32), SimpleAES::generateRandomBytes(16));
+    for (const Input& input : inputs) {
+        const std::string bytes = std::to_string(input.size);
+        const std::string sealed = RecordCompression::seal(aes, input.data, input.size, input.dictionary);
+        char ratio[16];
+        std::snprintf(ratio, sizeof(ratio), "%.3f", double(sealed.size()) / double(SimpleAES::recordSize(input.size)));
+
+        // Whole stage as the vault uses it, against plain record encryption
+        std::vector<uint8_t> record(SimpleAES::recordSize(input.size));
+        bench.run("compress.record.plain", {{"input", input.name}, {"bytes", bytes}}, input.size, 1, [&] {
+            keep(aes.encryptRecord(input.data, input.size, record.data(), record.size()));
+        });
+        bench.run("compress.record.seal", {{"input", input.name}, {"bytes", bytes}, {"size_ratio", ratio}},
+                  input.size, 1, [&] {
+            keep(RecordCompression::seal(aes, input.data, input.size, input.dictionary).size());
+        });
+        bench.run("compress.record.open", {{"input", input.name}, {"bytes", bytes}, {"size_ratio", ratio}},
+                  input.size, 1, [&] {
+            std::string plain = RecordCompression::open(aes, reinterpret_cast<const uint8_t*>(sealed.data()),
+                                                        sealed.size());
+            keep(plain.size());
+        });
+
+        // Raw codec throughput, no dictionary
+        std::vector<uint8_t> block(Lz4::compressBound(input.size));
+        const size_t blockSize = Lz4::compress(input.data, input.size, block.data(), block.size());
+        std::vector<uint8_t> back(input.size);
+        bench.run("compress.lz4.compress", {{"input", input.name}, {"bytes", bytes}}, input.size, 1, [&] {
+            keep(Lz4::compress(input.data, input.size, block.data(), block.size()));
+        });
+        bench.run("compress.lz4.decompress", {{"input", input.name}, {"bytes", bytes}}, input.size, 1, [&] {
+            keep(Lz4::decompress(block.data(), blockSize, back.data(), back.size()));
+        });
+    }
+}
+
+void benchSearch(Bench& bench, const std::vector<PasswordEntry>& vault) {
+    const std::string entries = std::to_string(vault.size());
+    SearchIndex index;
+
+    bench.run("search.index.build", {{"entries", entries}}, 0, vault.size(), [&] {
+        index.clear();
+        for (const PasswordEntry& e : vault) index.add(e.getId(), e.getTitle(), e.getUsername(), e.getWebsite());
+    });
+    index.clear();
+    for (const PasswordEntry& e : vault) index.add(e.getId(), e.getTitle(), e.getUsername(), e.getWebsite());
+
+    // A common term, a selective one, a single-entry hit and a miss
+    const char* const queries[] = {"shop", "user42", "github1234", "zzqx"};
+    for (const char* query : queries) {
+        bench.run("search.query", {{"entries", entries}, {"query", query}}, 0, 1, [&] {
+            keep(index.search(query, 50).size());
+        });
+    }
+}
+
+void benchAutofill(Bench& bench, const std::vector<PasswordEntry>& vault) {
+    const std::string entries = std::to_string(vault.size());
+    std::vector<std::string_view> websites;
+    websites.reserve(vault.size());
+    for (const PasswordEntry& e : vault) websites.emplace_back(e.getWebsite());
+    VaultIndex index;
+
+    // The batch normalisation PasswordManager runs when the vault loads
+    bench.run("autofill.index.build", {{"entries", entries}}, 0, vault.size(), [&] {
+        index.clear();
+        std::vector<std::string> domains = VaultIndex::registrableDomains(websites);
+        for (size_t i = 0; i < vault.size(); ++i) {
+            index.addNormalized(vault[i].getId(), vault[i].getCategory(), std::move(domains[i]), 0);
+        }
+    });
+
+    bench.run("autofill.match", {{"entries", entries}, {"source", "url"}}, 0, 1, [&] {
+        keep(index.idsForDomain("https://accounts.shop7.example.com/login?next=%2F").size());
+    });
+    bench.run("autofill.match", {{"entries", entries}, {"source", "package"}}, 0, 1, [&] {
+        keep(index.idsForPackage("com.example.shop.android").size());
+    });
+}
+
+void benchStore(Bench& bench, const std::vector<PasswordEntry>& vault) {
+    if (!bench.enabled("store")) return;
+    const std::string entries = std::to_string(vault.size());
+    EntryStore store;
+    store.reserve(vault.size());
+    for (const PasswordEntry& e : vault) store.put(EntryStore::keyFor(e.getId()), e);
+
+    // A list-view pass: titles of one category. The entry vector is the
+    // layout the store replaced; "full" assembles each entry like the
+    // PasswordEntry visitors do
+    bench.run("store.scan", {{"entries", entries}, {"layout", "entries"}}, 0, vault.size(), [&] {
+        size_t chars = 0;
+        for (const PasswordEntry& e : vault) {
+            if (e.getCategory() == Category::SHOPPING) chars += e.getTitle().size();
+        }
+        keep(chars);
+    });
+    bench.run("store.scan", {{"entries", entries}, {"layout", "columns"}}, 0, vault.size(), [&] {
+        size_t chars = 0;
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (store.category(i) == Category::SHOPPING) chars += store.row(i).title.size();
+        }
+        keep(chars);
+    });
+    bench.run("store.scan", {{"entries", entries}, {"layout", "full"}}, 0, vault.size(), [&] {
+        size_t chars = 0;
+        PasswordEntry scratch = store.entry(0);
+        for (size_t i = 0; i < store.size(); ++i) {
+            store.load(i, scratch);
+            if (scratch.getCategory() == Category::SHOPPING) chars += scratch.getTitle().size();
+        }
+        keep(chars);
+    });
+}
+
+void benchExport(Bench& bench, const std::vector<PasswordEntry>& vault) {
+    size_t bytes = 0;
+    {
+        JsonWriter probe([&](const char*, size_t size) { bytes += size; });
+        probe.beginObject().key("passwords").beginArray();
+        for (const PasswordEntry& e : vault) e.writeJson(probe);
+        probe.endArray().endObject();
+        probe.flush();
+    }
+
+    // Same document shape as PasswordManager::writeExport, streamed to a sink
+    bench.run("json.export", {{"entries", std::to_string(vault.size())}}, bytes, 1, [&] {
+        size_t written = 0;
+        JsonWriter json([&](const char*, size_t size) { written += size; });
+        json.beginObject().key("passwords").beginArray();
+        for (const PasswordEntry& e : vault) e.writeJson(json);
+        json.endArray().endObject();
+        json.flush();
+        keep(written);
+    });
+}
+
+#ifdef PASSWORDCORE_BENCH_SQLITE
+void benchDatabase(Bench& bench, const Options& options, const std::vector<PasswordEntry>& vault) {
+    const std::string entries = std::to_string(vault.size());
+    const std::string path = options.tmpdir + "/passwordcore_bench.db";
+    auto removeFiles = [&] {
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"}) std::remove((path + suffix).c_str());
+    };
+
+    bench.run("sqlite.insert", {{"entries", entries}}, 0, vault.size(), [&] {
+        removeFiles();
+        DatabaseManager db(path);
+        keep(db.savePasswords(vault));
+    });
+
+    removeFiles();
+    {
+        DatabaseManager db(path);
+        db.savePasswords(vault);
+    }
+    bench.run("sqlite.load", {{"entries", entries}}, 0, vault.size(), [&] {
+        DatabaseManager db(path);
+        keep(db.getAllPasswords().size());
+    });
+    removeFiles();
+}
+#endif
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time-ms" && hasValue) {
+            options.minTimeMs = std::max(1.0, std::atof(argv[++i]));
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (arg == "--tmpdir" && hasValue) {
+            options.tmpdir = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--quick] [--filter SUBSTRING] [--min-time-ms N] [--out FILE] [--tmpdir DIR]" << std::endl;
+            return false;
+        }
+    }
+    if (options.tmpdir.empty()) {
+        const char* env = std::getenv("TMPDIR");
+#ifdef __ANDROID__
+        options.tmpdir = env ? env : "/data/local/tmp";
+#else
+        options.tmpdir = env ? env : "/tmp";
+#endif
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) return 2;
+
+    // The library logs progress to std::cout; keep stdout for the report
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    // Entries seal their secrets under the published key, like in the app
+    CipherContext::publish(std::make_shared<const CipherContext>(std::unique_ptr<const SimpleAES>(
+        new SimpleAES(SimpleAES::generateRandomBytes(32), SimpleAES::generateRandomBytes(16)))));
+
+    Bench bench(options);
+    benchAES(bench);
+    benchKDF(bench, options);
+    benchBase64(bench);
+    benchBreach(bench, options);
+    benchCompress(bench);
+    for (size_t size : vaultSizes(options)) {
+        if (!bench.enabled("search") && !bench.enabled("autofill") && !bench.enabled("store") &&
+            !bench.enabled("json") && !bench.enabled("sqlite")) break;
+        const std::vector<PasswordEntry> vault = makeVault(size);
+        benchSearch(bench, vault);
+        benchAutofill(bench, vault);
+        benchStore(bench, vault);
+        benchExport(bench, vault);
+#ifdef PASSWORDCORE_BENCH_SQLITE
+        benchDatabase(bench, options, vault);
+#endif
+    }
+
+    std::cout.rdbuf(stdoutBuffer);
+    if (options.out.empty()) {
+        bench.write(std::cout);
+    } else {
+        std::ofstream file(options.out);
+        bench.write(file);
+        if (!file) {
+            std::cerr << "Could not write " << options.out << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+# Profile-guided optimization training for passwordcore
+#
+# The profile comes from passwordcore_bench, which drives the same hot paths
+# as the app: GCM record and field crypto, PBKDF2 unlock, base64, search and
+# the JSON export. Steps:
+#
+#   1. Configure an optimized build with the profile generator:
+#        cmake -S . -B build-pgo -DCMAKE_BUILD_TYPE=Release \
+#              -DPASSWORDCORE_BENCH=ON -DSECUREFLOW_PGO=GENERATE
+#   2. Train and merge:
+#        host:   cmake --build build-pgo --target pgo-train
+#        device: build with the NDK toolchain for the ABI, then
+#                adb push build-pgo/passwordcore_bench /data/local/tmp/
+#                adb shell LLVM_PROFILE_FILE=/data/local/tmp/pc-%p.profraw \
+#                    /data/local/tmp/passwordcore_bench --quick \
+#                    --tmpdir /data/local/tmp
+#                adb pull /data/local/tmp/<the .profraw files> build-pgo/pgo-raw/
+#                cmake -DRAW_DIR=build-pgo/pgo-raw -DPROFILE_DIR=pgo \
+#                      -DABI=arm64-v8a -DCOMPILER=Clang -DLLVM_PROFDATA=<ndk>/llvm-profdata \
+#                      -P pgo_train.cmake
+#   3. Commit pgo/<abi>.profdata and build with -DSECUREFLOW_PGO=USE (the
+#      Gradle release build passes it through cmake.arguments). ABIs without
+#      a profile build normally.
+#
+# Clang profiles are mostly tolerant of source changes; retrain after large
+# changes to the hot paths. GCC .gcda trees are tied to the build directory
+# that produced them and are only practical for host experiments.
+#
+# Inputs: BENCH (optional; run when set), RAW_DIR, PROFILE_DIR, ABI,
+# COMPILER, LLVM_PROFDATA (Clang only)
+
+cmake_minimum_required(VERSION 3.18.1)
+
+foreach(var RAW_DIR PROFILE_DIR ABI COMPILER)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "pgo_train.cmake: ${var} is required")
+    endif()
+endforeach()
+
+if(BENCH)
+    file(REMOVE_RECURSE ${RAW_DIR})
+    file(MAKE_DIRECTORY ${RAW_DIR})
+    set(ENV{LLVM_PROFILE_FILE} "${RAW_DIR}/passwordcore-%p.profraw")
+    execute_process(
+            COMMAND ${BENCH} --quick --out ${RAW_DIR}/training.json --tmpdir ${RAW_DIR}
+            RESULT_VARIABLE bench_result
+    )
+    if(NOT bench_result EQUAL 0)
+        message(FATAL_ERROR "passwordcore_bench failed: ${bench_result}")
+    endif()
+endif()
+
+file(MAKE_DIRECTORY ${PROFILE_DIR})
+if(COMPILER MATCHES "Clang")
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "llvm-profdata not found; pass -DLLVM_PROFDATA=")
+    endif()
+    file(GLOB raw_profiles "${RAW_DIR}/*.profraw")
+    if(NOT raw_profiles)
+        message(FATAL_ERROR "No .profraw files in ${RAW_DIR}")
+    endif()
+    execute_process(
+            COMMAND ${LLVM_PROFDATA} merge -output=${PROFILE_DIR}/${ABI}.profdata ${raw_profiles}
+            RESULT_VARIABLE merge_result
+    )
+    if(NOT merge_result EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge failed: ${merge_result}")
+    endif()
+    message(STATUS "Wrote ${PROFILE_DIR}/${ABI}.profdata")
+else()
+    # GCC reads the .gcda tree directly; there is nothing to merge
+    file(REMOVE_RECURSE ${PROFILE_DIR}/${ABI}-gcc)
+    file(COPY ${RAW_DIR}/ DESTINATION ${PROFILE_DIR}/${ABI}-gcc FILES_MATCHING PATTERN "*.gcda")
+    message(STATUS "Wrote ${PROFILE_DIR}/${ABI}-gcc")
+endif()
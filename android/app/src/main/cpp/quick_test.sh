@@ -16,9 +16,9 @@ echo ""
 
 # Build test suite (without AES to avoid Crypto++ dependency)
 echo "📦 Compiling test suite (XOR + NoEncrypt only)..."
+# EncryptionContext is defined inline in its header
 g++ -std=c++17 -Wall -Wextra -o test_strategy \
     test_strategy_pattern.cpp \
-    core/EncryptionContext.cpp \
     core/XOREncryptionStrategy.cpp \
     core/NoEncryptionStrategy.cpp
 
@@ -30,6 +30,21 @@ if [ $? -eq 0 ]; then
     ./test_strategy
     exit_code=$?
     echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+
+    # Vault core behaviour tests link the whole library: built through CMake
+    if command -v cmake &> /dev/null; then
+        echo ""
+        echo "🧪 Running vault core behaviour tests..."
+        build_dir=$(mktemp -d)
+        cmake -S . -B "$build_dir" -DCMAKE_BUILD_TYPE=Debug > /dev/null &&
+            cmake --build "$build_dir" --target test_core_behaviour -j > /dev/null &&
+            "$build_dir/test_core_behaviour"
+        [ $? -eq 0 ] || exit_code=1
+        rm -rf "$build_dir"
+        echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+    else
+        echo "⚠️  cmake not found: vault core behaviour tests skipped"
+    fi
     
     if [ $exit_code -eq 0 ]; then
         echo ""
@@ -0,0 +1,726 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "core/CipherContext.h"
+#include "core/EntryStore.h"
+#include "core/KeyRotation.h"
+#include "core/Lz4.h"
+#include "core/PBKDF2.h"
+#include "core/RecordCompression.h"
+#include "core/SimpleAES.h"
+#include "core/StorageManager.h"
+#ifdef PASSWORDCORE_TESTS_SQLITE
+#include <atomic>
+#include "core/DatabaseManager.h"
+#include "core/RekeyMigration.h"
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Behaviour tests for the vault core: records, KDF, compression,
+ * storage, key rotation and the change journal
+ *
+ * Built by CMake as test_core_behaviour (run through ctest) and by
+ * quick_test.sh. Files go to a scratch directory that is removed again.
+ */
+
+int passCount = 0;
+int failCount = 0;
+
+void test(const string& name, bool condition) {
+    if (condition) {
+        cout << "✅ PASS: " << name << "\n";
+        passCount++;
+    } else {
+        cout << "❌ FAIL: " << name << "\n";
+        failCount++;
+    }
+}
+
+const uint8_t* bytes(const string& s) { return reinterpret_cast<const uint8_t*>(s.data()); }
+
+vector<uint8_t> readFile(const fs::path& path) {
+    ifstream in(path, ios::binary);
+    return vector<uint8_t>(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+void writeFile(const fs::path& path, const vector<uint8_t>& data) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+}
+
+uint64_t loadLE(const uint8_t* p, size_t width) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; ++i) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return value;
+}
+
+string hex(const SecureBuffer& data) {
+    static const char digits[] = "0123456789abcdef";
+    string out;
+    for (uint8_t b : data) {
+        out += digits[b >> 4];
+        out += digits[b & 15];
+    }
+    return out;
+}
+
+// Key material as the FFI derives it: primary then legacy, 32-byte key + 16-byte IV each
+SecureBuffer materialFrom(uint8_t seed) {
+    SecureBuffer material(KeyRotation::MATERIAL_SIZE);
+    for (size_t i = 0; i < material.size(); ++i) material[i] = static_cast<uint8_t>(seed + i * 7);
+    return material;
+}
+
+shared_ptr<const CipherContext> contextFrom(const SecureBuffer& material) {
+    const uint8_t* legacy = material.data() + KeyRotation::MATERIAL_SIZE / 2;
+    return make_shared<const CipherContext>(
+        unique_ptr<const SimpleAES>(new SimpleAES(material.data(), material.data() + 32)),
+        unique_ptr<const SimpleAES>(new SimpleAES(legacy, legacy + 32)));
+}
+
+template <typename Keys>
+bool opens(const Keys& keys, const vector<uint8_t>& record, const string& expected,
+           const uint8_t* context = nullptr, size_t contextLength = 0) {
+    try {
+        vector<uint8_t> out(record.size());
+        size_t n = keys.decryptRecord(record.data(), record.size(), out.data(), out.size(), nullptr,
+                                      context, contextLength);
+        return string(out.begin(), out.begin() + n) == expected;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+void testGcmRecords() {
+    cout << "\n=== Testing GCM Records ===\n";
+
+    SecureBuffer material = materialFrom(1);
+    SimpleAES aes(material.data(), material.data() + 32);
+    const string plain = "correct horse battery staple";
+    const uint8_t context[] = {1, 2, 3, 4};
+
+    // Test 1: Round trip
+    vector<uint8_t> record(SimpleAES::recordSize(plain.size()));
+    size_t n = aes.encryptRecord(bytes(plain), plain.size(), record.data(), record.size(), 0, context, sizeof(context));
+    test("Record has the documented size", n == SimpleAES::RECORD_OVERHEAD + plain.size());
+    test("Record carries a header", SimpleAES::isRecord(record.data(), record.size()));
+    test("Record round trip", opens(aes, record, plain, context, sizeof(context)));
+
+    // Test 2: Fresh nonce per record
+    vector<uint8_t> again(record.size());
+    aes.encryptRecord(bytes(plain), plain.size(), again.data(), again.size(), 0, context, sizeof(context));
+    test("Records of the same plaintext differ", again != record);
+
+    // Test 3: Anything altered fails authentication
+    vector<uint8_t> tampered = record;
+    tampered.back() ^= 0x01;
+    test("Altered ciphertext is rejected", !opens(aes, tampered, plain, context, sizeof(context)));
+    tampered = record;
+    tampered[SimpleAES::RECORD_HEADER_SIZE + 2] ^= 0x80;
+    test("Altered nonce is rejected", !opens(aes, tampered, plain, context, sizeof(context)));
+    tampered = record;
+    tampered[5] ^= 0x01;
+    test("Altered header is rejected", !opens(aes, tampered, plain, context, sizeof(context)));
+    const uint8_t otherContext[] = {1, 2, 3, 5};
+    test("Other context is rejected", !opens(aes, record, plain, otherContext, sizeof(otherContext)));
+    test("Missing context is rejected", !opens(aes, record, plain));
+
+    SecureBuffer otherMaterial = materialFrom(2);
+    SimpleAES other(otherMaterial.data(), otherMaterial.data() + 32);
+    test("Other key is rejected", !opens(other, record, plain, context, sizeof(context)));
+
+    // Test 4: Base64 form
+    const string cipher = aes.encrypt(plain);
+    test("Base64 record round trip", aes.decrypt(cipher) == plain);
+    test("Base64 record has the record prefix", SimpleAES::hasRecordPrefix(cipher.data(), cipher.size()));
+    bool rejected = false;
+    try {
+        other.decrypt(cipher);
+    } catch (const exception&) {
+        rejected = true;
+    }
+    test("Base64 record under another key is rejected", rejected);
+}
+
+// Ciphertexts written by the pre-GCM SimpleAES (key 00..1f, IV a0..af), whose
+// rounds differ from FIPS-197; they must stay readable through the CBC path
+void testLegacyCbc() {
+    cout << "\n=== Testing Legacy CBC ===\n";
+
+    vector<uint8_t> key(32);
+    vector<uint8_t> iv(16);
+    for (size_t i = 0; i < key.size(); ++i) key[i] = static_cast<uint8_t>(i);
+    for (size_t i = 0; i < iv.size(); ++i) iv[i] = static_cast<uint8_t>(0xa0 + i);
+    SimpleAES aes(key, iv);
+
+    const pair<string, string> written[] = {
+        {"hunter2", "hCP/CssIvWT7WboosjMWEA=="},
+        {"twelve chars", "5LmzRvVVf7ePdj31uDdZRw=="},
+        {"a sixteen-byte p", "O5jyxEwEyAgfh65kYLL5CrPi3/YJgl5IjlwojsTx/rc="},
+        {"correct horse battery staple", "Fp9/vXYnWOsAQSylBJg8Nanlbz0D6EXQ4oQ5SqfWXLo="},
+    };
+    size_t opened = 0;
+    for (const auto& entry : written) {
+        try {
+            if (aes.decrypt(entry.second) == entry.first) opened++;
+        } catch (const exception&) {
+        }
+    }
+    test("Ciphertexts from older builds decrypt", opened == size(written));
+
+    // Test 2: Writing CBC reproduces them byte for byte
+    SimpleAES writer(key, iv);
+    writer.setWriteMode(SimpleAES::Mode::CBC);
+    test("CBC writes what older builds wrote", writer.encrypt(written[1].first) == written[1].second);
+
+    // Test 3: Only the legacy key of a context reads them
+    SecureBuffer material = materialFrom(80);
+    CipherContext keys(unique_ptr<const SimpleAES>(new SimpleAES(material.data(), material.data() + 32)),
+                       unique_ptr<const SimpleAES>(new SimpleAES(key, iv)));
+    const string& cipher = written[3].second;
+    vector<uint8_t> out(SimpleAES::maxPlaintextSize(cipher.size()));
+    size_t n = 0;
+    try {
+        n = keys.decryptInto(cipher.data(), cipher.size(), out.data(), out.size());
+    } catch (const exception&) {
+    }
+    test("Context reads them with its legacy key", string(out.begin(), out.begin() + n) == written[3].first);
+
+    // Test 4: A loaded legacy key is derived only once a CBC ciphertext turns up
+    size_t loads = 0;
+    CipherContext lazy(unique_ptr<const SimpleAES>(new SimpleAES(material.data(), material.data() + 32)), nullptr,
+                       [&]() {
+                           loads++;
+                           return unique_ptr<const SimpleAES>(new SimpleAES(key, iv));
+                       });
+    const string record = lazy.aes().encrypt("no legacy needed");
+    vector<uint8_t> plain(SimpleAES::maxPlaintextSize(record.size()));
+    lazy.decryptInto(record.data(), record.size(), plain.data(), plain.size());
+    test("GCM reads do not load the legacy key", loads == 0);
+    n = 0;
+    for (int i = 0; i < 2; ++i) {
+        try {
+            n = lazy.decryptInto(cipher.data(), cipher.size(), out.data(), out.size());
+        } catch (const exception&) {
+        }
+    }
+    test("Legacy key is loaded once, on the first CBC read",
+         loads == 1 && string(out.begin(), out.begin() + n) == written[3].first);
+}
+
+void testPbkdf2() {
+    cout << "\n=== Testing PBKDF2-HMAC-SHA256 ===\n";
+
+    // RFC 7914 section 11 vectors; 64 bytes span two blocks
+    const vector<uint8_t> salt = {'s', 'a', 'l', 't'};
+    test("RFC 7914 vector, 1 iteration",
+         hex(PBKDF2::deriveKey(string("passwd"), salt, 1, 64)) ==
+         "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+         "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783");
+
+    const vector<uint8_t> nacl = {'N', 'a', 'C', 'l'};
+    uint32_t lastDone = 0;
+    uint32_t lastTotal = 0;
+    SecureBuffer derived = PBKDF2::deriveKey(string("Password"), nacl, 80000, 64,
+                                             [&](uint32_t done, uint32_t total) {
+                                                 lastDone = done;
+                                                 lastTotal = total;
+                                             });
+    test("RFC 7914 vector, 80000 iterations",
+         hex(derived) ==
+         "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+         "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d");
+    test("Progress is reported against the iteration count",
+         lastTotal == 80000 && lastDone > 0 && lastDone < lastTotal);
+
+    // Test 3: Output is a prefix of a longer derivation
+    SecureBuffer shorter = PBKDF2::deriveKey(string("passwd"), salt, 1, 20);
+    test("Shorter output is a prefix", hex(shorter) == "55ac046e56e3089fec1691c22544b605f9418521");
+
+    bool caughtException = false;
+    try {
+        PBKDF2::deriveKey(string("passwd"), salt, 0, 32);
+    } catch (const invalid_argument&) {
+        caughtException = true;
+    }
+    test("Zero iterations are rejected", caughtException);
+}
+
+void testLz4() {
+    cout << "\n=== Testing LZ4 Blocks ===\n";
+
+    string text;
+    for (int i = 0; i < 200; ++i) text += "user" + to_string(i % 17) + "@example.com password reset; ";
+    vector<uint8_t> block(Lz4::compressBound(text.size()));
+    size_t n = Lz4::compress(bytes(text), text.size(), block.data(), block.size());
+    test("Repetitive text compresses", n > 0 && n < text.size() / 4);
+
+    // Test 1: Round trip
+    string back(text.size(), '\0');
+    bool ok = Lz4::decompress(block.data(), n, reinterpret_cast<uint8_t*>(&back[0]), back.size());
+    test("Block round trip", ok && back == text);
+
+    // Test 2: Dictionary round trip
+    const string dictionary = "https://accounts.example.com/login?user=";
+    const string shortText = "https://accounts.example.com/login?user=alice";
+    vector<uint8_t> small(Lz4::compressBound(shortText.size()));
+    size_t m = Lz4::compress(bytes(shortText), shortText.size(), small.data(), small.size(),
+                             bytes(dictionary), dictionary.size());
+    string shortBack(shortText.size(), '\0');
+    ok = m > 0 && Lz4::decompress(small.data(), m, reinterpret_cast<uint8_t*>(&shortBack[0]), shortBack.size(),
+                                  bytes(dictionary), dictionary.size());
+    test("Dictionary round trip", ok && shortBack == shortText);
+    test("Dictionary block needs its dictionary",
+         !Lz4::decompress(small.data(), m, reinterpret_cast<uint8_t*>(&shortBack[0]), shortBack.size()));
+
+    // Test 3: Malformed blocks are rejected, never overrun
+    test("Truncated block is rejected",
+         !Lz4::decompress(block.data(), n / 2, reinterpret_cast<uint8_t*>(&back[0]), back.size()));
+    test("Wrong length is rejected",
+         !Lz4::decompress(block.data(), n, reinterpret_cast<uint8_t*>(&back[0]), back.size() - 1));
+    bool allRejected = true;
+    for (size_t i = 0; i < n; i += 7) {
+        vector<uint8_t> corrupt(block.begin(), block.begin() + n);
+        corrupt[i] ^= 0xFF;
+        string out(text.size(), '\0');
+        if (Lz4::decompress(corrupt.data(), n, reinterpret_cast<uint8_t*>(&out[0]), out.size()) && out == text) {
+            allRejected = false;
+        }
+    }
+    test("Corrupted blocks never decode to the original", allRejected);
+    const uint8_t farOffset[] = {0x1F, 'a', 0xFF, 0xFF, 0x00};
+    uint8_t tiny[32];
+    test("Offset before the output is rejected", !Lz4::decompress(farOffset, sizeof(farOffset), tiny, sizeof(tiny)));
+
+    // Test 4: Through a sealed record
+    SecureBuffer material = materialFrom(3);
+    SimpleAES aes(material.data(), material.data() + 32);
+    string record = RecordCompression::seal(aes, bytes(text), text.size(), RecordCompression::Dictionary::TEXT);
+    test("Sealed record is compressed", record.size() < text.size());
+    test("Sealed record opens",
+         RecordCompression::open(aes, bytes(record), record.size()) == text);
+    record[record.size() / 2] ^= 0x01;
+    bool caughtException = false;
+    try {
+        RecordCompression::open(aes, bytes(record), record.size());
+    } catch (const runtime_error&) {
+        caughtException = true;
+    }
+    test("Corrupted sealed record throws", caughtException);
+}
+
+void testEntryStore() {
+    cout << "\n=== Testing EntryStore ===\n";
+
+    EntryStore store;
+    for (int id = 1; id <= 4; ++id) {
+        PasswordEntry entry("title" + to_string(id), "user", "secret" + to_string(id));
+        entry.setId(to_string(id));
+        store.put(EntryStore::keyFor(to_string(id)), entry);
+    }
+    test("Four entries stored", store.size() == 4);
+
+    // Test 1: Erase moves the last row into the gap
+    test("Erase finds the key", store.erase(EntryStore::keyFor("2")));
+    test("Erased entry is gone", !store.contains(EntryStore::keyFor("2")) && store.size() == 3);
+    test("Erasing again fails", !store.erase(EntryStore::keyFor("2")));
+    test("Update of an erased key fails",
+         !store.update(EntryStore::keyFor("2"), PasswordEntry("x", "y", "z")));
+    optional<PasswordEntry> moved = store.find(EntryStore::keyFor("4"));
+    test("Moved entry is intact", moved && moved->getTitle() == "title4" && moved->getPassword() == "secret4");
+    test("Moved entry is indexed at its new row",
+         store.indexOf(EntryStore::keyFor("4")) != EntryStore::NOT_FOUND &&
+         store.row(store.indexOf(EntryStore::keyFor("4"))).title == "title4");
+
+    // Test 2: Erase down to empty, then reuse
+    store.erase(EntryStore::keyFor("1"));
+    store.erase(EntryStore::keyFor("3"));
+    store.erase(EntryStore::keyFor("4"));
+    test("Store is empty", store.empty());
+    store.put(EntryStore::keyFor("7"), PasswordEntry("again", "user", "secret"));
+    test("Store is usable after erasing everything",
+         store.size() == 1 && store.find(EntryStore::keyFor("7"))->getTitle() == "again");
+}
+
+void testStorageManager(const fs::path& scratch) {
+    cout << "\n=== Testing StorageManager Integrity ===\n";
+
+    const fs::path directory = scratch / "vault";
+    fs::create_directories(directory);
+    const fs::path path = directory / "vault.sfv";
+    {
+        StorageManager storage(directory.string(), "correct horse");
+        vector<PasswordEntry> entries = {PasswordEntry("a", "u", "p1"), PasswordEntry("b", "u", "p2")};
+        test("Vault saves", storage.savePasswords(entries) && storage.saveUserData("k", "v"));
+    }
+    {
+        StorageManager storage(directory.string(), "correct horse");
+        vector<PasswordEntry> loaded = storage.loadPasswords();
+        test("Vault reloads", loaded.size() == 2 && loaded[0].getPassword() == "p1" &&
+                              loaded[1].getPassword() == "p2" && storage.loadUserData("k") == "v");
+    }
+    {
+        StorageManager storage(directory.string(), "wrong");
+        test("Wrong password opens nothing", storage.loadPasswords().empty());
+    }
+
+    // Index layout: offset 8, length 4, kind 1 per 24-byte entry, after the verifier
+    const vector<uint8_t> good = readFile(path);
+    const uint64_t index = loadLE(&good[40], 8);
+    auto offsetOf = [&](const vector<uint8_t>& d, size_t r) { return loadLE(&d[index + r * 24], 8); };
+    auto lengthOf = [&](const vector<uint8_t>& d, size_t r) { return loadLE(&d[index + r * 24 + 8], 4); };
+
+    // Test 1: A changed index is caught by its MAC
+    {
+        vector<uint8_t> d = good;
+        d[index + 24 + 12] = 2;   // Entry record relabelled as user data
+        writeFile(path, d);
+        StorageManager storage(directory.string(), "correct horse");
+        test("Altered index is rejected", storage.getPasswordCount() == 0);
+    }
+
+    // Test 2: Records swapped in place no longer open in their slots
+    {
+        vector<uint8_t> d = good;
+        const uint64_t first = offsetOf(d, 1);
+        const uint64_t second = offsetOf(d, 2);
+        const uint64_t length = lengthOf(d, 1);
+        if (length == lengthOf(d, 2)) {
+            vector<uint8_t> saved(d.begin() + first, d.begin() + first + length);
+            copy(d.begin() + second, d.begin() + second + length, d.begin() + first);
+            copy(saved.begin(), saved.end(), d.begin() + second);
+        }
+        writeFile(path, d);
+        StorageManager storage(directory.string(), "correct horse");
+        test("Swapped records are rejected",
+             storage.getPasswordCount() == 2 && storage.loadPasswords().empty() && !storage.loadPassword(0));
+    }
+
+    // Test 3: A flipped record byte fails that record
+    {
+        vector<uint8_t> d = good;
+        d[offsetOf(d, 2) + lengthOf(d, 2) - 1] ^= 0x01;
+        writeFile(path, d);
+        StorageManager storage(directory.string(), "correct horse");
+        test("Altered record is rejected", !storage.loadPassword(1));
+    }
+
+    // Test 4: Truncation
+    {
+        vector<uint8_t> d(good.begin(), good.begin() + good.size() / 2);
+        writeFile(path, d);
+        StorageManager storage(directory.string(), "correct horse");
+        test("Truncated vault opens nothing", storage.loadPasswords().empty());
+    }
+}
+
+// Every store this build requires confirms; returns the last answer
+KeyRotation::Confirmation confirmAll(uint64_t rotation, const shared_ptr<const CipherContext>& keys) {
+    KeyRotation::Confirmation last = KeyRotation::Confirmation::STALE;
+    for (KeyRotation::Store store : {KeyRotation::STORE_VAULT, KeyRotation::STORE_CALLER}) {
+        if (KeyRotation::stores() & store) last = KeyRotation::confirm(rotation, store, keys);
+    }
+    return last;
+}
+
+void testKeyRotation(const fs::path& scratch) {
+    cout << "\n=== Testing Key Rotation ===\n";
+
+    const fs::path state = scratch / "rekey_state.bin";
+    KeyRotation::setPath(state.string());
+
+    SecureBuffer oldMaterial = materialFrom(10);
+    SecureBuffer newMaterial = materialFrom(20);
+    shared_ptr<const CipherContext> oldKeys = contextFrom(oldMaterial);
+    shared_ptr<const CipherContext> newKeys = contextFrom(newMaterial);
+    CipherContext::publish(oldKeys);
+
+    const string plain = "written before the change";
+    vector<uint8_t> record(SimpleAES::recordSize(plain.size()));
+    oldKeys->encryptRecord(bytes(plain), plain.size(), record.data(), record.size());
+
+    // Test 1: Begin records the retiring generation durably
+    shared_ptr<const CipherContext> rotating = KeyRotation::begin(oldKeys, oldMaterial, newKeys);
+    const uint64_t rotation = KeyRotation::pending();
+    test("Rotation begins", rotating && rotating->isRotating() && rotation != 0);
+    test("State file written", fs::exists(state));
+    if (!rotating) return;
+    test("New key alone cannot read old records", !opens(*newKeys, record, plain));
+    test("Rotating keys read old records", opens(*rotating, record, plain));
+
+    // Test 2: After process death the new keys pick the rotation up again
+    shared_ptr<const CipherContext> resumed = KeyRotation::resume(newKeys);
+    test("Resume restores the retiring keys", resumed->isRotating() && opens(*resumed, record, plain));
+    test("Resume under the wrong keys does nothing", !KeyRotation::resume(oldKeys)->isRotating());
+
+    // Test 3: Reseal moves a record to the new key
+    vector<uint8_t> resealed;
+    test("Reseal rewrites an old record", rotating->resealRecord(record.data(), record.size(), resealed));
+    test("Resealed record opens under the new key", opens(*newKeys, resealed, plain));
+    vector<uint8_t> untouched;
+    test("Reseal leaves a current record alone",
+         !rotating->resealRecord(resealed.data(), resealed.size(), untouched));
+
+    // Test 4: Only the pending rotation can be confirmed, and only once all stores have
+    test("Other rotation id is stale",
+         KeyRotation::confirm(rotation + 1, KeyRotation::STORE_CALLER, newKeys) ==
+         KeyRotation::Confirmation::STALE);
+    test("Last confirmation finishes the rotation",
+         confirmAll(rotation, newKeys) == KeyRotation::Confirmation::FINISHED);
+    test("Nothing pending afterwards", KeyRotation::pending() == 0 && !fs::exists(state));
+    shared_ptr<const CipherContext> published = CipherContext::current();
+    test("Published keys drop the retiring chain", published && !published->isRotating());
+    test("Old records are unreadable once finished", !opens(*KeyRotation::resume(newKeys), record, plain));
+
+    CipherContext::publish(nullptr);
+}
+
+// Base64 text as cpp_reseal_aes_batch handles it. A 12-byte plaintext makes
+// a block-aligned record, which an old CBC fallback read as garbage under
+// the new key instead of moving on to the retiring one
+void testResealText() {
+    cout << "\n=== Testing Base64 Reseal ===\n";
+
+    SecureBuffer oldMaterial = materialFrom(30);
+    SecureBuffer newMaterial = materialFrom(40);
+    shared_ptr<const CipherContext> oldKeys = contextFrom(oldMaterial);
+    CipherContext newKeys(unique_ptr<const SimpleAES>(new SimpleAES(newMaterial.data(), newMaterial.data() + 32)));
+    CipherContext rotating(newKeys, oldKeys);
+
+    const size_t count = 4000;
+    size_t wrong = 0;
+    size_t unreadable = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char plain[16];
+        snprintf(plain, sizeof(plain), "pw-%09zu", i);
+        const size_t length = strlen(plain);
+        try {
+            string cipher(SimpleAES::ciphertextSize(length), '\0');
+            oldKeys->encryptInto(bytes(plain), length, &cipher[0], cipher.size());
+
+            vector<uint8_t> out(SimpleAES::maxPlaintextSize(cipher.size()));
+            size_t n = rotating.decryptInto(cipher.data(), cipher.size(), out.data(), out.size());
+            string resealed(SimpleAES::ciphertextSize(n), '\0');
+            rotating.encryptInto(out.data(), n, &resealed[0], resealed.size());
+
+            n = newKeys.decryptInto(resealed.data(), resealed.size(), out.data(), out.size());
+            if (string(out.begin(), out.begin() + n) != plain) wrong++;
+        } catch (const exception&) {
+            unreadable++;
+        }
+    }
+    test("12-byte plaintexts survive a reseal", wrong == 0 && unreadable == 0);
+}
+
+#ifdef PASSWORDCORE_TESTS_SQLITE
+void testJournal(const fs::path& scratch) {
+    cout << "\n=== Testing Change Journal ===\n";
+
+    DatabaseManager db((scratch / "journal.db").string());
+    const int64_t a = db.savePassword(PasswordEntry("a", "u", "p1"));
+    const int64_t b = db.savePassword(PasswordEntry("b", "u", "p2"));
+    test("Rows saved", a > 0 && b > 0);
+
+    // Test 1: Latest change per entry, in sequence order
+    PasswordEntry changed("a2", "u", "p1");
+    changed.setId(to_string(a));
+    test("Row updated", db.updatePassword(changed));
+    test("Row deleted", db.deletePassword(b));
+    vector<JournalChange> changes;
+    test("changesSince(0) succeeds", db.changesSince(0, 100, changes));
+    test("One change per entry", changes.size() == 2);
+    if (changes.size() == 2) {
+        test("Changes come in sequence order", changes[0].seq < changes[1].seq);
+        test("Update carries the current row",
+             changes[0].id == a && changes[0].entry && changes[0].entry->getTitle() == "a2");
+        test("Deletion is a tombstone", changes[1].id == b && !changes[1].entry);
+    }
+
+    // Test 2: Nothing after the head
+    const int64_t head = db.journalHead();
+    changes.clear();
+    test("Nothing new after the head", head > 0 && db.changesSince(head, 100, changes) && changes.empty());
+}
+
+// A sealed legacy CBC secret must never be stored as its plaintext
+void testSealedLegacySecret(const fs::path& scratch) {
+    cout << "\n=== Testing Sealed Legacy Secrets ===\n";
+
+    vector<uint8_t> key(32);
+    vector<uint8_t> iv(16);
+    for (size_t i = 0; i < key.size(); ++i) key[i] = static_cast<uint8_t>(i);
+    for (size_t i = 0; i < iv.size(); ++i) iv[i] = static_cast<uint8_t>(0xa0 + i);
+    const string cipher = "hCP/CssIvWT7WboosjMWEA==";   // "hunter2", see testLegacyCbc
+    SecureBuffer material = materialFrom(90);
+    CipherContext::publish(make_shared<const CipherContext>(
+            unique_ptr<const SimpleAES>(new SimpleAES(material.data(), material.data() + 32)),
+            unique_ptr<const SimpleAES>(new SimpleAES(key, iv))));
+
+    DatabaseManager db((scratch / "legacy.db").string());
+
+    // Test 1: Re-sealed as a record while the keys open it
+    PasswordEntry entry("a", "u", "");
+    entry.setEncryptedPassword(cipher);
+    optional<PasswordEntry> stored = db.getPasswordById(db.savePassword(entry));
+    test("Legacy secret is stored as a record",
+         stored && stored->isPasswordEncrypted() && stored->getSealedPassword().encoding() == LazySecret::Encoding::RECORD);
+    test("Record opens to the same plaintext", stored && stored->getPassword() == "hunter2");
+
+    // Test 2: Kept as it is without keys
+    CipherContext::publish(nullptr);
+    PasswordEntry locked("b", "u", "");
+    locked.setEncryptedPassword(cipher);
+    stored = db.getPasswordById(db.savePassword(locked));
+    test("Without keys the ciphertext is stored unchanged", stored && stored->getPassword() == cipher);
+}
+
+void testRekeyJournaling(const fs::path& scratch) {
+    cout << "\n=== Testing Re-key Journaling ===\n";
+
+    KeyRotation::setPath((scratch / "rekey_journal_state.bin").string());
+    SecureBuffer oldMaterial = materialFrom(30);
+    SecureBuffer newMaterial = materialFrom(40);
+    shared_ptr<const CipherContext> oldKeys = contextFrom(oldMaterial);
+    shared_ptr<const CipherContext> newKeys = contextFrom(newMaterial);
+    CipherContext::publish(oldKeys);
+
+    DatabaseManager db((scratch / "rekey.db").string());
+    // Base64 records handed in as the value are stored as sealed BLOBs
+    const int64_t a = db.savePassword(PasswordEntry("a", "u", oldKeys->aes().encrypt("secret-a")));
+    const int64_t b = db.savePassword(PasswordEntry("b", "u", oldKeys->aes().encrypt("secret-b")));
+    const int64_t head = db.journalHead();
+
+    shared_ptr<const CipherContext> rotating = KeyRotation::begin(oldKeys, oldMaterial, newKeys);
+    const uint64_t rotation = KeyRotation::pending();
+    test("Rotation begins", rotating != nullptr);
+    if (!rotating) return;
+    CipherContext::publish(rotating);
+
+    // Test 1: The pass rewrites both rows and journals them
+    int64_t cursor = db.rekeyCheckpoint(rotation);
+    RekeyTally tally;
+    int64_t examined = 0;
+    int64_t batch;
+    while ((batch = db.rekeyRecords(*rotating, rotation, cursor, 1, &tally)) > 0) examined += batch;
+    test("Pass completes", batch == 0 && examined == 2);
+    test("Both rows rewritten", tally.rewritten == 2 && tally.unreadable == 0);
+    vector<JournalChange> changes;
+    test("Re-keyed rows are journaled", db.changesSince(head, 100, changes) && changes.size() == 2);
+
+    // Test 2: A second pass finds nothing to do and journals nothing
+    const int64_t afterPass = db.journalHead();
+    cursor = 0;
+    RekeyTally second;
+    while (db.rekeyRecords(*rotating, rotation, cursor, 16, &second) > 0) {
+    }
+    test("Second pass rewrites nothing", second.rewritten == 0 && db.journalHead() == afterPass);
+
+    // Test 3: Rows read under the new key alone once the rotation ends
+    test("Rotation finishes", confirmAll(rotation, newKeys) == KeyRotation::Confirmation::FINISHED);
+    CipherContext::publish(newKeys);
+    optional<PasswordEntry> entryA = db.getPasswordById(a);
+    optional<PasswordEntry> entryB = db.getPasswordById(b);
+    test("Rows open under the new key",
+         entryA && entryB && entryA->getPassword() == "secret-a" && entryB->getPassword() == "secret-b");
+
+    CipherContext::publish(nullptr);
+}
+
+void testRekeyUnreadable(const fs::path& scratch) {
+    cout << "\n=== Testing Re-key With Unreadable Rows ===\n";
+
+    KeyRotation::setPath((scratch / "rekey_unreadable_state.bin").string());
+    SecureBuffer oldMaterial = materialFrom(50);
+    SecureBuffer newMaterial = materialFrom(60);
+    SecureBuffer strayMaterial = materialFrom(70);
+    shared_ptr<const CipherContext> oldKeys = contextFrom(oldMaterial);
+    shared_ptr<const CipherContext> newKeys = contextFrom(newMaterial);
+    const string path = (scratch / "rekey_unreadable.db").string();
+
+    int64_t stray;
+    {
+        DatabaseManager db(path);
+        db.savePassword(PasswordEntry("a", "u", oldKeys->aes().encrypt("secret-a")));
+        stray = db.savePassword(PasswordEntry("b", "u", contextFrom(strayMaterial)->aes().encrypt("secret-b")));
+    }
+    shared_ptr<const CipherContext> rotating = KeyRotation::begin(oldKeys, oldMaterial, newKeys);
+    test("Rotation begins", rotating != nullptr);
+    if (!rotating) return;
+    CipherContext::publish(rotating);
+
+    atomic<bool> finished{false};
+    auto progress = [&](size_t, bool done) { if (done) finished = true; };
+
+    // Test 1: A row no key opens keeps the retiring keys
+    {
+        RekeyMigration migration(path, 1, progress);
+        migration.wait();
+        test("Pass with an unreadable row ends", migration.hasEnded());
+    }
+    shared_ptr<const CipherContext> published = CipherContext::current();
+    test("Unreadable row keeps the retiring keys",
+         !finished && KeyRotation::pending() != 0 && published && published->isRotating());
+
+    // Test 2: Once it is gone, the next engine finishes the rotation
+    {
+        DatabaseManager db(path);
+        test("Unreadable row deleted", db.deletePassword(stray));
+    }
+    {
+        RekeyMigration migration(path, 1, progress);
+        migration.wait();
+    }
+    test("Clean pass finishes the re-key", finished.load());
+
+    CipherContext::publish(nullptr);
+}
+#endif
+
+int main() {
+    cout << "╔════════════════════════════════════════════════╗\n";
+    cout << "║  Vault Core - Behaviour Tests                  ║\n";
+    cout << "╚════════════════════════════════════════════════╝\n";
+
+    const fs::path scratch = fs::temp_directory_path() / ("passwordcore_test_" + to_string(::getpid()));
+    fs::remove_all(scratch);
+    fs::create_directories(scratch);
+
+    testGcmRecords();
+    testLegacyCbc();
+    testPbkdf2();
+    testLz4();
+    testEntryStore();
+    testStorageManager(scratch);
+    testKeyRotation(scratch);
+    testResealText();
+#ifdef PASSWORDCORE_TESTS_SQLITE
+    testJournal(scratch);
+    testSealedLegacySecret(scratch);
+    testRekeyJournaling(scratch);
+    testRekeyUnreadable(scratch);
+#else
+    cout << "\n(SQLite not available: journal tests skipped)\n";
+#endif
+
+    fs::remove_all(scratch);
+
+    cout << "\n╔════════════════════════════════════════════════╗\n";
+    cout << "║  Test Summary                                  ║\n";
+    cout << "╠════════════════════════════════════════════════╣\n";
+    cout << "║  Total Tests: " << (passCount + failCount) << "\n";
+    cout << "║  ✅ Passed: " << passCount << "\n";
+    cout << "║  ❌ Failed: " << failCount << "\n";
+    cout << "╚════════════════════════════════════════════════╝\n";
+
+    return failCount == 0 ? 0 : 1;
+}
@@ -2,7 +2,9 @@
 #include <cassert>
 #include <string>
 #include <memory>
+#include <vector>
 #include "core/EncryptionContext.h"
+#include "core/StaticEncryptionContext.h"
 #include "core/XOREncryptionStrategy.h"
 #include "core/NoEncryptionStrategy.h"
 
@@ -94,6 +96,67 @@ void testEncryptionContext() {
     test("Context provides algorithm info", !context.getAlgorithmInfo().empty());
 }
 
+void testStaticEncryptionContext() {
+    cout << "\n=== Testing Static Encryption Context ===\n";
+    
+    // Test 1: Same results as the runtime context
+    StaticEncryptionContext<XOREncryptionStrategy> context("key");
+    EncryptionContext runtime(make_unique<XOREncryptionStrategy>("key"));
+    string plain = "Test Data";
+    test("Static context matches runtime context", context.encrypt(plain) == runtime.encrypt(plain));
+    test("Static context roundtrip", context.decrypt(context.encrypt(plain)) == plain);
+    
+    // Test 2: string_view input
+    string_view view = "View Data";
+    test("Static context accepts string_view", context.decrypt(context.encrypt(view)) == view);
+    
+    // Test 3: Strategy replacement
+    context.setStrategy(XOREncryptionStrategy("other"));
+    test("Static context uses new strategy", context.encrypt(plain) != runtime.encrypt(plain));
+}
+
+void testBufferAndBatch() {
+    cout << "\n=== Testing Buffer and Batch Forms ===\n";
+    
+    XOREncryptionStrategy xorStrategy("key");
+    NoEncryptionStrategy noEnc;
+    IEncryptionStrategy* strategies[] = {&xorStrategy, &noEnc};
+    
+    for (IEncryptionStrategy* strategy : strategies) {
+        const string name = strategy->getAlgorithmName();
+        
+        // Test 1: encryptInto matches encrypt
+        string plain = "Buffer Test";
+        vector<uint8_t> cipher(strategy->maxEncryptedSize(plain.size()));
+        size_t written = strategy->encryptInto(asBytes(plain), cipher);
+        test(name + ": encryptInto matches encrypt",
+             string(cipher.begin(), cipher.begin() + written) == strategy->encrypt(plain));
+        
+        // Test 2: decryptInto roundtrip
+        vector<uint8_t> back(strategy->maxDecryptedSize(written));
+        size_t length = strategy->decryptInto(ConstByteSpan(cipher.data(), written), back);
+        test(name + ": decryptInto roundtrip", string(back.begin(), back.begin() + length) == plain);
+        
+        // Test 3: Batch matches single calls
+        vector<string> batch = {"one", "", "three", string(1000, 'x')};
+        vector<string> encrypted = strategy->encryptBatch(batch);
+        bool same = encrypted.size() == batch.size();
+        for (size_t i = 0; same && i < batch.size(); ++i) same = encrypted[i] == strategy->encrypt(batch[i]);
+        test(name + ": encryptBatch matches encrypt", same);
+        test(name + ": decryptBatch roundtrip", strategy->decryptBatch(encrypted) == batch);
+    }
+    
+    // Test 4: Small buffers are rejected
+    bool caughtException = false;
+    try {
+        uint8_t small[2];
+        xorStrategy.encryptInto(asBytes(string("too long")), small);
+    } catch (const length_error&) {
+        caughtException = true;
+    }
+    test("encryptInto rejects a small buffer", caughtException);
+}
+
 void testStrategyPolymorphism() {
     cout << "\n=== Testing Polymorphism ===\n";
     
@@ -180,6 +243,8 @@ int main() {
     testXORStrategy();
     testNoEncryptionStrategy();
     testEncryptionContext();
+    testStaticEncryptionContext();
+    testBufferAndBatch();
     testStrategyPolymorphism();
     testStrategySwitching();
     testEdgeCases();
@@ -1,8 +1,188 @@
 package com.example.last_final
 
+import android.content.Context
+import android.os.Build
+import android.security.keystore.KeyGenParameterSpec
+import android.security.keystore.KeyPermanentlyInvalidatedException
+import android.security.keystore.KeyProperties
+import android.security.keystore.StrongBoxUnavailableException
+import android.security.keystore.UserNotAuthenticatedException
+import android.util.Base64
 import io.flutter.embedding.android.FlutterActivity
+import io.flutter.embedding.engine.FlutterEngine
+import io.flutter.plugin.common.MethodCall
+import io.flutter.plugin.common.MethodChannel
+import java.security.KeyStore
+import javax.crypto.Cipher
+import javax.crypto.KeyGenerator
+import javax.crypto.SecretKey
+import javax.crypto.spec.GCMParameterSpec
 
 class MainActivity: FlutterActivity() {
-    // For now, keep it simple - we'll use the Flutter-side implementation
-    // The password suggestions will work with the Flutter implementation we created
-}
\ No newline at end of file
+    // The password suggestions use the Flutter implementation; the only
+    // platform channel is the Keystore wrap for the native key cache
+
+    override fun configureFlutterEngine(flutterEngine: FlutterEngine) {
+        super.configureFlutterEngine(flutterEngine)
+        MethodChannel(flutterEngine.dartExecutor.binaryMessenger, KeyCacheChannel.NAME)
+            .setMethodCallHandler(KeyCacheChannel(applicationContext))
+    }
+}
+
+/**
+ * Keeps the native resume key (see cpp_take_resume_key) wrapped by a
+ * non-exportable AES-GCM key in the Android Keystore, StrongBox-backed where
+ * the device has one. Only the wrapped form is stored; the sealed key
+ * material itself stays in the native key_cache.bin.
+ *
+ * The Keystore key only works for AUTH_TIMEOUT_SECONDS after the user
+ * authenticated (biometric or device credential), and is invalidated when
+ * biometrics are enrolled. Both store and load therefore follow a
+ * successful local_auth prompt; outside that window they fail, and the app
+ * derives the keys from the password instead. The wrap is dropped after
+ * CACHE_TTL_MILLIS, which matches the native cache's own expiry.
+ *
+ *   store(bytes) -> bool, load() -> bytes or null, clear() -> null
+ */
+class KeyCacheChannel(context: Context) : MethodChannel.MethodCallHandler {
+    companion object {
+        const val NAME = "com.example.last_final/key_cache"
+        private const val KEY_ALIAS = "secureflow_resume_key_auth"
+        private const val LEGACY_KEY_ALIAS = "secureflow_resume_key"   // Usable without authentication
+        private const val PREFS = "secureflow_key_cache"
+        private const val PREF_WRAPPED = "wrapped_resume_key"
+        private const val PREF_STORED_AT = "wrapped_resume_key_stored_at"
+        private const val AUTH_TIMEOUT_SECONDS = 30
+        private const val CACHE_TTL_MILLIS = 24L * 60 * 60 * 1000   // KEY_CACHE_TTL in native_ffi_bridge.cpp
+        private const val TRANSFORMATION = "AES/GCM/NoPadding"
+        private const val GCM_TAG_BITS = 128
+    }
+
+    private val prefs = context.getSharedPreferences(PREFS, Context.MODE_PRIVATE)
+
+    override fun onMethodCall(call: MethodCall, result: MethodChannel.Result) {
+        try {
+            when (call.method) {
+                "store" -> {
+                    val resumeKey = call.arguments as? ByteArray
+                    if (resumeKey == null) {
+                        result.error("INVALID_ARGUMENT", "store expects bytes", null)
+                        return
+                    }
+                    try {
+                        result.success(store(resumeKey))
+                    } finally {
+                        resumeKey.fill(0)
+                    }
+                }
+                "load" -> result.success(load())
+                "clear" -> {
+                    clear()
+                    result.success(null)
+                }
+                else -> result.notImplemented()
+            }
+        } catch (e: Exception) {
+            result.error("KEY_CACHE_ERROR", e.message, null)
+        }
+    }
+
+    // False when the user has not authenticated within AUTH_TIMEOUT_SECONDS
+    private fun store(resumeKey: ByteArray): Boolean {
+        val cipher = Cipher.getInstance(TRANSFORMATION)
+        try {
+            cipher.init(Cipher.ENCRYPT_MODE, wrappingKey())
+        } catch (e: UserNotAuthenticatedException) {
+            return false
+        } catch (e: KeyPermanentlyInvalidatedException) {
+            clear()
+            return false
+        }
+        val wrapped = cipher.iv + cipher.doFinal(resumeKey)
+        return prefs.edit()
+            .putString(PREF_WRAPPED, Base64.encodeToString(wrapped, Base64.NO_WRAP))
+            .putLong(PREF_STORED_AT, System.currentTimeMillis())
+            .commit()
+    }
+
+    // A wrap that no longer opens (key invalidated, data restored from
+    // another device) or has expired is dropped so the next unlock derives
+    // and stores afresh. Missing authentication keeps it for a later try.
+    private fun load(): ByteArray? {
+        val encoded = prefs.getString(PREF_WRAPPED, null) ?: return null
+        val age = System.currentTimeMillis() - prefs.getLong(PREF_STORED_AT, 0L)
+        if (age < 0 || age > CACHE_TTL_MILLIS) {
+            clear()
+            return null
+        }
+        val key = keyStore().getKey(KEY_ALIAS, null) as? SecretKey ?: run {
+            clear()
+            return null
+        }
+        return try {
+            val wrapped = Base64.decode(encoded, Base64.NO_WRAP)
+            val cipher = Cipher.getInstance(TRANSFORMATION)
+            cipher.init(Cipher.DECRYPT_MODE, key, GCMParameterSpec(GCM_TAG_BITS, wrapped, 0, 12))
+            cipher.doFinal(wrapped, 12, wrapped.size - 12)
+        } catch (e: UserNotAuthenticatedException) {
+            null
+        } catch (e: Exception) {
+            clear()
+            null
+        }
+    }
+
+    private fun clear() {
+        prefs.edit().remove(PREF_WRAPPED).remove(PREF_STORED_AT).commit()
+        val store = keyStore()
+        for (alias in listOf(KEY_ALIAS, LEGACY_KEY_ALIAS)) {
+            if (store.containsAlias(alias)) store.deleteEntry(alias)
+        }
+    }
+
+    private fun keyStore(): KeyStore = KeyStore.getInstance("AndroidKeyStore").apply { load(null) }
+
+    private fun wrappingKey(): SecretKey {
+        val store = keyStore()
+        (store.getKey(KEY_ALIAS, null) as? SecretKey)?.let { return it }
+        if (store.containsAlias(LEGACY_KEY_ALIAS)) store.deleteEntry(LEGACY_KEY_ALIAS)
+
+        fun generate(strongBox: Boolean): SecretKey {
+            val spec = KeyGenParameterSpec.Builder(
+                KEY_ALIAS, KeyProperties.PURPOSE_ENCRYPT or KeyProperties.PURPOSE_DECRYPT
+            )
+                .setBlockModes(KeyProperties.BLOCK_MODE_GCM)
+                .setEncryptionPaddings(KeyProperties.ENCRYPTION_PADDING_NONE)
+                .setKeySize(256)
+                .setUserAuthenticationRequired(true)
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+                spec.setUserAuthenticationParameters(
+                    AUTH_TIMEOUT_SECONDS,
+                    KeyProperties.AUTH_BIOMETRIC_STRONG or KeyProperties.AUTH_DEVICE_CREDENTIAL
+                )
+            } else {
+                @Suppress("DEPRECATION")
+                spec.setUserAuthenticationValidityDurationSeconds(AUTH_TIMEOUT_SECONDS)
+            }
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.N) {
+                spec.setInvalidatedByBiometricEnrollment(true)
+            }
+            if (strongBox && Build.VERSION.SDK_INT >= Build.VERSION_CODES.P) {
+                spec.setIsStrongBoxBacked(true)
+            }
+            val generator = KeyGenerator.getInstance(KeyProperties.KEY_ALGORITHM_AES, "AndroidKeyStore")
+            generator.init(spec.build())
+            return generator.generateKey()
+        }
+
+        return if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.P) {
+            try {
+                generate(strongBox = true)
+            } catch (e: StrongBoxUnavailableException) {
+                generate(strongBox = false)
+            }
+        } else {
+            generate(strongBox = false)
+        }
+    }
+}
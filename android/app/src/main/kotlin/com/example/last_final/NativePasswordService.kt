@@ -1,5 +1,7 @@
 package com.example.last_final
 
+import java.nio.ByteBuffer
+
 class NativePasswordService {
     // Existing native methods
     external fun createManager(): Long
@@ -11,8 +13,14 @@ class NativePasswordService {
     external fun getAllPasswordsJson(managerPtr: Long): String
     external fun getPasswordsByCategoryJson(managerPtr: Long, category: Int): String
     external fun searchPasswordsJson(managerPtr: Long, query: String): String
+    external fun matchForUrlJson(managerPtr: Long, url: String): String
+    external fun matchForPackageJson(managerPtr: Long, packageName: String): String
     external fun getCategoryStatsJson(managerPtr: Long): String
+    external fun getVaultAuditJson(managerPtr: Long): String
     external fun getTotalPasswordCount(managerPtr: Long): Int
+    /** Re-encrypts the vault after a master password change, if one is pending. True while it runs */
+    external fun startRekey(managerPtr: Long): Boolean
+    external fun isRekeying(managerPtr: Long): Boolean
     external fun analyzePassword(managerPtr: Long, password: String): String
     external fun generateRandomPassword(managerPtr: Long, length: Int): String
     external fun generateFromFavorite(managerPtr: Long, favorite: String, length: Int): String
@@ -25,10 +33,29 @@ class NativePasswordService {
     external fun generateStrongPassword(managerPtr: Long, length: Int,
                                         includeUpper: Boolean, includeLower: Boolean,
                                         includeDigits: Boolean, includeSymbols: Boolean): String
+    external fun generatePasswordBatch(managerPtr: Long, count: Int, length: Int,
+                                       includeUpper: Boolean, includeLower: Boolean,
+                                       includeDigits: Boolean, includeSymbols: Boolean): String
+    external fun createStrengthMeter(): Long
+    external fun updateStrengthMeter(meterPtr: Long, password: String): String
+    external fun destroyStrengthMeter(meterPtr: Long)
+
+    // Batched record exchange. Buffers must come from ByteBuffer.allocateDirect
+    // and be read with order(ByteOrder.LITTLE_ENDIAN). A batch is a u32 count
+    // followed by that many records, each laid out as:
+    //   u8 category | u64 createdAt | u64 modifiedAt |
+    //   u32 length + UTF-8 bytes for id, title, username, password, website, notes
+
+    /** Adds the batch in [position, limit). Returns the count added, or -1 if the batch is malformed. New ids go to [ids] */
+    external fun addPasswordsBinary(managerPtr: Long, records: ByteBuffer, ids: LongArray?): Int
+    /** Fills [out] with the records for [ids] and flips it. Returns the ids consumed, or -(bytes needed) */
+    external fun getPasswordsBinary(managerPtr: Long, ids: LongArray, out: ByteBuffer): Int
+    /** Fills [out] with the records from index [start] on. Returns the records written: 0 at the end, or -(bytes needed) */
+    external fun getAllPasswordsBinary(managerPtr: Long, start: Int, out: ByteBuffer): Int
 
     companion object {
         init {
-            System.loadLibrary("advanced_password_manager")
+            System.loadLibrary("passwordcore")
         }
     }
 }
\ No newline at end of file
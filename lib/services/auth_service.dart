@@ -66,6 +66,8 @@ class AuthService with ChangeNotifier {
       // This ensures encryption is available when creating user document
       print('🔐 Initializing encryption with user-specific keys...');
       EncryptionService.setUserPassword(password);
+      await NativeEncryption.deriveKeysAsync(password);
+      NativeEncryption.retireLegacyKeys(); // A new account has no pre-PBKDF2 data
       print('✅ User-specific encryption keys initialized');
 
       final result = await _firebaseService.registerUser(email, password);
@@ -111,6 +113,7 @@ class AuthService with ChangeNotifier {
         // This enables: Phone → Tablet → PC backup/restore
         print('🔐 Initializing encryption with user-specific keys...');
         EncryptionService.setUserPassword(password);
+        await NativeEncryption.deriveKeysAsync(password);
         print('✅ User-specific encryption keys initialized');
         print('🌍 Keys are cross-device compatible - works on any device!');
 
@@ -165,6 +168,20 @@ class AuthService with ChangeNotifier {
     }
   }
 
+  // Native keys after a successful prompt: the Keystore wrap only opens
+  // within its authentication window, so this must follow local_auth.
+  // Falls back to deriving from the stored password, then caches the result
+  // so the next resume skips the KDF.
+  Future<void> _unlockNativeKeys() async {
+    if (await NativeEncryption.resumeFromCache()) return;
+    final storedPassword =
+        await _secureStorage.read(key: 'user_encryption_password');
+    if (storedPassword == null) return;
+    if (await NativeEncryption.deriveKeysAsync(storedPassword)) {
+      await NativeEncryption.cacheUnlockedKeys();
+    }
+  }
+
   // Enhanced Biometric Authentication
   Future<bool> authenticate() async {
     try {
@@ -191,6 +208,8 @@ class AuthService with ChangeNotifier {
 
       print('🎯 Biometric authentication result: $result');
 
+      if (result) await _unlockNativeKeys();
+
       _isAuthenticated = result;
       notifyListeners();
 
@@ -365,8 +384,9 @@ class AuthService with ChangeNotifier {
       print('🚪 AuthService: Starting logout process...');
       await AppPinService().clearPinData();
 
-      // Clear stored encryption password
+      // Clear stored encryption password, native keys and their resume cache
       await _secureStorage.delete(key: 'user_encryption_password');
+      NativeEncryption.clearKeys();
       print('🗑️ Cleared stored encryption password');
 
       // FIRST: Clear all local data
@@ -0,0 +1,106 @@
+import 'dart:io' show Directory, File;
+import 'package:http/http.dart' as http;
+import 'native_encryption.dart';
+
+/// Lazy download of offline breach-filter shards
+///
+/// The native filter answers "unknown" for shards that are not on disk and
+/// remembers which ones lookups needed. [syncRequested] fetches exactly
+/// those, so a fresh install downloads only the shards its own passwords
+/// fall into. [checkForUpdates] replaces installed shards when the server
+/// publishes a newer corpus generation.
+///
+/// Server layout: `<baseUrl>/<generation>/breach-XX.sfbf` (as written by
+/// breach_filter_build) plus `<baseUrl>/generation` holding the latest
+/// generation number as text.
+class BreachFilterService {
+  static final BreachFilterService _instance = BreachFilterService._internal();
+  factory BreachFilterService() => _instance;
+  BreachFilterService._internal();
+
+  // Same app-private directory the native key files live in
+  static const String defaultDirectory =
+      '/data/data/com.example.last_final/breach';
+
+  String _directory = defaultDirectory;
+  String? _baseUrl;
+  bool _opened = false;
+  Future<void>? _syncing;
+
+  /// Open the filter; checks work right away for shards already on disk.
+  /// Without a [baseUrl] the filter only uses shards already installed.
+  Future<bool> open({
+    String directory = defaultDirectory,
+    String? baseUrl,
+  }) async {
+    _directory = directory;
+    _baseUrl = baseUrl;
+    await Directory(directory).create(recursive: true);
+    _opened = NativeEncryption.breachOpen(directory);
+    return _opened;
+  }
+
+  /// 0 clear, 1 breached, 2 unknown; unknown results queue their shard
+  /// for the next [syncRequested]
+  int? check(String password) {
+    if (!_opened) return null;
+    return NativeEncryption.breachCheck(password);
+  }
+
+  /// Download and install every shard a lookup asked for
+  Future<void> syncRequested() {
+    return _syncing ??= _installShards(
+      NativeEncryption.breachRequestedShards(),
+    ).whenComplete(() => _syncing = null);
+  }
+
+  /// Install a newer corpus generation for the shards already on disk
+  Future<void> checkForUpdates() async {
+    if (!_opened) return;
+    final latest = await _latestGeneration();
+    if (latest == null) return;
+    final stale = <int>[];
+    for (var shard = 0; shard < 256; shard++) {
+      final generation = NativeEncryption.breachShardGeneration(shard);
+      if (generation != 0 && generation < latest) stale.add(shard);
+    }
+    await _installShards(stale, generation: latest);
+  }
+
+  Future<void> _installShards(List<int> shards, {int? generation}) async {
+    if (!_opened || _baseUrl == null || shards.isEmpty) return;
+    generation ??= await _latestGeneration();
+    if (generation == null) return;
+
+    for (final shard in shards) {
+      final name = 'breach-${shard.toRadixString(16).padLeft(2, '0')}.sfbf';
+      try {
+        final response = await http.get(
+          Uri.parse('$_baseUrl/$generation/$name'),
+        );
+        if (response.statusCode != 200) continue;
+        // Downloaded next to the target so the native rename stays atomic
+        final temp = File('$_directory/$name.download');
+        await temp.writeAsBytes(response.bodyBytes, flush: true);
+        if (!NativeEncryption.breachInstallShard(shard, temp.path) &&
+            await temp.exists()) {
+          await temp.delete();
+        }
+      } catch (e) {
+        print('❌ Breach shard $shard download failed: $e');
+      }
+    }
+  }
+
+  Future<int?> _latestGeneration() async {
+    if (_baseUrl == null) return null;
+    try {
+      final response = await http.get(Uri.parse('$_baseUrl/generation'));
+      if (response.statusCode != 200) return null;
+      return int.tryParse(response.body.trim());
+    } catch (e) {
+      print('❌ Breach filter generation check failed: $e');
+      return null;
+    }
+  }
+}
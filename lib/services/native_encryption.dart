@@ -1,7 +1,10 @@
+import 'dart:async' show Completer;
 import 'dart:ffi' as ffi;
 import 'package:ffi/ffi.dart' as pkg_ffi;
 import 'dart:io' show Platform;
-import 'dart:convert' show utf8;
+import 'dart:convert' show jsonDecode, utf8;
+import 'dart:typed_data' show Uint8List;
+import 'package:flutter/services.dart' show MethodChannel;
 
 // Dart FFI bindings for the native C++ encryption bridge.
 // NOTE: These functions currently wrap an XOR strategy (educational only).
@@ -19,13 +22,97 @@ typedef _DecryptNative =
 typedef _FreeNative = ffi.Void Function(ffi.Pointer<ffi.Char>);
 typedef _ClearKeysNative = ffi.Void Function();
 typedef _ResetKeysNative = ffi.Void Function();
+typedef _RetireLegacyKeysNative = ffi.Void Function();
 typedef _SetUserPasswordNative = ffi.Void Function(ffi.Pointer<ffi.Char>);
 
+// Batch entry points: (inputs, lengths, count, cancel_flag) -> arena freed
+// with cpp_free. cancel_flag may be null.
+typedef _BatchNative =
+    ffi.Pointer<ffi.Uint8> Function(
+      ffi.Pointer<ffi.Pointer<ffi.Char>>, // inputs
+      ffi.Pointer<ffi.Int32>, // lengths
+      ffi.Int32, // count
+      ffi.Pointer<ffi.Int32>, // cancel_flag
+    );
+typedef _Batch =
+    ffi.Pointer<ffi.Uint8> Function(
+      ffi.Pointer<ffi.Pointer<ffi.Char>>,
+      ffi.Pointer<ffi.Int32>,
+      int,
+      ffi.Pointer<ffi.Int32>,
+    );
+
+// Caller-buffer entry points: sizes, then (input, length, out, capacity) -> n
+typedef _SizeNative = ffi.Int32 Function(ffi.Int32);
+typedef _Size = int Function(int);
+typedef _IntoNative =
+    ffi.Int32 Function(
+      ffi.Pointer<ffi.Char>, // input
+      ffi.Int32, // length
+      ffi.Pointer<ffi.Char>, // out
+      ffi.Int32, // capacity
+    );
+typedef _Into =
+    int Function(ffi.Pointer<ffi.Char>, int, ffi.Pointer<ffi.Char>, int);
+
+// Async key derivation: callback(event, progress, user_data) from a native thread
+typedef _KeyCallbackNative =
+    ffi.Void Function(ffi.Int32, ffi.Int32, ffi.Pointer<ffi.Void>);
+typedef _DeriveKeysAsyncNative =
+    ffi.Void Function(
+      ffi.Pointer<ffi.Char>, // password
+      ffi.Pointer<ffi.NativeFunction<_KeyCallbackNative>>, // callback
+      ffi.Pointer<ffi.Void>, // user_data
+    );
+typedef _DeriveKeysAsync =
+    void Function(
+      ffi.Pointer<ffi.Char>,
+      ffi.Pointer<ffi.NativeFunction<_KeyCallbackNative>>,
+      ffi.Pointer<ffi.Void>,
+    );
+typedef _KeysStateNative = ffi.Int32 Function();
+typedef _KeysState = int Function();
+typedef _RekeyPendingNative = ffi.Int64 Function();
+typedef _RekeyPending = int Function();
+typedef _RekeyConfirmNative = ffi.Int32 Function(ffi.Int64);
+typedef _RekeyConfirm = int Function(int);
+typedef _PerfStatsNative = ffi.Pointer<ffi.Char> Function();
+typedef _PerfStats = ffi.Pointer<ffi.Char> Function();
+typedef _ResetPerfStatsNative = ffi.Void Function();
+typedef _ResetPerfStats = void Function();
+
+// Resume cache: (out, capacity) -> length / (resume_key, length) -> 1 or 0
+typedef _TakeResumeKeyNative =
+    ffi.Int32 Function(ffi.Pointer<ffi.Uint8>, ffi.Int32);
+typedef _TakeResumeKey = int Function(ffi.Pointer<ffi.Uint8>, int);
+typedef _ResumeKeysNative =
+    ffi.Int32 Function(ffi.Pointer<ffi.Uint8>, ffi.Int32);
+typedef _ResumeKeys = int Function(ffi.Pointer<ffi.Uint8>, int);
+
+// Breach filter: (directory) -> 1/0, (password, length) -> status,
+// shard index -> generation, (shard, path) -> 1/0
+typedef _BreachOpenNative = ffi.Int32 Function(ffi.Pointer<ffi.Char>);
+typedef _BreachOpen = int Function(ffi.Pointer<ffi.Char>);
+typedef _BreachCheckNative =
+    ffi.Int32 Function(ffi.Pointer<ffi.Char>, ffi.Int32);
+typedef _BreachCheck = int Function(ffi.Pointer<ffi.Char>, int);
+typedef _BreachGenerationNative = ffi.Int64 Function(ffi.Int32);
+typedef _BreachGeneration = int Function(int);
+typedef _BreachInstallNative =
+    ffi.Int32 Function(ffi.Int32, ffi.Pointer<ffi.Char>);
+typedef _BreachInstall = int Function(int, ffi.Pointer<ffi.Char>);
+
+// Mirrors KeyEvent / KeyState in native_ffi_bridge.cpp
+const int _keyEventProgress = 0;
+const int _keyEventReady = 1;
+const int _keysReady = 2;
+
 typedef _Encrypt = ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>);
 typedef _Decrypt = ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>);
 typedef _Free = void Function(ffi.Pointer<ffi.Char>);
 typedef _ClearKeys = void Function();
 typedef _ResetKeys = void Function();
+typedef _RetireLegacyKeys = void Function();
 typedef _SetUserPassword = void Function(ffi.Pointer<ffi.Char>);
 
 class NativeEncryption {
@@ -36,6 +123,39 @@ class NativeEncryption {
   static _ClearKeys? _clearKeys;
   static _ResetKeys? _resetKeys;
   static _SetUserPassword? _setUserPassword;
+  static _Batch? _encryptBatch;
+  static _Batch? _decryptBatch;
+  static _Batch? _resealBatch;
+  static _Size? _ciphertextSize;
+  static _Size? _plaintextMaxSize;
+  static _Into? _encryptInto;
+  static _Into? _decryptInto;
+  static _DeriveKeysAsync? _deriveKeysAsync;
+  static _DeriveKeysAsync? _changeMasterPassword;
+  static _RekeyPending? _rekeyPending;
+  static _RekeyConfirm? _rekeyConfirm;
+  static _RetireLegacyKeys? _retireLegacyKeys;
+  static _KeysState? _keysState;
+  static _PerfStats? _perfStats;
+  static _PerfStats? _secretCacheStats;
+  static _ResetPerfStats? _resetPerfStats;
+  static _TakeResumeKey? _takeResumeKey;
+  static _ResumeKeys? _resumeKeys;
+  static _BreachOpen? _breachOpen;
+  static _BreachCheck? _breachCheck;
+  static _PerfStats? _breachRequestedShards;
+  static _BreachGeneration? _breachShardGeneration;
+  static _BreachInstall? _breachInstallShard;
+
+  // Keystore wrap for the resume key, see KeyCacheChannel in MainActivity.kt
+  static const MethodChannel _keyCacheChannel = MethodChannel(
+    'com.example.last_final/key_cache',
+  );
+  static const int _resumeKeySize = 48;
+
+  // Reused native buffer for encryptAES/decryptAES: input, then output
+  static ffi.Pointer<ffi.Uint8> _scratch = ffi.Pointer.fromAddress(0);
+  static int _scratchSize = 0;
 
   static bool get isAvailable =>
       _lib != null && _encrypt != null && _decrypt != null && _free != null;
@@ -72,6 +192,83 @@ class NativeEncryption {
           .lookupFunction<_SetUserPasswordNative, _SetUserPassword>(
             'cpp_set_user_password',
           );
+      _encryptBatch = _lib!.lookupFunction<_BatchNative, _Batch>(
+        'cpp_encrypt_aes_batch_cancellable',
+      );
+      _decryptBatch = _lib!.lookupFunction<_BatchNative, _Batch>(
+        'cpp_decrypt_aes_batch_cancellable',
+      );
+      _resealBatch = _lib!.lookupFunction<_BatchNative, _Batch>(
+        'cpp_reseal_aes_batch_cancellable',
+      );
+      _ciphertextSize = _lib!.lookupFunction<_SizeNative, _Size>(
+        'cpp_aes_ciphertext_size',
+      );
+      _plaintextMaxSize = _lib!.lookupFunction<_SizeNative, _Size>(
+        'cpp_aes_plaintext_max_size',
+      );
+      _encryptInto = _lib!.lookupFunction<_IntoNative, _Into>(
+        'cpp_encrypt_aes_into',
+      );
+      _decryptInto = _lib!.lookupFunction<_IntoNative, _Into>(
+        'cpp_decrypt_aes_into',
+      );
+      _deriveKeysAsync = _lib!
+          .lookupFunction<_DeriveKeysAsyncNative, _DeriveKeysAsync>(
+            'cpp_derive_keys_async',
+          );
+      _changeMasterPassword = _lib!
+          .lookupFunction<_DeriveKeysAsyncNative, _DeriveKeysAsync>(
+            'cpp_change_master_password',
+          );
+      _rekeyPending = _lib!.lookupFunction<_RekeyPendingNative, _RekeyPending>(
+        'cpp_rekey_pending',
+      );
+      _rekeyConfirm = _lib!.lookupFunction<_RekeyConfirmNative, _RekeyConfirm>(
+        'cpp_rekey_confirm',
+      );
+      _retireLegacyKeys = _lib!
+          .lookupFunction<_RetireLegacyKeysNative, _RetireLegacyKeys>(
+            'cpp_retire_legacy_keys',
+          );
+      _keysState = _lib!.lookupFunction<_KeysStateNative, _KeysState>(
+        'cpp_keys_state',
+      );
+      _perfStats = _lib!.lookupFunction<_PerfStatsNative, _PerfStats>(
+        'cpp_get_perf_stats',
+      );
+      _secretCacheStats = _lib!.lookupFunction<_PerfStatsNative, _PerfStats>(
+        'cpp_get_secret_cache_stats',
+      );
+      _resetPerfStats = _lib!
+          .lookupFunction<_ResetPerfStatsNative, _ResetPerfStats>(
+            'cpp_reset_perf_stats',
+          );
+      _takeResumeKey = _lib!
+          .lookupFunction<_TakeResumeKeyNative, _TakeResumeKey>(
+            'cpp_take_resume_key',
+          );
+      _resumeKeys = _lib!.lookupFunction<_ResumeKeysNative, _ResumeKeys>(
+        'cpp_resume_keys',
+      );
+      _breachOpen = _lib!.lookupFunction<_BreachOpenNative, _BreachOpen>(
+        'cpp_breach_open',
+      );
+      _breachCheck = _lib!.lookupFunction<_BreachCheckNative, _BreachCheck>(
+        'cpp_breach_check',
+      );
+      _breachRequestedShards = _lib!
+          .lookupFunction<_PerfStatsNative, _PerfStats>(
+            'cpp_breach_requested_shards',
+          );
+      _breachShardGeneration = _lib!
+          .lookupFunction<_BreachGenerationNative, _BreachGeneration>(
+            'cpp_breach_shard_generation',
+          );
+      _breachInstallShard = _lib!
+          .lookupFunction<_BreachInstallNative, _BreachInstall>(
+            'cpp_breach_install_shard',
+          );
     } catch (_) {
       _lib = null;
       _encrypt = null;
@@ -79,14 +276,40 @@ class NativeEncryption {
       _free = null;
       _resetKeys = null;
       _setUserPassword = null;
+      _encryptBatch = null;
+      _decryptBatch = null;
+      _resealBatch = null;
+      _ciphertextSize = null;
+      _plaintextMaxSize = null;
+      _encryptInto = null;
+      _decryptInto = null;
+      _deriveKeysAsync = null;
+      _changeMasterPassword = null;
+      _rekeyPending = null;
+      _rekeyConfirm = null;
+      _retireLegacyKeys = null;
+      _keysState = null;
+      _perfStats = null;
+      _secretCacheStats = null;
+      _resetPerfStats = null;
+      _takeResumeKey = null;
+      _resumeKeys = null;
+      _breachOpen = null;
+      _breachCheck = null;
+      _breachRequestedShards = null;
+      _breachShardGeneration = null;
+      _breachInstallShard = null;
     }
   }
 
-  /// Encrypt using C++ AES-256-CBC encryption
-  /// Returns base64 encoded ciphertext
+  /// Encrypt using C++ AES-256-GCM encryption
+  /// Returns base64 encoded ciphertext record (random nonce + tag)
   static String? encryptAES(String plain) {
     init();
     if (!isAvailable) return null;
+    if (_encryptInto != null) {
+      return _runInto(_encryptInto!, _ciphertextSize!, plain);
+    }
     final plainPtr = _toNativeUtf8(plain);
     final resPtr = _encrypt!(plainPtr);
     _freeNativeString(plainPtr);
@@ -96,11 +319,14 @@ class NativeEncryption {
     return result;
   }
 
-  /// Decrypt using C++ AES-256-CBC encryption
-  /// Input should be base64 encoded ciphertext
+  /// Decrypt using C++ AES-256 encryption
+  /// Input should be base64 encoded ciphertext (GCM record or legacy CBC)
   static String? decryptAES(String cipher) {
     init();
     if (!isAvailable) return null;
+    if (_decryptInto != null) {
+      return _runInto(_decryptInto!, _plaintextMaxSize!, cipher);
+    }
     final cipherPtr = _toNativeUtf8(cipher);
     final resPtr = _decrypt!(cipherPtr);
     _freeNativeString(cipherPtr);
@@ -110,12 +336,49 @@ class NativeEncryption {
     return result;
   }
 
+  /// Encrypt many strings in one native call
+  /// Result has one entry per input; null marks an item that failed
+  static List<String?>? encryptAESBatch(
+    List<String> plains, {
+    NativeCancelToken? cancelToken,
+  }) {
+    init();
+    if (!isAvailable || _encryptBatch == null) return null;
+    return _runBatch(_encryptBatch!, plains, cancelToken);
+  }
+
+  /// Decrypt many ciphertexts in one native call (e.g. whole vault on unlock)
+  /// Result has one entry per input; null marks an item that failed
+  /// (or was skipped because [cancelToken] fired mid-job)
+  static List<String?>? decryptAESBatch(
+    List<String> ciphers, {
+    NativeCancelToken? cancelToken,
+  }) {
+    init();
+    if (!isAvailable || _decryptBatch == null) return null;
+    return _runBatch(_decryptBatch!, ciphers, cancelToken);
+  }
+
+  /// Re-encrypt ciphertexts under the current keys, whichever generation
+  /// wrote them; see [changeMasterPassword]
+  /// Result has one entry per input; null marks an item that failed
+  static List<String?>? resealAESBatch(
+    List<String> ciphers, {
+    NativeCancelToken? cancelToken,
+  }) {
+    init();
+    if (!isAvailable || _resealBatch == null) return null;
+    return _runBatch(_resealBatch!, ciphers, cancelToken);
+  }
+
   /// Clear encryption keys (for logout)
   static void clearKeys() {
     init();
+    _releaseScratch();
     if (_clearKeys != null) {
       _clearKeys!();
     }
+    _forgetCachedKeys();
   }
 
   /// Reset encryption keys (regenerate deterministic keys)
@@ -124,6 +387,62 @@ class NativeEncryption {
     if (_resetKeys != null) {
       _resetKeys!();
     }
+    _forgetCachedKeys();
+  }
+
+  /// After an unlock that derived keys, hand the native resume key to the
+  /// Android Keystore wrap so the next app-lock resume can skip the KDF.
+  /// Returns false if no derivation is pending or the wrap failed.
+  static Future<bool> cacheUnlockedKeys() async {
+    init();
+    if (_takeResumeKey == null) return false;
+    final out = pkg_ffi.malloc.allocate<ffi.Uint8>(_resumeKeySize);
+    try {
+      final n = _takeResumeKey!(out, _resumeKeySize);
+      if (n != _resumeKeySize) return false;
+      final resumeKey = Uint8List.fromList(out.asTypedList(n));
+      try {
+        return await _keyCacheChannel.invokeMethod<bool>('store', resumeKey) ??
+            false;
+      } finally {
+        resumeKey.fillRange(0, resumeKey.length, 0);
+      }
+    } catch (_) {
+      return false;
+    } finally {
+      out.asTypedList(_resumeKeySize).fillRange(0, _resumeKeySize, 0);
+      pkg_ffi.malloc.free(out);
+    }
+  }
+
+  /// PIN/biometric resume: unwrap the resume key and publish the cached
+  /// keys in one step. False means no usable cache; derive from the
+  /// password (deriveKeysAsync) instead.
+  static Future<bool> resumeFromCache() async {
+    init();
+    if (_resumeKeys == null) return false;
+    Uint8List? resumeKey;
+    try {
+      resumeKey = await _keyCacheChannel.invokeMethod<Uint8List>('load');
+    } catch (_) {
+      return false;
+    }
+    if (resumeKey == null || resumeKey.length != _resumeKeySize) return false;
+
+    final key = pkg_ffi.malloc.allocate<ffi.Uint8>(_resumeKeySize);
+    try {
+      key.asTypedList(_resumeKeySize).setAll(0, resumeKey);
+      return _resumeKeys!(key, _resumeKeySize) == 1;
+    } finally {
+      key.asTypedList(_resumeKeySize).fillRange(0, _resumeKeySize, 0);
+      pkg_ffi.malloc.free(key);
+      resumeKey.fillRange(0, resumeKey.length, 0);
+    }
+  }
+
+  // The native side already deleted the sealed keys; drop the wrap too
+  static void _forgetCachedKeys() {
+    _keyCacheChannel.invokeMethod<void>('clear').catchError((_) {});
   }
 
   /// Set user password for key derivation (called after login)
@@ -137,6 +456,296 @@ class NativeEncryption {
     }
   }
 
+  /// Native per-operation counts and latency histograms as JSON
+  /// (key setup, KDF, encrypt, decrypt, vault load, search); null if unavailable
+  static String? perfStatsJson() {
+    init();
+    return _takeJson(_perfStats);
+  }
+
+  /// Decrypted-field cache hits, misses, evictions, expirations, size and
+  /// hit rate as JSON; null if unavailable
+  static String? secretCacheStatsJson() {
+    init();
+    return _takeJson(_secretCacheStats);
+  }
+
+  static String? _takeJson(_PerfStats? fn) {
+    if (fn == null || _free == null) return null;
+    final ptr = fn();
+    if (ptr == ffi.Pointer.fromAddress(0)) return null;
+    try {
+      return _fromNativeUtf8(ptr);
+    } finally {
+      _free!(ptr);
+    }
+  }
+
+  /// Zero the native perf and secret cache counters, e.g. before
+  /// reproducing a slow unlock
+  static void resetPerfStats() {
+    init();
+    if (_resetPerfStats != null) {
+      _resetPerfStats!();
+    }
+  }
+
+  /// Use the breach filter shards in [directory] for password checks,
+  /// strength analysis and the vault audit
+  static bool breachOpen(String directory) {
+    init();
+    if (_breachOpen == null) return false;
+    final dirPtr = _toNativeUtf8(directory);
+    try {
+      return _breachOpen!(dirPtr) == 1;
+    } finally {
+      _freeNativeString(dirPtr);
+    }
+  }
+
+  /// 0 clear, 1 breached, 2 unknown (shard not downloaded yet), null if
+  /// no filter is open
+  static int? breachCheck(String password) {
+    init();
+    if (_breachCheck == null) return null;
+    final units = utf8.encode(password);
+    final ptr = pkg_ffi.malloc.allocate<ffi.Uint8>(units.length + 1);
+    try {
+      ptr.asTypedList(units.length).setAll(0, units);
+      final status = _breachCheck!(ptr.cast<ffi.Char>(), units.length);
+      return status < 0 ? null : status;
+    } finally {
+      ptr.asTypedList(units.length).fillRange(0, units.length, 0);
+      pkg_ffi.malloc.free(ptr);
+    }
+  }
+
+  /// Shard indexes that lookups needed but are not installed
+  static List<int> breachRequestedShards() {
+    init();
+    if (_breachRequestedShards == null || _free == null) return const [];
+    final ptr = _breachRequestedShards!();
+    if (ptr == ffi.Pointer.fromAddress(0)) return const [];
+    try {
+      return (jsonDecode(_fromNativeUtf8(ptr)) as List).cast<int>();
+    } finally {
+      _free!(ptr);
+    }
+  }
+
+  /// Corpus generation of an installed shard, 0 when missing
+  static int breachShardGeneration(int shard) {
+    init();
+    if (_breachShardGeneration == null) return 0;
+    final generation = _breachShardGeneration!(shard);
+    return generation < 0 ? 0 : generation;
+  }
+
+  /// Verify a downloaded shard file and move it into the filter directory
+  static bool breachInstallShard(int shard, String path) {
+    init();
+    if (_breachInstallShard == null) return false;
+    final pathPtr = _toNativeUtf8(path);
+    try {
+      return _breachInstallShard!(shard, pathPtr) == 1;
+    } finally {
+      _freeNativeString(pathPtr);
+    }
+  }
+
+  /// Derive keys for [password] on a native worker thread
+  /// Completes with true once keys are ready; never blocks the UI isolate.
+  /// [onProgress] receives 0..99 while the KDF runs.
+  static Future<bool> deriveKeysAsync(
+    String password, {
+    void Function(int percent)? onProgress,
+  }) {
+    init();
+    if (_deriveKeysAsync == null) return Future.value(false);
+    return _runDerivation(_deriveKeysAsync!, password, onProgress);
+  }
+
+  /// Switch the unlocked vault to [newPassword]
+  /// Completes with true once the new keys are live; false keeps the old
+  /// keys. Ciphertexts under the old keys stay readable until every store
+  /// has re-keyed: the vault re-encrypts its rows in the background
+  /// (NativePasswordService.startRekey), and ciphertexts from [encryptAES]
+  /// that the caller keeps must go through [resealAESBatch], be saved, and
+  /// then be confirmed with [confirmRekey] using [pendingRekey].
+  static Future<bool> changeMasterPassword(
+    String newPassword, {
+    void Function(int percent)? onProgress,
+  }) {
+    init();
+    if (_changeMasterPassword == null) return Future.value(false);
+    return _runDerivation(_changeMasterPassword!, newPassword, onProgress);
+  }
+
+  /// True while a master password change has records left to re-encrypt
+  static bool get rekeyPending => pendingRekey != 0;
+
+  /// Id of the master password change still re-keying, 0 when none is
+  static int get pendingRekey {
+    init();
+    return _rekeyPending == null ? 0 : _rekeyPending!();
+  }
+
+  /// Report that everything the caller keeps is resealed for change [id]
+  /// Only call it when no item of [resealAESBatch] came back null: the old
+  /// keys may be all that still opens such an item.
+  /// Returns 1 once the old keys are dropped, 0 while the vault is still
+  /// re-keying, -1 if [id] is no longer pending (reseal again for the
+  /// newer change).
+  static int confirmRekey(int id) {
+    init();
+    return _rekeyConfirm == null ? -1 : _rekeyConfirm!(id);
+  }
+
+  /// Never derive the pre-PBKDF2 key again (it is otherwise derived once a
+  /// legacy ciphertext is read). Call when nothing the app holds was
+  /// written by such a build: a new account, or after resealing old data
+  /// with [resealAESBatch].
+  static void retireLegacyKeys() {
+    init();
+    _retireLegacyKeys?.call();
+  }
+
+  static Future<bool> _runDerivation(
+    _DeriveKeysAsync derive,
+    String password,
+    void Function(int percent)? onProgress,
+  ) {
+    final completer = Completer<bool>();
+    late final ffi.NativeCallable<_KeyCallbackNative> callable;
+    callable = ffi.NativeCallable<_KeyCallbackNative>.listener((
+      int event,
+      int progress,
+      ffi.Pointer<ffi.Void> _,
+    ) {
+      if (event == _keyEventProgress) {
+        onProgress?.call(progress);
+        return;
+      }
+      callable.close();
+      if (!completer.isCompleted) completer.complete(event == _keyEventReady);
+    });
+
+    final passwordPtr = _toNativeUtf8(password);
+    derive(
+      passwordPtr,
+      callable.nativeFunction,
+      ffi.Pointer<ffi.Void>.fromAddress(0),
+    );
+    _freeNativeString(passwordPtr);
+    return completer.future;
+  }
+
+  /// True once derived (or file-based) keys are loaded
+  static bool get keysReady {
+    init();
+    return _keysState != null && _keysState!() == _keysReady;
+  }
+
+  static String? _runInto(_Into fn, _Size bound, String value) {
+    final input = utf8.encode(value);
+    final capacity = bound(input.length);
+    if (capacity < 0) return null;
+
+    // One native buffer holds the input followed by the output, so the
+    // steady state does no native allocation at all
+    final needed = input.length + capacity;
+    if (needed > _scratchSize) {
+      _releaseScratch();
+      _scratchSize = needed < 256 ? 256 : needed;
+      _scratch = pkg_ffi.malloc.allocate<ffi.Uint8>(_scratchSize);
+    }
+
+    final buffer = _scratch.asTypedList(_scratchSize);
+    buffer.setRange(0, input.length, input);
+    final out = _scratch.elementAt(input.length);
+    final n = fn(
+      _scratch.cast<ffi.Char>(),
+      input.length,
+      out.cast<ffi.Char>(),
+      capacity,
+    );
+    if (n < 0) return null;
+    final result = utf8.decode(out.asTypedList(n));
+    // Plaintext passes through this buffer in either direction
+    buffer.fillRange(0, input.length + n, 0);
+    return result;
+  }
+
+  static void _releaseScratch() {
+    if (_scratchSize == 0) return;
+    _scratch.asTypedList(_scratchSize).fillRange(0, _scratchSize, 0);
+    pkg_ffi.malloc.free(_scratch);
+    _scratch = ffi.Pointer.fromAddress(0);
+    _scratchSize = 0;
+  }
+
+  static List<String?>? _runBatch(
+    _Batch fn,
+    List<String> values,
+    NativeCancelToken? cancelToken,
+  ) {
+    final count = values.length;
+    if (count == 0) return <String?>[];
+
+    // Pack all inputs into one buffer plus pointer/length tables
+    final encoded = values.map(utf8.encode).toList(growable: false);
+    final total = encoded.fold<int>(0, (sum, e) => sum + e.length);
+    final data = pkg_ffi.malloc.allocate<ffi.Uint8>(total == 0 ? 1 : total);
+    final ptrs = pkg_ffi.malloc.allocate<ffi.Pointer<ffi.Char>>(
+      count * ffi.sizeOf<ffi.Pointer<ffi.Char>>(),
+    );
+    final lens = pkg_ffi.malloc.allocate<ffi.Int32>(
+      count * ffi.sizeOf<ffi.Int32>(),
+    );
+
+    try {
+      final bytes = data.asTypedList(total == 0 ? 1 : total);
+      var offset = 0;
+      for (var i = 0; i < count; i++) {
+        final e = encoded[i];
+        bytes.setRange(offset, offset + e.length, e);
+        ptrs[i] = data.elementAt(offset).cast<ffi.Char>();
+        lens[i] = e.length;
+        offset += e.length;
+      }
+
+      final arena = fn(
+        ptrs,
+        lens,
+        count,
+        cancelToken?._flag ?? ffi.Pointer<ffi.Int32>.fromAddress(0),
+      );
+      if (arena == ffi.Pointer<ffi.Uint8>.fromAddress(0)) return null;
+
+      try {
+        final header = arena.cast<ffi.Int32>();
+        final n = header[0];
+        final results = List<String?>.filled(n, null);
+        for (var i = 0; i < n; i++) {
+          final itemOffset = header[2 + 2 * i];
+          final itemLength = header[3 + 2 * i];
+          if (itemLength < 0) continue;
+          final Uint8List view = arena
+              .elementAt(itemOffset)
+              .asTypedList(itemLength);
+          results[i] = utf8.decode(view);
+        }
+        return results;
+      } finally {
+        _free!(arena.cast<ffi.Char>());
+      }
+    } finally {
+      pkg_ffi.malloc.free(data);
+      pkg_ffi.malloc.free(ptrs);
+      pkg_ffi.malloc.free(lens);
+    }
+  }
+
   static ffi.Pointer<ffi.Char> _toNativeUtf8(String s) {
     final units = utf8.encode(s);
     final ptr = pkg_ffi.malloc.allocate<ffi.Char>(units.length + 1);
@@ -164,3 +773,30 @@ class NativeEncryption {
     return utf8.decode(bytes);
   }
 }
+
+/// Cancellation flag for a native batch job
+///
+/// The flag lives in native memory, so a batch running on a background
+/// isolate can be cancelled from the UI isolate: pass [address] across and
+/// rebuild the token there with [NativeCancelToken.fromAddress].
+class NativeCancelToken {
+  final ffi.Pointer<ffi.Int32> _flag;
+  final bool _owned;
+
+  NativeCancelToken()
+    : _flag = pkg_ffi.calloc.allocate<ffi.Int32>(ffi.sizeOf<ffi.Int32>()),
+      _owned = true;
+
+  NativeCancelToken.fromAddress(int address)
+    : _flag = ffi.Pointer<ffi.Int32>.fromAddress(address),
+      _owned = false;
+
+  int get address => _flag.address;
+
+  void cancel() => _flag.value = 1;
+
+  /// Free the flag; only the creating token owns it
+  void dispose() {
+    if (_owned) pkg_ffi.calloc.free(_flag);
+  }
+}